@@ -299,6 +299,7 @@ void gavl_video_frame_absdiff(gavl_video_frame_t * dst,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       gavl_pixelformat_chroma_sub(format->pixelformat,
                                   &sub_h, &sub_v);
       absdiff_16(dst->planes[0], dst->strides[0],
@@ -314,6 +315,10 @@ void gavl_video_frame_absdiff(gavl_video_frame_t * dst,
                 src2->planes[2], src2->strides[2],
                 format->image_width/sub_h, format->image_height/sub_v);
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
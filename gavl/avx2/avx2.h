@@ -0,0 +1,220 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  Common inline helpers for the AVX2 routines.
+ *  Unlike the MMX and SSE code, these use compiler intrinsics.
+ *  The files in this directory are compiled with -mavx2 -mfma, so they
+ *  must only be called if gavl_accel_supported() reports GAVL_ACCEL_AVX2.
+ */
+
+#ifndef AVX2_H_INCLUDED
+#define AVX2_H_INCLUDED
+
+#include <immintrin.h>
+
+/* Round a floating point coefficient to fixed point with <bits> fractional bits */
+
+#define AVX2_FIX(x, bits) \
+  ((int)((x)*(double)(1<<(bits)) + (((x) < 0.0) ? -0.5 : 0.5)))
+
+/* Pack 16 signed 16 bit values to 16 unsigned bytes with saturation */
+
+static inline __m128i avx2_pack_16_to_8(__m256i x)
+  {
+  return _mm_packus_epi16(_mm256_castsi256_si128(x),
+                          _mm256_extracti128_si256(x, 1));
+  }
+
+/* Pack 2x8 signed 32 bit values to 16 unsigned bytes with saturation */
+
+static inline __m128i avx2_pack_32_to_8(__m256i lo, __m256i hi)
+  {
+  __m256i x = _mm256_packs_epi32(lo, hi);
+  x = _mm256_permute4x64_epi64(x, 0xd8);
+  return avx2_pack_16_to_8(x);
+  }
+
+/* Pack 8 signed 32 bit values to 8 unsigned bytes (in the lower half) */
+
+static inline __m128i avx2_pack_32_to_8_half(__m256i x)
+  {
+  __m128i ret = _mm_packs_epi32(_mm256_castsi256_si128(x),
+                                _mm256_extracti128_si256(x, 1));
+  return _mm_packus_epi16(ret, ret);
+  }
+
+/* Get the even elements of 2x8 32 bit values */
+
+static inline __m256i avx2_even_32(__m256i lo, __m256i hi)
+  {
+  const __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  lo = _mm256_permutevar8x32_epi32(lo, idx);
+  hi = _mm256_permutevar8x32_epi32(hi, idx);
+  return _mm256_permute2x128_si256(lo, hi, 0x20);
+  }
+
+/* Load 16 bytes and expand them to 16 bit */
+
+static inline __m256i avx2_load_8_to_16(const uint8_t * src)
+  {
+  return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)src));
+  }
+
+/* Load 8 bytes, expand them to 16 bit and duplicate each value */
+
+static inline __m256i avx2_load_8_to_16_dup(const uint8_t * src)
+  {
+  __m128i x = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)src));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(x, x)),
+                                 _mm_unpackhi_epi16(x, x), 1);
+  }
+
+/* Convert 16 signed 16 bit values to 2x8 floats */
+
+static inline void avx2_16_to_float(__m256i x, __m256 * lo, __m256 * hi)
+  {
+  *lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(x)));
+  *hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1)));
+  }
+
+/* Interleave 16 bytes of each component to 16 packed 32 bit pixels */
+
+static inline void avx2_interleave_4x8(__m128i c1, __m128i c2,
+                                       __m128i c3, __m128i c4,
+                                       __m128i * p)
+  {
+  __m128i c12_lo = _mm_unpacklo_epi8(c1, c2);
+  __m128i c12_hi = _mm_unpackhi_epi8(c1, c2);
+  __m128i c34_lo = _mm_unpacklo_epi8(c3, c4);
+  __m128i c34_hi = _mm_unpackhi_epi8(c3, c4);
+  p[0] = _mm_unpacklo_epi16(c12_lo, c34_lo);
+  p[1] = _mm_unpackhi_epi16(c12_lo, c34_lo);
+  p[2] = _mm_unpacklo_epi16(c12_hi, c34_hi);
+  p[3] = _mm_unpackhi_epi16(c12_hi, c34_hi);
+  }
+
+/* Store 16 packed 32 bit pixels */
+
+static inline void avx2_store_32(uint8_t * dst, const __m128i * p)
+  {
+  _mm_storeu_si128((__m128i*)dst,      p[0]);
+  _mm_storeu_si128((__m128i*)(dst+16), p[1]);
+  _mm_storeu_si128((__m128i*)(dst+32), p[2]);
+  _mm_storeu_si128((__m128i*)(dst+48), p[3]);
+  }
+
+/* Store 16 packed 32 bit pixels as 24 bit pixels (the 4th byte is dropped) */
+
+static inline void avx2_store_32_as_24(uint8_t * dst, const __m128i * p)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                     -1, -1, -1, -1);
+  __m128i p0 = _mm_shuffle_epi8(p[0], mask);
+  __m128i p1 = _mm_shuffle_epi8(p[1], mask);
+  __m128i p2 = _mm_shuffle_epi8(p[2], mask);
+  __m128i p3 = _mm_shuffle_epi8(p[3], mask);
+
+  _mm_storeu_si128((__m128i*)dst,
+                   _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+  _mm_storeu_si128((__m128i*)(dst+16),
+                   _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+  _mm_storeu_si128((__m128i*)(dst+32),
+                   _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+  }
+
+/* Load 16 24 bit pixels and expand them to 2x8 32 bit pixels */
+
+static inline void avx2_load_24_as_32(const uint8_t * src, __m256i * lo, __m256i * hi)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                     6, 7, 8, -1, 9, 10, 11, -1);
+  __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src),      mask);
+  __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+12)), mask);
+  __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src+24)), mask);
+  /* Load the last 4 pixels from the end to stay inside the buffer */
+  __m128i p3 = _mm_shuffle_epi8(_mm_srli_si128(_mm_loadu_si128((const __m128i*)(src+32)), 4),
+                                mask);
+  *lo = _mm256_inserti128_si256(_mm256_castsi128_si256(p0), p1, 1);
+  *hi = _mm256_inserti128_si256(_mm256_castsi128_si256(p2), p3, 1);
+  }
+
+/* Load 16 32 bit pixels */
+
+static inline void avx2_load_32(const uint8_t * src, __m256i * lo, __m256i * hi)
+  {
+  *lo = _mm256_loadu_si256((const __m256i*)src);
+  *hi = _mm256_loadu_si256((const __m256i*)(src+32));
+  }
+
+/* Transpose and store 8 pixels of 4 float components */
+
+static inline void avx2_transpose_4x8_ps(__m256 c1, __m256 c2, __m256 c3, __m256 c4,
+                                         __m128 * p)
+  {
+  __m256 t0 = _mm256_unpacklo_ps(c1, c2);
+  __m256 t1 = _mm256_unpackhi_ps(c1, c2);
+  __m256 t2 = _mm256_unpacklo_ps(c3, c4);
+  __m256 t3 = _mm256_unpackhi_ps(c3, c4);
+  __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+  __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+  __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+  __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+  p[0] = _mm256_castps256_ps128(s0);
+  p[1] = _mm256_castps256_ps128(s1);
+  p[2] = _mm256_castps256_ps128(s2);
+  p[3] = _mm256_castps256_ps128(s3);
+  p[4] = _mm256_extractf128_ps(s0, 1);
+  p[5] = _mm256_extractf128_ps(s1, 1);
+  p[6] = _mm256_extractf128_ps(s2, 1);
+  p[7] = _mm256_extractf128_ps(s3, 1);
+  }
+
+static inline void avx2_store_float_4x8(float * dst,
+                                        __m256 c1, __m256 c2, __m256 c3, __m256 c4)
+  {
+  int i;
+  __m128 p[8];
+  avx2_transpose_4x8_ps(c1, c2, c3, c4, p);
+  for(i = 0; i < 8; i++)
+    _mm_storeu_ps(dst + 4*i, p[i]);
+  }
+
+static inline void avx2_store_float_3x8(float * dst,
+                                        __m256 c1, __m256 c2, __m256 c3)
+  {
+  int i;
+  __m128 p[8];
+  avx2_transpose_4x8_ps(c1, c2, c3, c3, p);
+
+  /* Overlapping stores, the 4th element is overwritten by the next pixel */
+  for(i = 0; i < 7; i++)
+    _mm_storeu_ps(dst + 3*i, p[i]);
+
+  _mm_storel_pi((__m64*)(dst + 21), p[7]);
+  _mm_store_ss(dst + 23, _mm_movehl_ps(p[7], p[7]));
+  }
+
+static inline __m256 avx2_clip_float(__m256 x, __m256 min, __m256 max)
+  {
+  return _mm256_max_ps(_mm256_min_ps(x, max), min);
+  }
+
+#endif // AVX2_H_INCLUDED
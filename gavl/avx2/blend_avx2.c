@@ -0,0 +1,692 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <blend.h>
+
+#include "avx2.h"
+
+/*
+ *  AVX2 blend functions. Each 128 bit lane does exactly what the SSE2
+ *  version does for one half of the pixels: The lanes are loaded from
+ *  and stored to 2 separate addresses, so all shuffles stay inside the
+ *  lanes. The results are identical to the C versions. The remaining
+ *  pixels of each line are done with the scalar macros.
+ *
+ *  Float formats are left to SSE2: This directory is compiled with
+ *  -mfma, so the compiler would contract the products and the results
+ *  would differ from the C versions.
+ */
+
+#define BLEND_8(s, d, a) \
+  d = (((s - d) * a)>>8) + d;
+
+#define BLEND_16(s, d, a)                        \
+  d = (((s - d) * a)>>16) + d;
+
+/* Load and store the 2 lanes separately */
+
+#define LOAD2(lo, hi)                                                   \
+  _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(lo))), \
+                          _mm_loadu_si128((const __m128i*)(hi)), 1)
+
+#define STORE2(lo, hi, x)                                          \
+  _mm_storeu_si128((__m128i*)(lo), _mm256_castsi256_si128(x));     \
+  _mm_storeu_si128((__m128i*)(hi), _mm256_extracti128_si256(x, 1));
+
+#define LOAD(ptr)       _mm256_loadu_si256((const __m256i*)(ptr))
+#define STORE(ptr, val) _mm256_storeu_si256((__m256i*)(ptr), val)
+
+/* d + ((s - d) * a) >> 8 for 16 words */
+
+static inline __m256i blend_8(__m256i s, __m256i d, __m256i a)
+  {
+  __m256i x = _mm256_sub_epi16(s, d);
+  return _mm256_add_epi16(d,
+                          _mm256_or_si256(_mm256_slli_epi16(_mm256_mulhi_epi16(x, a), 8),
+                                          _mm256_srli_epi16(_mm256_mullo_epi16(x, a), 8)));
+  }
+
+/* d + ((s - d) * a) >> 16 for 16 unsigned words: The high words of
+   s * a and d * a are subtracted, a borrow from the low words is
+   subtracted as well */
+
+static inline __m256i blend_16(__m256i s, __m256i d, __m256i a)
+  {
+  const __m256i sign = _mm256_set1_epi16(0x8000);
+  __m256i borrow = _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_mullo_epi16(d, a), sign),
+                                      _mm256_xor_si256(_mm256_mullo_epi16(s, a), sign));
+  return _mm256_add_epi16(_mm256_add_epi16(d, borrow),
+                          _mm256_sub_epi16(_mm256_mulhi_epu16(s, a),
+                                           _mm256_mulhi_epu16(d, a)));
+  }
+
+/* Blend 32 bytes of dst */
+
+static inline __m256i blend_8x32(__m256i s_lo, __m256i s_hi,
+                                 __m256i a_lo, __m256i a_hi, __m256i d)
+  {
+  const __m256i zero = _mm256_setzero_si256();
+  return _mm256_packus_epi16(blend_8(s_lo, _mm256_unpacklo_epi8(d, zero), a_lo),
+                             blend_8(s_hi, _mm256_unpackhi_epi8(d, zero), a_hi));
+  }
+
+/* Blend 16 bytes of dst */
+
+static inline void blend_8x16(uint8_t * dst, __m256i s, __m256i a)
+  {
+  __m256i d = avx2_load_8_to_16(dst);
+  _mm_storeu_si128((__m128i*)dst, avx2_pack_16_to_8(blend_8(s, d, a)));
+  }
+
+/* Components of 2x8 packed 32 bit pixels as 16 bit words */
+
+#define COMPONENT(p0, p1, shift)                                        \
+  _mm256_packs_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, shift), mask_ff), \
+                     _mm256_and_si256(_mm256_srli_epi32(p1, shift), mask_ff))
+
+/* Even words of 2x16 words */
+
+#define EVEN(x0, x1)                                   \
+  _mm256_packs_epi32(_mm256_and_si256(x0, mask_ffff),  \
+                     _mm256_and_si256(x1, mask_ffff))
+
+/* ovl: GAVL_YUVA_32, 32 pixels at once. The first lane gets
+   pixels 0-15, the second lane 16-31 */
+
+#define INIT_YUVA_32 \
+  __m256i p0, p1, p2, p3, y0, y1, a0, a1; \
+  const __m256i mask_ff = _mm256_set1_epi32(0xff);
+
+#define INIT_EVEN \
+  const __m256i mask_ffff = _mm256_set1_epi32(0xffff);
+
+#define LOAD_YUVA_32(ptr) \
+  p0 = LOAD2((ptr),    (ptr)+64); \
+  p1 = LOAD2((ptr)+16, (ptr)+80); \
+  p2 = LOAD2((ptr)+32, (ptr)+96); \
+  p3 = LOAD2((ptr)+48, (ptr)+112); \
+  y0 = COMPONENT(p0, p1, 0); \
+  y1 = COMPONENT(p2, p3, 0); \
+  a0 = COMPONENT(p0, p1, 24); \
+  a1 = COMPONENT(p2, p3, 24);
+
+#define BLEND_Y(dst) \
+  STORE(dst, blend_8x32(y0, y1, a0, a1, LOAD(dst)));
+
+/* Chroma of every second pixel */
+
+#define BLEND_UV_EVEN(dst_u, dst_v)                                      \
+  a0 = EVEN(a0, a1);                                                    \
+  blend_8x16(dst_u, EVEN(COMPONENT(p0, p1, 8), COMPONENT(p2, p3, 8)), a0); \
+  blend_8x16(dst_v, EVEN(COMPONENT(p0, p1, 16), COMPONENT(p2, p3, 16)), a0);
+
+static void blend_yuv_420_p_avx2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr_y;
+  uint8_t * dst_ptr_u;
+  uint8_t * dst_ptr_v;
+  int w32 = width & ~31;
+  INIT_YUVA_32
+  INIT_EVEN
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr_y = frame->planes[0] + i * frame->strides[0];
+    dst_ptr_u = frame->planes[1] + (i/2) * frame->strides[1];
+    dst_ptr_v = frame->planes[2] + (i/2) * frame->strides[2];
+
+    for(j = 0; j < w32; j += 32)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_Y(dst_ptr_y);
+
+      if(!(i & 1))
+        {
+        BLEND_UV_EVEN(dst_ptr_u, dst_ptr_v);
+        dst_ptr_u += 16;
+        dst_ptr_v += 16;
+        }
+      ovl_ptr += 128;
+      dst_ptr_y += 32;
+      }
+
+    for(j = w32; j < width; j += 2)
+      {
+      tmp = dst_ptr_y[0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr_y[0] = tmp;
+
+      tmp = dst_ptr_y[1];
+      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
+      dst_ptr_y[1] = tmp;
+
+      if(!(i & 1))
+        {
+        tmp = *dst_ptr_u;
+        BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+        *(dst_ptr_u++) = tmp;
+
+        tmp = *dst_ptr_v;
+        BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+        *(dst_ptr_v++) = tmp;
+        }
+      ovl_ptr += 8;
+      dst_ptr_y += 2;
+      }
+    }
+  }
+
+static void blend_yuv_422_p_avx2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr_y;
+  uint8_t * dst_ptr_u;
+  uint8_t * dst_ptr_v;
+  int w32 = width & ~31;
+  INIT_YUVA_32
+  INIT_EVEN
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr_y = frame->planes[0] + i * frame->strides[0];
+    dst_ptr_u = frame->planes[1] + i * frame->strides[1];
+    dst_ptr_v = frame->planes[2] + i * frame->strides[2];
+
+    for(j = 0; j < w32; j += 32)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_Y(dst_ptr_y);
+      BLEND_UV_EVEN(dst_ptr_u, dst_ptr_v);
+      ovl_ptr += 128;
+      dst_ptr_y += 32;
+      dst_ptr_u += 16;
+      dst_ptr_v += 16;
+      }
+
+    for(j = w32; j < width; j += 2)
+      {
+      tmp = dst_ptr_y[0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr_y[0] = tmp;
+
+      tmp = dst_ptr_y[1];
+      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
+      dst_ptr_y[1] = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      *(dst_ptr_v++) = tmp;
+
+      ovl_ptr += 8;
+      dst_ptr_y += 2;
+      }
+    }
+  }
+
+static void blend_yuv_444_p_avx2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr_y;
+  uint8_t * dst_ptr_u;
+  uint8_t * dst_ptr_v;
+  int w32 = width & ~31;
+  INIT_YUVA_32
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr_y = frame->planes[0] + i * frame->strides[0];
+    dst_ptr_u = frame->planes[1] + i * frame->strides[1];
+    dst_ptr_v = frame->planes[2] + i * frame->strides[2];
+
+    for(j = 0; j < w32; j += 32)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_Y(dst_ptr_y);
+
+      STORE(dst_ptr_u,
+            blend_8x32(COMPONENT(p0, p1, 8), COMPONENT(p2, p3, 8),
+                       a0, a1, LOAD(dst_ptr_u)));
+      STORE(dst_ptr_v,
+            blend_8x32(COMPONENT(p0, p1, 16), COMPONENT(p2, p3, 16),
+                       a0, a1, LOAD(dst_ptr_v)));
+      ovl_ptr += 128;
+      dst_ptr_y += 32;
+      dst_ptr_u += 32;
+      dst_ptr_v += 32;
+      }
+
+    for(j = w32; j < width; j++)
+      {
+      tmp = *dst_ptr_y;
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      *(dst_ptr_y++) = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      *(dst_ptr_v++) = tmp;
+
+      ovl_ptr += 4;
+      }
+    }
+  }
+
+/* Packed 4:2:2: The chroma of the even pixels is interleaved with
+   the luma of all pixels. The first lane gets destination bytes 0-31,
+   the second lane 32-63 */
+
+#define BLEND_PACKED_422(dst, y_first)                                  \
+  c0 = EVEN(COMPONENT(p0, p1, 8), COMPONENT(p2, p3, 8));                \
+  c1 = EVEN(COMPONENT(p0, p1, 16), COMPONENT(p2, p3, 16));              \
+  ca = EVEN(a0, a1);                                                    \
+  /* u0 v0 u2 v2 ... */                                                 \
+  c = _mm256_unpacklo_epi16(c0, c1);                                    \
+  c1 = _mm256_unpackhi_epi16(c0, c1);                                   \
+  c0 = c;                                                               \
+  c = _mm256_unpacklo_epi16(ca, ca);                                    \
+  ca = _mm256_unpackhi_epi16(ca, ca);                                   \
+  if(y_first)                                                           \
+    {                                                                   \
+    d = blend_8x32(_mm256_unpacklo_epi16(y0, c0), _mm256_unpackhi_epi16(y0, c0), \
+                   _mm256_unpacklo_epi16(a0, c), _mm256_unpackhi_epi16(a0, c), \
+                   LOAD2((dst), (dst)+32));                             \
+    STORE2((dst), (dst)+32, d);                                         \
+    d = blend_8x32(_mm256_unpacklo_epi16(y1, c1), _mm256_unpackhi_epi16(y1, c1), \
+                   _mm256_unpacklo_epi16(a1, ca), _mm256_unpackhi_epi16(a1, ca), \
+                   LOAD2((dst)+16, (dst)+48));                          \
+    STORE2((dst)+16, (dst)+48, d);                                      \
+    }                                                                   \
+  else                                                                  \
+    {                                                                   \
+    d = blend_8x32(_mm256_unpacklo_epi16(c0, y0), _mm256_unpackhi_epi16(c0, y0), \
+                   _mm256_unpacklo_epi16(c, a0), _mm256_unpackhi_epi16(c, a0), \
+                   LOAD2((dst), (dst)+32));                             \
+    STORE2((dst), (dst)+32, d);                                         \
+    d = blend_8x32(_mm256_unpacklo_epi16(c1, y1), _mm256_unpackhi_epi16(c1, y1), \
+                   _mm256_unpacklo_epi16(ca, a1), _mm256_unpackhi_epi16(ca, a1), \
+                   LOAD2((dst)+16, (dst)+48));                          \
+    STORE2((dst)+16, (dst)+48, d);                                      \
+    }
+
+static void blend_packed_422_avx2(gavl_video_frame_t * frame,
+                                  gavl_video_frame_t * overlay,
+                                  int width, int height, int y_first)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  __m256i c, c0, c1, ca, d;
+  int w32 = width & ~31;
+  /* Byte offsets of y0, u, y1, v */
+  int oy0 = y_first ? 0 : 1;
+  int ou  = y_first ? 1 : 0;
+  int oy1 = y_first ? 2 : 3;
+  int ov  = y_first ? 3 : 2;
+  INIT_YUVA_32
+  INIT_EVEN
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+
+    for(j = 0; j < w32; j += 32)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_PACKED_422(dst_ptr, y_first);
+      ovl_ptr += 128;
+      dst_ptr += 64;
+      }
+
+    for(j = w32; j < width; j += 2)
+      {
+      tmp = dst_ptr[oy0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr[oy0] = tmp;
+
+      tmp = dst_ptr[ou];
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      dst_ptr[ou] = tmp;
+
+      tmp = dst_ptr[ov];
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      dst_ptr[ov] = tmp;
+
+      tmp = dst_ptr[oy1];
+      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
+      dst_ptr[oy1] = tmp;
+
+      ovl_ptr += 8;
+      dst_ptr += 4;
+      }
+    }
+  }
+
+static void blend_yuy2_avx2(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
+  {
+  blend_packed_422_avx2(frame, overlay, width, height, 1);
+  }
+
+static void blend_uyvy_avx2(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
+  {
+  blend_packed_422_avx2(frame, overlay, width, height, 0);
+  }
+
+/* ovl: GAVL_RGBA_32, 8 pixels at once. The 4th byte of the
+   destination is blended with zero alpha, so it stays unchanged */
+
+static void blend_rgb_32_common(gavl_video_frame_t * frame,
+                                gavl_video_frame_t * overlay,
+                                int width, int height, int swap)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  __m256i o, s_lo, s_hi, a_lo, a_hi;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i mask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1,
+                                        0, -1, -1, -1, 0, -1, -1, -1);
+  int w8 = width & ~7;
+  /* Byte offsets of r and b */
+  int o_r = swap ? 2 : 0;
+  int o_b = swap ? 0 : 2;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+
+    for(j = 0; j < w8; j += 8)
+      {
+      o = LOAD(ovl_ptr);
+      s_lo = _mm256_unpacklo_epi8(o, zero);
+      s_hi = _mm256_unpackhi_epi8(o, zero);
+
+      a_lo = _mm256_and_si256(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_lo, 0xff), 0xff), mask);
+      a_hi = _mm256_and_si256(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_hi, 0xff), 0xff), mask);
+
+      if(swap)
+        {
+        s_lo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_lo, _MM_SHUFFLE(3, 0, 1, 2)),
+                                      _MM_SHUFFLE(3, 0, 1, 2));
+        s_hi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_hi, _MM_SHUFFLE(3, 0, 1, 2)),
+                                      _MM_SHUFFLE(3, 0, 1, 2));
+        }
+
+      STORE(dst_ptr, blend_8x32(s_lo, s_hi, a_lo, a_hi, LOAD(dst_ptr)));
+      ovl_ptr += 32;
+      dst_ptr += 32;
+      }
+
+    for(j = w8; j < width; j++)
+      {
+      tmp = dst_ptr[o_r];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr[o_r] = tmp;
+
+      tmp = dst_ptr[1];
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      dst_ptr[1] = tmp;
+
+      tmp = dst_ptr[o_b];
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      dst_ptr[o_b] = tmp;
+
+      ovl_ptr += 4;
+      dst_ptr += 4;
+      }
+    }
+  }
+
+static void blend_rgb_32_avx2(gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay,
+                              int width, int height)
+  {
+  blend_rgb_32_common(frame, overlay, width, height, 0);
+  }
+
+static void blend_bgr_32_avx2(gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay,
+                              int width, int height)
+  {
+  blend_rgb_32_common(frame, overlay, width, height, 1);
+  }
+
+/* ovl: GAVL_YUVA_64, 2x8 pixels at once */
+
+/* Transpose 2 pixels from each lane of p0, p1 into the components
+   of 4 pixels: y in the lower and u in the upper half of yu */
+
+#define TRANSPOSE_64(p0, p1, yu, va)            \
+  t0 = _mm256_unpacklo_epi16(p0, p1);           \
+  t1 = _mm256_unpackhi_epi16(p0, p1);           \
+  yu = _mm256_unpacklo_epi16(t0, t1);           \
+  va = _mm256_unpackhi_epi16(t0, t1);
+
+/* The first lane gets the 8 pixels at ptr, the second lane
+   the 8 pixels at ptr + offset */
+
+#define LOAD_YUVA_64(ptr, offset)                    \
+  p0 = LOAD2((ptr),    (ptr)+(offset));              \
+  p1 = LOAD2((ptr)+16, (ptr)+(offset)+16);           \
+  p2 = LOAD2((ptr)+32, (ptr)+(offset)+32);           \
+  p3 = LOAD2((ptr)+48, (ptr)+(offset)+48);           \
+  TRANSPOSE_64(p0, p1, yu0, va0);                    \
+  TRANSPOSE_64(p2, p3, yu1, va1);                    \
+  y = _mm256_unpacklo_epi64(yu0, yu1);               \
+  u = _mm256_unpackhi_epi64(yu0, yu1);               \
+  v = _mm256_unpacklo_epi64(va0, va1);               \
+  a = _mm256_unpackhi_epi64(va0, va1);
+
+#define BLEND_16_STORE(dst, s, a) \
+  STORE(dst, blend_16(s, LOAD(dst), a));
+
+static void blend_yuv_444_p_16_avx2(gavl_video_frame_t * frame,
+                                    gavl_video_frame_t * overlay,
+                                    int width, int height)
+  {
+  int i, j;
+  uint16_t * ovl_ptr;
+  uint16_t * dst_ptr_y;
+  uint16_t * dst_ptr_u;
+  uint16_t * dst_ptr_v;
+  int64_t tmp, alpha;
+  __m256i p0, p1, p2, p3, t0, t1, yu0, yu1, va0, va1, y, u, v, a;
+  int w16 = width & ~15;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = (uint16_t*)(overlay->planes[0] + i * overlay->strides[0]);
+    dst_ptr_y = (uint16_t*)(frame->planes[0] + i * frame->strides[0]);
+    dst_ptr_u = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+    dst_ptr_v = (uint16_t*)(frame->planes[2] + i * frame->strides[2]);
+
+    for(j = 0; j < w16; j += 16)
+      {
+      LOAD_YUVA_64((uint8_t*)ovl_ptr, 64);
+      BLEND_16_STORE(dst_ptr_y, y, a);
+      BLEND_16_STORE(dst_ptr_u, u, a);
+      BLEND_16_STORE(dst_ptr_v, v, a);
+      ovl_ptr += 64;
+      dst_ptr_y += 16;
+      dst_ptr_u += 16;
+      dst_ptr_v += 16;
+      }
+
+    for(j = w16; j < width; j++)
+      {
+      alpha = ovl_ptr[3];
+
+      tmp = *dst_ptr_y;
+      BLEND_16(ovl_ptr[0], tmp, alpha);
+      *(dst_ptr_y++) = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_16(ovl_ptr[1], tmp, alpha);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_16(ovl_ptr[2], tmp, alpha);
+      *(dst_ptr_v++) = tmp;
+
+      ovl_ptr += 4;
+      }
+    }
+  }
+
+/* The luma of 2x16 pixels is blended in 2 steps. The first step
+   blends pixels 0-7 and 16-23, the second one 8-15 and 24-31 */
+
+static void blend_yuv_422_p_16_avx2(gavl_video_frame_t * frame,
+                                    gavl_video_frame_t * overlay,
+                                    int width, int height)
+  {
+  int i, j;
+  uint16_t * ovl_ptr;
+  uint16_t * dst_ptr_y;
+  uint16_t * dst_ptr_u;
+  uint16_t * dst_ptr_v;
+  int64_t tmp, alpha;
+  __m256i p0, p1, p2, p3, t0, t1, yu0, yu1, va0, va1, y, u, v, a;
+  __m256i u_even, v_even, a_even;
+  int w32 = width & ~31;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = (uint16_t*)(overlay->planes[0] + i * overlay->strides[0]);
+    dst_ptr_y = (uint16_t*)(frame->planes[0] + i * frame->strides[0]);
+    dst_ptr_u = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+    dst_ptr_v = (uint16_t*)(frame->planes[2] + i * frame->strides[2]);
+
+    for(j = 0; j < w32; j += 32)
+      {
+      LOAD_YUVA_64((uint8_t*)ovl_ptr, 128);
+      y = blend_16(y, LOAD2(dst_ptr_y, dst_ptr_y + 16), a);
+      STORE2(dst_ptr_y, dst_ptr_y + 16, y);
+      u_even = u;
+      v_even = v;
+      a_even = a;
+
+      LOAD_YUVA_64((uint8_t*)(ovl_ptr+32), 128);
+      y = blend_16(y, LOAD2(dst_ptr_y + 8, dst_ptr_y + 24), a);
+      STORE2(dst_ptr_y + 8, dst_ptr_y + 24, y);
+
+      /* Select the even words with sign-extension safe shifts */
+      u_even = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(u_even, 16), 16),
+                                  _mm256_srai_epi32(_mm256_slli_epi32(u, 16), 16));
+      v_even = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(v_even, 16), 16),
+                                  _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16));
+      a_even = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(a_even, 16), 16),
+                                  _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16));
+
+      BLEND_16_STORE(dst_ptr_u, u_even, a_even);
+      BLEND_16_STORE(dst_ptr_v, v_even, a_even);
+
+      ovl_ptr += 128;
+      dst_ptr_y += 32;
+      dst_ptr_u += 16;
+      dst_ptr_v += 16;
+      }
+
+    for(j = w32; j < width; j += 2)
+      {
+      alpha = ovl_ptr[3];
+
+      tmp = *dst_ptr_y;
+      BLEND_16(ovl_ptr[0], tmp, alpha);
+      *(dst_ptr_y++) = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_16(ovl_ptr[1], tmp, alpha);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_16(ovl_ptr[2], tmp, alpha);
+      *(dst_ptr_v++) = tmp;
+
+      alpha = ovl_ptr[7];
+
+      tmp = *dst_ptr_y;
+      BLEND_16(ovl_ptr[4], tmp, alpha);
+      *(dst_ptr_y++) = tmp;
+
+      ovl_ptr += 8;
+      }
+    }
+  }
+
+gavl_blend_func_t
+gavl_find_blend_func_avx2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format,
+                          gavl_pixelformat_t overlay_format)
+  {
+  switch(frame_format)
+    {
+    case GAVL_YUV_420_P:
+      return blend_yuv_420_p_avx2;
+    case GAVL_YUV_422_P:
+      return blend_yuv_422_p_avx2;
+    case GAVL_YUV_444_P:
+      return blend_yuv_444_p_avx2;
+    case GAVL_YUY2:
+      return blend_yuy2_avx2;
+    case GAVL_UYVY:
+      return blend_uyvy_avx2;
+    case GAVL_RGB_32:
+      return blend_rgb_32_avx2;
+    case GAVL_BGR_32:
+      return blend_bgr_32_avx2;
+    case GAVL_YUV_444_P_16:
+      return blend_yuv_444_p_16_avx2;
+    case GAVL_YUV_422_P_16:
+      return blend_yuv_422_p_16_avx2;
+    default:
+      break;
+    }
+  return NULL;
+  }
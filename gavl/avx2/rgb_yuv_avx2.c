@@ -0,0 +1,910 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include <attributes.h>
+
+#include "avx2.h"
+#include "../c/colorspace_macros.h"
+
+/*
+ *  AVX2 RGB -> YUV conversions. 16 pixels are processed at once.
+ *  The pixels are expanded to 32 bit, so that red and blue end up in
+ *  the two 16 bit halves of each word and can be multiplied and
+ *  summed with a single _mm256_madd_epi16.
+ *  Coefficients have 15 fractional bits. Chroma of subsampled formats
+ *  is taken from the even pixels like in the C version.
+ */
+
+typedef struct
+  {
+  __m256i y_rb;
+  __m256i y_g;
+  __m256i u_rb;
+  __m256i u_g;
+  __m256i v_rb;
+  __m256i v_g;
+
+  __m256i y_off;
+  __m256i uv_off;
+  
+  __m256i mask_rb;
+  __m256i mask_g;
+  } rgb_yuv_avx2_t;
+
+#define COEFF_PAIR(lo, hi) \
+  _mm256_set1_epi32((AVX2_FIX(hi, 15) << 16) | (AVX2_FIX(lo, 15) & 0xffff))
+
+static inline void rgb_yuv_avx2_init(rgb_yuv_avx2_t * c, int jpeg, int swap)
+  {
+  /* Scale factors for luma and chroma */
+  double ys = jpeg ? 1.0 : 219.0/255.0;
+  double uvs = jpeg ? 1.0 : 224.0/255.0;
+  
+  if(swap)
+    {
+    /* BGR: Blue is in the lower half */
+    c->y_rb = COEFF_PAIR(b_float_to_y * ys,  r_float_to_y * ys);
+    c->u_rb = COEFF_PAIR(b_float_to_u * uvs, r_float_to_u * uvs);
+    c->v_rb = COEFF_PAIR(b_float_to_v * uvs, r_float_to_v * uvs);
+    }
+  else
+    {
+    c->y_rb = COEFF_PAIR(r_float_to_y * ys,  b_float_to_y * ys);
+    c->u_rb = COEFF_PAIR(r_float_to_u * uvs, b_float_to_u * uvs);
+    c->v_rb = COEFF_PAIR(r_float_to_v * uvs, b_float_to_v * uvs);
+    }
+  c->y_g = COEFF_PAIR(g_float_to_y * ys,  0.0);
+  c->u_g = COEFF_PAIR(g_float_to_u * uvs, 0.0);
+  c->v_g = COEFF_PAIR(g_float_to_v * uvs, 0.0);
+
+  /* Offset and rounding */
+  c->y_off  = _mm256_set1_epi32(((jpeg ? 0 : 0x10) << 15) + (1 << 14));
+  c->uv_off = _mm256_set1_epi32((0x80 << 15) + (1 << 14));
+
+  c->mask_rb = _mm256_set1_epi32(0x00ff00ff);
+  c->mask_g  = _mm256_set1_epi32(0x000000ff);
+  }
+
+static inline __m256i rgb_to_yuv_avx2(__m256i rb, __m256i g,
+                                      __m256i coeff_rb, __m256i coeff_g,
+                                      __m256i off)
+  {
+  __m256i ret = _mm256_add_epi32(_mm256_madd_epi16(rb, coeff_rb),
+                                 _mm256_madd_epi16(g, coeff_g));
+  return _mm256_srai_epi32(_mm256_add_epi32(ret, off), 15);
+  }
+
+/* Loading */
+
+#define INIT_LOAD \
+  __m256i p_lo, p_hi, rb_lo, rb_hi, g_lo, g_hi; \
+  __m128i y, u, v;
+
+#define SPLIT_RGB \
+  rb_lo = _mm256_and_si256(p_lo, c.mask_rb); \
+  rb_hi = _mm256_and_si256(p_hi, c.mask_rb); \
+  g_lo = _mm256_and_si256(_mm256_srli_epi32(p_lo, 8), c.mask_g); \
+  g_hi = _mm256_and_si256(_mm256_srli_epi32(p_hi, 8), c.mask_g);
+
+#define LOAD_RGB_24 \
+  avx2_load_24_as_32(src, &p_lo, &p_hi); \
+  SPLIT_RGB
+
+#define LOAD_RGB_32 \
+  avx2_load_32(src, &p_lo, &p_hi); \
+  SPLIT_RGB
+
+/* Calculation */
+
+#define CALC_Y \
+  y = avx2_pack_32_to_8(rgb_to_yuv_avx2(rb_lo, g_lo, c.y_rb, c.y_g, c.y_off), \
+                        rgb_to_yuv_avx2(rb_hi, g_hi, c.y_rb, c.y_g, c.y_off));
+
+#define CALC_UV \
+  u = avx2_pack_32_to_8(rgb_to_yuv_avx2(rb_lo, g_lo, c.u_rb, c.u_g, c.uv_off), \
+                        rgb_to_yuv_avx2(rb_hi, g_hi, c.u_rb, c.u_g, c.uv_off)); \
+  v = avx2_pack_32_to_8(rgb_to_yuv_avx2(rb_lo, g_lo, c.v_rb, c.v_g, c.uv_off), \
+                        rgb_to_yuv_avx2(rb_hi, g_hi, c.v_rb, c.v_g, c.uv_off));
+
+/* Only the 8 even pixels */
+
+#define CALC_UV_SUB \
+  rb_lo = avx2_even_32(rb_lo, rb_hi); \
+  g_lo = avx2_even_32(g_lo, g_hi); \
+  u = avx2_pack_32_to_8_half(rgb_to_yuv_avx2(rb_lo, g_lo, c.u_rb, c.u_g, c.uv_off)); \
+  v = avx2_pack_32_to_8_half(rgb_to_yuv_avx2(rb_lo, g_lo, c.v_rb, c.v_g, c.uv_off));
+
+/* Storing */
+
+#define STORE_Y \
+  _mm_storeu_si128((__m128i*)dst_y, y);
+
+#define STORE_UV \
+  _mm_storeu_si128((__m128i*)dst_u, u); \
+  _mm_storeu_si128((__m128i*)dst_v, v);
+
+#define STORE_UV_SUB \
+  _mm_storel_epi64((__m128i*)dst_u, u); \
+  _mm_storel_epi64((__m128i*)dst_v, v);
+
+#define STORE_YUY2 \
+  u = _mm_unpacklo_epi8(u, v); \
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(y, u)); \
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(y, u));
+
+#define STORE_UYVY \
+  u = _mm_unpacklo_epi8(u, v); \
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(u, y)); \
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(u, y));
+
+/* RGB_24 */
+
+/* rgb_24_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      rgb_24_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_yuy2_avx2 */
+
+#define FUNC_NAME   rgb_24_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT     LOAD_RGB_24 CALC_Y CALC_UV_SUB STORE_YUY2
+
+#include "../csp_packed_packed.h"
+
+/* rgb_24_to_uyvy_avx2 */
+
+#define FUNC_NAME   rgb_24_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT     LOAD_RGB_24 CALC_Y CALC_UV_SUB STORE_UYVY
+
+#include "../csp_packed_packed.h"
+
+/* BGR_24 */
+
+/* bgr_24_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      bgr_24_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_yuy2_avx2 */
+
+#define FUNC_NAME   bgr_24_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT     LOAD_RGB_24 CALC_Y CALC_UV_SUB STORE_YUY2
+
+#include "../csp_packed_packed.h"
+
+/* bgr_24_to_uyvy_avx2 */
+
+#define FUNC_NAME   bgr_24_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  48
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT     LOAD_RGB_24 CALC_Y CALC_UV_SUB STORE_UYVY
+
+#include "../csp_packed_packed.h"
+
+/* RGB_32 */
+
+/* rgb_32_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      rgb_32_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_yuy2_avx2 */
+
+#define FUNC_NAME   rgb_32_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT     LOAD_RGB_32 CALC_Y CALC_UV_SUB STORE_YUY2
+
+#include "../csp_packed_packed.h"
+
+/* rgb_32_to_uyvy_avx2 */
+
+#define FUNC_NAME   rgb_32_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT     LOAD_RGB_32 CALC_Y CALC_UV_SUB STORE_UYVY
+
+#include "../csp_packed_packed.h"
+
+/* BGR_32 */
+
+/* bgr_32_to_yuv_420_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuv_422_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuv_444_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuv_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuvj_420_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuvj_420_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuvj_422_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuvj_422_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_SUB
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuvj_444_p_avx2 */
+
+#define FUNC_NAME      bgr_32_to_yuvj_444_p_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 1, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_yuy2_avx2 */
+
+#define FUNC_NAME   bgr_32_to_yuy2_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT     LOAD_RGB_32 CALC_Y CALC_UV_SUB STORE_YUY2
+
+#include "../csp_packed_packed.h"
+
+/* bgr_32_to_uyvy_avx2 */
+
+#define FUNC_NAME   bgr_32_to_uyvy_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  64
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT     LOAD_RGB_32 CALC_Y CALC_UV_SUB STORE_UYVY
+
+#include "../csp_packed_packed.h"
+
+/*
+ *  Semiplanar formats: The chroma samples are stored interleaved
+ *  to the plane pointed to by dst_u, dst_v is unused.
+ */
+
+#define STORE_UV_NV12 \
+  _mm_storeu_si128((__m128i*)dst_u, _mm_unpacklo_epi8(u, v));
+
+#define STORE_UV_NV21 \
+  _mm_storeu_si128((__m128i*)dst_u, _mm_unpacklo_epi8(v, u));
+
+/* RGB_24 -> Semiplanar */
+
+/* rgb_24_to_nv12_avx2 */
+
+#define FUNC_NAME      rgb_24_to_nv12_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_nv21_avx2 */
+
+#define FUNC_NAME      rgb_24_to_nv21_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV21
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_24_to_nv16_avx2 */
+
+#define FUNC_NAME      rgb_24_to_nv16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+
+#include "../csp_packed_planar.h"
+
+/* BGR_24 -> Semiplanar */
+
+/* bgr_24_to_nv12_avx2 */
+
+#define FUNC_NAME      bgr_24_to_nv12_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_nv21_avx2 */
+
+#define FUNC_NAME      bgr_24_to_nv21_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV21
+#define CONVERT_Y      LOAD_RGB_24 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_24_to_nv16_avx2 */
+
+#define FUNC_NAME      bgr_24_to_nv16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     48
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_24 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+
+#include "../csp_packed_planar.h"
+
+/* RGB_32 -> Semiplanar */
+
+/* rgb_32_to_nv12_avx2 */
+
+#define FUNC_NAME      rgb_32_to_nv12_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_nv21_avx2 */
+
+#define FUNC_NAME      rgb_32_to_nv21_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV21
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* rgb_32_to_nv16_avx2 */
+
+#define FUNC_NAME      rgb_32_to_nv16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 0);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+
+#include "../csp_packed_planar.h"
+
+/* BGR_32 -> Semiplanar */
+
+/* bgr_32_to_nv12_avx2 */
+
+#define FUNC_NAME      bgr_32_to_nv12_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_nv21_avx2 */
+
+#define FUNC_NAME      bgr_32_to_nv21_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV21
+#define CONVERT_Y      LOAD_RGB_32 CALC_Y STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* bgr_32_to_nv16_avx2 */
+
+#define FUNC_NAME      bgr_32_to_nv16_avx2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     64
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 16
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_LOAD rgb_yuv_avx2_t c; rgb_yuv_avx2_init(&c, 0, 1);
+#define CONVERT_YUV    LOAD_RGB_32 CALC_Y STORE_Y CALC_UV_SUB STORE_UV_NV12
+
+#include "../csp_packed_planar.h"
+
+void gavl_init_rgb_yuv_funcs_avx2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  if(width % 16)
+    return;
+
+  if(opt->quality && (opt->quality >= 3))
+    return;
+
+  tab->rgb_24_to_yuv_420_p = rgb_24_to_yuv_420_p_avx2;
+  tab->rgb_24_to_yuv_422_p = rgb_24_to_yuv_422_p_avx2;
+  tab->rgb_24_to_yuv_444_p = rgb_24_to_yuv_444_p_avx2;
+  tab->rgb_24_to_yuvj_420_p = rgb_24_to_yuvj_420_p_avx2;
+  tab->rgb_24_to_yuvj_422_p = rgb_24_to_yuvj_422_p_avx2;
+  tab->rgb_24_to_yuvj_444_p = rgb_24_to_yuvj_444_p_avx2;
+  tab->rgb_24_to_yuy2 = rgb_24_to_yuy2_avx2;
+  tab->rgb_24_to_uyvy = rgb_24_to_uyvy_avx2;
+
+  tab->bgr_24_to_yuv_420_p = bgr_24_to_yuv_420_p_avx2;
+  tab->bgr_24_to_yuv_422_p = bgr_24_to_yuv_422_p_avx2;
+  tab->bgr_24_to_yuv_444_p = bgr_24_to_yuv_444_p_avx2;
+  tab->bgr_24_to_yuvj_420_p = bgr_24_to_yuvj_420_p_avx2;
+  tab->bgr_24_to_yuvj_422_p = bgr_24_to_yuvj_422_p_avx2;
+  tab->bgr_24_to_yuvj_444_p = bgr_24_to_yuvj_444_p_avx2;
+  tab->bgr_24_to_yuy2 = bgr_24_to_yuy2_avx2;
+  tab->bgr_24_to_uyvy = bgr_24_to_uyvy_avx2;
+
+  tab->rgb_32_to_yuv_420_p = rgb_32_to_yuv_420_p_avx2;
+  tab->rgb_32_to_yuv_422_p = rgb_32_to_yuv_422_p_avx2;
+  tab->rgb_32_to_yuv_444_p = rgb_32_to_yuv_444_p_avx2;
+  tab->rgb_32_to_yuvj_420_p = rgb_32_to_yuvj_420_p_avx2;
+  tab->rgb_32_to_yuvj_422_p = rgb_32_to_yuvj_422_p_avx2;
+  tab->rgb_32_to_yuvj_444_p = rgb_32_to_yuvj_444_p_avx2;
+  tab->rgb_32_to_yuy2 = rgb_32_to_yuy2_avx2;
+  tab->rgb_32_to_uyvy = rgb_32_to_uyvy_avx2;
+
+  tab->bgr_32_to_yuv_420_p = bgr_32_to_yuv_420_p_avx2;
+  tab->bgr_32_to_yuv_422_p = bgr_32_to_yuv_422_p_avx2;
+  tab->bgr_32_to_yuv_444_p = bgr_32_to_yuv_444_p_avx2;
+  tab->bgr_32_to_yuvj_420_p = bgr_32_to_yuvj_420_p_avx2;
+  tab->bgr_32_to_yuvj_422_p = bgr_32_to_yuvj_422_p_avx2;
+  tab->bgr_32_to_yuvj_444_p = bgr_32_to_yuvj_444_p_avx2;
+  tab->bgr_32_to_yuy2 = bgr_32_to_yuy2_avx2;
+  tab->bgr_32_to_uyvy = bgr_32_to_uyvy_avx2;
+
+  tab->rgb_24_to_nv12 = rgb_24_to_nv12_avx2;
+  tab->rgb_24_to_nv21 = rgb_24_to_nv21_avx2;
+  tab->rgb_24_to_nv16 = rgb_24_to_nv16_avx2;
+
+  tab->bgr_24_to_nv12 = bgr_24_to_nv12_avx2;
+  tab->bgr_24_to_nv21 = bgr_24_to_nv21_avx2;
+  tab->bgr_24_to_nv16 = bgr_24_to_nv16_avx2;
+
+  tab->rgb_32_to_nv12 = rgb_32_to_nv12_avx2;
+  tab->rgb_32_to_nv21 = rgb_32_to_nv21_avx2;
+  tab->rgb_32_to_nv16 = rgb_32_to_nv16_avx2;
+
+  tab->bgr_32_to_nv12 = bgr_32_to_nv12_avx2;
+  tab->bgr_32_to_nv21 = bgr_32_to_nv21_avx2;
+  tab->bgr_32_to_nv16 = bgr_32_to_nv16_avx2;
+  }
@@ -0,0 +1,764 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* AVX2 Optimized scaling for any number of filter taps */
+
+#include <config.h>
+#include <attributes.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+#include "avx2.h"
+
+/*
+ *  y-Direction: The output pixel is a sum of complete source lines,
+ *  so we can process the line as one array of components.
+ *  8 bit values are multiplied with 14 bit integer factors (pmaddwd on pairs of lines),
+ *  16 bit and float values are accumulated in float with FMA.
+ *
+ *  x-Direction: All values are accumulated in float with the floating
+ *  point factors of the table. Packed pixels are processed 2 at once
+ *  (one per 128 bit lane), single components 8 at once.
+ */
+
+#define TYPE_UINT8  0
+#define TYPE_UINT16 1
+#define TYPE_FLOAT  2
+
+#define BITS_UINT8 14
+
+/*
+ *  Clipping limits for num consecutive components of a line with period
+ *  components per pixel. We always clip (like the generic C version),
+ *  for tables without overshoot this changes nothing.
+ */
+
+static void get_limits_i(const gavl_video_scale_context_t * ctx,
+                         const int * min_values, const int * max_values,
+                         int period, int32_t * min, int32_t * max, int num)
+  {
+  int i, idx;
+  for(i = 0; i < num; i++)
+    {
+    idx = (period == 1) ? ctx->plane : i % period;
+    min[i] = min_values[idx];
+    max[i] = max_values[idx];
+    }
+  }
+
+static void get_limits_f(const gavl_video_scale_context_t * ctx,
+                         int period, float * min, float * max, int num)
+  {
+  int i, idx;
+  for(i = 0; i < num; i++)
+    {
+    idx = (period == 1) ? ctx->plane : i % period;
+    min[i] = ctx->min_values_f[idx];
+    max[i] = ctx->max_values_f[idx];
+    }
+  }
+
+static inline int round_f(float f)
+  {
+  return _mm_cvtss_si32(_mm_set_ss(f));
+  }
+
+/* y-Direction, 8 bit */
+
+static void scale_uint8_y_avx2(gavl_video_scale_context_t * ctx, int scanline,
+                               uint8_t * dst)
+  {
+  int i, j, num, period, taps, tmp;
+  int32_t min_i[64], max_i[64];
+  int16_t min[64], max[64];
+  const uint8_t * src, * s;
+  const int32_t * fac;
+  __m256i acc_lo, acc_hi, f, a, b, x;
+  const __m256i round = _mm256_set1_epi32(1<<(BITS_UINT8-1));
+  const __m256i zero  = _mm256_setzero_si256();
+
+  period = ctx->offset->src_advance;
+  num    = ctx->dst_size * period;
+  taps   = ctx->table_v.factors_per_pixel;
+  fac    = ctx->table_v.pixels[scanline].factor_i;
+  src    = ctx->src + ctx->table_v.pixels[scanline].index * ctx->src_stride;
+
+  /* Limits for 16 consecutive components, which repeat after period vectors */
+  get_limits_i(ctx, ctx->min_values_v, ctx->max_values_v,
+               period, min_i, max_i, 16 * period);
+  for(i = 0; i < 16 * period; i++)
+    {
+    min[i] = min_i[i];
+    max[i] = max_i[i];
+    }
+
+  for(i = 0; i + 16 <= num; i += 16)
+    {
+    acc_lo = round;
+    acc_hi = round;
+    s = src + i;
+
+    for(j = 0; j + 1 < taps; j += 2)
+      {
+      f = _mm256_set1_epi32((fac[j] & 0xffff) | ((uint32_t)fac[j+1] << 16));
+      a = avx2_load_8_to_16(s);
+      b = avx2_load_8_to_16(s + ctx->src_stride);
+      acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), f));
+      acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), f));
+      s += 2 * ctx->src_stride;
+      }
+    if(j < taps)
+      {
+      f = _mm256_set1_epi32(fac[j] & 0xffff);
+      a = avx2_load_8_to_16(s);
+      acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, zero), f));
+      acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, zero), f));
+      }
+
+    /* The unpacking is undone by packs within the 128 bit lanes */
+    x = _mm256_packs_epi32(_mm256_srai_epi32(acc_lo, BITS_UINT8),
+                           _mm256_srai_epi32(acc_hi, BITS_UINT8));
+
+    j = i % (16 * period);
+    x = _mm256_max_epi16(x, _mm256_loadu_si256((const __m256i*)(min + j)));
+    x = _mm256_min_epi16(x, _mm256_loadu_si256((const __m256i*)(max + j)));
+    _mm_storeu_si128((__m128i*)(dst + i), avx2_pack_16_to_8(x));
+    }
+
+  /* Remaining components */
+  for(; i < num; i++)
+    {
+    tmp = 1<<(BITS_UINT8-1);
+    s = src + i;
+    for(j = 0; j < taps; j++)
+      {
+      tmp += fac[j] * *s;
+      s += ctx->src_stride;
+      }
+    tmp >>= BITS_UINT8;
+    j = i % (16 * period);
+    if(tmp < min[j])
+      tmp = min[j];
+    if(tmp > max[j])
+      tmp = max[j];
+    dst[i] = tmp;
+    }
+  }
+
+/* y-Direction, 16 bit and float */
+
+static inline __m256 load_8_float(const uint8_t * src, int type)
+  {
+  if(type == TYPE_UINT16)
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src)));
+  else
+    return _mm256_loadu_ps((const float*)src);
+  }
+
+static inline void
+scale_y_float_avx2(gavl_video_scale_context_t * ctx, int scanline,
+                   uint8_t * dst, int type)
+  {
+  int i, j, num, period, taps, bytes;
+  float min[32], max[32];
+  int32_t min_i[32], max_i[32];
+  float tmp;
+  const uint8_t * src, * s;
+  const float * fac;
+  __m256 acc;
+  __m256i x;
+
+  bytes  = (type == TYPE_UINT16) ? 2 : 4;
+  period = ctx->offset->src_advance / bytes;
+  num    = ctx->dst_size * period;
+  taps   = ctx->table_v.factors_per_pixel;
+  fac    = ctx->table_v.pixels[scanline].factor_f;
+  src    = ctx->src + ctx->table_v.pixels[scanline].index * ctx->src_stride;
+
+  if(type == TYPE_UINT16)
+    {
+    get_limits_i(ctx, ctx->min_values_v, ctx->max_values_v,
+                 period, min_i, max_i, 8 * period);
+    for(i = 0; i < 8 * period; i++)
+      {
+      min[i] = min_i[i];
+      max[i] = max_i[i];
+      }
+    }
+  else
+    get_limits_f(ctx, period, min, max, 8 * period);
+
+  for(i = 0; i + 8 <= num; i += 8)
+    {
+    s = src + i * bytes;
+    acc = _mm256_mul_ps(load_8_float(s, type), _mm256_set1_ps(fac[0]));
+    for(j = 1; j < taps; j++)
+      {
+      s += ctx->src_stride;
+      acc = _mm256_fmadd_ps(load_8_float(s, type), _mm256_set1_ps(fac[j]), acc);
+      }
+
+    j = i % (8 * period);
+    acc = _mm256_max_ps(acc, _mm256_loadu_ps(min + j));
+    acc = _mm256_min_ps(acc, _mm256_loadu_ps(max + j));
+
+    if(type == TYPE_UINT16)
+      {
+      x = _mm256_cvtps_epi32(acc);
+      _mm_storeu_si128((__m128i*)(dst + i * bytes),
+                       _mm_packus_epi32(_mm256_castsi256_si128(x),
+                                        _mm256_extracti128_si256(x, 1)));
+      }
+    else
+      _mm256_storeu_ps((float*)(dst + i * bytes), acc);
+    }
+
+  /* Remaining components */
+  for(; i < num; i++)
+    {
+    s = src + i * bytes;
+    tmp = 0.0;
+    for(j = 0; j < taps; j++)
+      {
+      if(type == TYPE_UINT16)
+        tmp += fac[j] * *((const uint16_t*)s);
+      else
+        tmp += fac[j] * *((const float*)s);
+      s += ctx->src_stride;
+      }
+    j = i % (8 * period);
+    if(tmp < min[j])
+      tmp = min[j];
+    if(tmp > max[j])
+      tmp = max[j];
+
+    if(type == TYPE_UINT16)
+      *((uint16_t*)(dst + i * bytes)) = round_f(tmp);
+    else
+      *((float*)(dst + i * bytes)) = tmp;
+    }
+  }
+
+static void scale_uint16_y_avx2(gavl_video_scale_context_t * ctx, int scanline,
+                                uint8_t * dst)
+  {
+  scale_y_float_avx2(ctx, scanline, dst, TYPE_UINT16);
+  }
+
+static void scale_float_y_avx2(gavl_video_scale_context_t * ctx, int scanline,
+                               uint8_t * dst)
+  {
+  scale_y_float_avx2(ctx, scanline, dst, TYPE_FLOAT);
+  }
+
+/* x-Direction */
+
+/* Remaining pixels in C */
+
+static inline void scale_x_c(gavl_video_scale_context_t * ctx,
+                             const uint8_t * src, uint8_t * dst,
+                             int start, int end, int type, int num_components,
+                             const float * min, const float * max)
+  {
+  int i, j, c, bytes, src_advance, dst_advance, taps;
+  float tmp;
+  const uint8_t * s;
+  const float * fac;
+
+  bytes       = (type == TYPE_UINT8) ? 1 : ((type == TYPE_UINT16) ? 2 : 4);
+  src_advance = ctx->offset->src_advance;
+  dst_advance = ctx->offset->dst_advance;
+  taps        = ctx->table_h.factors_per_pixel;
+
+  for(i = start; i < end; i++)
+    {
+    fac = ctx->table_h.pixels[i].factor_f;
+    for(c = 0; c < num_components; c++)
+      {
+      s = src + ctx->table_h.pixels[i].index * src_advance + c * bytes;
+      tmp = 0.0;
+      for(j = 0; j < taps; j++)
+        {
+        if(type == TYPE_UINT8)
+          tmp += fac[j] * *s;
+        else if(type == TYPE_UINT16)
+          tmp += fac[j] * *((const uint16_t*)s);
+        else
+          tmp += fac[j] * *((const float*)s);
+        s += src_advance;
+        }
+      if(tmp < min[c])
+        tmp = min[c];
+      if(tmp > max[c])
+        tmp = max[c];
+
+      if(type == TYPE_UINT8)
+        dst[c] = round_f(tmp);
+      else if(type == TYPE_UINT16)
+        *((uint16_t*)(dst + 2 * c)) = round_f(tmp);
+      else
+        *((float*)(dst + 4 * c)) = tmp;
+      }
+    dst += dst_advance;
+    }
+  }
+
+/*
+ *  Get the number of destination pixels, for which loading <load_bytes>
+ *  starting at the first filter tap stays inside the source line.
+ *  The source indices are ascending, so the remaining ones are at the end.
+ */
+
+static int get_safe_pixels(const gavl_video_scale_context_t * ctx,
+                           int pixel_bytes, int load_bytes)
+  {
+  int ret, end;
+  const gavl_video_scale_pixel_t * pixels = ctx->table_h.pixels;
+
+  ret = ctx->dst_size;
+  end = (pixels[ret-1].index + ctx->table_h.factors_per_pixel - 1) *
+    ctx->offset->src_advance + pixel_bytes;
+
+  while((ret > 0) &&
+        (pixels[ret-1].index * ctx->offset->src_advance + load_bytes > end))
+    ret--;
+  return ret;
+  }
+
+static void get_limits_x(const gavl_video_scale_context_t * ctx, int type,
+                         int num_components, float * min, float * max)
+  {
+  int i;
+  int32_t min_i[4], max_i[4];
+
+  if(type == TYPE_FLOAT)
+    get_limits_f(ctx, num_components, min, max, 4);
+  else
+    {
+    get_limits_i(ctx, ctx->min_values_h, ctx->max_values_h,
+                 num_components, min_i, max_i, 4);
+    for(i = 0; i < 4; i++)
+      {
+      min[i] = min_i[i];
+      max[i] = max_i[i];
+      }
+    }
+  }
+
+/*
+ *  One component per pixel: 8 output pixels are calculated at once,
+ *  the source values and factors are fetched with gather instructions.
+ */
+
+static inline __m256 gather_8_float(const uint8_t * src, __m256i idx, int type)
+  {
+  if(type == TYPE_UINT8)
+    return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_i32gather_epi32((const int*)src, idx, 1),
+                                               _mm256_set1_epi32(0xff)));
+  else if(type == TYPE_UINT16)
+    return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_i32gather_epi32((const int*)src, idx, 1),
+                                               _mm256_set1_epi32(0xffff)));
+  else
+    return _mm256_i32gather_ps((const float*)src, idx, 1);
+  }
+
+static inline void store_8_float(uint8_t * dst, __m256 v, int type, int dst_advance)
+  {
+  int i;
+  __m256i x;
+  int32_t tmp_i[8];
+  float tmp_f[8];
+
+  if(type == TYPE_FLOAT)
+    {
+    if(dst_advance == 4)
+      _mm256_storeu_ps((float*)dst, v);
+    else
+      {
+      _mm256_storeu_ps(tmp_f, v);
+      for(i = 0; i < 8; i++)
+        memcpy(dst + i * dst_advance, tmp_f + i, 4);
+      }
+    return;
+    }
+
+  x = _mm256_cvtps_epi32(v);
+
+  if((type == TYPE_UINT8) && (dst_advance == 1))
+    _mm_storel_epi64((__m128i*)dst, avx2_pack_32_to_8_half(x));
+  else if((type == TYPE_UINT16) && (dst_advance == 2))
+    _mm_storeu_si128((__m128i*)dst,
+                     _mm_packus_epi32(_mm256_castsi256_si128(x),
+                                      _mm256_extracti128_si256(x, 1)));
+  else
+    {
+    _mm256_storeu_si256((__m256i*)tmp_i, x);
+    for(i = 0; i < 8; i++)
+      {
+      if(type == TYPE_UINT8)
+        dst[i * dst_advance] = tmp_i[i];
+      else
+        *((uint16_t*)(dst + i * dst_advance)) = tmp_i[i];
+      }
+    }
+  }
+
+static inline void
+scale_x_1_avx2(gavl_video_scale_context_t * ctx, int scanline,
+               uint8_t * dst, int type)
+  {
+  int i, j, imax, taps, bytes, src_advance, dst_advance;
+  float min[4], max[4];
+  const uint8_t * src;
+  const gavl_video_scale_pixel_t * pixels;
+  __m256 acc, f;
+  __m256i idx, fac_idx, advance;
+
+  bytes       = (type == TYPE_UINT8) ? 1 : ((type == TYPE_UINT16) ? 2 : 4);
+  src_advance = ctx->offset->src_advance;
+  dst_advance = ctx->offset->dst_advance;
+  taps        = ctx->table_h.factors_per_pixel;
+  pixels      = ctx->table_h.pixels;
+  src         = ctx->src + scanline * ctx->src_stride;
+
+  get_limits_x(ctx, type, 1, min, max);
+
+  /* The integer gathers load 4 bytes */
+  imax = get_safe_pixels(ctx, bytes, (taps - 1) * src_advance + 4);
+
+  /* Factors of the 8 pixels are consecutive in the table */
+  fac_idx = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                               _mm256_set1_epi32(taps));
+  advance = _mm256_set1_epi32(src_advance);
+
+  for(i = 0; i + 8 <= imax; i += 8)
+    {
+    idx = _mm256_mullo_epi32(_mm256_setr_epi32(pixels[i].index,   pixels[i+1].index,
+                                               pixels[i+2].index, pixels[i+3].index,
+                                               pixels[i+4].index, pixels[i+5].index,
+                                               pixels[i+6].index, pixels[i+7].index),
+                             advance);
+    acc = _mm256_setzero_ps();
+
+    for(j = 0; j < taps; j++)
+      {
+      f = _mm256_i32gather_ps(pixels[i].factor_f + j, fac_idx, 4);
+      acc = _mm256_fmadd_ps(gather_8_float(src, idx, type), f, acc);
+      idx = _mm256_add_epi32(idx, advance);
+      }
+
+    acc = _mm256_max_ps(acc, _mm256_set1_ps(min[0]));
+    acc = _mm256_min_ps(acc, _mm256_set1_ps(max[0]));
+    store_8_float(dst, acc, type, dst_advance);
+    dst += 8 * dst_advance;
+    }
+
+  scale_x_c(ctx, src, dst, i, ctx->dst_size, type, 1, min, max);
+  }
+
+/*
+ *  One component per pixel with contiguous source values: The taps of one
+ *  output pixel are loaded 8 at once and multiplied with the factors.
+ *  The horizontal sums of 8 pixels are then calculated together.
+ */
+
+static inline __m256 load_8_components(const uint8_t * src, int type)
+  {
+  if(type == TYPE_UINT8)
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src)));
+  else
+    return load_8_float(src, type);
+  }
+
+static inline void
+scale_x_1_dot_avx2(gavl_video_scale_context_t * ctx, int scanline,
+                   uint8_t * dst, int type)
+  {
+  int i, j, k, imax, taps, bytes, dst_advance;
+  float min[4], max[4];
+  const uint8_t * src, * s;
+  const float * fac;
+  const gavl_video_scale_pixel_t * pixels;
+  __m256 p[8], t[4], acc;
+  __m256i mask, lanes;
+
+  bytes       = (type == TYPE_UINT8) ? 1 : ((type == TYPE_UINT16) ? 2 : 4);
+  dst_advance = ctx->offset->dst_advance;
+  taps        = ctx->table_h.factors_per_pixel;
+  pixels      = ctx->table_h.pixels;
+  src         = ctx->src + scanline * ctx->src_stride;
+
+  get_limits_x(ctx, type, 1, min, max);
+
+  lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  /* The taps are loaded in multiples of 8 */
+  imax = get_safe_pixels(ctx, bytes, ((taps + 7) / 8) * 8 * bytes);
+
+  for(i = 0; i + 8 <= imax; i += 8)
+    {
+    for(k = 0; k < 8; k++)
+      {
+      s   = src + pixels[i+k].index * bytes;
+      fac = pixels[i+k].factor_f;
+      p[k] = _mm256_setzero_ps();
+
+      for(j = 0; j < taps; j += 8)
+        {
+        /* The masked load doesn't touch the factors of the next pixel */
+        mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(taps - j), lanes);
+        p[k] = _mm256_fmadd_ps(load_8_components(s + j * bytes, type),
+                               _mm256_maskload_ps(fac + j, mask), p[k]);
+        }
+      }
+
+    t[0] = _mm256_hadd_ps(p[0], p[1]);
+    t[1] = _mm256_hadd_ps(p[2], p[3]);
+    t[2] = _mm256_hadd_ps(p[4], p[5]);
+    t[3] = _mm256_hadd_ps(p[6], p[7]);
+    t[0] = _mm256_hadd_ps(t[0], t[1]);
+    t[1] = _mm256_hadd_ps(t[2], t[3]);
+
+    /* Add the 128 bit lanes */
+    acc = _mm256_add_ps(_mm256_permute2f128_ps(t[0], t[1], 0x20),
+                        _mm256_permute2f128_ps(t[0], t[1], 0x31));
+
+    acc = _mm256_max_ps(acc, _mm256_set1_ps(min[0]));
+    acc = _mm256_min_ps(acc, _mm256_set1_ps(max[0]));
+    store_8_float(dst, acc, type, dst_advance);
+    dst += 8 * dst_advance;
+    }
+
+  scale_x_c(ctx, src, dst, i, ctx->dst_size, type, 1, min, max);
+  }
+
+/*
+ *  Packed pixels: The components of one source pixel are loaded into one
+ *  128 bit lane, so 2 output pixels are calculated at once.
+ */
+
+static inline __m256 load_2_pixels(const uint8_t * s0, const uint8_t * s1, int type)
+  {
+  int32_t i0, i1;
+  int64_t l0, l1;
+
+  if(type == TYPE_UINT8)
+    {
+    memcpy(&i0, s0, 4);
+    memcpy(&i1, s1, 4);
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_setr_epi32(i0, i1, 0, 0)));
+    }
+  else if(type == TYPE_UINT16)
+    {
+    memcpy(&l0, s0, 8);
+    memcpy(&l1, s1, 8);
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_set_epi64x(l1, l0)));
+    }
+  else
+    return _mm256_set_m128(_mm_loadu_ps((const float*)s1),
+                           _mm_loadu_ps((const float*)s0));
+  }
+
+static inline void store_2_pixels(uint8_t * d0, uint8_t * d1, __m256 v,
+                                  int type, int num_components)
+  {
+  __m256i x;
+  __m128i lo, hi;
+  int32_t i0, i1;
+  int64_t l0, l1;
+  float f[8];
+
+  if(type == TYPE_FLOAT)
+    {
+    _mm256_storeu_ps(f, v);
+    memcpy(d0, f,     4 * num_components);
+    memcpy(d1, f + 4, 4 * num_components);
+    return;
+    }
+
+  x  = _mm256_cvtps_epi32(v);
+  lo = _mm256_castsi256_si128(x);
+  hi = _mm256_extracti128_si256(x, 1);
+
+  if(type == TYPE_UINT8)
+    {
+    lo = _mm_packus_epi16(_mm_packs_epi32(lo, hi), lo);
+    i0 = _mm_cvtsi128_si32(lo);
+    i1 = _mm_extract_epi32(lo, 1);
+    memcpy(d0, &i0, num_components);
+    memcpy(d1, &i1, num_components);
+    }
+  else
+    {
+    lo = _mm_packus_epi32(lo, hi);
+    l0 = _mm_cvtsi128_si64(lo);
+    l1 = _mm_extract_epi64(lo, 1);
+    memcpy(d0, &l0, 2 * num_components);
+    memcpy(d1, &l1, 2 * num_components);
+    }
+  }
+
+static inline void
+scale_x_n_avx2(gavl_video_scale_context_t * ctx, int scanline,
+               uint8_t * dst, int type, int num_components)
+  {
+  int i, j, imax, taps, bytes, src_advance, dst_advance;
+  float min[4], max[4];
+  const uint8_t * src, * s0, * s1;
+  const float * f0, * f1;
+  const gavl_video_scale_pixel_t * pixels;
+  __m256 acc, f, vmin, vmax;
+
+  bytes       = (type == TYPE_UINT8) ? 1 : ((type == TYPE_UINT16) ? 2 : 4);
+  src_advance = ctx->offset->src_advance;
+  dst_advance = ctx->offset->dst_advance;
+  taps        = ctx->table_h.factors_per_pixel;
+  pixels      = ctx->table_h.pixels;
+  src         = ctx->src + scanline * ctx->src_stride;
+
+  get_limits_x(ctx, type, num_components, min, max);
+  vmin = _mm256_set_m128(_mm_loadu_ps(min), _mm_loadu_ps(min));
+  vmax = _mm256_set_m128(_mm_loadu_ps(max), _mm_loadu_ps(max));
+
+  /* We always load 4 components */
+  imax = get_safe_pixels(ctx, num_components * bytes,
+                         (taps - 1) * src_advance + 4 * bytes);
+
+  for(i = 0; i + 2 <= imax; i += 2)
+    {
+    s0 = src + pixels[i].index   * src_advance;
+    s1 = src + pixels[i+1].index * src_advance;
+    f0 = pixels[i].factor_f;
+    f1 = pixels[i+1].factor_f;
+
+    acc = _mm256_setzero_ps();
+    for(j = 0; j < taps; j++)
+      {
+      f = _mm256_set_m128(_mm_set1_ps(f1[j]), _mm_set1_ps(f0[j]));
+      acc = _mm256_fmadd_ps(load_2_pixels(s0, s1, type), f, acc);
+      s0 += src_advance;
+      s1 += src_advance;
+      }
+
+    acc = _mm256_max_ps(acc, vmin);
+    acc = _mm256_min_ps(acc, vmax);
+    store_2_pixels(dst, dst + dst_advance, acc, type, num_components);
+    dst += 2 * dst_advance;
+    }
+
+  scale_x_c(ctx, src, dst, i, ctx->dst_size, type, num_components, min, max);
+  }
+
+#define SCALE_X_FUNC(name, type, bytes, num_components)                  \
+static void name(gavl_video_scale_context_t * ctx, int scanline, uint8_t * dst) \
+  {                                                                     \
+  if((num_components == 1) && (ctx->offset->src_advance == bytes))      \
+    scale_x_1_dot_avx2(ctx, scanline, dst, type);                       \
+  else if(num_components == 1)                                          \
+    scale_x_1_avx2(ctx, scanline, dst, type);                           \
+  else                                                                  \
+    scale_x_n_avx2(ctx, scanline, dst, type, num_components);           \
+  }
+
+SCALE_X_FUNC(scale_uint8_x_1_x_avx2,   TYPE_UINT8,  1, 1)
+SCALE_X_FUNC(scale_uint8_x_2_x_avx2,   TYPE_UINT8,  1, 2)
+SCALE_X_FUNC(scale_uint8_x_3_x_avx2,   TYPE_UINT8,  1, 3)
+SCALE_X_FUNC(scale_uint8_x_4_x_avx2,   TYPE_UINT8,  1, 4)
+SCALE_X_FUNC(scale_uint16_x_1_x_avx2,  TYPE_UINT16, 2, 1)
+SCALE_X_FUNC(scale_uint16_x_2_x_avx2,  TYPE_UINT16, 2, 2)
+SCALE_X_FUNC(scale_uint16_x_3_x_avx2,  TYPE_UINT16, 2, 3)
+SCALE_X_FUNC(scale_uint16_x_4_x_avx2,  TYPE_UINT16, 2, 4)
+SCALE_X_FUNC(scale_float_x_1_x_avx2,   TYPE_FLOAT,  4, 1)
+SCALE_X_FUNC(scale_float_x_2_x_avx2,   TYPE_FLOAT,  4, 2)
+SCALE_X_FUNC(scale_float_x_3_x_avx2,   TYPE_FLOAT,  4, 3)
+SCALE_X_FUNC(scale_float_x_4_x_avx2,   TYPE_FLOAT,  4, 4)
+
+/*
+ *  The x-functions use the floating point factors, so the integer
+ *  accuracy doesn't matter for them. The y-functions process
+ *  whole lines, so they need the same advance for source and destination.
+ */
+
+void gavl_init_scale_funcs_x_avx2(gavl_scale_funcs_t * tab)
+  {
+  tab->funcs_x.scale_uint8_x_1_advance   = scale_uint8_x_1_x_avx2;
+  tab->funcs_x.scale_uint8_x_1_noadvance = scale_uint8_x_1_x_avx2;
+  tab->funcs_x.scale_uint8_x_2  = scale_uint8_x_2_x_avx2;
+  tab->funcs_x.scale_uint8_x_3  = scale_uint8_x_3_x_avx2;
+  tab->funcs_x.scale_uint8_x_4  = scale_uint8_x_4_x_avx2;
+  tab->funcs_x.scale_uint16_x_1 = scale_uint16_x_1_x_avx2;
+  tab->funcs_x.scale_uint16_x_2 = scale_uint16_x_2_x_avx2;
+  tab->funcs_x.scale_uint16_x_3 = scale_uint16_x_3_x_avx2;
+  tab->funcs_x.scale_uint16_x_4 = scale_uint16_x_4_x_avx2;
+  tab->funcs_x.scale_float_x_1  = scale_float_x_1_x_avx2;
+  tab->funcs_x.scale_float_x_2  = scale_float_x_2_x_avx2;
+  tab->funcs_x.scale_float_x_3  = scale_float_x_3_x_avx2;
+  tab->funcs_x.scale_float_x_4  = scale_float_x_4_x_avx2;
+  }
+
+void gavl_init_scale_funcs_y_avx2(gavl_scale_funcs_t * tab,
+                                  int src_advance, int dst_advance)
+  {
+  if(src_advance != dst_advance)
+    return;
+
+  if(src_advance == 1)
+    {
+    tab->funcs_y.scale_uint8_x_1_noadvance = scale_uint8_y_avx2;
+    tab->funcs_y.bits_uint8_noadvance = BITS_UINT8;
+    }
+  else if(src_advance == 2)
+    {
+    tab->funcs_y.scale_uint8_x_2 = scale_uint8_y_avx2;
+    tab->funcs_y.bits_uint8_noadvance = BITS_UINT8;
+    }
+  else if(src_advance == 3)
+    {
+    tab->funcs_y.scale_uint8_x_3 = scale_uint8_y_avx2;
+    tab->funcs_y.bits_uint8_noadvance = BITS_UINT8;
+    }
+  else if(src_advance == 4)
+    {
+    /* 32 bit RGB is scaled including the padding byte */
+    tab->funcs_y.scale_uint8_x_3 = scale_uint8_y_avx2;
+    tab->funcs_y.scale_uint8_x_4 = scale_uint8_y_avx2;
+    tab->funcs_y.bits_uint8_noadvance = BITS_UINT8;
+    }
+
+  if(!(src_advance % 2) && (src_advance <= 8))
+    {
+    tab->funcs_y.scale_uint16_x_1 = scale_uint16_y_avx2;
+    tab->funcs_y.scale_uint16_x_2 = scale_uint16_y_avx2;
+    tab->funcs_y.scale_uint16_x_3 = scale_uint16_y_avx2;
+    tab->funcs_y.scale_uint16_x_4 = scale_uint16_y_avx2;
+    }
+  if(!(src_advance % 4) && (src_advance <= 16))
+    {
+    tab->funcs_y.scale_float_x_1 = scale_float_y_avx2;
+    tab->funcs_y.scale_float_x_2 = scale_float_y_avx2;
+    tab->funcs_y.scale_float_x_3 = scale_float_y_avx2;
+    tab->funcs_y.scale_float_x_4 = scale_float_y_avx2;
+    }
+  }
@@ -0,0 +1,332 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <transform.h>
+
+#include "avx2.h"
+
+/*
+ *  Affine bilinear transform. Like the SSE2 version, but the source
+ *  positions of 8 pixels are stepped in parallel and the source pixels
+ *  are loaded with gather instructions.
+ */
+
+#define FRAC_MASK ((1 << TRANSFORM_FIXED_BITS) - 1)
+
+typedef struct
+  {
+  __m256i hi_x, lo_x;
+  __m256i hi_y, lo_y;
+  __m256i step_hi_x, step_lo_x;
+  __m256i step_hi_y, step_lo_y;
+  } pos_avx2_t;
+
+static void pos_init(pos_avx2_t * p, const gavl_transform_affine_t * pos)
+  {
+  int i;
+  int64_t x, y;
+  int32_t hi_x[8], lo_x[8], hi_y[8], lo_y[8];
+
+  for(i = 0; i < 8; i++)
+    {
+    x = pos->x + i * pos->step_x;
+    y = pos->y + i * pos->step_y;
+    hi_x[i] = x >> TRANSFORM_FIXED_BITS;
+    lo_x[i] = x & FRAC_MASK;
+    hi_y[i] = y >> TRANSFORM_FIXED_BITS;
+    lo_y[i] = y & FRAC_MASK;
+    }
+  p->hi_x = _mm256_loadu_si256((const __m256i*)hi_x);
+  p->lo_x = _mm256_loadu_si256((const __m256i*)lo_x);
+  p->hi_y = _mm256_loadu_si256((const __m256i*)hi_y);
+  p->lo_y = _mm256_loadu_si256((const __m256i*)lo_y);
+
+  x = 8 * pos->step_x;
+  y = 8 * pos->step_y;
+  p->step_hi_x = _mm256_set1_epi32(x >> TRANSFORM_FIXED_BITS);
+  p->step_lo_x = _mm256_set1_epi32(x & FRAC_MASK);
+  p->step_hi_y = _mm256_set1_epi32(y >> TRANSFORM_FIXED_BITS);
+  p->step_lo_y = _mm256_set1_epi32(y & FRAC_MASK);
+  }
+
+static inline void pos_step(pos_avx2_t * p)
+  {
+  const __m256i mask = _mm256_set1_epi32(FRAC_MASK);
+
+  p->lo_x = _mm256_add_epi32(p->lo_x, p->step_lo_x);
+  p->hi_x = _mm256_add_epi32(p->hi_x, p->step_hi_x);
+  p->hi_x = _mm256_add_epi32(p->hi_x,
+                             _mm256_srli_epi32(p->lo_x, TRANSFORM_FIXED_BITS));
+  p->lo_x = _mm256_and_si256(p->lo_x, mask);
+
+  p->lo_y = _mm256_add_epi32(p->lo_y, p->step_lo_y);
+  p->hi_y = _mm256_add_epi32(p->hi_y, p->step_hi_y);
+  p->hi_y = _mm256_add_epi32(p->hi_y,
+                             _mm256_srli_epi32(p->lo_y, TRANSFORM_FIXED_BITS));
+  p->lo_y = _mm256_and_si256(p->lo_y, mask);
+  }
+
+/* Rounded position on the phase grid, shifted by half a pixel */
+
+static inline __m256i pos_get(__m256i hi, __m256i lo)
+  {
+  lo = _mm256_add_epi32(lo,
+                        _mm256_set1_epi32(1 << (TRANSFORM_FIXED_BITS - 1)));
+  hi = _mm256_add_epi32(hi, _mm256_set1_epi32(TRANSFORM_PHASES / 2));
+  return _mm256_add_epi32(hi, _mm256_srli_epi32(lo, TRANSFORM_FIXED_BITS));
+  }
+
+/* Pairs of 16 bit weights (1 - frac, frac) in 1/TRANSFORM_PHASES */
+
+static inline __m256i get_weights(__m256i pos)
+  {
+  __m256i frac =
+    _mm256_and_si256(pos, _mm256_set1_epi32(TRANSFORM_PHASES - 1));
+  return _mm256_or_si256(_mm256_sub_epi32(_mm256_set1_epi32(TRANSFORM_PHASES),
+                                          frac),
+                         _mm256_slli_epi32(frac, 16));
+  }
+
+/* Check if the first taps of 8 pixels are in [1 .. max - 1] */
+
+static inline int is_inside(__m256i idx_x, __m256i idx_y,
+                            __m256i max_x, __m256i max_y)
+  {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i m;
+
+  m = _mm256_and_si256(_mm256_cmpgt_epi32(idx_x, zero),
+                       _mm256_cmpgt_epi32(max_x, idx_x));
+  m = _mm256_and_si256(m, _mm256_cmpgt_epi32(idx_y, zero));
+  m = _mm256_and_si256(m, _mm256_cmpgt_epi32(max_y, idx_y));
+  return _mm256_movemask_epi8(m) == -1;
+  }
+
+/*
+ *  Interpolate 2 rows with 10 bit weights, the result is
+ *  scaled down to 15 bits for the vertical pass
+ */
+
+static inline __m256i interpolate_x(__m256i src, __m256i w)
+  {
+  src = _mm256_madd_epi16(src, w);
+  return _mm256_srai_epi32(_mm256_add_epi32(src, _mm256_set1_epi32(4)), 3);
+  }
+
+static inline __m256i interpolate_y(__m256i src, __m256i w)
+  {
+  src = _mm256_madd_epi16(src, w);
+  return _mm256_srai_epi32(_mm256_add_epi32(src,
+                                            _mm256_set1_epi32(1 << 16)), 17);
+  }
+
+/* Offset of the upper left tap */
+
+static inline __m256i get_offset(__m256i idx_x, __m256i idx_y,
+                                 int advance, int stride)
+  {
+  const __m256i one = _mm256_set1_epi32(1);
+  
+  idx_x = _mm256_sub_epi32(idx_x, one);
+  idx_y = _mm256_sub_epi32(idx_y, one);
+
+  if(advance > 1)
+    idx_x = _mm256_mullo_epi32(idx_x, _mm256_set1_epi32(advance));
+  
+  return _mm256_add_epi32(idx_x,
+                          _mm256_mullo_epi32(idx_y,
+                                             _mm256_set1_epi32(stride)));
+  }
+
+static void affine_uint8_x_1_avx2(gavl_transform_context_t * ctx,
+                                  const gavl_transform_affine_t * pos,
+                                  int y, uint8_t * dest_start)
+  {
+  int i, start = 0;
+  pos_avx2_t p;
+  __m256i px, py, ix, iy, wx, wy, s, t, h_lo, h_hi;
+  
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i mask = _mm256_set1_epi32(0xffff);
+
+  /* The gather loads 4 bytes, so the last 2 pixels are left out */
+  const __m256i max_x = _mm256_set1_epi32(ctx->tab.width - 2);
+  const __m256i max_y = _mm256_set1_epi32(ctx->tab.height);
+  
+  pos_init(&p, pos);
+
+  for(i = 0; i <= ctx->dst_width - 8; i += 8)
+    {
+    px = pos_get(p.hi_x, p.lo_x);
+    py = pos_get(p.hi_y, p.lo_y);
+    pos_step(&p);
+    
+    ix = _mm256_srai_epi32(px, TRANSFORM_PHASE_BITS);
+    iy = _mm256_srai_epi32(py, TRANSFORM_PHASE_BITS);
+
+    if(!is_inside(ix, iy, max_x, max_y))
+      continue;
+
+    if(start < i)
+      gavl_transform_context_scanline(ctx, y, start, i - start,
+                                      dest_start + start);
+    start = i + 8;
+
+    /* 2x2 source pixels per destination pixel */
+    ix = get_offset(ix, iy, 1, ctx->src_stride);
+    
+    s = _mm256_i32gather_epi32((const int*)ctx->src, ix, 1);
+    t = _mm256_i32gather_epi32((const int*)(ctx->src + ctx->src_stride),
+                               ix, 1);
+    s = _mm256_or_si256(_mm256_and_si256(s, mask),
+                        _mm256_slli_epi32(t, 16));
+    
+    wx = get_weights(px);
+    wy = get_weights(py);
+    
+    h_lo = interpolate_x(_mm256_unpacklo_epi8(s, zero),
+                         _mm256_unpacklo_epi32(wx, wx));
+    h_hi = interpolate_x(_mm256_unpackhi_epi8(s, zero),
+                         _mm256_unpackhi_epi32(wx, wx));
+    
+    s = interpolate_y(_mm256_packs_epi32(h_lo, h_hi), wy);
+    _mm_storel_epi64((__m128i*)(dest_start + i), avx2_pack_32_to_8_half(s));
+    }
+  
+  if(start < ctx->dst_width)
+    gavl_transform_context_scanline(ctx, y, start, ctx->dst_width - start,
+                                    dest_start + start);
+  }
+
+/*
+ *  Interpolate 4 pixels with 4 channels. Each 128 bit lane holds one
+ *  pixel, lo has the pixels 0 and 2, hi the pixels 1 and 3
+ */
+
+static inline __m128i interpolate_x_4(const uint8_t * src, int stride,
+                                      __m128i offset, __m256i wx, __m256i wy)
+  {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i idx_lo = _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2);
+  const __m256i idx_hi = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+  __m256i a, b, a_lo, a_hi, b_lo, b_hi, w_lo, w_hi;
+  
+  a = _mm256_i32gather_epi64((const long long*)src, offset, 1);
+  b = _mm256_i32gather_epi64((const long long*)(src + stride), offset, 1);
+
+  a_lo = _mm256_unpacklo_epi8(a, zero);
+  a_hi = _mm256_unpackhi_epi8(a, zero);
+  b_lo = _mm256_unpacklo_epi8(b, zero);
+  b_hi = _mm256_unpackhi_epi8(b, zero);
+
+  /* Interleave the channels of the left and right pixel */
+  a_lo = _mm256_unpacklo_epi16(a_lo, _mm256_srli_si256(a_lo, 8));
+  a_hi = _mm256_unpacklo_epi16(a_hi, _mm256_srli_si256(a_hi, 8));
+  b_lo = _mm256_unpacklo_epi16(b_lo, _mm256_srli_si256(b_lo, 8));
+  b_hi = _mm256_unpacklo_epi16(b_hi, _mm256_srli_si256(b_hi, 8));
+
+  w_lo = _mm256_permutevar8x32_epi32(wx, idx_lo);
+  w_hi = _mm256_permutevar8x32_epi32(wx, idx_hi);
+  
+  a_lo = interpolate_x(a_lo, w_lo);
+  a_hi = interpolate_x(a_hi, w_hi);
+  b_lo = interpolate_x(b_lo, w_lo);
+  b_hi = interpolate_x(b_hi, w_hi);
+
+  a_lo = _mm256_packs_epi32(a_lo, b_lo);
+  a_hi = _mm256_packs_epi32(a_hi, b_hi);
+  a_lo = _mm256_unpacklo_epi16(a_lo, _mm256_srli_si256(a_lo, 8));
+  a_hi = _mm256_unpacklo_epi16(a_hi, _mm256_srli_si256(a_hi, 8));
+  
+  a_lo = interpolate_y(a_lo, _mm256_permutevar8x32_epi32(wy, idx_lo));
+  a_hi = interpolate_y(a_hi, _mm256_permutevar8x32_epi32(wy, idx_hi));
+
+  /* Pixels 0, 1 in the lower, 2, 3 in the upper lane */
+  a = _mm256_packs_epi32(a_lo, a_hi);
+  a = _mm256_packus_epi16(a, a);
+  return _mm_unpacklo_epi64(_mm256_castsi256_si128(a),
+                            _mm256_extracti128_si256(a, 1));
+  }
+
+static void affine_uint8_x_4_avx2(gavl_transform_context_t * ctx,
+                                  const gavl_transform_affine_t * pos,
+                                  int y, uint8_t * dest_start)
+  {
+  int i, start = 0;
+  pos_avx2_t p;
+  __m256i px, py, ix, iy, wx, wy;
+  
+  const __m256i max_x = _mm256_set1_epi32(ctx->tab.width);
+  const __m256i max_y = _mm256_set1_epi32(ctx->tab.height);
+  
+  pos_init(&p, pos);
+
+  for(i = 0; i <= ctx->dst_width - 8; i += 8)
+    {
+    px = pos_get(p.hi_x, p.lo_x);
+    py = pos_get(p.hi_y, p.lo_y);
+    pos_step(&p);
+    
+    ix = _mm256_srai_epi32(px, TRANSFORM_PHASE_BITS);
+    iy = _mm256_srai_epi32(py, TRANSFORM_PHASE_BITS);
+
+    if(!is_inside(ix, iy, max_x, max_y))
+      continue;
+
+    if(start < i)
+      gavl_transform_context_scanline(ctx, y, start, i - start,
+                                      dest_start + start * 4);
+    start = i + 8;
+    
+    ix = get_offset(ix, iy, 4, ctx->src_stride);
+    wx = get_weights(px);
+    wy = get_weights(py);
+
+    _mm_storeu_si128((__m128i*)(dest_start + i * 4),
+                     interpolate_x_4(ctx->src, ctx->src_stride,
+                                     _mm256_castsi256_si128(ix), wx, wy));
+
+    wx = _mm256_permute2x128_si256(wx, wx, 0x01);
+    wy = _mm256_permute2x128_si256(wy, wy, 0x01);
+    
+    _mm_storeu_si128((__m128i*)(dest_start + i * 4 + 16),
+                     interpolate_x_4(ctx->src, ctx->src_stride,
+                                     _mm256_extracti128_si256(ix, 1),
+                                     wx, wy));
+    }
+  
+  if(start < ctx->dst_width)
+    gavl_transform_context_scanline(ctx, y, start, ctx->dst_width - start,
+                                    dest_start + start * 4);
+  }
+
+void gavl_init_transform_funcs_bilinear_avx2(gavl_transform_funcs_t * tab,
+                                             int advance)
+  {
+  if(advance == 1)
+    tab->affine_uint8_x_1 = affine_uint8_x_1_avx2;
+  else if(advance == 4)
+    tab->affine_uint8_x_4 = affine_uint8_x_4_avx2;
+  }
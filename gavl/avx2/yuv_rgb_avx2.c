@@ -0,0 +1,1741 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include <attributes.h>
+
+#include "avx2.h"
+
+/*
+ *  AVX2 YUV -> RGB conversions. 16 pixels are processed at once.
+ *  For 8 bit output, the calculation is done in 16 bit fixed point
+ *  with 3 fractional bits. Float output is calculated in single precision.
+ */
+
+typedef struct
+  {
+  __m256i y_off;
+  __m256i uv_off;
+  __m256i y;
+  __m256i v_r;
+  __m256i u_g;
+  __m256i v_g;
+  __m256i u_b;
+  __m256i round;
+
+  __m256 y_f;
+  __m256 v_r_f;
+  __m256 u_g_f;
+  __m256 v_g_f;
+  __m256 u_b_f;
+  __m256 min_f;
+  __m256 max_f;
+  } yuv_rgb_avx2_t;
+
+/*
+ *  The inputs are shifted left by 7 bits and _mm256_mulhrs_epi16 shifts the
+ *  product right by 15 bits. Scaling the coefficients by 2048 therefore
+ *  gives results with 3 fractional bits.
+ */
+
+#define Y_COEFF   (255.0/219.0)
+#define V_R_COEFF ( 1.40200*255.0/224.0)
+#define U_G_COEFF (-0.34414*255.0/224.0)
+#define V_G_COEFF (-0.71414*255.0/224.0)
+#define U_B_COEFF ( 1.77200*255.0/224.0)
+
+#define YJ_COEFF   1.0
+#define VJ_R_COEFF ( 1.40200)
+#define UJ_G_COEFF (-0.34414)
+#define VJ_G_COEFF (-0.71414)
+#define UJ_B_COEFF ( 1.77200)
+
+static inline void yuv_rgb_avx2_init(yuv_rgb_avx2_t * c, int jpeg)
+  {
+  c->uv_off = _mm256_set1_epi16(0x80);
+  c->round  = _mm256_set1_epi16(4);
+  c->min_f  = _mm256_setzero_ps();
+  c->max_f  = _mm256_set1_ps(1.0);
+  
+  if(jpeg)
+    {
+    c->y_off = _mm256_setzero_si256();
+    c->y     = _mm256_set1_epi16(AVX2_FIX(YJ_COEFF,   11));
+    c->v_r   = _mm256_set1_epi16(AVX2_FIX(VJ_R_COEFF, 11));
+    c->u_g   = _mm256_set1_epi16(AVX2_FIX(UJ_G_COEFF, 11));
+    c->v_g   = _mm256_set1_epi16(AVX2_FIX(VJ_G_COEFF, 11));
+    c->u_b   = _mm256_set1_epi16(AVX2_FIX(UJ_B_COEFF, 11));
+
+    c->y_f   = _mm256_set1_ps(1.0/255.0);
+    c->v_r_f = _mm256_set1_ps(VJ_R_COEFF/255.0);
+    c->u_g_f = _mm256_set1_ps(UJ_G_COEFF/255.0);
+    c->v_g_f = _mm256_set1_ps(VJ_G_COEFF/255.0);
+    c->u_b_f = _mm256_set1_ps(UJ_B_COEFF/255.0);
+    }
+  else
+    {
+    c->y_off = _mm256_set1_epi16(0x10);
+    c->y     = _mm256_set1_epi16(AVX2_FIX(Y_COEFF,   11));
+    c->v_r   = _mm256_set1_epi16(AVX2_FIX(V_R_COEFF, 11));
+    c->u_g   = _mm256_set1_epi16(AVX2_FIX(U_G_COEFF, 11));
+    c->v_g   = _mm256_set1_epi16(AVX2_FIX(V_G_COEFF, 11));
+    c->u_b   = _mm256_set1_epi16(AVX2_FIX(U_B_COEFF, 11));
+
+    c->y_f   = _mm256_set1_ps(1.0/219.0);
+    c->v_r_f = _mm256_set1_ps(V_R_COEFF/255.0);
+    c->u_g_f = _mm256_set1_ps(U_G_COEFF/255.0);
+    c->v_g_f = _mm256_set1_ps(V_G_COEFF/255.0);
+    c->u_b_f = _mm256_set1_ps(U_B_COEFF/255.0);
+    }
+  }
+
+/* 16 YUV values (16 bit) -> 16 RGB values (16 bit, 0..255 range) */
+
+static inline void yuv_to_rgb_avx2(const yuv_rgb_avx2_t * c,
+                                   __m256i y, __m256i u, __m256i v,
+                                   __m256i * r, __m256i * g, __m256i * b)
+  {
+  y = _mm256_slli_epi16(_mm256_sub_epi16(y, c->y_off), 7);
+  u = _mm256_slli_epi16(_mm256_sub_epi16(u, c->uv_off), 7);
+  v = _mm256_slli_epi16(_mm256_sub_epi16(v, c->uv_off), 7);
+
+  y = _mm256_add_epi16(_mm256_mulhrs_epi16(y, c->y), c->round);
+  
+  *r = _mm256_add_epi16(y, _mm256_mulhrs_epi16(v, c->v_r));
+  *g = _mm256_add_epi16(y, _mm256_add_epi16(_mm256_mulhrs_epi16(u, c->u_g),
+                                            _mm256_mulhrs_epi16(v, c->v_g)));
+  *b = _mm256_add_epi16(y, _mm256_mulhrs_epi16(u, c->u_b));
+
+  *r = _mm256_srai_epi16(*r, 3);
+  *g = _mm256_srai_epi16(*g, 3);
+  *b = _mm256_srai_epi16(*b, 3);
+  }
+
+/* 16 YUV values (16 bit) -> 2x8 RGB values (float, 0..1 range) */
+
+static inline void yuv_to_rgb_float_avx2(const yuv_rgb_avx2_t * c,
+                                         __m256i y, __m256i u, __m256i v,
+                                         __m256 * r, __m256 * g, __m256 * b)
+  {
+  int i;
+  __m256 y_f[2], u_f[2], v_f[2];
+  
+  avx2_16_to_float(_mm256_sub_epi16(y, c->y_off),  &y_f[0], &y_f[1]);
+  avx2_16_to_float(_mm256_sub_epi16(u, c->uv_off), &u_f[0], &u_f[1]);
+  avx2_16_to_float(_mm256_sub_epi16(v, c->uv_off), &v_f[0], &v_f[1]);
+
+  for(i = 0; i < 2; i++)
+    {
+    y_f[i] = _mm256_mul_ps(y_f[i], c->y_f);
+    r[i] = _mm256_fmadd_ps(v_f[i], c->v_r_f, y_f[i]);
+    g[i] = _mm256_fmadd_ps(u_f[i], c->u_g_f,
+                           _mm256_fmadd_ps(v_f[i], c->v_g_f, y_f[i]));
+    b[i] = _mm256_fmadd_ps(u_f[i], c->u_b_f, y_f[i]);
+    r[i] = avx2_clip_float(r[i], c->min_f, c->max_f);
+    g[i] = avx2_clip_float(g[i], c->min_f, c->max_f);
+    b[i] = avx2_clip_float(b[i], c->min_f, c->max_f);
+    }
+  }
+
+/* Loading */
+
+#define INIT_LOAD_PLANAR \
+  __m256i y, u, v;
+
+#define INIT_LOAD_PACKED \
+  __m256i y, u, v, p; \
+  const __m256i mask_00ff = _mm256_set1_epi16(0x00ff); \
+  const __m256i mask_0000ffff = _mm256_set1_epi32(0x0000ffff);
+
+/* 4:2:x: 16 luma and 8 chroma samples */
+
+#define LOAD_YUV_PLANAR_2 \
+  y = avx2_load_8_to_16(src_y); \
+  u = avx2_load_8_to_16_dup(src_u); \
+  v = avx2_load_8_to_16_dup(src_v);
+
+/* 4:4:4: 16 luma and 16 chroma samples */
+
+#define LOAD_YUV_PLANAR_1 \
+  y = avx2_load_8_to_16(src_y); \
+  u = avx2_load_8_to_16(src_u); \
+  v = avx2_load_8_to_16(src_v);
+
+/* Chroma is in the lower 16 bits (U) and upper 16 bits (V) of each 32 bit word */
+
+#define EXPAND_UV \
+  v = _mm256_srli_epi32(u, 16); \
+  u = _mm256_and_si256(u, mask_0000ffff); \
+  u = _mm256_or_si256(u, _mm256_slli_epi32(u, 16)); \
+  v = _mm256_or_si256(v, _mm256_slli_epi32(v, 16));
+
+#define LOAD_YUY2 \
+  p = _mm256_loadu_si256((const __m256i*)src); \
+  y = _mm256_and_si256(p, mask_00ff); \
+  u = _mm256_srli_epi16(p, 8); \
+  EXPAND_UV
+
+#define LOAD_UYVY \
+  p = _mm256_loadu_si256((const __m256i*)src); \
+  y = _mm256_srli_epi16(p, 8); \
+  u = _mm256_and_si256(p, mask_00ff); \
+  EXPAND_UV
+
+/* Storing */
+
+#define INIT_STORE_8 \
+  __m256i r, g, b; \
+  __m128i pix[4]; \
+  const __m128i alpha = _mm_set1_epi8(-1);
+
+#define INIT_STORE_FLOAT \
+  __m256 r_f[2], g_f[2], b_f[2];
+
+#define INIT_STORE_FLOAT_ALPHA \
+  INIT_STORE_FLOAT \
+  const __m256 alpha_f = _mm256_set1_ps(1.0);
+
+#define INIT_COEFFS \
+  yuv_rgb_avx2_t c; \
+  yuv_rgb_avx2_init(&c, 0);
+
+#define INIT_COEFFS_J \
+  yuv_rgb_avx2_t c; \
+  yuv_rgb_avx2_init(&c, 1);
+
+#define STORE_RGB_24 \
+  yuv_to_rgb_avx2(&c, y, u, v, &r, &g, &b); \
+  avx2_interleave_4x8(avx2_pack_16_to_8(r), avx2_pack_16_to_8(g), \
+                      avx2_pack_16_to_8(b), alpha, pix); \
+  avx2_store_32_as_24(dst, pix);
+
+#define STORE_BGR_24 \
+  yuv_to_rgb_avx2(&c, y, u, v, &r, &g, &b); \
+  avx2_interleave_4x8(avx2_pack_16_to_8(b), avx2_pack_16_to_8(g), \
+                      avx2_pack_16_to_8(r), alpha, pix); \
+  avx2_store_32_as_24(dst, pix);
+
+#define STORE_RGB_32 \
+  yuv_to_rgb_avx2(&c, y, u, v, &r, &g, &b); \
+  avx2_interleave_4x8(avx2_pack_16_to_8(r), avx2_pack_16_to_8(g), \
+                      avx2_pack_16_to_8(b), alpha, pix); \
+  avx2_store_32(dst, pix);
+
+#define STORE_BGR_32 \
+  yuv_to_rgb_avx2(&c, y, u, v, &r, &g, &b); \
+  avx2_interleave_4x8(avx2_pack_16_to_8(b), avx2_pack_16_to_8(g), \
+                      avx2_pack_16_to_8(r), alpha, pix); \
+  avx2_store_32(dst, pix);
+
+#define STORE_RGBA_32 STORE_RGB_32
+
+#define STORE_RGB_FLOAT \
+  yuv_to_rgb_float_avx2(&c, y, u, v, r_f, g_f, b_f); \
+  avx2_store_float_3x8(dst,    r_f[0], g_f[0], b_f[0]); \
+  avx2_store_float_3x8(dst+24, r_f[1], g_f[1], b_f[1]);
+
+#define STORE_RGBA_FLOAT \
+  yuv_to_rgb_float_avx2(&c, y, u, v, r_f, g_f, b_f); \
+  avx2_store_float_4x8(dst,    r_f[0], g_f[0], b_f[0], alpha_f); \
+  avx2_store_float_4x8(dst+32, r_f[1], g_f[1], b_f[1], alpha_f);
+
+/* YUV_420P */
+
+/* yuv_420_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgb_float_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgba_float_avx2 */
+
+#define FUNC_NAME     yuv_420_p_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* YUV_422P */
+
+/* yuv_422_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgb_float_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgba_float_avx2 */
+
+#define FUNC_NAME     yuv_422_p_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* YUV_444P */
+
+/* yuv_444_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgb_float_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgba_float_avx2 */
+
+#define FUNC_NAME     yuv_444_p_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* YUVJ_420P */
+
+/* yuvj_420_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgb_float_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgba_float_avx2 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* YUVJ_422P */
+
+/* yuvj_422_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgb_float_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgba_float_avx2 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* YUVJ_444P */
+
+/* yuvj_444_p_to_rgb_24_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_bgr_24_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgb_32_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_bgr_32_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgba_32_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgb_float_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgba_float_avx2 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* YUY2 */
+
+/* yuy2_to_rgb_24_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgb_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGB_24
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_bgr_24_avx2 */
+
+#define FUNC_NAME   yuy2_to_bgr_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_BGR_24
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgb_32_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgb_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGB_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_bgr_32_avx2 */
+
+#define FUNC_NAME   yuy2_to_bgr_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_BGR_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgba_32_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgba_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGBA_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgb_float_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgb_float_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    float
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGB_FLOAT
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgba_float_avx2 */
+
+#define FUNC_NAME   yuy2_to_rgba_float_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    float
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGBA_FLOAT
+
+#include "../csp_packed_packed.h"
+
+/* UYVY */
+
+/* uyvy_to_rgb_24_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgb_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGB_24
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_bgr_24_avx2 */
+
+#define FUNC_NAME   uyvy_to_bgr_24_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_BGR_24
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgb_32_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgb_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGB_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_bgr_32_avx2 */
+
+#define FUNC_NAME   uyvy_to_bgr_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_BGR_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgba_32_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgba_32_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGBA_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgb_float_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgb_float_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    float
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 48
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGB_FLOAT
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgba_float_avx2 */
+
+#define FUNC_NAME   uyvy_to_rgba_float_avx2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    float
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 64
+#define NUM_PIXELS  16
+#define INIT        INIT_LOAD_PACKED INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGBA_FLOAT
+
+#include "../csp_packed_packed.h"
+
+/*
+ *  Semiplanar formats: 16 luma and 8 interleaved chroma pairs.
+ *  The chroma pointer is advanced by 16 bytes per step, src_v is unused.
+ */
+
+#define INIT_LOAD_SEMIPLANAR \
+  __m256i y, u, v; \
+  const __m256i mask_0000ffff = _mm256_set1_epi32(0x0000ffff);
+
+#define LOAD_NV12 \
+  y = avx2_load_8_to_16(src_y); \
+  u = avx2_load_8_to_16(src_u); \
+  EXPAND_UV
+
+#define LOAD_NV21 \
+  y = avx2_load_8_to_16(src_y); \
+  v = avx2_load_8_to_16(src_u); \
+  u = _mm256_srli_epi32(v, 16); \
+  v = _mm256_and_si256(v, mask_0000ffff); \
+  u = _mm256_or_si256(u, _mm256_slli_epi32(u, 16)); \
+  v = _mm256_or_si256(v, _mm256_slli_epi32(v, 16));
+
+/* NV12 */
+
+/* nv12_to_rgb_24_avx2 */
+
+#define FUNC_NAME     nv12_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_bgr_24_avx2 */
+
+#define FUNC_NAME     nv12_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_rgb_32_avx2 */
+
+#define FUNC_NAME     nv12_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_bgr_32_avx2 */
+
+#define FUNC_NAME     nv12_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_rgba_32_avx2 */
+
+#define FUNC_NAME     nv12_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_rgb_float_avx2 */
+
+#define FUNC_NAME     nv12_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_rgba_float_avx2 */
+
+#define FUNC_NAME     nv12_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* NV21 */
+
+/* nv21_to_rgb_24_avx2 */
+
+#define FUNC_NAME     nv21_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_bgr_24_avx2 */
+
+#define FUNC_NAME     nv21_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_rgb_32_avx2 */
+
+#define FUNC_NAME     nv21_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_bgr_32_avx2 */
+
+#define FUNC_NAME     nv21_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_rgba_32_avx2 */
+
+#define FUNC_NAME     nv21_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_rgb_float_avx2 */
+
+#define FUNC_NAME     nv21_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_rgba_float_avx2 */
+
+#define FUNC_NAME     nv21_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* NV16 */
+
+/* nv16_to_rgb_24_avx2 */
+
+#define FUNC_NAME     nv16_to_rgb_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_bgr_24_avx2 */
+
+#define FUNC_NAME     nv16_to_bgr_24_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_rgb_32_avx2 */
+
+#define FUNC_NAME     nv16_to_rgb_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_bgr_32_avx2 */
+
+#define FUNC_NAME     nv16_to_bgr_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_rgba_32_avx2 */
+
+#define FUNC_NAME     nv16_to_rgba_32_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_rgb_float_avx2 */
+
+#define FUNC_NAME     nv16_to_rgb_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   48
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_FLOAT INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_rgba_float_avx2 */
+
+#define FUNC_NAME     nv16_to_rgba_float_avx2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      float
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 16
+#define OUT_ADVANCE   64
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_FLOAT_ALPHA INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGBA_FLOAT
+
+#include "../csp_planar_packed.h"
+
+/*
+ *  16 bit 4:2:0 -> 16 bit RGB. 8 pixels are processed at once
+ *  in single precision, so no float intermediate format is needed.
+ */
+
+typedef struct
+  {
+  __m256 y_off;
+  __m256 uv_off;
+  __m256 y;
+  __m256 v_r;
+  __m256 u_g;
+  __m256 v_g;
+  __m256 u_b;
+  __m256 min;
+  __m256 max;
+  } yuv_16_rgb_avx2_t;
+
+static inline void yuv_16_rgb_avx2_init(yuv_16_rgb_avx2_t * c)
+  {
+  c->y_off  = _mm256_set1_ps(0x1000);
+  c->uv_off = _mm256_set1_ps(0x8000);
+  c->y      = _mm256_set1_ps(Y_COEFF);
+  c->v_r    = _mm256_set1_ps(V_R_COEFF);
+  c->u_g    = _mm256_set1_ps(U_G_COEFF);
+  c->v_g    = _mm256_set1_ps(V_G_COEFF);
+  c->u_b    = _mm256_set1_ps(U_B_COEFF);
+  c->min    = _mm256_setzero_ps();
+  c->max    = _mm256_set1_ps(65535.0);
+  }
+
+static inline __m256 load_16_to_float(__m128i x)
+  {
+  return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(x));
+  }
+
+static inline __m128i store_float_to_16(__m256 x, const yuv_16_rgb_avx2_t * c)
+  {
+  __m256i i = _mm256_cvtps_epi32(avx2_clip_float(x, c->min, c->max));
+  return _mm_packus_epi32(_mm256_castsi256_si128(i),
+                          _mm256_extracti128_si256(i, 1));
+  }
+
+/* 8 YUV values (16 bit) -> 8 RGB values (16 bit) */
+
+static inline void yuv_16_to_rgb_48_avx2(const yuv_16_rgb_avx2_t * c,
+                                         __m128i y, __m128i u, __m128i v,
+                                         __m128i * r, __m128i * g, __m128i * b)
+  {
+  __m256 y_f, u_f, v_f;
+
+  y_f = _mm256_mul_ps(_mm256_sub_ps(load_16_to_float(y), c->y_off), c->y);
+  u_f = _mm256_sub_ps(load_16_to_float(u), c->uv_off);
+  v_f = _mm256_sub_ps(load_16_to_float(v), c->uv_off);
+
+  *r = store_float_to_16(_mm256_fmadd_ps(v_f, c->v_r, y_f), c);
+  *g = store_float_to_16(_mm256_fmadd_ps(u_f, c->u_g,
+                                         _mm256_fmadd_ps(v_f, c->v_g, y_f)), c);
+  *b = store_float_to_16(_mm256_fmadd_ps(u_f, c->u_b, y_f), c);
+  }
+
+/* Interleave 8 values of each component to 8 packed 64 bit pixels */
+
+static inline void avx2_interleave_4x16(__m128i c1, __m128i c2,
+                                        __m128i c3, __m128i c4,
+                                        __m128i * p)
+  {
+  __m128i c12_lo = _mm_unpacklo_epi16(c1, c2);
+  __m128i c12_hi = _mm_unpackhi_epi16(c1, c2);
+  __m128i c34_lo = _mm_unpacklo_epi16(c3, c4);
+  __m128i c34_hi = _mm_unpackhi_epi16(c3, c4);
+  p[0] = _mm_unpacklo_epi32(c12_lo, c34_lo);
+  p[1] = _mm_unpackhi_epi32(c12_lo, c34_lo);
+  p[2] = _mm_unpacklo_epi32(c12_hi, c34_hi);
+  p[3] = _mm_unpackhi_epi32(c12_hi, c34_hi);
+  }
+
+/* Store 8 packed 64 bit pixels as 48 bit pixels (the 4th component is dropped) */
+
+static inline void avx2_store_64_as_48(uint16_t * dst, const __m128i * p)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13,
+                                     -1, -1, -1, -1);
+  __m128i p0 = _mm_shuffle_epi8(p[0], mask);
+  __m128i p1 = _mm_shuffle_epi8(p[1], mask);
+  __m128i p2 = _mm_shuffle_epi8(p[2], mask);
+  __m128i p3 = _mm_shuffle_epi8(p[3], mask);
+
+  _mm_storeu_si128((__m128i*)dst,
+                   _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+  _mm_storeu_si128((__m128i*)(dst+8),
+                   _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+  _mm_storeu_si128((__m128i*)(dst+16),
+                   _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+  }
+
+static inline void avx2_store_64(uint16_t * dst, const __m128i * p)
+  {
+  _mm_storeu_si128((__m128i*)dst,      p[0]);
+  _mm_storeu_si128((__m128i*)(dst+8),  p[1]);
+  _mm_storeu_si128((__m128i*)(dst+16), p[2]);
+  _mm_storeu_si128((__m128i*)(dst+24), p[3]);
+  }
+
+#define DECLARE_16 \
+  __m128i y, u, v, r, g, b; \
+  __m128i pix[4]; \
+  const __m128i alpha = _mm_set1_epi16(-1); \
+  yuv_16_rgb_avx2_t c;
+
+#define DECLARE_16_SEMIPLANAR \
+  DECLARE_16 \
+  const __m128i mask_u = _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, \
+                                       8, 9, 8, 9, 12, 13, 12, 13); \
+  const __m128i mask_v = _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, \
+                                       10, 11, 10, 11, 14, 15, 14, 15);
+
+#define INIT_16_COEFFS \
+  yuv_16_rgb_avx2_init(&c);
+
+/* 8 luma and 4 chroma samples */
+
+#define LOAD_YUV_420_P_16 \
+  y = _mm_loadu_si128((const __m128i*)src_y); \
+  u = _mm_loadl_epi64((const __m128i*)src_u); \
+  v = _mm_loadl_epi64((const __m128i*)src_v); \
+  u = _mm_unpacklo_epi16(u, u); \
+  v = _mm_unpacklo_epi16(v, v);
+
+#define LOAD_P016 \
+  y = _mm_loadu_si128((const __m128i*)src_y); \
+  v = _mm_loadu_si128((const __m128i*)src_u); \
+  u = _mm_shuffle_epi8(v, mask_u); \
+  v = _mm_shuffle_epi8(v, mask_v);
+
+#define STORE_RGB_48 \
+  yuv_16_to_rgb_48_avx2(&c, y, u, v, &r, &g, &b); \
+  avx2_interleave_4x16(r, g, b, alpha, pix); \
+  avx2_store_64_as_48(dst, pix);
+
+#define STORE_RGBA_64 \
+  yuv_16_to_rgb_48_avx2(&c, y, u, v, &r, &g, &b); \
+  avx2_interleave_4x16(r, g, b, alpha, pix); \
+  avx2_store_64(dst, pix);
+
+/* yuv_420_p_16_to_rgb_48_avx2 */
+
+#define FUNC_NAME     yuv_420_p_16_to_rgb_48_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          DECLARE_16 INIT_16_COEFFS
+#define CONVERT       LOAD_YUV_420_P_16 STORE_RGB_48
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_16_to_rgba_64_avx2 */
+
+#define FUNC_NAME     yuv_420_p_16_to_rgba_64_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          DECLARE_16 INIT_16_COEFFS
+#define CONVERT       LOAD_YUV_420_P_16 STORE_RGBA_64
+
+#include "../csp_planar_packed.h"
+
+/* p016_to_rgb_48_avx2 */
+
+#define FUNC_NAME     p016_to_rgb_48_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          DECLARE_16_SEMIPLANAR INIT_16_COEFFS
+#define CONVERT       LOAD_P016 STORE_RGB_48
+
+#include "../csp_planar_packed.h"
+
+/* p016_to_rgba_64_avx2 */
+
+#define FUNC_NAME     p016_to_rgba_64_avx2
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          DECLARE_16_SEMIPLANAR INIT_16_COEFFS
+#define CONVERT       LOAD_P016 STORE_RGBA_64
+
+#include "../csp_planar_packed.h"
+
+void gavl_init_yuv_rgb_funcs_avx2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  if(width % 16)
+    return;
+
+  if(opt->quality && (opt->quality >= 3))
+    return;
+
+  tab->yuv_420_p_to_rgb_24 = yuv_420_p_to_rgb_24_avx2;
+  tab->yuv_420_p_to_bgr_24 = yuv_420_p_to_bgr_24_avx2;
+  tab->yuv_420_p_to_rgb_32 = yuv_420_p_to_rgb_32_avx2;
+  tab->yuv_420_p_to_bgr_32 = yuv_420_p_to_bgr_32_avx2;
+  tab->yuv_420_p_to_rgba_32 = yuv_420_p_to_rgba_32_avx2;
+  tab->yuv_420_p_to_rgb_float = yuv_420_p_to_rgb_float_avx2;
+  tab->yuv_420_p_to_rgba_float = yuv_420_p_to_rgba_float_avx2;
+
+  tab->yuv_422_p_to_rgb_24 = yuv_422_p_to_rgb_24_avx2;
+  tab->yuv_422_p_to_bgr_24 = yuv_422_p_to_bgr_24_avx2;
+  tab->yuv_422_p_to_rgb_32 = yuv_422_p_to_rgb_32_avx2;
+  tab->yuv_422_p_to_bgr_32 = yuv_422_p_to_bgr_32_avx2;
+  tab->yuv_422_p_to_rgba_32 = yuv_422_p_to_rgba_32_avx2;
+  tab->yuv_422_p_to_rgb_float = yuv_422_p_to_rgb_float_avx2;
+  tab->yuv_422_p_to_rgba_float = yuv_422_p_to_rgba_float_avx2;
+
+  tab->yuv_444_p_to_rgb_24 = yuv_444_p_to_rgb_24_avx2;
+  tab->yuv_444_p_to_bgr_24 = yuv_444_p_to_bgr_24_avx2;
+  tab->yuv_444_p_to_rgb_32 = yuv_444_p_to_rgb_32_avx2;
+  tab->yuv_444_p_to_bgr_32 = yuv_444_p_to_bgr_32_avx2;
+  tab->yuv_444_p_to_rgba_32 = yuv_444_p_to_rgba_32_avx2;
+  tab->yuv_444_p_to_rgb_float = yuv_444_p_to_rgb_float_avx2;
+  tab->yuv_444_p_to_rgba_float = yuv_444_p_to_rgba_float_avx2;
+
+  tab->yuvj_420_p_to_rgb_24 = yuvj_420_p_to_rgb_24_avx2;
+  tab->yuvj_420_p_to_bgr_24 = yuvj_420_p_to_bgr_24_avx2;
+  tab->yuvj_420_p_to_rgb_32 = yuvj_420_p_to_rgb_32_avx2;
+  tab->yuvj_420_p_to_bgr_32 = yuvj_420_p_to_bgr_32_avx2;
+  tab->yuvj_420_p_to_rgba_32 = yuvj_420_p_to_rgba_32_avx2;
+  tab->yuvj_420_p_to_rgb_float = yuvj_420_p_to_rgb_float_avx2;
+  tab->yuvj_420_p_to_rgba_float = yuvj_420_p_to_rgba_float_avx2;
+
+  tab->yuvj_422_p_to_rgb_24 = yuvj_422_p_to_rgb_24_avx2;
+  tab->yuvj_422_p_to_bgr_24 = yuvj_422_p_to_bgr_24_avx2;
+  tab->yuvj_422_p_to_rgb_32 = yuvj_422_p_to_rgb_32_avx2;
+  tab->yuvj_422_p_to_bgr_32 = yuvj_422_p_to_bgr_32_avx2;
+  tab->yuvj_422_p_to_rgba_32 = yuvj_422_p_to_rgba_32_avx2;
+  tab->yuvj_422_p_to_rgb_float = yuvj_422_p_to_rgb_float_avx2;
+  tab->yuvj_422_p_to_rgba_float = yuvj_422_p_to_rgba_float_avx2;
+
+  tab->yuvj_444_p_to_rgb_24 = yuvj_444_p_to_rgb_24_avx2;
+  tab->yuvj_444_p_to_bgr_24 = yuvj_444_p_to_bgr_24_avx2;
+  tab->yuvj_444_p_to_rgb_32 = yuvj_444_p_to_rgb_32_avx2;
+  tab->yuvj_444_p_to_bgr_32 = yuvj_444_p_to_bgr_32_avx2;
+  tab->yuvj_444_p_to_rgba_32 = yuvj_444_p_to_rgba_32_avx2;
+  tab->yuvj_444_p_to_rgb_float = yuvj_444_p_to_rgb_float_avx2;
+  tab->yuvj_444_p_to_rgba_float = yuvj_444_p_to_rgba_float_avx2;
+
+  tab->yuy2_to_rgb_24 = yuy2_to_rgb_24_avx2;
+  tab->yuy2_to_bgr_24 = yuy2_to_bgr_24_avx2;
+  tab->yuy2_to_rgb_32 = yuy2_to_rgb_32_avx2;
+  tab->yuy2_to_bgr_32 = yuy2_to_bgr_32_avx2;
+  tab->yuy2_to_rgba_32 = yuy2_to_rgba_32_avx2;
+  tab->yuy2_to_rgb_float = yuy2_to_rgb_float_avx2;
+  tab->yuy2_to_rgba_float = yuy2_to_rgba_float_avx2;
+
+  tab->uyvy_to_rgb_24 = uyvy_to_rgb_24_avx2;
+  tab->uyvy_to_bgr_24 = uyvy_to_bgr_24_avx2;
+  tab->uyvy_to_rgb_32 = uyvy_to_rgb_32_avx2;
+  tab->uyvy_to_bgr_32 = uyvy_to_bgr_32_avx2;
+  tab->uyvy_to_rgba_32 = uyvy_to_rgba_32_avx2;
+  tab->uyvy_to_rgb_float = uyvy_to_rgb_float_avx2;
+  tab->uyvy_to_rgba_float = uyvy_to_rgba_float_avx2;
+
+  tab->nv12_to_rgb_24 = nv12_to_rgb_24_avx2;
+  tab->nv12_to_bgr_24 = nv12_to_bgr_24_avx2;
+  tab->nv12_to_rgb_32 = nv12_to_rgb_32_avx2;
+  tab->nv12_to_bgr_32 = nv12_to_bgr_32_avx2;
+  tab->nv12_to_rgba_32 = nv12_to_rgba_32_avx2;
+  tab->nv12_to_rgb_float = nv12_to_rgb_float_avx2;
+  tab->nv12_to_rgba_float = nv12_to_rgba_float_avx2;
+
+  tab->nv21_to_rgb_24 = nv21_to_rgb_24_avx2;
+  tab->nv21_to_bgr_24 = nv21_to_bgr_24_avx2;
+  tab->nv21_to_rgb_32 = nv21_to_rgb_32_avx2;
+  tab->nv21_to_bgr_32 = nv21_to_bgr_32_avx2;
+  tab->nv21_to_rgba_32 = nv21_to_rgba_32_avx2;
+  tab->nv21_to_rgb_float = nv21_to_rgb_float_avx2;
+  tab->nv21_to_rgba_float = nv21_to_rgba_float_avx2;
+
+  tab->nv16_to_rgb_24 = nv16_to_rgb_24_avx2;
+  tab->nv16_to_bgr_24 = nv16_to_bgr_24_avx2;
+  tab->nv16_to_rgb_32 = nv16_to_rgb_32_avx2;
+  tab->nv16_to_bgr_32 = nv16_to_bgr_32_avx2;
+  tab->nv16_to_rgba_32 = nv16_to_rgba_32_avx2;
+  tab->nv16_to_rgb_float = nv16_to_rgb_float_avx2;
+  tab->nv16_to_rgba_float = nv16_to_rgba_float_avx2;
+
+  tab->yuv_420_p_16_to_rgb_48 = yuv_420_p_16_to_rgb_48_avx2;
+  tab->yuv_420_p_16_to_rgba_64 = yuv_420_p_16_to_rgba_64_avx2;
+  tab->p016_to_rgb_48 = p016_to_rgb_48_avx2;
+  tab->p016_to_rgba_64 = p016_to_rgba_64_avx2;
+  }
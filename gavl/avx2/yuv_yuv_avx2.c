@@ -0,0 +1,570 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+#include <accel.h>
+
+#include <attributes.h>
+
+#include "avx2.h"
+
+/*
+ *  AVX2 Semiplanar <-> Planar conversions. The luma plane is copied,
+ *  the chroma plane is (de)interleaved 16 pairs at once. The remaining
+ *  pairs of each line are done in C, so any image width is supported.
+ */
+
+static inline void deinterleave_line(const uint8_t * src,
+                                     uint8_t * dst_1, uint8_t * dst_2,
+                                     int num)
+  {
+  int i;
+  __m256i p;
+  const __m256i mask = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14,
+                                        1, 3, 5, 7, 9, 11, 13, 15,
+                                        0, 2, 4, 6, 8, 10, 12, 14,
+                                        1, 3, 5, 7, 9, 11, 13, 15);
+  for(i = 0; i < num / 16; i++)
+    {
+    p = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), mask);
+    p = _mm256_permute4x64_epi64(p, 0xd8);
+    _mm_storeu_si128((__m128i*)dst_1, _mm256_castsi256_si128(p));
+    _mm_storeu_si128((__m128i*)dst_2, _mm256_extracti128_si256(p, 1));
+    src += 32;
+    dst_1 += 16;
+    dst_2 += 16;
+    }
+  
+  for(i = 0; i < num % 16; i++)
+    {
+    *(dst_1++) = src[0];
+    *(dst_2++) = src[1];
+    src += 2;
+    }
+  }
+
+static inline void interleave_line(const uint8_t * src_1, const uint8_t * src_2,
+                                   uint8_t * dst, int num)
+  {
+  int i;
+  __m128i c1, c2;
+  
+  for(i = 0; i < num / 16; i++)
+    {
+    c1 = _mm_loadu_si128((const __m128i*)src_1);
+    c2 = _mm_loadu_si128((const __m128i*)src_2);
+    _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(c1, c2));
+    _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(c1, c2));
+    src_1 += 16;
+    src_2 += 16;
+    dst += 32;
+    }
+
+  for(i = 0; i < num % 16; i++)
+    {
+    dst[0] = *(src_1++);
+    dst[1] = *(src_2++);
+    dst += 2;
+    }
+  }
+
+static void copy_luma(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int y_size =
+    ctx->input_frame->strides[0] < ctx->output_frame->strides[0] ?
+    ctx->input_frame->strides[0] : ctx->output_frame->strides[0];
+  uint8_t * src_y = ctx->input_frame->planes[0];
+  uint8_t * dst_y = ctx->output_frame->planes[0];
+  
+  for(i = 0; i < ctx->input_format.image_height; i++)
+    {
+    gavl_memcpy(dst_y, src_y, y_size);
+    dst_y += ctx->output_frame->strides[0];
+    src_y += ctx->input_frame->strides[0];
+    }
+  }
+
+static void semiplanar_to_planar(gavl_video_convert_context_t * ctx,
+                                 int sub_v, int swap)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + sub_v - 1) / sub_v;
+  uint8_t * src = ctx->input_frame->planes[1];
+  uint8_t * dst_u = ctx->output_frame->planes[1];
+  uint8_t * dst_v = ctx->output_frame->planes[2];
+
+  copy_luma(ctx);
+  
+  for(i = 0; i < uv_height; i++)
+    {
+    if(swap)
+      deinterleave_line(src, dst_v, dst_u, uv_width);
+    else
+      deinterleave_line(src, dst_u, dst_v, uv_width);
+    
+    src += ctx->input_frame->strides[1];
+    dst_u += ctx->output_frame->strides[1];
+    dst_v += ctx->output_frame->strides[2];
+    }
+  }
+
+static void planar_to_semiplanar(gavl_video_convert_context_t * ctx,
+                                 int sub_v, int swap)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + sub_v - 1) / sub_v;
+  uint8_t * src_u = ctx->input_frame->planes[1];
+  uint8_t * src_v = ctx->input_frame->planes[2];
+  uint8_t * dst = ctx->output_frame->planes[1];
+
+  copy_luma(ctx);
+  
+  for(i = 0; i < uv_height; i++)
+    {
+    if(swap)
+      interleave_line(src_v, src_u, dst, uv_width);
+    else
+      interleave_line(src_u, src_v, dst, uv_width);
+    
+    dst += ctx->output_frame->strides[1];
+    src_u += ctx->input_frame->strides[1];
+    src_v += ctx->input_frame->strides[2];
+    }
+  }
+
+static void nv12_to_yuv_420_p_avx2(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 2, 0);
+  }
+
+static void nv21_to_yuv_420_p_avx2(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 2, 1);
+  }
+
+static void nv16_to_yuv_422_p_avx2(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 1, 0);
+  }
+
+static void yuv_420_p_to_nv12_avx2(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 2, 0);
+  }
+
+static void yuv_420_p_to_nv21_avx2(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 2, 1);
+  }
+
+static void yuv_422_p_to_nv16_avx2(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 1, 0);
+  }
+
+/*
+ *  16 bit 4:2:0 (YUV 420 Planar (16 bit) and P016). 16 bit samples are
+ *  reduced to 8 bit by dropping the lower byte like the C versions do,
+ *  8 bit samples are expanded by shifting them into the upper byte.
+ */
+
+/* 16 bit <-> 8 bit for a line of num samples */
+
+static inline void line_16_to_8(const uint16_t * src, uint8_t * dst, int num)
+  {
+  int i;
+  __m256i p1, p2;
+  
+  for(i = 0; i < num / 32; i++)
+    {
+    p1 = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)src), 8);
+    p2 = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(src+16)), 8);
+    p1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(p1, p2), 0xd8);
+    _mm256_storeu_si256((__m256i*)dst, p1);
+    src += 32;
+    dst += 32;
+    }
+
+  for(i = 0; i < num % 32; i++)
+    *(dst++) = *(src++) >> 8;
+  }
+
+static inline void line_8_to_16(const uint8_t * src, uint16_t * dst, int num)
+  {
+  int i;
+  
+  for(i = 0; i < num / 16; i++)
+    {
+    _mm256_storeu_si256((__m256i*)dst,
+                        _mm256_slli_epi16(avx2_load_8_to_16(src), 8));
+    src += 16;
+    dst += 16;
+    }
+
+  for(i = 0; i < num % 16; i++)
+    *(dst++) = *(src++) << 8;
+  }
+
+/* (De)interleave num pairs of 16 bit samples */
+
+static inline void deinterleave_line_16(const uint16_t * src,
+                                        uint16_t * dst_1, uint16_t * dst_2,
+                                        int num)
+  {
+  int i;
+  __m256i p;
+  const __m256i mask = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13,
+                                        2, 3, 6, 7, 10, 11, 14, 15,
+                                        0, 1, 4, 5, 8, 9, 12, 13,
+                                        2, 3, 6, 7, 10, 11, 14, 15);
+  for(i = 0; i < num / 8; i++)
+    {
+    p = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)src), mask);
+    p = _mm256_permute4x64_epi64(p, 0xd8);
+    _mm_storeu_si128((__m128i*)dst_1, _mm256_castsi256_si128(p));
+    _mm_storeu_si128((__m128i*)dst_2, _mm256_extracti128_si256(p, 1));
+    src += 16;
+    dst_1 += 8;
+    dst_2 += 8;
+    }
+  
+  for(i = 0; i < num % 8; i++)
+    {
+    *(dst_1++) = src[0];
+    *(dst_2++) = src[1];
+    src += 2;
+    }
+  }
+
+static inline void interleave_line_16(const uint16_t * src_1, const uint16_t * src_2,
+                                      uint16_t * dst, int num)
+  {
+  int i;
+  __m128i c1, c2;
+  
+  for(i = 0; i < num / 8; i++)
+    {
+    c1 = _mm_loadu_si128((const __m128i*)src_1);
+    c2 = _mm_loadu_si128((const __m128i*)src_2);
+    _mm_storeu_si128((__m128i*)dst,     _mm_unpacklo_epi16(c1, c2));
+    _mm_storeu_si128((__m128i*)(dst+8), _mm_unpackhi_epi16(c1, c2));
+    src_1 += 8;
+    src_2 += 8;
+    dst += 16;
+    }
+
+  for(i = 0; i < num % 8; i++)
+    {
+    dst[0] = *(src_1++);
+    dst[1] = *(src_2++);
+    dst += 2;
+    }
+  }
+
+/* Interleaved 16 bit chroma -> 2 planes of 8 bit chroma */
+
+static inline void deinterleave_line_16_to_8(const uint16_t * src,
+                                             uint8_t * dst_1, uint8_t * dst_2,
+                                             int num)
+  {
+  int i;
+  __m256i p1, p2;
+  const __m256i mask = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14,
+                                        1, 3, 5, 7, 9, 11, 13, 15,
+                                        0, 2, 4, 6, 8, 10, 12, 14,
+                                        1, 3, 5, 7, 9, 11, 13, 15);
+  for(i = 0; i < num / 16; i++)
+    {
+    p1 = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)src), 8);
+    p2 = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(src+16)), 8);
+    p1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(p1, p2), 0xd8);
+    p1 = _mm256_shuffle_epi8(p1, mask);
+    p1 = _mm256_permute4x64_epi64(p1, 0xd8);
+    _mm_storeu_si128((__m128i*)dst_1, _mm256_castsi256_si128(p1));
+    _mm_storeu_si128((__m128i*)dst_2, _mm256_extracti128_si256(p1, 1));
+    src += 32;
+    dst_1 += 16;
+    dst_2 += 16;
+    }
+  
+  for(i = 0; i < num % 16; i++)
+    {
+    *(dst_1++) = src[0] >> 8;
+    *(dst_2++) = src[1] >> 8;
+    src += 2;
+    }
+  }
+
+/* 2 planes of 8 bit chroma -> interleaved 16 bit chroma */
+
+static inline void interleave_line_8_to_16(const uint8_t * src_1, const uint8_t * src_2,
+                                           uint16_t * dst, int num)
+  {
+  int i;
+  __m128i c1, c2;
+  
+  for(i = 0; i < num / 16; i++)
+    {
+    c1 = _mm_loadu_si128((const __m128i*)src_1);
+    c2 = _mm_loadu_si128((const __m128i*)src_2);
+    /* Zero extend the interleaved samples and move them into the upper byte */
+    _mm256_storeu_si256((__m256i*)dst,
+                        _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(c1, c2)), 8));
+    _mm256_storeu_si256((__m256i*)(dst+16),
+                        _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_unpackhi_epi8(c1, c2)), 8));
+    src_1 += 16;
+    src_2 += 16;
+    dst += 32;
+    }
+
+  for(i = 0; i < num % 16; i++)
+    {
+    dst[0] = *(src_1++) << 8;
+    dst[1] = *(src_2++) << 8;
+    dst += 2;
+    }
+  }
+
+static void luma_16_to_8(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  const uint8_t * src = ctx->input_frame->planes[0];
+  uint8_t * dst = ctx->output_frame->planes[0];
+  
+  for(i = 0; i < ctx->input_format.image_height; i++)
+    {
+    line_16_to_8((const uint16_t*)src, dst, ctx->input_format.image_width);
+    src += ctx->input_frame->strides[0];
+    dst += ctx->output_frame->strides[0];
+    }
+  }
+
+static void luma_8_to_16(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  const uint8_t * src = ctx->input_frame->planes[0];
+  uint8_t * dst = ctx->output_frame->planes[0];
+  
+  for(i = 0; i < ctx->input_format.image_height; i++)
+    {
+    line_8_to_16(src, (uint16_t*)dst, ctx->input_format.image_width);
+    src += ctx->input_frame->strides[0];
+    dst += ctx->output_frame->strides[0];
+    }
+  }
+
+static void yuv_420_p_16_to_yuv_420_p_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src_u = ctx->input_frame->planes[1];
+  const uint8_t * src_v = ctx->input_frame->planes[2];
+  uint8_t * dst_u = ctx->output_frame->planes[1];
+  uint8_t * dst_v = ctx->output_frame->planes[2];
+
+  luma_16_to_8(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    line_16_to_8((const uint16_t*)src_u, dst_u, uv_width);
+    line_16_to_8((const uint16_t*)src_v, dst_v, uv_width);
+    src_u += ctx->input_frame->strides[1];
+    src_v += ctx->input_frame->strides[2];
+    dst_u += ctx->output_frame->strides[1];
+    dst_v += ctx->output_frame->strides[2];
+    }
+  }
+
+static void yuv_420_p_to_yuv_420_p_16_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src_u = ctx->input_frame->planes[1];
+  const uint8_t * src_v = ctx->input_frame->planes[2];
+  uint8_t * dst_u = ctx->output_frame->planes[1];
+  uint8_t * dst_v = ctx->output_frame->planes[2];
+
+  luma_8_to_16(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    line_8_to_16(src_u, (uint16_t*)dst_u, uv_width);
+    line_8_to_16(src_v, (uint16_t*)dst_v, uv_width);
+    src_u += ctx->input_frame->strides[1];
+    src_v += ctx->input_frame->strides[2];
+    dst_u += ctx->output_frame->strides[1];
+    dst_v += ctx->output_frame->strides[2];
+    }
+  }
+
+static void p016_to_yuv_420_p_16_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src = ctx->input_frame->planes[1];
+  uint8_t * dst_u = ctx->output_frame->planes[1];
+  uint8_t * dst_v = ctx->output_frame->planes[2];
+
+  copy_luma(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    deinterleave_line_16((const uint16_t*)src,
+                         (uint16_t*)dst_u, (uint16_t*)dst_v, uv_width);
+    src += ctx->input_frame->strides[1];
+    dst_u += ctx->output_frame->strides[1];
+    dst_v += ctx->output_frame->strides[2];
+    }
+  }
+
+static void yuv_420_p_16_to_p016_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src_u = ctx->input_frame->planes[1];
+  const uint8_t * src_v = ctx->input_frame->planes[2];
+  uint8_t * dst = ctx->output_frame->planes[1];
+
+  copy_luma(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    interleave_line_16((const uint16_t*)src_u, (const uint16_t*)src_v,
+                       (uint16_t*)dst, uv_width);
+    src_u += ctx->input_frame->strides[1];
+    src_v += ctx->input_frame->strides[2];
+    dst += ctx->output_frame->strides[1];
+    }
+  }
+
+static void p016_to_yuv_420_p_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src = ctx->input_frame->planes[1];
+  uint8_t * dst_u = ctx->output_frame->planes[1];
+  uint8_t * dst_v = ctx->output_frame->planes[2];
+
+  luma_16_to_8(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    deinterleave_line_16_to_8((const uint16_t*)src, dst_u, dst_v, uv_width);
+    src += ctx->input_frame->strides[1];
+    dst_u += ctx->output_frame->strides[1];
+    dst_v += ctx->output_frame->strides[2];
+    }
+  }
+
+static void yuv_420_p_to_p016_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src_u = ctx->input_frame->planes[1];
+  const uint8_t * src_v = ctx->input_frame->planes[2];
+  uint8_t * dst = ctx->output_frame->planes[1];
+
+  luma_8_to_16(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    interleave_line_8_to_16(src_u, src_v, (uint16_t*)dst, uv_width);
+    src_u += ctx->input_frame->strides[1];
+    src_v += ctx->input_frame->strides[2];
+    dst += ctx->output_frame->strides[1];
+    }
+  }
+
+static void p016_to_nv12_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src = ctx->input_frame->planes[1];
+  uint8_t * dst = ctx->output_frame->planes[1];
+
+  luma_16_to_8(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    line_16_to_8((const uint16_t*)src, dst, 2 * uv_width);
+    src += ctx->input_frame->strides[1];
+    dst += ctx->output_frame->strides[1];
+    }
+  }
+
+static void nv12_to_p016_avx2(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + 1) / 2;
+  const uint8_t * src = ctx->input_frame->planes[1];
+  uint8_t * dst = ctx->output_frame->planes[1];
+
+  luma_8_to_16(ctx);
+
+  for(i = 0; i < uv_height; i++)
+    {
+    line_8_to_16(src, (uint16_t*)dst, 2 * uv_width);
+    src += ctx->input_frame->strides[1];
+    dst += ctx->output_frame->strides[1];
+    }
+  }
+
+void gavl_init_yuv_yuv_funcs_avx2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  /* These are lossless, so they are used for any quality and width */
+  
+  tab->nv12_to_yuv_420_p = nv12_to_yuv_420_p_avx2;
+  tab->nv21_to_yuv_420_p = nv21_to_yuv_420_p_avx2;
+  tab->nv16_to_yuv_422_p = nv16_to_yuv_422_p_avx2;
+  tab->yuv_420_p_to_nv12 = yuv_420_p_to_nv12_avx2;
+  tab->yuv_420_p_to_nv21 = yuv_420_p_to_nv21_avx2;
+  tab->yuv_422_p_to_nv16 = yuv_422_p_to_nv16_avx2;
+
+  tab->p016_to_yuv_420_p_16 = p016_to_yuv_420_p_16_avx2;
+  tab->yuv_420_p_16_to_p016 = yuv_420_p_16_to_p016_avx2;
+  tab->yuv_420_p_to_yuv_420_p_16 = yuv_420_p_to_yuv_420_p_16_avx2;
+  tab->yuv_420_p_to_p016 = yuv_420_p_to_p016_avx2;
+  tab->nv12_to_p016 = nv12_to_p016_avx2;
+
+  /* The C versions round when reducing the precision in high quality mode */
+  
+  if(opt->quality && (opt->quality >= 3))
+    return;
+
+  tab->yuv_420_p_16_to_yuv_420_p = yuv_420_p_16_to_yuv_420_p_avx2;
+  tab->p016_to_yuv_420_p = p016_to_yuv_420_p_avx2;
+  tab->p016_to_nv12 = p016_to_nv12_avx2;
+  }
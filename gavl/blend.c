@@ -24,9 +24,16 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <config.h>
+
 #include <gavl/gavl.h>
 #include <video.h>
 #include <blend.h>
+#include <accel.h>
+
+/* Overlays with at least this number of pixels are blended in parallel */
+
+#define MIN_THREAD_PIXELS (256*256)
 
 gavl_overlay_blend_context_t * gavl_overlay_blend_context_create()
   {
@@ -51,6 +58,11 @@ void gavl_overlay_blend_context_destroy(gavl_overlay_blend_context_t * ctx)
 
   if(ctx->sink)
     gavl_video_sink_destroy(ctx->sink);
+
+  gavl_video_jobs_free(&ctx->jobs);
+  
+  if(ctx->tp_priv)
+    gavl_thread_pool_destroy(ctx->tp_priv);
   
   free(ctx);
   }
@@ -185,6 +197,35 @@ gavl_overlay_blend_context_init(gavl_overlay_blend_context_t * ctx,
     gavl_find_blend_func_c(ctx,
                            dst_format->pixelformat,
                            &ctx->ovl_format.pixelformat);
+
+  if(ctx->func)
+    {
+    gavl_blend_func_t func = NULL;
+#ifdef HAVE_AVX2
+    if(ctx->opt.accel_flags & GAVL_ACCEL_AVX2)
+      func = gavl_find_blend_func_avx2(ctx, dst_format->pixelformat,
+                                       ctx->ovl_format.pixelformat);
+#endif
+#ifdef HAVE_SSE2
+    if(!func && (ctx->opt.accel_flags & GAVL_ACCEL_SSE2))
+      func = gavl_find_blend_func_sse2(ctx, dst_format->pixelformat,
+                                       ctx->ovl_format.pixelformat);
+#endif
+#ifdef HAVE_SSSE3
+    if(!func && (ctx->opt.accel_flags & GAVL_ACCEL_SSSE3))
+      func = gavl_find_blend_func_ssse3(ctx, dst_format->pixelformat,
+                                        ctx->ovl_format.pixelformat);
+#endif
+    if(func)
+      ctx->func = func;
+    }
+
+  if(!ctx->opt.tp)
+    {
+    if(!ctx->tp_priv)
+      ctx->tp_priv = gavl_thread_pool_get_shared();
+    ctx->opt.tp = ctx->tp_priv;
+    }
   
   gavl_video_format_copy(ovl_format, &ctx->ovl_format);
   
@@ -200,6 +241,38 @@ gavl_overlay_blend_context_get_sink(gavl_overlay_blend_context_t * ctx)
   return ctx->sink;
   }
 
+/* Blend the scanlines [start, end[ of the overlay. The band borders
+   are rounded to the vertical chroma subsampling */
+
+static void blend_band(void * data, int start, int end)
+  {
+  gavl_rectangle_i_t r;
+  gavl_video_frame_t dst_band;
+  gavl_video_frame_t ovl_band;
+  gavl_overlay_blend_context_t * ctx = data;
+
+  start += (ctx->dst_sub_v - start % ctx->dst_sub_v) % ctx->dst_sub_v;
+  end   += (ctx->dst_sub_v - end % ctx->dst_sub_v) % ctx->dst_sub_v;
+
+  if(end <= start)
+    return;
+
+  memset(&dst_band, 0, sizeof(dst_band));
+  memset(&ovl_band, 0, sizeof(ovl_band));
+  
+  r.x = 0;
+  r.y = start;
+  r.w = ctx->dst_rect.w;
+  r.h = end - start;
+
+  gavl_video_frame_get_subframe(ctx->dst_format.pixelformat,
+                                ctx->dst_win, &dst_band, &r);
+  gavl_video_frame_get_subframe(ctx->ovl_format.pixelformat,
+                                ctx->ovl_win, &ovl_band, &r);
+
+  ctx->func(&dst_band, &ovl_band, r.w, r.h);
+  }
+
 void gavl_overlay_blend(gavl_overlay_blend_context_t * ctx,
                         gavl_video_frame_t * dst_frame)
   {
@@ -213,6 +286,14 @@ void gavl_overlay_blend(gavl_overlay_blend_context_t * ctx,
                                 &ctx->dst_rect);
   /* Fire up blender */
 
-  ctx->func(ctx, ctx->dst_win, ctx->ovl_win);
+  if(ctx->dst_rect.w * ctx->dst_rect.h < MIN_THREAD_PIXELS)
+    {
+    ctx->func(ctx->dst_win, ctx->ovl_win, ctx->dst_rect.w, ctx->dst_rect.h);
+    return;
+    }
+  
+  gavl_video_jobs_reset(&ctx->jobs);
+  gavl_video_jobs_add(&ctx->jobs, blend_band, ctx, ctx->dst_rect.h);
+  gavl_video_jobs_run(&ctx->jobs, ctx->opt.tp);
   }
 
@@ -741,7 +741,7 @@
   dst[2] = tmp; \
   tmp = (TMP_TYPE_8)pixel->factors_i[0][0] * src_0[3] +  \
         (TMP_TYPE_8)pixel->factors_i[0][1] * src_0[7] +  \
-        (TMP_TYPE_8)pixel->factors_i[1][0] * src_1[2] +  \
+        (TMP_TYPE_8)pixel->factors_i[1][0] * src_1[3] +  \
         (TMP_TYPE_8)pixel->factors_i[1][1] * src_1[7];   \
   tmp=DOWNSHIFT(tmp,16);\
   dst[3] = tmp;
@@ -58,9 +58,9 @@
 
 /* ovl: GAVL_GRAYA_16 */
 
-static void blend_gray_8(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_gray_8(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -74,12 +74,12 @@ static void blend_gray_8(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       tmp = *dst_ptr;
       BLEND_8(ovl_ptr[0], tmp, ovl_ptr[1]);
@@ -96,9 +96,9 @@ static void blend_gray_8(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_GRAYA_32 */
 
-static void blend_gray_16(gavl_overlay_blend_context_t * ctx,
-                          gavl_video_frame_t * frame,
-                          gavl_video_frame_t * overlay)
+static void blend_gray_16(gavl_video_frame_t * frame,
+                          gavl_video_frame_t * overlay,
+                          int width, int height)
   {
   int i, j;
   uint16_t * ovl_ptr;
@@ -112,12 +112,12 @@ static void blend_gray_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       tmp = *dst_ptr;
       BLEND_16(ovl_ptr[0], tmp, ovl_ptr[1]);
@@ -134,9 +134,9 @@ static void blend_gray_16(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_GRAYA_FLOAT */
 
-static void blend_gray_float(gavl_overlay_blend_context_t * ctx,
-                             gavl_video_frame_t * frame,
-                             gavl_video_frame_t * overlay)
+static void blend_gray_float(gavl_video_frame_t * frame,
+                             gavl_video_frame_t * overlay,
+                             int width, int height)
   {
   int i, j;
   float * ovl_ptr;
@@ -148,12 +148,12 @@ static void blend_gray_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       BLEND_FLOAT(ovl_ptr[0], *dst_ptr, ovl_ptr[1]);
       dst_ptr++;
@@ -168,9 +168,9 @@ static void blend_gray_float(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_GRAYA_16 */
 
-static void blend_graya_16(gavl_overlay_blend_context_t * ctx,
-                           gavl_video_frame_t * frame,
-                           gavl_video_frame_t * overlay)
+static void blend_graya_16(gavl_video_frame_t * frame,
+                           gavl_video_frame_t * overlay,
+                           int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -184,12 +184,12 @@ static void blend_graya_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[1])
@@ -227,9 +227,9 @@ static void blend_graya_16(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_GRAYA_32 */
 
-static void blend_graya_32(gavl_overlay_blend_context_t * ctx,
-                           gavl_video_frame_t * frame,
-                           gavl_video_frame_t * overlay)
+static void blend_graya_32(gavl_video_frame_t * frame,
+                           gavl_video_frame_t * overlay,
+                           int width, int height)
   {
   int i, j;
   uint16_t * ovl_ptr;
@@ -243,12 +243,12 @@ static void blend_graya_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[1])
@@ -288,9 +288,9 @@ static void blend_graya_32(gavl_overlay_blend_context_t * ctx,
   }
 /* ovl: GAVL_GRAYA_FLOAT */
 
-static void blend_graya_float(gavl_overlay_blend_context_t * ctx,
-                           gavl_video_frame_t * frame,
-                           gavl_video_frame_t * overlay)
+static void blend_graya_float(gavl_video_frame_t * frame,
+                           gavl_video_frame_t * overlay,
+                           int width, int height)
   {
   int i, j;
   float * ovl_ptr;
@@ -304,12 +304,12 @@ static void blend_graya_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(dst_ptr[3] == 0.0)
@@ -348,9 +348,9 @@ static void blend_graya_float(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_rgb_15(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_rgb_15(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -364,12 +364,12 @@ static void blend_rgb_15(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = RGB15_TO_R_8(*dst_ptr);
       g_tmp = RGB15_TO_G_8(*dst_ptr);
@@ -394,9 +394,9 @@ static void blend_rgb_15(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_bgr_15(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_bgr_15(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -410,12 +410,12 @@ static void blend_bgr_15(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = BGR15_TO_R_8(*dst_ptr);
       g_tmp = BGR15_TO_G_8(*dst_ptr);
@@ -439,9 +439,9 @@ static void blend_bgr_15(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_rgb_16(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_rgb_16(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -455,12 +455,12 @@ static void blend_rgb_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = RGB16_TO_R_8(*dst_ptr);
       g_tmp = RGB16_TO_G_8(*dst_ptr);
@@ -484,9 +484,9 @@ static void blend_rgb_16(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_bgr_16(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_bgr_16(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -500,12 +500,12 @@ static void blend_bgr_16(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = BGR16_TO_R_8(*dst_ptr);
       g_tmp = BGR16_TO_G_8(*dst_ptr);
@@ -529,9 +529,9 @@ static void blend_bgr_16(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_rgb_24(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_rgb_24(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -545,12 +545,12 @@ static void blend_rgb_24(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = dst_ptr[0];
       g_tmp = dst_ptr[1];
@@ -576,9 +576,9 @@ static void blend_rgb_24(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_bgr_24(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_bgr_24(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -592,12 +592,12 @@ static void blend_bgr_24(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = dst_ptr[2];
       g_tmp = dst_ptr[1];
@@ -623,9 +623,9 @@ static void blend_bgr_24(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_rgb_32(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_rgb_32(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -639,12 +639,12 @@ static void blend_rgb_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = dst_ptr[0];
       g_tmp = dst_ptr[1];
@@ -670,9 +670,9 @@ static void blend_rgb_32(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_bgr_32(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_bgr_32(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -686,12 +686,12 @@ static void blend_bgr_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = dst_ptr[2];
       g_tmp = dst_ptr[1];
@@ -717,9 +717,9 @@ static void blend_bgr_32(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_32 */
 
-static void blend_rgba_32(gavl_overlay_blend_context_t * ctx,
-                          gavl_video_frame_t * frame,
-                          gavl_video_frame_t * overlay)
+static void blend_rgba_32(gavl_video_frame_t * frame,
+                          gavl_video_frame_t * overlay,
+                          int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -733,12 +733,12 @@ static void blend_rgba_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[3])
@@ -791,9 +791,9 @@ static void blend_rgba_32(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_64 */
 
-static void blend_rgb_48(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_rgb_48(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint16_t * ovl_ptr;
@@ -807,12 +807,12 @@ static void blend_rgb_48(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       r_tmp = dst_ptr[0];
       g_tmp = dst_ptr[1];
@@ -838,9 +838,9 @@ static void blend_rgb_48(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_64 */
 
-static void blend_rgba_64(gavl_overlay_blend_context_t * ctx,
-                         gavl_video_frame_t * frame,
-                         gavl_video_frame_t * overlay)
+static void blend_rgba_64(gavl_video_frame_t * frame,
+                         gavl_video_frame_t * overlay,
+                         int width, int height)
   {
   int i, j;
   uint16_t * ovl_ptr;
@@ -854,12 +854,12 @@ static void blend_rgba_64(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr = (uint16_t*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[3])
@@ -912,9 +912,9 @@ static void blend_rgba_64(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_FLOAT */
 
-static void blend_rgb_float(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_rgb_float(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j;
   float * ovl_ptr;
@@ -927,12 +927,12 @@ static void blend_rgb_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       BLEND_FLOAT(ovl_ptr[0], dst_ptr[0], ovl_ptr[3]);
       BLEND_FLOAT(ovl_ptr[1], dst_ptr[1], ovl_ptr[3]);
@@ -949,9 +949,9 @@ static void blend_rgb_float(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_RGBA_FLOAT */
 
-static void blend_rgba_float(gavl_overlay_blend_context_t * ctx,
-                             gavl_video_frame_t * frame,
-                             gavl_video_frame_t * overlay)
+static void blend_rgba_float(gavl_video_frame_t * frame,
+                             gavl_video_frame_t * overlay,
+                             int width, int height)
   {
   int i, j;
   float * ovl_ptr;
@@ -964,12 +964,12 @@ static void blend_rgba_float(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (float*)ovl_ptr_start;
     dst_ptr = (float*)dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       a_dst = dst_ptr[3] + ovl_ptr[3] - dst_ptr[3]*ovl_ptr[3];
 
@@ -997,9 +997,9 @@ static void blend_rgba_float(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuy2(gavl_overlay_blend_context_t * ctx,
-                       gavl_video_frame_t * frame,
-                       gavl_video_frame_t * overlay)
+static void blend_yuy2(gavl_video_frame_t * frame,
+                       gavl_video_frame_t * overlay,
+                       int width, int height)
   {
   int i, j, jmax;
   uint8_t * ovl_ptr;
@@ -1013,9 +1013,9 @@ static void blend_yuy2(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = width / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
@@ -1056,9 +1056,9 @@ static void blend_yuy2(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_uyvy(gavl_overlay_blend_context_t * ctx,
-                       gavl_video_frame_t * frame,
-                       gavl_video_frame_t * overlay)
+static void blend_uyvy(gavl_video_frame_t * frame,
+                       gavl_video_frame_t * overlay,
+                       int width, int height)
   {
   int i, j, jmax;
   uint8_t * ovl_ptr;
@@ -1072,9 +1072,9 @@ static void blend_uyvy(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = width / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
@@ -1113,9 +1113,9 @@ static void blend_uyvy(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuva_32(gavl_overlay_blend_context_t * ctx,
-                          gavl_video_frame_t * frame,
-                          gavl_video_frame_t * overlay)
+static void blend_yuva_32(gavl_video_frame_t * frame,
+                          gavl_video_frame_t * overlay,
+                          int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -1129,12 +1129,12 @@ static void blend_yuva_32(gavl_overlay_blend_context_t * ctx,
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_start = frame->planes[0];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr = dst_ptr_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Transparent frame -> Copy overlay */
       if(!dst_ptr[3])
@@ -1187,9 +1187,9 @@ static void blend_yuva_32(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuv_420_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuv_420_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j, imax, jmax;
   uint8_t * ovl_ptr;
@@ -1209,8 +1209,8 @@ static void blend_yuv_420_p(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
 
-  imax = ctx->ovl->src_rect.h / 2;
-  jmax = ctx->ovl->src_rect.w / 2;
+  imax = height / 2;
+  jmax = width / 2;
   
   for(i = 0; i < imax; i++)
     {
@@ -1276,9 +1276,9 @@ static void blend_yuv_420_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuv_422_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuv_422_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j, jmax;
   uint8_t * ovl_ptr;
@@ -1298,9 +1298,9 @@ static void blend_yuv_422_p(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = width / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr_y = dst_ptr_y_start;
@@ -1342,9 +1342,9 @@ static void blend_yuv_422_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuv_444_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuv_444_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -1364,14 +1364,14 @@ static void blend_yuv_444_p(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr_y = dst_ptr_y_start;
     dst_ptr_u = dst_ptr_u_start;
     dst_ptr_v = dst_ptr_v_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Y0 */
       tmp = *dst_ptr_y;
@@ -1401,9 +1401,9 @@ static void blend_yuv_444_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuv_411_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuv_411_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j, jmax;
   uint8_t * ovl_ptr;
@@ -1423,9 +1423,9 @@ static void blend_yuv_411_p(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
 
-  jmax = ctx->ovl->src_rect.w / 4;
+  jmax = width / 4;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr_y = dst_ptr_y_start;
@@ -1476,9 +1476,9 @@ static void blend_yuv_411_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuv_410_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuv_410_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j, imax, jmax;
   uint8_t * ovl_ptr;
@@ -1499,8 +1499,8 @@ static void blend_yuv_410_p(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
 
-  imax = ctx->ovl->src_rect.h / 4;
-  jmax = ctx->ovl->src_rect.w / 4;
+  imax = height / 4;
+  jmax = width / 4;
   
   for(i = 0; i < imax; i++)
     {
@@ -1653,9 +1653,9 @@ static void blend_yuv_410_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuvj_420_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuvj_420_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j, imax, jmax;
   uint8_t * ovl_ptr;
@@ -1670,8 +1670,8 @@ static void blend_yuvj_420_p(gavl_overlay_blend_context_t * ctx,
   
   int tmp;
 
-  imax = ctx->ovl->src_rect.h/2;
-  jmax = ctx->ovl->src_rect.w/2;
+  imax = height/2;
+  jmax = width/2;
   
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_y_start = frame->planes[0];
@@ -1744,9 +1744,9 @@ static void blend_yuvj_420_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuvj_422_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuvj_422_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j, jmax;
   uint8_t * ovl_ptr;
@@ -1761,14 +1761,14 @@ static void blend_yuvj_422_p(gavl_overlay_blend_context_t * ctx,
   
   int tmp;
 
-  jmax = ctx->ovl->src_rect.w/2;
+  jmax = width/2;
   
   ovl_ptr_start = overlay->planes[0];
   dst_ptr_y_start = frame->planes[0];
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr_y = dst_ptr_y_start;
@@ -1811,9 +1811,9 @@ static void blend_yuvj_422_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_32 */
 
-static void blend_yuvj_444_p(gavl_overlay_blend_context_t * ctx,
-                            gavl_video_frame_t * frame,
-                            gavl_video_frame_t * overlay)
+static void blend_yuvj_444_p(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
   {
   int i, j;
   uint8_t * ovl_ptr;
@@ -1833,14 +1833,14 @@ static void blend_yuvj_444_p(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = ovl_ptr_start;
     dst_ptr_y = dst_ptr_y_start;
     dst_ptr_u = dst_ptr_u_start;
     dst_ptr_v = dst_ptr_v_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       /* Y0 */
       tmp = *dst_ptr_y;
@@ -1870,9 +1870,9 @@ static void blend_yuvj_444_p(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_64 */
 
-static void blend_yuv_422_p_16(gavl_overlay_blend_context_t * ctx,
-                               gavl_video_frame_t * frame,
-                               gavl_video_frame_t * overlay)
+static void blend_yuv_422_p_16(gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay,
+                               int width, int height)
   {
   int i, j, jmax;
   uint16_t * ovl_ptr;
@@ -1892,9 +1892,9 @@ static void blend_yuv_422_p_16(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
 
-  jmax = ctx->ovl->src_rect.w / 2;
+  jmax = width / 2;
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr_y = (uint16_t*)dst_ptr_y_start;
@@ -1923,7 +1923,7 @@ static void blend_yuv_422_p_16(gavl_overlay_blend_context_t * ctx,
 
       /* Y1 */
       tmp = *dst_ptr_y;
-      BLEND_16(ovl_ptr[0], tmp, alpha);
+      BLEND_16(ovl_ptr[4], tmp, alpha);
       *(dst_ptr_y++) = tmp;
       
       ovl_ptr+=8;
@@ -1939,9 +1939,9 @@ static void blend_yuv_422_p_16(gavl_overlay_blend_context_t * ctx,
 
 /* ovl: GAVL_YUVA_64 */
 
-static void blend_yuv_444_p_16(gavl_overlay_blend_context_t * ctx,
-                               gavl_video_frame_t * frame,
-                               gavl_video_frame_t * overlay)
+static void blend_yuv_444_p_16(gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay,
+                               int width, int height)
   {
   int i, j;
   uint16_t * ovl_ptr;
@@ -1961,14 +1961,14 @@ static void blend_yuv_444_p_16(gavl_overlay_blend_context_t * ctx,
   dst_ptr_u_start = frame->planes[1];
   dst_ptr_v_start = frame->planes[2];
   
-  for(i = 0; i < ctx->ovl->src_rect.h; i++)
+  for(i = 0; i < height; i++)
     {
     ovl_ptr = (uint16_t*)ovl_ptr_start;
     dst_ptr_y = (uint16_t*)dst_ptr_y_start;
     dst_ptr_u = (uint16_t*)dst_ptr_u_start;
     dst_ptr_v = (uint16_t*)dst_ptr_v_start;
     
-    for(j = 0; j < ctx->ovl->src_rect.w; j++)
+    for(j = 0; j < width; j++)
       {
       alpha = ovl_ptr[3];
       /* Y0 */
@@ -2144,6 +2144,11 @@ gavl_find_blend_func_c(gavl_overlay_blend_context_t * ctx,
       *overlay_format = GAVL_RGBA_FLOAT;
       return blend_rgba_float;
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       return NULL;
     }
@@ -0,0 +1,197 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+
+#include <deinterlace.h>
+
+/*
+ *  Motion adaptive deinterlacing (similar to yadif, but only the
+ *  previous frame is used, so there is no delay).
+ *
+ *  The spatial prediction is the average of the lines above and below,
+ *  taken along the direction with the smallest differences. It is
+ *  then limited to the range around the temporal prediction (the
+ *  average of the missing line in the previous and current frame),
+ *  which is allowed by the detected motion.
+ */
+
+#define ABS(a) ((a) < 0 ? -(a) : (a))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN3(a, b, c) MIN(MIN(a, b), c)
+#define MAX3(a, b, c) MAX(MAX(a, b), c)
+
+/* Edge check along the direction j (in pixels) */
+
+#define SCORE(j)                                                        \
+  (ABS((ITYPE)c_m1[i + ((j)-1)*adv] - (ITYPE)c_p1[i - ((j)+1)*adv]) +  \
+   ABS((ITYPE)c_m1[i + (j)*adv]     - (ITYPE)c_p1[i - (j)*adv]) +      \
+   ABS((ITYPE)c_m1[i + ((j)+1)*adv] - (ITYPE)c_p1[i - ((j)-1)*adv]))
+
+#define CHECK(j)                                                        \
+  score = SCORE(j);                                                     \
+  if(score < spatial_score)                                             \
+    {                                                                   \
+    spatial_score = score;                                              \
+    spatial_pred = HALF((ITYPE)c_m1[i + (j)*adv] +                      \
+                        (ITYPE)c_p1[i - (j)*adv]);
+
+#define ADAPTIVE_FUNC_BODY(TYPE)                                        \
+  int i, adv;                                                           \
+  ITYPE c, e, d, b, f, diff, min, max, score;                           \
+  ITYPE spatial_pred, spatial_score;                                    \
+  const TYPE * c_m2 = (const TYPE *)cur[0];                             \
+  const TYPE * c_m1 = (const TYPE *)cur[1];                             \
+  const TYPE * c_0  = (const TYPE *)cur[2];                             \
+  const TYPE * c_p1 = (const TYPE *)cur[3];                             \
+  const TYPE * c_p2 = (const TYPE *)cur[4];                             \
+  const TYPE * p_m2 = NULL, * p_m1 = NULL, * p_0 = NULL;                \
+  const TYPE * p_p1 = NULL, * p_p2 = NULL;                              \
+  TYPE * dst = (TYPE *)dst1;                                            \
+                                                                        \
+  if(prev)                                                              \
+    {                                                                   \
+    p_m2 = (const TYPE *)prev[0];                                       \
+    p_m1 = (const TYPE *)prev[1];                                       \
+    p_0  = (const TYPE *)prev[2];                                       \
+    p_p1 = (const TYPE *)prev[3];                                       \
+    p_p2 = (const TYPE *)prev[4];                                       \
+    }                                                                   \
+                                                                        \
+  for(i = start; i < end; i++)                                          \
+    {                                                                   \
+    c = c_m1[i];                                                        \
+    e = c_p1[i];                                                        \
+    spatial_pred = HALF(c + e);                                         \
+    adv = ADVANCE(i);                                                   \
+                                                                        \
+    /* Pixels with enough neighbors for the edge check */               \
+    if((i >= 3 * adv) && (i < num - 3 * adv))                           \
+      {                                                                 \
+      spatial_score = SCORE(0) - BIAS;                                  \
+      CHECK(-1) CHECK(-2) } }                                           \
+      CHECK(1) CHECK(2) } }                                             \
+      }                                                                 \
+                                                                        \
+    if(prev)                                                            \
+      {                                                                 \
+      d = HALF((ITYPE)p_0[i] + (ITYPE)c_0[i]);                          \
+      diff = MAX(HALF(ABS((ITYPE)p_0[i] - (ITYPE)c_0[i])),              \
+                 HALF(ABS((ITYPE)p_m1[i] - c) + ABS((ITYPE)p_p1[i] - e))); \
+                                                                        \
+      b = HALF((ITYPE)p_m2[i] + (ITYPE)c_m2[i]);                        \
+      f = HALF((ITYPE)p_p2[i] + (ITYPE)c_p2[i]);                        \
+      max = MAX3(d - e, d - c, MIN(b - c, f - e));                      \
+      min = MIN3(d - e, d - c, MAX(b - c, f - e));                      \
+      diff = MAX3(diff, min, -max);                                     \
+                                                                        \
+      if(spatial_pred > d + diff)                                       \
+        spatial_pred = d + diff;                                        \
+      else if(spatial_pred < d - diff)                                  \
+        spatial_pred = d - diff;                                        \
+      }                                                                 \
+    dst[i] = spatial_pred;                                              \
+    }
+
+#define ITYPE int
+#define HALF(a) ((a) >> 1)
+#define BIAS 1
+#define ADVANCE(i) advance
+
+void gavl_deinterlace_adaptive_8_c(const uint8_t * const * prev,
+                                   const uint8_t * const * cur,
+                                   uint8_t * dst1,
+                                   int start, int end,
+                                   int num, int advance)
+  {
+  ADAPTIVE_FUNC_BODY(uint8_t)
+  }
+
+static void adaptive_16_c(const uint8_t * const * prev,
+                          const uint8_t * const * cur,
+                          uint8_t * dst1,
+                          int start, int end,
+                          int num, int advance)
+  {
+  ADAPTIVE_FUNC_BODY(uint16_t)
+  }
+
+/* Packed 4:2:2: advance is the distance of the luma samples, the
+   chroma samples of the same component are twice as far apart */
+
+#undef ADVANCE
+#define ADVANCE(i) (((i) & 1) ? 2 * advance : advance)
+
+void gavl_deinterlace_adaptive_yuy2_c(const uint8_t * const * prev,
+                                      const uint8_t * const * cur,
+                                      uint8_t * dst1,
+                                      int start, int end,
+                                      int num, int advance)
+  {
+  ADAPTIVE_FUNC_BODY(uint8_t)
+  }
+
+#undef ADVANCE
+#define ADVANCE(i) (((i) & 1) ? advance : 2 * advance)
+
+void gavl_deinterlace_adaptive_uyvy_c(const uint8_t * const * prev,
+                                      const uint8_t * const * cur,
+                                      uint8_t * dst1,
+                                      int start, int end,
+                                      int num, int advance)
+  {
+  ADAPTIVE_FUNC_BODY(uint8_t)
+  }
+
+#undef ADVANCE
+#define ADVANCE(i) advance
+
+#undef ITYPE
+#undef HALF
+#undef BIAS
+
+#define ITYPE float
+#define HALF(a) ((a) * 0.5f)
+#define BIAS 0.0f
+
+static void adaptive_float_c(const uint8_t * const * prev,
+                             const uint8_t * const * cur,
+                             uint8_t * dst1,
+                             int start, int end,
+                             int num, int advance)
+  {
+  ADAPTIVE_FUNC_BODY(float)
+  }
+
+void
+gavl_find_deinterlacer_adaptive_funcs_c(gavl_video_deinterlace_adaptive_func_table_t * tab,
+                                        const gavl_video_options_t * opt,
+                                        const gavl_video_format_t * format)
+  {
+  tab->func_8     = gavl_deinterlace_adaptive_8_c;
+  tab->func_yuy2  = gavl_deinterlace_adaptive_yuy2_c;
+  tab->func_uyvy  = gavl_deinterlace_adaptive_uyvy_c;
+  tab->func_16    = adaptive_16_c;
+  tab->func_float = adaptive_float_c;
+  }
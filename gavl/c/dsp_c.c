@@ -540,7 +540,7 @@ static void add_s32_c(const void * _src1, const void * _src2,
 
   while(--i)
     {
-    tmp = *(src1++) + *(src2++);
+    tmp = (int64_t)*(src1++) + *(src2++);
     *(dst++) = GENERIC_CLIP(tmp,-2147483648LL,2147483647LL);
     }
   }
@@ -668,7 +668,7 @@ static void sub_u16_s_c(const void * _src1, const void * _src2,
 
   while(--i)
     {
-    tmp = *(src1++) + *(src2++);
+    tmp = *(src1++) - *(src2++);
     *(dst++) = GENERIC_CLIP(tmp,-32768,32767) + 32768;
     }
   }
@@ -684,7 +684,7 @@ static void sub_s32_c(const void * _src1, const void * _src2,
 
   while(--i)
     {
-    tmp = *(src1++) - *(src2++);
+    tmp = (int64_t)*(src1++) - *(src2++);
     *(dst++) = GENERIC_CLIP(tmp,-2147483648LL,2147483647LL);
     }
   }
@@ -0,0 +1,69 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <gavl/gavl.h>
+#include <video.h>
+
+#include <metrics.h>
+
+static uint64_t sse_8_c(const uint8_t * src1, const uint8_t * src2, int num)
+  {
+  int i, diff;
+  uint64_t ret = 0;
+  for(i = 0; i < num; i++)
+    {
+    diff = (int)src1[i] - (int)src2[i];
+    ret += diff * diff;
+    }
+  return ret;
+  }
+
+static uint64_t sse_16_c(const uint16_t * src1, const uint16_t * src2, int num)
+  {
+  int i;
+  int64_t diff;
+  uint64_t ret = 0;
+  for(i = 0; i < num; i++)
+    {
+    diff = (int64_t)src1[i] - (int64_t)src2[i];
+    ret += diff * diff;
+    }
+  return ret;
+  }
+
+static double sse_float_c(const float * src1, const float * src2, int num)
+  {
+  int i;
+  double diff;
+  double ret = 0.0;
+  for(i = 0; i < num; i++)
+    {
+    diff = src1[i] - src2[i];
+    ret += diff * diff;
+    }
+  return ret;
+  }
+
+void gavl_init_metrics_funcs_c(gavl_metrics_funcs_t * funcs)
+  {
+  funcs->sse_8     = sse_8_c;
+  funcs->sse_16    = sse_16_c;
+  funcs->sse_float = sse_float_c;
+  }
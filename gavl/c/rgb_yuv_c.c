@@ -3283,7 +3283,7 @@ RGB_24_TO_Y_8(BGR16_TO_R_8(src[3]), \
 #define OUT_ADVANCE 3
 #define NUM_PIXELS  1
 #define CONVERT     \
-    RGB_48_TO_YUV_FLOAT(src[0],src[1],src[2],dst[0],dst[1],dst[3])
+    RGB_48_TO_YUV_FLOAT(src[0],src[1],src[2],dst[0],dst[1],dst[2])
 
 
 #include "../csp_packed_packed.h"
@@ -3359,6 +3359,155 @@ RGB_24_TO_Y_8(BGR16_TO_R_8(src[3]), \
 
 #endif // !HQ
 
+/*
+ * 16 bit RGB -> 16 bit 4:2:0. For P016 the chroma plane is
+ * interleaved, so dst_u[0] is Cb and dst_u[1] is Cr.
+ */
+
+#ifndef HQ
+
+/* rgb_48_to_yuv_420_p_16_c */
+
+#define FUNC_NAME      rgb_48_to_yuv_420_p_16_c
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     6
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_48_TO_YUV_16(src[0],src[1],src[2], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGB_48_TO_Y_16(src[3],src[4],src[5],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_48_TO_Y_16(src[0],src[1],src[2],dst_y[0]) \
+    RGB_48_TO_Y_16(src[3],src[4],src[5],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+/* rgb_48_to_p016_c */
+
+#define FUNC_NAME      rgb_48_to_p016_c
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     6
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_48_TO_YUV_16(src[0],src[1],src[2], \
+               dst_y[0],dst_u[0],dst_u[1]) \
+    RGB_48_TO_Y_16(src[3],src[4],src[5],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_48_TO_Y_16(src[0],src[1],src[2],dst_y[0]) \
+    RGB_48_TO_Y_16(src[3],src[4],src[5],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+/* rgba_64_to_yuv_420_p_16_c */
+
+#define FUNC_NAME      rgba_64_to_yuv_420_p_16_c
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     8
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGBA_64_TO_YUV_16(src[0],src[1],src[2],src[3], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGBA_64_TO_Y_16(src[4],src[5],src[6],src[7],dst_y[1])
+
+#define CONVERT_Y      \
+    RGBA_64_TO_Y_16(src[0],src[1],src[2],src[3],dst_y[0]) \
+    RGBA_64_TO_Y_16(src[4],src[5],src[6],src[7],dst_y[1])
+#define INIT   INIT_RGBA_64 \
+  uint16_t r_tmp;                                                       \
+  uint16_t g_tmp;                                                       \
+  uint16_t b_tmp;
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+/* rgba_64_to_p016_c */
+
+#define FUNC_NAME      rgba_64_to_p016_c
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     8
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGBA_64_TO_YUV_16(src[0],src[1],src[2],src[3], \
+               dst_y[0],dst_u[0],dst_u[1]) \
+    RGBA_64_TO_Y_16(src[4],src[5],src[6],src[7],dst_y[1])
+
+#define CONVERT_Y      \
+    RGBA_64_TO_Y_16(src[0],src[1],src[2],src[3],dst_y[0]) \
+    RGBA_64_TO_Y_16(src[4],src[5],src[6],src[7],dst_y[1])
+#define INIT   INIT_RGBA_64 \
+  uint16_t r_tmp;                                                       \
+  uint16_t g_tmp;                                                       \
+  uint16_t b_tmp;
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+/* rgba_64_to_yuv_420_p_16_ia_c */
+
+#define FUNC_NAME      rgba_64_to_yuv_420_p_16_ia_c
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     8
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_48_TO_YUV_16(src[0],src[1],src[2], \
+               dst_y[0],*dst_u,*dst_v) \
+    RGB_48_TO_Y_16(src[4],src[5],src[6],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_48_TO_Y_16(src[0],src[1],src[2],dst_y[0]) \
+    RGB_48_TO_Y_16(src[4],src[5],src[6],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+/* rgba_64_to_p016_ia_c */
+
+#define FUNC_NAME      rgba_64_to_p016_ia_c
+#define IN_TYPE        uint16_t
+#define OUT_TYPE       uint16_t
+#define IN_ADVANCE     8
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CONVERT_YUV    \
+    RGB_48_TO_YUV_16(src[0],src[1],src[2], \
+               dst_y[0],dst_u[0],dst_u[1]) \
+    RGB_48_TO_Y_16(src[4],src[5],src[6],dst_y[1])
+
+#define CONVERT_Y      \
+    RGB_48_TO_Y_16(src[0],src[1],src[2],dst_y[0]) \
+    RGB_48_TO_Y_16(src[4],src[5],src[6],dst_y[1])
+
+#define CHROMA_SUB     2
+
+#include "../csp_packed_planar.h"
+
+#endif // !HQ
+
 /* rgba_64_to_yuv_411_p_ia_c */
 
 #define FUNC_NAME      rgba_64_to_yuv_411_p_ia_c
@@ -5175,6 +5324,8 @@ void gavl_init_rgb_yuv_funcs_c(gavl_pixelformat_function_table_t * tab, const ga
   tab->rgb_48_to_yuvj_444_p = rgb_48_to_yuvj_444_p_c;
 #ifndef HQ
   tab->rgb_48_to_yuv_422_p_16 = rgb_48_to_yuv_422_p_16_c;
+  tab->rgb_48_to_yuv_420_p_16 = rgb_48_to_yuv_420_p_16_c;
+  tab->rgb_48_to_p016 = rgb_48_to_p016_c;
   tab->rgb_48_to_yuv_444_p_16 = rgb_48_to_yuv_444_p_16_c;
   tab->rgb_48_to_yuva_64 = rgb_48_to_yuva_64_c;
   tab->rgb_48_to_yuva_float = rgb_48_to_yuva_float_c;
@@ -5287,6 +5438,8 @@ void gavl_init_rgb_yuv_funcs_c(gavl_pixelformat_function_table_t * tab, const ga
     tab->rgba_64_to_yuvj_444_p = rgba_64_to_yuvj_444_p_c;
 #ifndef HQ
     tab->rgba_64_to_yuv_422_p_16 = rgba_64_to_yuv_422_p_16_c;
+    tab->rgba_64_to_yuv_420_p_16 = rgba_64_to_yuv_420_p_16_c;
+    tab->rgba_64_to_p016 = rgba_64_to_p016_c;
     tab->rgba_64_to_yuv_444_p_16 = rgba_64_to_yuv_444_p_16_c;
     tab->rgba_64_to_yuv_float  = rgba_64_to_yuv_float_c;
 #endif // HQ
@@ -5341,6 +5494,8 @@ void gavl_init_rgb_yuv_funcs_c(gavl_pixelformat_function_table_t * tab, const ga
 #ifndef HQ
     tab->rgba_64_to_yuv_float = rgba_64_to_yuv_float_ia_c;
     tab->rgba_64_to_yuv_422_p_16 = rgba_64_to_yuv_422_p_16_ia_c;
+    tab->rgba_64_to_yuv_420_p_16 = rgba_64_to_yuv_420_p_16_ia_c;
+    tab->rgba_64_to_p016 = rgba_64_to_p016_ia_c;
     tab->rgba_64_to_yuv_444_p_16 = rgba_64_to_yuv_444_p_16_ia_c;
 #endif // HQ
     tab->rgba_float_to_yuv_float = rgba_float_to_yuv_float_ia_c;
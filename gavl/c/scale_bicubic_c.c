@@ -694,7 +694,7 @@
   dst[1] = tmp; \
   tmp = (fac_1 * src_1[2] + \
          fac_2 * src_2[2] + \
-         fac_3 * src_2[2] + \
+         fac_3 * src_3[2] + \
          fac_4 * src_4[2]); \
   tmp=DOWNSHIFT(tmp,16);\
   RECLIP_V(tmp, 2);                              \
@@ -0,0 +1,213 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+
+#include <stdio.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+/* Box filter (area averaging) for integer downscaling ratios. The tables
+   contain equal weights, so we just sum up the source pixels and divide
+   with rounding. The sums are exact, so no integer coefficients are needed */
+
+#define FUNC_NAME scale_uint8_x_1_xy_box_c
+#define TYPE uint8_t
+#define INIT int tmp[1]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0;
+#define SCALE_ACCUM tmp[0] += src[0];
+#define SCALE_FINISH dst[0] = (tmp[0] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint8_x_2_xy_box_c
+#define TYPE uint8_t
+#define INIT int tmp[2]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1];
+#define SCALE_FINISH \
+  dst[0] = (tmp[0] + round) / num; \
+  dst[1] = (tmp[1] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint8_x_3_xy_box_c
+#define TYPE uint8_t
+#define INIT int tmp[3]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0; tmp[2] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1]; \
+  tmp[2] += src[2];
+#define SCALE_FINISH \
+  dst[0] = (tmp[0] + round) / num; \
+  dst[1] = (tmp[1] + round) / num; \
+  dst[2] = (tmp[2] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint8_x_4_xy_box_c
+#define TYPE uint8_t
+#define INIT int tmp[4]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0; tmp[2] = 0; tmp[3] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1]; \
+  tmp[2] += src[2]; \
+  tmp[3] += src[3];
+#define SCALE_FINISH \
+  dst[0] = (tmp[0] + round) / num; \
+  dst[1] = (tmp[1] + round) / num; \
+  dst[2] = (tmp[2] + round) / num; \
+  dst[3] = (tmp[3] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint16_x_1_xy_box_c
+#define TYPE uint16_t
+#define INIT int64_t tmp[1]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0;
+#define SCALE_ACCUM tmp[0] += src[0];
+#define SCALE_FINISH dst[0] = (tmp[0] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint16_x_2_xy_box_c
+#define TYPE uint16_t
+#define INIT int64_t tmp[2]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1];
+#define SCALE_FINISH \
+  dst[0] = (tmp[0] + round) / num; \
+  dst[1] = (tmp[1] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint16_x_3_xy_box_c
+#define TYPE uint16_t
+#define INIT int64_t tmp[3]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0; tmp[2] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1]; \
+  tmp[2] += src[2];
+#define SCALE_FINISH \
+  dst[0] = (tmp[0] + round) / num; \
+  dst[1] = (tmp[1] + round) / num; \
+  dst[2] = (tmp[2] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_uint16_x_4_xy_box_c
+#define TYPE uint16_t
+#define INIT int64_t tmp[4]; int round = num / 2;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0; tmp[2] = 0; tmp[3] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1]; \
+  tmp[2] += src[2]; \
+  tmp[3] += src[3];
+#define SCALE_FINISH \
+  dst[0] = (tmp[0] + round) / num; \
+  dst[1] = (tmp[1] + round) / num; \
+  dst[2] = (tmp[2] + round) / num; \
+  dst[3] = (tmp[3] + round) / num;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_float_x_1_xy_box_c
+#define TYPE float
+#define INIT float tmp[1]; float fac = 1.0 / num;
+#define SCALE_INIT tmp[0] = 0;
+#define SCALE_ACCUM tmp[0] += src[0];
+#define SCALE_FINISH dst[0] = tmp[0] * fac;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_float_x_2_xy_box_c
+#define TYPE float
+#define INIT float tmp[2]; float fac = 1.0 / num;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1];
+#define SCALE_FINISH \
+  dst[0] = tmp[0] * fac; \
+  dst[1] = tmp[1] * fac;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_float_x_3_xy_box_c
+#define TYPE float
+#define INIT float tmp[3]; float fac = 1.0 / num;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0; tmp[2] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1]; \
+  tmp[2] += src[2];
+#define SCALE_FINISH \
+  dst[0] = tmp[0] * fac; \
+  dst[1] = tmp[1] * fac; \
+  dst[2] = tmp[2] * fac;
+
+#include "scale_box.h"
+
+#define FUNC_NAME scale_float_x_4_xy_box_c
+#define TYPE float
+#define INIT float tmp[4]; float fac = 1.0 / num;
+#define SCALE_INIT tmp[0] = 0; tmp[1] = 0; tmp[2] = 0; tmp[3] = 0;
+#define SCALE_ACCUM \
+  tmp[0] += src[0]; \
+  tmp[1] += src[1]; \
+  tmp[2] += src[2]; \
+  tmp[3] += src[3];
+#define SCALE_FINISH \
+  dst[0] = tmp[0] * fac; \
+  dst[1] = tmp[1] * fac; \
+  dst[2] = tmp[2] * fac; \
+  dst[3] = tmp[3] * fac;
+
+#include "scale_box.h"
+
+void gavl_init_scale_funcs_box_c(gavl_scale_funcs_t * tab)
+  {
+  tab->funcs_xy.scale_uint8_x_1_advance   = scale_uint8_x_1_xy_box_c;
+  tab->funcs_xy.scale_uint8_x_1_noadvance = scale_uint8_x_1_xy_box_c;
+  tab->funcs_xy.scale_uint8_x_2  = scale_uint8_x_2_xy_box_c;
+  tab->funcs_xy.scale_uint8_x_3  = scale_uint8_x_3_xy_box_c;
+  tab->funcs_xy.scale_uint8_x_4  = scale_uint8_x_4_xy_box_c;
+  tab->funcs_xy.scale_uint16_x_1 = scale_uint16_x_1_xy_box_c;
+  tab->funcs_xy.scale_uint16_x_2 = scale_uint16_x_2_xy_box_c;
+  tab->funcs_xy.scale_uint16_x_3 = scale_uint16_x_3_xy_box_c;
+  tab->funcs_xy.scale_uint16_x_4 = scale_uint16_x_4_xy_box_c;
+  tab->funcs_xy.scale_float_x_1  = scale_float_x_1_xy_box_c;
+  tab->funcs_xy.scale_float_x_2  = scale_float_x_2_xy_box_c;
+  tab->funcs_xy.scale_float_x_3  = scale_float_x_3_xy_box_c;
+  tab->funcs_xy.scale_float_x_4  = scale_float_x_4_xy_box_c;
+
+  tab->funcs_xy.bits_uint8_advance   = 0;
+  tab->funcs_xy.bits_uint8_noadvance = 0;
+  tab->funcs_xy.bits_uint16          = 0;
+  }
@@ -476,7 +476,7 @@
   dst[1] = DOWNSHIFT(tmp, 16); \
   tmp = fac_1 * src_1[2] + \
         fac_2 * src_2[2] + \
-        fac_3 * src_2[2]; \
+        fac_3 * src_3[2]; \
   dst[2] = DOWNSHIFT(tmp, 16); \
   tmp = fac_1 * src_1[3] + \
         fac_2 * src_2[3] + \
@@ -0,0 +1,164 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+
+#include <stdio.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+#include "scale_macros.h"
+
+/*
+ *  Sliding window box filter for convolution in x-direction.
+ *  The sum of the 2*radius+1 taps is updated by adding the pixel
+ *  entering the window and subtracting the one leaving it, so the
+ *  costs don't depend on the radius. Pixels outside the image are
+ *  replaced by the border pixels, as done by the scale table.
+ */
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+/* Factor of the taps, taken from a pixel not touching the borders */
+
+static float get_factor(const gavl_video_scale_context_t * ctx)
+  {
+  return ctx->table_h.pixels[ctx->table_h.factors_per_pixel/2].factor_f[0];
+  }
+
+/*
+ *  Template for one data type. The window sums are kept in ACCUM.
+ *  FINISH converts sum[c] to the output value dst[c].
+ */
+
+#define SLIDE_FUNC_BODY(TYPE, ACCUM, INIT, FINISH)                      \
+  int i, c, in, out;                                                    \
+  ACCUM sum[4];                                                         \
+  TYPE * dst;                                                           \
+  int width  = ctx->dst_size;                                           \
+  int radius = ctx->table_h.factors_per_pixel / 2;                      \
+  int advance = ctx->offset->src_advance;                               \
+  float fac = get_factor(ctx);                                          \
+  uint8_t * src = ctx->src + scanline * ctx->src_stride +               \
+    ctx->table_h.pixels[0].index * advance;                             \
+                                                                        \
+  INIT                                                                  \
+                                                                        \
+  /* Initial window, the left border pixel is repeated */               \
+  for(c = 0; c < num_comp; c++)                                         \
+    {                                                                   \
+    sum[c] = (radius + 1) * (ACCUM)((TYPE*)src)[c];                     \
+    for(i = 1; i <= radius; i++)                                        \
+      sum[c] += ((TYPE*)(src + MIN(i, width - 1) * advance))[c];        \
+    }                                                                   \
+                                                                        \
+  for(i = 0; i < width; i++)                                            \
+    {                                                                   \
+    dst = (TYPE*)dest_start;                                            \
+    for(c = 0; c < num_comp; c++)                                       \
+      {                                                                 \
+      FINISH                                                            \
+      }                                                                 \
+    dest_start += ctx->offset->dst_advance;                             \
+                                                                        \
+    in  = MIN(i + radius + 1, width - 1) * advance;                     \
+    out = MAX(i - radius, 0) * advance;                                 \
+    for(c = 0; c < num_comp; c++)                                       \
+      sum[c] += (ACCUM)((TYPE*)(src + in))[c] - (ACCUM)((TYPE*)(src + out))[c]; \
+    }
+
+/* Integers: 32 bit fixed point factor, 16 bits are too few for long
+   kernels on 16 bit data */
+
+#define INIT_INT   int64_t tmp, fac_i = (int64_t)(fac * 4294967296.0 + 0.5);
+
+#define FINISH_INT                                      \
+  tmp = (sum[c] * fac_i + 0x80000000LL) >> 32;          \
+  RECLIP_H(tmp, single ? ctx->plane : c);               \
+  dst[c] = tmp;
+
+#define INIT_FLOAT float tmp;
+
+#define FINISH_FLOAT                                    \
+  tmp = sum[c] * fac;                                   \
+  RECLIP_FLOAT(tmp, single ? ctx->plane : c);           \
+  dst[c] = tmp;
+
+static inline void slide_uint8(gavl_video_scale_context_t * ctx, int scanline,
+                               uint8_t * dest_start, int num_comp, int single)
+  {
+  SLIDE_FUNC_BODY(uint8_t, int, INIT_INT, FINISH_INT)
+  }
+
+static inline void slide_uint16(gavl_video_scale_context_t * ctx, int scanline,
+                                uint8_t * dest_start, int num_comp, int single)
+  {
+  SLIDE_FUNC_BODY(uint16_t, int, INIT_INT, FINISH_INT)
+  }
+
+/* Double sums, float would accumulate rounding errors along the line */
+
+static inline void slide_float(gavl_video_scale_context_t * ctx, int scanline,
+                               uint8_t * dest_start, int num_comp, int single)
+  {
+  SLIDE_FUNC_BODY(float, double, INIT_FLOAT, FINISH_FLOAT)
+  }
+
+#define SLIDE_FUNC(name, func, num_comp, single)                        \
+static void name(gavl_video_scale_context_t * ctx, int scanline, uint8_t * dst) \
+  {                                                                     \
+  func(ctx, scanline, dst, num_comp, single);                           \
+  }
+
+SLIDE_FUNC(scale_uint8_x_1_x_slide_c,  slide_uint8,  1, 1)
+SLIDE_FUNC(scale_uint8_x_2_x_slide_c,  slide_uint8,  2, 0)
+SLIDE_FUNC(scale_uint8_x_3_x_slide_c,  slide_uint8,  3, 0)
+SLIDE_FUNC(scale_uint8_x_4_x_slide_c,  slide_uint8,  4, 0)
+SLIDE_FUNC(scale_uint16_x_1_x_slide_c, slide_uint16, 1, 1)
+SLIDE_FUNC(scale_uint16_x_2_x_slide_c, slide_uint16, 2, 0)
+SLIDE_FUNC(scale_uint16_x_3_x_slide_c, slide_uint16, 3, 0)
+SLIDE_FUNC(scale_uint16_x_4_x_slide_c, slide_uint16, 4, 0)
+SLIDE_FUNC(scale_float_x_1_x_slide_c,  slide_float,  1, 1)
+SLIDE_FUNC(scale_float_x_2_x_slide_c,  slide_float,  2, 0)
+SLIDE_FUNC(scale_float_x_3_x_slide_c,  slide_float,  3, 0)
+SLIDE_FUNC(scale_float_x_4_x_slide_c,  slide_float,  4, 0)
+
+void gavl_init_scale_funcs_slide_x_c(gavl_scale_funcs_t * tab)
+  {
+  tab->funcs_x.scale_uint8_x_1_advance   = scale_uint8_x_1_x_slide_c;
+  tab->funcs_x.scale_uint8_x_1_noadvance = scale_uint8_x_1_x_slide_c;
+  tab->funcs_x.scale_uint8_x_2  = scale_uint8_x_2_x_slide_c;
+  tab->funcs_x.scale_uint8_x_3  = scale_uint8_x_3_x_slide_c;
+  tab->funcs_x.scale_uint8_x_4  = scale_uint8_x_4_x_slide_c;
+  tab->funcs_x.scale_uint16_x_1 = scale_uint16_x_1_x_slide_c;
+  tab->funcs_x.scale_uint16_x_2 = scale_uint16_x_2_x_slide_c;
+  tab->funcs_x.scale_uint16_x_3 = scale_uint16_x_3_x_slide_c;
+  tab->funcs_x.scale_uint16_x_4 = scale_uint16_x_4_x_slide_c;
+  tab->funcs_x.scale_float_x_1  = scale_float_x_1_x_slide_c;
+  tab->funcs_x.scale_float_x_2  = scale_float_x_2_x_slide_c;
+  tab->funcs_x.scale_float_x_3  = scale_float_x_3_x_slide_c;
+  tab->funcs_x.scale_float_x_4  = scale_float_x_4_x_slide_c;
+
+  tab->funcs_x.bits_uint8_advance   = 0;
+  tab->funcs_x.bits_uint8_noadvance = 0;
+  tab->funcs_x.bits_uint16          = 0;
+  }
@@ -0,0 +1,97 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <gavl/gavl.h>
+#include <video.h>
+
+#include <ssim.h>
+
+static void filter_h_c(const float * src, float * dst,
+                       const float * coeffs, int taps, int num)
+  {
+  int i, t;
+  float sum;
+  
+  for(i = 0; i < num; i++)
+    {
+    sum = 0.0f;
+    for(t = 0; t < taps; t++)
+      sum += coeffs[t] * src[i + t];
+    dst[i] = sum;
+    }
+  }
+
+static void filter_v_c(const float * const * src, float * dst,
+                       const float * coeffs, int taps, int num)
+  {
+  int i, t;
+  float sum;
+  
+  for(i = 0; i < num; i++)
+    {
+    sum = 0.0f;
+    for(t = 0; t < taps; t++)
+      sum += coeffs[t] * src[t][i];
+    dst[i] = sum;
+    }
+  }
+
+/* Wang, eq. 13 with sigma_x^2 = E(x*x) - mu_x^2 etc. */
+
+static double ssim_c(const float * const * mom, float * map, int num,
+                     float c1, float c2, double * cs)
+  {
+  int i;
+  float mu_x, mu_y, sigma_xy, sigma_xx, sigma_yy, ssim;
+  double ret = 0.0;
+  double cs_sum = 0.0;
+  
+  for(i = 0; i < num; i++)
+    {
+    sigma_xy = mom[4][i] - mom[0][i] * mom[1][i];
+    sigma_xx = mom[2][i] - mom[0][i] * mom[0][i];
+    sigma_yy = mom[3][i] - mom[1][i] * mom[1][i];
+
+    /* Undo the shift */
+    mu_x = mom[0][i] + 0.5f;
+    mu_y = mom[1][i] + 0.5f;
+    
+    ssim = ((2.0f * mu_x * mu_y + c1) * (2.0f * sigma_xy + c2)) /
+      ((mu_x * mu_x + mu_y * mu_y + c1) * (sigma_xx + sigma_yy + c2));
+    
+    if(map)
+      map[i] = ssim;
+    ret += ssim;
+
+    if(cs)
+      cs_sum += (2.0f * sigma_xy + c2) / (sigma_xx + sigma_yy + c2);
+    }
+  if(cs)
+    *cs = cs_sum;
+  return ret;
+  }
+
+void gavl_init_ssim_funcs_c(gavl_ssim_funcs_t * funcs)
+  {
+  funcs->filter_h = filter_h_c;
+  funcs->filter_v = filter_v_c;
+  funcs->ssim     = ssim_c;
+  }
@@ -20,7 +20,7 @@
 
 
 
-static void (FUNC_NAME)(gavl_transform_context_t * ctx, gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+static void (FUNC_NAME)(gavl_transform_context_t * ctx, gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
 
@@ -44,7 +44,7 @@ static void (FUNC_NAME)(gavl_transform_context_t * ctx, gavl_transform_pixel_t *
 
   pixel = pixels;    
 
-  i = ctx->dst_width+1;
+  i = num_pixels+1;
   
   while(--i)
     {
@@ -26,7 +26,7 @@
 #include <transform.h>
 
 #define TRANSFORM_FUNC_HEAD \
-  for(i = 0; i < ctx->dst_width; i++)       \
+  for(i = 0; i < num_pixels; i++)       \
     {
 
 #define TRANSFORM_FUNC_TAIL \
@@ -34,7 +34,7 @@
     }
 
 static void transform_rgb_16_nearest_c(gavl_transform_context_t * ctx,
-                                       gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                                       gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   uint16_t * src, *dst;
@@ -53,7 +53,7 @@ static void transform_rgb_16_nearest_c(gavl_transform_context_t * ctx,
   }
 
 static void transform_uint8_x_1_nearest_c(gavl_transform_context_t * ctx,
-                                          gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                                          gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   uint8_t * src, *dst;
@@ -72,7 +72,7 @@ static void transform_uint8_x_1_nearest_c(gavl_transform_context_t * ctx,
   }
 
 static void transform_uint8_x_3_nearest_c(gavl_transform_context_t * ctx,
-                                          gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                                          gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   uint8_t * src, *dst;
@@ -93,7 +93,7 @@ static void transform_uint8_x_3_nearest_c(gavl_transform_context_t * ctx,
   }
 
 static void transform_uint8_x_4_nearest_c(gavl_transform_context_t * ctx,
-                                          gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                                          gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   uint32_t * src, *dst;
@@ -112,7 +112,7 @@ static void transform_uint8_x_4_nearest_c(gavl_transform_context_t * ctx,
   }
 
 static void transform_uint16_x_3_nearest_c(gavl_transform_context_t * ctx,
-                                           gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                                           gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   uint16_t * src, *dst;
@@ -133,7 +133,7 @@ static void transform_uint16_x_3_nearest_c(gavl_transform_context_t * ctx,
   }
 
 static void transform_uint16_x_4_nearest_c(gavl_transform_context_t * ctx,
-                                           gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                                           gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   uint64_t * src, *dst;
@@ -153,7 +153,7 @@ static void transform_uint16_x_4_nearest_c(gavl_transform_context_t * ctx,
 
 static void
 transform_float_x_1_nearest_c(gavl_transform_context_t *
-                              ctx, gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                              ctx, gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   float * src, *dst;
@@ -173,7 +173,7 @@ transform_float_x_1_nearest_c(gavl_transform_context_t *
 
 static void
 transform_float_x_2_nearest_c(gavl_transform_context_t * ctx,
-                              gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                              gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   float * src, *dst;
@@ -194,7 +194,7 @@ transform_float_x_2_nearest_c(gavl_transform_context_t * ctx,
 
 static void
 transform_float_x_3_nearest_c(gavl_transform_context_t * ctx,
-                              gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                              gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   float * src, *dst;
@@ -216,7 +216,7 @@ transform_float_x_3_nearest_c(gavl_transform_context_t * ctx,
 
 static void
 transform_float_x_4_nearest_c(gavl_transform_context_t * ctx,
-                              gavl_transform_pixel_t * pixels, uint8_t * dest_start)
+                              gavl_transform_pixel_t * pixels, int num_pixels, uint8_t * dest_start)
   {
   int i;
   float * src, *dst;
@@ -1638,6 +1638,87 @@
 
 #include "../csp_planar_packed.h"
 
+/*
+ * 16 bit 4:2:0 -> 16 bit RGB. For P016 the chroma plane is
+ * interleaved, so src_u[0] is Cb and src_u[1] is Cr.
+ */
+
+/* yuv_420_p_16_to_rgb_48_c */
+
+#define FUNC_NAME yuv_420_p_16_to_rgb_48_c
+#define IN_TYPE uint16_t
+#define OUT_TYPE uint16_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 1
+#define OUT_ADVANCE   6
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_16_TO_RGB_48(src_y[0], src_u[0], src_v[0], dst[0], dst[1], dst[2])\
+  YUV_16_TO_RGB_48(src_y[1], src_u[0], src_v[0], dst[3], dst[4], dst[5])
+
+#define INIT   int64_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_16_to_rgba_64_c */
+
+#define FUNC_NAME yuv_420_p_16_to_rgba_64_c
+#define IN_TYPE uint16_t
+#define OUT_TYPE uint16_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 1
+#define OUT_ADVANCE   8
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_16_TO_RGB_48(src_y[0], src_u[0], src_v[0], dst[0], dst[1], dst[2]) \
+  dst[3] = 0xffff;\
+  YUV_16_TO_RGB_48(src_y[1], src_u[0], src_v[0], dst[4], dst[5], dst[6]) \
+  dst[7] = 0xffff;
+
+#define INIT   int64_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+/* p016_to_rgb_48_c */
+
+#define FUNC_NAME p016_to_rgb_48_c
+#define IN_TYPE uint16_t
+#define OUT_TYPE uint16_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   6
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_16_TO_RGB_48(src_y[0], src_u[0], src_u[1], dst[0], dst[1], dst[2])\
+  YUV_16_TO_RGB_48(src_y[1], src_u[0], src_u[1], dst[3], dst[4], dst[5])
+
+#define INIT   int64_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
+/* p016_to_rgba_64_c */
+
+#define FUNC_NAME p016_to_rgba_64_c
+#define IN_TYPE uint16_t
+#define OUT_TYPE uint16_t
+#define IN_ADVANCE_Y  2
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   8
+#define NUM_PIXELS    2
+#define CHROMA_SUB    2
+#define CONVERT \
+  YUV_16_TO_RGB_48(src_y[0], src_u[0], src_u[1], dst[0], dst[1], dst[2]) \
+  dst[3] = 0xffff;\
+  YUV_16_TO_RGB_48(src_y[1], src_u[0], src_u[1], dst[4], dst[5], dst[6]) \
+  dst[7] = 0xffff;
+
+#define INIT   int64_t i_tmp;
+
+#include "../csp_planar_packed.h"
+
 /* yuv_422_p_16_to_rgba_float_c */
 
 #define FUNC_NAME yuv_422_p_16_to_rgba_float_c
@@ -5254,6 +5335,11 @@ void gavl_init_yuv_rgb_funcs_c(gavl_pixelformat_function_table_t * tab, const ga
   tab->yuv_422_p_16_to_rgba_64 = yuv_422_p_16_to_rgba_64_c;
   tab->yuv_422_p_16_to_rgba_float = yuv_422_p_16_to_rgba_float_c;
 
+  tab->yuv_420_p_16_to_rgb_48 = yuv_420_p_16_to_rgb_48_c;
+  tab->yuv_420_p_16_to_rgba_64 = yuv_420_p_16_to_rgba_64_c;
+  tab->p016_to_rgb_48 = p016_to_rgb_48_c;
+  tab->p016_to_rgba_64 = p016_to_rgba_64_c;
+
   tab->yuv_411_p_to_rgb_15 = yuv_411_p_to_rgb_15_c;
   tab->yuv_411_p_to_bgr_15 = yuv_411_p_to_bgr_15_c;
   tab->yuv_411_p_to_rgb_16 = yuv_411_p_to_rgb_16_c;
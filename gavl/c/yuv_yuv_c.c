@@ -269,6 +269,130 @@ static void yuv_411_p_to_yuv_410_p_generic(gavl_video_convert_context_t * ctx)
 
 
 
+/*
+ *  Semiplanar (NV12, NV21, NV16) <-> Planar. The luma plane is
+ *  identical, the chroma plane is interleaved (NV21 has V first).
+ */
+
+static void semiplanar_to_planar(gavl_video_convert_context_t * ctx,
+                                 int sub_v, int u_off)
+  {
+  int i, j;
+  uint8_t * src;
+  uint8_t * dst_u;
+  uint8_t * dst_v;
+  int y_size =
+    ctx->input_frame->strides[0] < ctx->output_frame->strides[0] ?
+    ctx->input_frame->strides[0] : ctx->output_frame->strides[0];
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + sub_v - 1) / sub_v;
+  
+  uint8_t * src_y = ctx->input_frame->planes[0];
+  uint8_t * src_uv = ctx->input_frame->planes[1];
+  uint8_t * dst_y = ctx->output_frame->planes[0];
+  uint8_t * dst_u_row = ctx->output_frame->planes[1];
+  uint8_t * dst_v_row = ctx->output_frame->planes[2];
+  
+  for(i = 0; i < ctx->input_format.image_height; i++)
+    {
+    gavl_memcpy(dst_y, src_y, y_size);
+    dst_y += ctx->output_frame->strides[0];
+    src_y += ctx->input_frame->strides[0];
+    }
+  
+  for(i = 0; i < uv_height; i++)
+    {
+    src = src_uv;
+    dst_u = dst_u_row;
+    dst_v = dst_v_row;
+    
+    for(j = 0; j < uv_width; j++)
+      {
+      *(dst_u++) = src[u_off];
+      *(dst_v++) = src[1-u_off];
+      src += 2;
+      }
+    src_uv += ctx->input_frame->strides[1];
+    dst_u_row += ctx->output_frame->strides[1];
+    dst_v_row += ctx->output_frame->strides[2];
+    }
+  }
+
+static void planar_to_semiplanar(gavl_video_convert_context_t * ctx,
+                                 int sub_v, int u_off)
+  {
+  int i, j;
+  uint8_t * dst;
+  uint8_t * src_u;
+  uint8_t * src_v;
+  int y_size =
+    ctx->input_frame->strides[0] < ctx->output_frame->strides[0] ?
+    ctx->input_frame->strides[0] : ctx->output_frame->strides[0];
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + sub_v - 1) / sub_v;
+  
+  uint8_t * src_y = ctx->input_frame->planes[0];
+  uint8_t * src_u_row = ctx->input_frame->planes[1];
+  uint8_t * src_v_row = ctx->input_frame->planes[2];
+  uint8_t * dst_y = ctx->output_frame->planes[0];
+  uint8_t * dst_uv = ctx->output_frame->planes[1];
+  
+  for(i = 0; i < ctx->input_format.image_height; i++)
+    {
+    gavl_memcpy(dst_y, src_y, y_size);
+    dst_y += ctx->output_frame->strides[0];
+    src_y += ctx->input_frame->strides[0];
+    }
+  
+  for(i = 0; i < uv_height; i++)
+    {
+    dst = dst_uv;
+    src_u = src_u_row;
+    src_v = src_v_row;
+    
+    for(j = 0; j < uv_width; j++)
+      {
+      dst[u_off]   = *(src_u++);
+      dst[1-u_off] = *(src_v++);
+      dst += 2;
+      }
+    dst_uv += ctx->output_frame->strides[1];
+    src_u_row += ctx->input_frame->strides[1];
+    src_v_row += ctx->input_frame->strides[2];
+    }
+  }
+
+static void nv12_to_yuv_420_p_c(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 2, 0);
+  }
+
+static void nv21_to_yuv_420_p_c(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 2, 1);
+  }
+
+static void nv16_to_yuv_422_p_c(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 1, 0);
+  }
+
+static void yuv_420_p_to_nv12_c(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 2, 0);
+  }
+
+static void yuv_420_p_to_nv21_c(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 2, 1);
+  }
+
+static void yuv_422_p_to_nv16_c(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 1, 0);
+  }
+
+
 /*****************************************************
  *
  * C YUV <-> YUV Conversions
@@ -5974,6 +6098,255 @@ dst_v[0]=UVJ_8_TO_UV_16(src_v[0]);
 
 #include "../csp_packed_packed.h"
 
+/*****************************************************
+ *
+ * 16 bit 4:2:0 (YUV 420 Planar (16 bit), P016)
+ *
+ * The chroma plane of P016 is interleaved (CbCrCbCr...),
+ * so src_u and dst_u point to both components.
+ *
+ ******************************************************/
+
+/* yuv_420_p_16_to_yuv_420_p_c */
+
+#define FUNC_NAME     yuv_420_p_16_to_yuv_420_p_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);                 \
+  UV_16_TO_UV_8(src_u[0], dst_u[0]);               \
+  UV_16_TO_UV_8(src_v[0], dst_v[0]);               \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#define CONVERT_Y    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);                 \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#include "../csp_planar_planar.h"
+
+/* p016_to_yuv_420_p_c */
+
+#define FUNC_NAME     p016_to_yuv_420_p_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);                 \
+  UV_16_TO_UV_8(src_u[0], dst_u[0]);               \
+  UV_16_TO_UV_8(src_u[1], dst_v[0]);               \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#define CONVERT_Y    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);                 \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#include "../csp_planar_planar.h"
+
+/* p016_to_nv12_c */
+
+#define FUNC_NAME     p016_to_nv12_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);                 \
+  UV_16_TO_UV_8(src_u[0], dst_u[0]);               \
+  UV_16_TO_UV_8(src_u[1], dst_u[1]);               \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#define CONVERT_Y    \
+  Y_16_TO_Y_8(src_y[0], dst_y[0]);                 \
+  Y_16_TO_Y_8(src_y[1], dst_y[1]);
+
+#include "../csp_planar_planar.h"
+
+#ifndef HQ
+
+/* yuv_420_p_to_yuv_420_p_16_c */
+
+#define FUNC_NAME     yuv_420_p_to_yuv_420_p_16_c
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0]=Y_8_TO_16(src_y[0]);                  \
+  dst_u[0]=UV_8_TO_16(src_u[0]);                 \
+  dst_v[0]=UV_8_TO_16(src_v[0]);                 \
+  dst_y[1]=Y_8_TO_16(src_y[1]);
+
+#define CONVERT_Y    \
+  dst_y[0]=Y_8_TO_16(src_y[0]);                  \
+  dst_y[1]=Y_8_TO_16(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+/* yuv_420_p_to_p016_c */
+
+#define FUNC_NAME     yuv_420_p_to_p016_c
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0]=Y_8_TO_16(src_y[0]);                  \
+  dst_u[0]=UV_8_TO_16(src_u[0]);                 \
+  dst_u[1]=UV_8_TO_16(src_v[0]);                 \
+  dst_y[1]=Y_8_TO_16(src_y[1]);
+
+#define CONVERT_Y    \
+  dst_y[0]=Y_8_TO_16(src_y[0]);                  \
+  dst_y[1]=Y_8_TO_16(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+/* nv12_to_p016_c */
+
+#define FUNC_NAME     nv12_to_p016_c
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0]=Y_8_TO_16(src_y[0]);                  \
+  dst_u[0]=UV_8_TO_16(src_u[0]);                 \
+  dst_u[1]=UV_8_TO_16(src_u[1]);                 \
+  dst_y[1]=Y_8_TO_16(src_y[1]);
+
+#define CONVERT_Y    \
+  dst_y[0]=Y_8_TO_16(src_y[0]);                  \
+  dst_y[1]=Y_8_TO_16(src_y[1]);
+
+#include "../csp_planar_planar.h"
+
+/* p016_to_yuv_420_p_16_c */
+
+#define FUNC_NAME     p016_to_yuv_420_p_16_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  2
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0]=src_y[0];                             \
+  dst_u[0]=src_u[0];                             \
+  dst_v[0]=src_u[1];                             \
+  dst_y[1]=src_y[1];
+
+#define CONVERT_Y    \
+  dst_y[0]=src_y[0];                             \
+  dst_y[1]=src_y[1];
+
+#include "../csp_planar_planar.h"
+
+/* yuv_420_p_16_to_p016_c */
+
+#define FUNC_NAME     yuv_420_p_16_to_p016_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 2
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0]=src_y[0];                             \
+  dst_u[0]=src_u[0];                             \
+  dst_u[1]=src_v[0];                             \
+  dst_y[1]=src_y[1];
+
+#define CONVERT_Y    \
+  dst_y[0]=src_y[0];                             \
+  dst_y[1]=src_y[1];
+
+#include "../csp_planar_planar.h"
+
+/* yuv_420_p_16_to_yuv_422_p_16_c */
+
+#define FUNC_NAME     yuv_420_p_16_to_yuv_422_p_16_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  2
+#define CHROMA_SUB_OUT 1
+#define CONVERT_YUV    \
+  dst_y[0]=src_y[0];                             \
+  dst_u[0]=src_u[0];                             \
+  dst_v[0]=src_v[0];                             \
+  dst_y[1]=src_y[1];
+
+#include "../csp_planar_planar.h"
+
+/* yuv_422_p_16_to_yuv_420_p_16_c */
+
+#define FUNC_NAME     yuv_422_p_16_to_yuv_420_p_16_c
+#define IN_TYPE       uint16_t
+#define OUT_TYPE      uint16_t
+#define IN_ADVANCE_Y   2
+#define IN_ADVANCE_UV  1
+#define OUT_ADVANCE_Y  2
+#define OUT_ADVANCE_UV 1
+#define NUM_PIXELS     2
+#define CHROMA_SUB_IN  1
+#define CHROMA_SUB_OUT 2
+#define CONVERT_YUV    \
+  dst_y[0]=src_y[0];                             \
+  dst_u[0]=src_u[0];                             \
+  dst_v[0]=src_v[0];                             \
+  dst_y[1]=src_y[1];
+
+#define CONVERT_Y    \
+  dst_y[0]=src_y[0];                             \
+  dst_y[1]=src_y[1];
+
+#include "../csp_planar_planar.h"
+
+#endif // !HQ
+
 
 #ifdef HQ
 void gavl_init_yuv_yuv_funcs_hq(gavl_pixelformat_function_table_t * tab, const gavl_video_options_t * opt)
@@ -6274,8 +6647,26 @@ void gavl_init_yuv_yuv_funcs_c(gavl_pixelformat_function_table_t * tab, const ga
   tab->yuva_32_to_yuva_float = yuva_32_to_yuva_float_c;
   tab->yuva_64_to_yuva_float = yuva_64_to_yuva_float_c;
   tab->yuv_float_to_yuva_float = yuv_float_to_yuva_float_c;
+
+  tab->nv12_to_yuv_420_p = nv12_to_yuv_420_p_c;
+  tab->nv21_to_yuv_420_p = nv21_to_yuv_420_p_c;
+  tab->nv16_to_yuv_422_p = nv16_to_yuv_422_p_c;
+  tab->yuv_420_p_to_nv12 = yuv_420_p_to_nv12_c;
+  tab->yuv_420_p_to_nv21 = yuv_420_p_to_nv21_c;
+  tab->yuv_422_p_to_nv16 = yuv_422_p_to_nv16_c;
+
+  tab->yuv_420_p_to_yuv_420_p_16 = yuv_420_p_to_yuv_420_p_16_c;
+  tab->yuv_420_p_to_p016 = yuv_420_p_to_p016_c;
+  tab->nv12_to_p016 = nv12_to_p016_c;
+  tab->p016_to_yuv_420_p_16 = p016_to_yuv_420_p_16_c;
+  tab->yuv_420_p_16_to_p016 = yuv_420_p_16_to_p016_c;
+  tab->yuv_420_p_16_to_yuv_422_p_16 = yuv_420_p_16_to_yuv_422_p_16_c;
+  tab->yuv_422_p_16_to_yuv_420_p_16 = yuv_422_p_16_to_yuv_420_p_16_c;
   
 #endif // !HQ
+  tab->yuv_420_p_16_to_yuv_420_p = yuv_420_p_16_to_yuv_420_p_c;
+  tab->p016_to_yuv_420_p = p016_to_yuv_420_p_c;
+  tab->p016_to_nv12 = p016_to_nv12_c;
   tab->yuv_444_p_16_to_yuva_32  = yuv_444_p_16_to_yuva_32_c;
   tab->yuv_422_p_16_to_yuva_32  = yuv_422_p_16_to_yuva_32_c;
   tab->yuv_422_p_16_to_yuy2       = yuv_422_p_16_to_yuy2_c;
@@ -867,6 +867,10 @@ static int get_channel_properties(gavl_pixelformat_t src_format,
   
   switch(src_format)
     {
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       return 0;
     case GAVL_GRAY_8:
@@ -1435,6 +1439,7 @@ static int get_channel_properties(gavl_pixelformat_t src_format,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       dst_format = GAVL_GRAY_16;
       switch(ch)
         {
@@ -85,7 +85,12 @@ const pixelformat_tab_t pixelformat_tab[] =
     { GAVL_YUV_444_P_16, "YUV 444 Planar (16 bit)", "yuv444p16" },
     { GAVL_YUVJ_420_P, "YUVJ 420 Planar",           "yuvj420p8" },
     { GAVL_YUVJ_422_P, "YUVJ 422 Planar",           "yuvj422p8" },
-    { GAVL_YUVJ_444_P, "YUVJ 444 Planar",           "yuvj444p8" }
+    { GAVL_YUVJ_444_P, "YUVJ 444 Planar",           "yuvj444p8" },
+    { GAVL_NV12, "YUV 420 Semiplanar (NV12)",       "nv12"      },
+    { GAVL_NV21, "YUV 420 Semiplanar (NV21)",       "nv21"      },
+    { GAVL_NV16, "YUV 422 Semiplanar (NV16)",       "nv16"      },
+    { GAVL_YUV_420_P_16, "YUV 420 Planar (16 bit)", "yuv420p16" },
+    { GAVL_P016, "YUV 420 Semiplanar (P016)",       "p016"      },
   };
 
 static const int num_pixelformats =
@@ -132,8 +137,15 @@ int gavl_pixelformat_num_planes(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_YUV_420_P_16:
       return 3;
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
+      return 2;
+      break;
     case GAVL_PIXELFORMAT_NONE:
       return 0;
       break;
@@ -180,6 +192,10 @@ void gavl_pixelformat_chroma_sub(gavl_pixelformat_t csp, int * sub_hp,
       break;
     case GAVL_YUV_420_P:
     case GAVL_YUVJ_420_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
       sub_h = 2;
       sub_v = 2;
       break;
@@ -188,6 +204,7 @@ void gavl_pixelformat_chroma_sub(gavl_pixelformat_t csp, int * sub_hp,
     case GAVL_YUVJ_422_P:
     case GAVL_YUY2:
     case GAVL_UYVY:
+    case GAVL_NV16:
       sub_h = 2;
       sub_v = 1;
       break;
@@ -212,6 +229,25 @@ void gavl_pixelformat_chroma_sub(gavl_pixelformat_t csp, int * sub_hp,
   }
 
 
+gavl_pixelformat_t gavl_pixelformat_get_planar(gavl_pixelformat_t pixelformat)
+  {
+  switch(pixelformat)
+    {
+    case GAVL_NV12:
+    case GAVL_NV21:
+      return GAVL_YUV_420_P;
+      break;
+    case GAVL_NV16:
+      return GAVL_YUV_422_P;
+      break;
+    case GAVL_P016:
+      return GAVL_YUV_420_P_16;
+      break;
+    default:
+      break;
+    }
+  return pixelformat;
+  }
 
 int gavl_num_pixelformats()
   {
@@ -332,6 +368,12 @@ create_pixelformat_function_table(const gavl_video_options_t * opt,
     //    gavl_init_yuv_rgb_funcs_sse(csp_tab, opt);
     }
 #endif
+#ifdef HAVE_SSE2
+  if(opt->accel_flags & GAVL_ACCEL_SSE2)
+    {
+    gavl_init_yuv_yuv_funcs_sse2(csp_tab, width, opt);
+    }
+#endif
 #ifdef HAVE_SSE3
   if(opt->accel_flags & GAVL_ACCEL_SSE3)
     {
@@ -341,6 +383,23 @@ create_pixelformat_function_table(const gavl_video_options_t * opt,
     //    gavl_init_yuv_yuv_funcs_sse(csp_tab, opt);
     //    gavl_init_yuv_rgb_funcs_sse(csp_tab, opt);
     }
+#endif
+#ifdef HAVE_SSSE3
+  /* Replace the MMX versions */
+  if(opt->accel_flags & GAVL_ACCEL_SSSE3)
+    {
+    gavl_init_rgb_rgb_funcs_ssse3(csp_tab, width, opt);
+    gavl_init_rgb_yuv_funcs_ssse3(csp_tab, width, opt);
+    gavl_init_yuv_rgb_funcs_ssse3(csp_tab, width, opt);
+    }
+#endif
+#ifdef HAVE_AVX2
+  if(opt->accel_flags & GAVL_ACCEL_AVX2)
+    {
+    gavl_init_rgb_yuv_funcs_avx2(csp_tab, width, opt);
+    gavl_init_yuv_rgb_funcs_avx2(csp_tab, width, opt);
+    gavl_init_yuv_yuv_funcs_avx2(csp_tab, width, opt);
+    }
 #endif
   /* High quality */
   
@@ -358,6 +417,152 @@ create_pixelformat_function_table(const gavl_video_options_t * opt,
   return csp_tab;
   }
 
+/*
+ *  Conversions from and to semiplanar formats. Only the planar formats
+ *  with the same subsampling and some RGB formats are supported directly,
+ *  everything else is done by the video converter through the planar format.
+ */
+
+#define SEMIPLANAR_RGB_FUNCS(ret, tab, fmt, pfx)        \
+  switch(fmt)                                            \
+    {                                                    \
+    case GAVL_RGB_24:     ret = tab->pfx##_to_rgb_24;     break; \
+    case GAVL_BGR_24:     ret = tab->pfx##_to_bgr_24;     break; \
+    case GAVL_RGB_32:     ret = tab->pfx##_to_rgb_32;     break; \
+    case GAVL_BGR_32:     ret = tab->pfx##_to_bgr_32;     break; \
+    case GAVL_RGBA_32:    ret = tab->pfx##_to_rgba_32;    break; \
+    case GAVL_RGB_FLOAT:  ret = tab->pfx##_to_rgb_float;  break; \
+    case GAVL_RGBA_FLOAT: ret = tab->pfx##_to_rgba_float; break; \
+    default: break;                                      \
+    }
+
+#define RGB_SEMIPLANAR_FUNCS(ret, tab, fmt, sfx)        \
+  switch(fmt)                                            \
+    {                                                    \
+    case GAVL_RGB_24:     ret = tab->rgb_24_to_##sfx;     break; \
+    case GAVL_BGR_24:     ret = tab->bgr_24_to_##sfx;     break; \
+    case GAVL_RGB_32:     ret = tab->rgb_32_to_##sfx;     break; \
+    case GAVL_BGR_32:     ret = tab->bgr_32_to_##sfx;     break; \
+    default: break;                                      \
+    }
+
+static gavl_video_func_t
+find_semiplanar_converter(gavl_pixelformat_function_table_t * tab,
+                          gavl_pixelformat_t input_pixelformat,
+                          gavl_pixelformat_t output_pixelformat)
+  {
+  gavl_video_func_t ret = NULL;
+  
+  switch(input_pixelformat)
+    {
+    case GAVL_NV12:
+      if(output_pixelformat == GAVL_YUV_420_P)
+        ret = tab->nv12_to_yuv_420_p;
+      else if(output_pixelformat == GAVL_P016)
+        ret = tab->nv12_to_p016;
+      else
+        SEMIPLANAR_RGB_FUNCS(ret, tab, output_pixelformat, nv12);
+      break;
+    case GAVL_NV21:
+      if(output_pixelformat == GAVL_YUV_420_P)
+        ret = tab->nv21_to_yuv_420_p;
+      else
+        SEMIPLANAR_RGB_FUNCS(ret, tab, output_pixelformat, nv21);
+      break;
+    case GAVL_NV16:
+      if(output_pixelformat == GAVL_YUV_422_P)
+        ret = tab->nv16_to_yuv_422_p;
+      else
+        SEMIPLANAR_RGB_FUNCS(ret, tab, output_pixelformat, nv16);
+      break;
+    case GAVL_P016:
+      switch(output_pixelformat)
+        {
+        case GAVL_YUV_420_P_16: ret = tab->p016_to_yuv_420_p_16; break;
+        case GAVL_YUV_420_P:    ret = tab->p016_to_yuv_420_p;    break;
+        case GAVL_NV12:         ret = tab->p016_to_nv12;         break;
+        case GAVL_RGB_48:       ret = tab->p016_to_rgb_48;       break;
+        case GAVL_RGBA_64:      ret = tab->p016_to_rgba_64;      break;
+        default: break;
+        }
+      break;
+    default:
+      switch(output_pixelformat)
+        {
+        case GAVL_NV12:
+          if(input_pixelformat == GAVL_YUV_420_P)
+            ret = tab->yuv_420_p_to_nv12;
+          else
+            RGB_SEMIPLANAR_FUNCS(ret, tab, input_pixelformat, nv12);
+          break;
+        case GAVL_NV21:
+          if(input_pixelformat == GAVL_YUV_420_P)
+            ret = tab->yuv_420_p_to_nv21;
+          else
+            RGB_SEMIPLANAR_FUNCS(ret, tab, input_pixelformat, nv21);
+          break;
+        case GAVL_NV16:
+          if(input_pixelformat == GAVL_YUV_422_P)
+            ret = tab->yuv_422_p_to_nv16;
+          else
+            RGB_SEMIPLANAR_FUNCS(ret, tab, input_pixelformat, nv16);
+          break;
+        case GAVL_P016:
+          switch(input_pixelformat)
+            {
+            case GAVL_YUV_420_P_16: ret = tab->yuv_420_p_16_to_p016; break;
+            case GAVL_YUV_420_P:    ret = tab->yuv_420_p_to_p016;    break;
+            case GAVL_RGB_48:       ret = tab->rgb_48_to_p016;       break;
+            case GAVL_RGBA_64:      ret = tab->rgba_64_to_p016;      break;
+            default: break;
+            }
+          break;
+        default:
+          break;
+        }
+      break;
+    }
+  return ret;
+  }
+
+/*
+ *  16 bit 4:2:0 is converted directly only from and to the 8 bit and 16 bit
+ *  planar formats and the 16 bit RGB formats. Everything else is done by the
+ *  video converter through YUV 422 Planar (16 bit).
+ */
+
+static gavl_video_func_t
+find_yuv_420_p_16_converter(gavl_pixelformat_function_table_t * tab,
+                            gavl_pixelformat_t input_pixelformat,
+                            gavl_pixelformat_t output_pixelformat)
+  {
+  gavl_video_func_t ret = NULL;
+
+  if(input_pixelformat == GAVL_YUV_420_P_16)
+    {
+    switch(output_pixelformat)
+      {
+      case GAVL_YUV_420_P:    ret = tab->yuv_420_p_16_to_yuv_420_p;    break;
+      case GAVL_YUV_422_P_16: ret = tab->yuv_420_p_16_to_yuv_422_p_16; break;
+      case GAVL_RGB_48:       ret = tab->yuv_420_p_16_to_rgb_48;       break;
+      case GAVL_RGBA_64:      ret = tab->yuv_420_p_16_to_rgba_64;      break;
+      default: break;
+      }
+    }
+  else
+    {
+    switch(input_pixelformat)
+      {
+      case GAVL_YUV_420_P:    ret = tab->yuv_420_p_to_yuv_420_p_16;    break;
+      case GAVL_YUV_422_P_16: ret = tab->yuv_422_p_16_to_yuv_420_p_16; break;
+      case GAVL_RGB_48:       ret = tab->rgb_48_to_yuv_420_p_16;       break;
+      case GAVL_RGBA_64:      ret = tab->rgba_64_to_yuv_420_p_16;      break;
+      default: break;
+      }
+    }
+  return ret;
+  }
+
 gavl_video_func_t
 gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
                                gavl_pixelformat_t input_pixelformat,
@@ -369,6 +574,22 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
   gavl_pixelformat_function_table_t * tab =
     create_pixelformat_function_table(opt, width, height);
 
+  if(gavl_pixelformat_is_semiplanar(input_pixelformat) ||
+     gavl_pixelformat_is_semiplanar(output_pixelformat))
+    {
+    ret = find_semiplanar_converter(tab, input_pixelformat, output_pixelformat);
+    free(tab);
+    return ret;
+    }
+
+  if((input_pixelformat == GAVL_YUV_420_P_16) ||
+     (output_pixelformat == GAVL_YUV_420_P_16))
+    {
+    ret = find_yuv_420_p_16_converter(tab, input_pixelformat, output_pixelformat);
+    free(tab);
+    return ret;
+    }
+  
   switch(input_pixelformat)
     {
     case GAVL_GRAY_8:
@@ -455,6 +676,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->gray_8_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
           break;
@@ -544,6 +770,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->graya_16_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAYA_16:
           break;
@@ -635,6 +866,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->gray_16_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_16:
           break;
@@ -724,6 +960,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->graya_32_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAYA_32:
           break;
@@ -815,6 +1056,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->gray_float_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_FLOAT:
           break;
@@ -905,6 +1151,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->graya_float_to_yj_8;
           break;
           /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAYA_FLOAT:
           break;
@@ -1017,6 +1268,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_15_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
           break;
@@ -1128,6 +1384,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_15_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_15:
           break;
@@ -1240,6 +1501,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_16:
           break;
@@ -1352,6 +1618,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_16:
           break;
@@ -1463,6 +1734,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_24_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_24:
           break;
@@ -1574,6 +1850,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_24_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_24:
           break;
@@ -1685,6 +1966,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_32_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_32:
           break;
@@ -1796,6 +2082,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->bgr_32_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_BGR_32:
           break;
@@ -1907,6 +2198,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgba_32_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGBA_32:
           break;
@@ -2019,6 +2315,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgba_64_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGBA_64:
           break;
@@ -2131,6 +2432,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgba_float_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGBA_FLOAT:
           break;
@@ -2244,6 +2550,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_48_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_48:
           break;
@@ -2355,6 +2666,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->rgb_float_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_FLOAT:
           break;
@@ -2469,6 +2785,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuy2_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUY2:
           break;
@@ -2580,6 +2901,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->uyvy_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_UYVY:
           break;
@@ -2692,6 +3018,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuva_32_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVA_32:
           break;
@@ -2804,6 +3135,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuva_64_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVA_64:
           break;
@@ -2916,6 +3252,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuva_float_to_yuv_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVA_FLOAT:
           break;
@@ -3028,6 +3369,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_float_to_yuva_float;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_FLOAT:
           break;
@@ -3141,6 +3487,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_420_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_420_P:
           break;
@@ -3253,6 +3604,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_410_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_410_P:
           break;
@@ -3364,6 +3720,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_422_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_422_P:
           break;
@@ -3476,6 +3837,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_422_p_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_422_P_16:
           break;
@@ -3589,6 +3955,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_411_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_411_P:
           break;
@@ -3701,6 +4072,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_444_p_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_444_P:
           break;
@@ -3814,6 +4190,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_444_p_16_to_yuvj_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUV_444_P_16:
           break;
@@ -3927,6 +4308,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_420_p_to_yuv_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVJ_420_P:
           break;
@@ -4038,6 +4424,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuv_422_p_to_yuv_444_p;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVJ_422_P:
           break;
@@ -4149,6 +4540,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
           ret = tab->yuvj_444_p_to_yuv_444_p_16;
           break;
         /* Keep GCC happy */
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_YUVJ_444_P:
           break;
@@ -4156,6 +4552,11 @@ gavl_find_pixelformat_converter(const gavl_video_options_t * opt,
       break;
 
       
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -4205,10 +4606,15 @@ int gavl_pixelformat_bytes_per_component(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
       return 1;
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
       return 2;
     }
   return 0;
@@ -4278,6 +4684,11 @@ int gavl_pixelformat_bytes_per_pixel(gavl_pixelformat_t csp)
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
       return 0;
     }
   return 0;
@@ -4338,15 +4749,20 @@ int gavl_pixelformat_bits_per_pixel(gavl_pixelformat_t pixelformat)
     case GAVL_UYVY:
     case GAVL_YUV_422_P:
     case GAVL_YUVJ_422_P:
+    case GAVL_NV16:
       return 16;
       break;
     case GAVL_YUV_420_P:
     case GAVL_YUVJ_420_P:
     case GAVL_YUV_411_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
       return 12;
       break;
     case GAVL_YUV_444_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
       return 24;
       break;
     case GAVL_YUV_422_P_16:
@@ -4396,6 +4812,9 @@ static int effective_bits_per_component(gavl_pixelformat_t fmt)
     case GAVL_YUV_444_P:
     case GAVL_YUVJ_444_P:
     case GAVL_YUV_410_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
       return 8;
       break;
     case GAVL_GRAY_16:
@@ -4405,6 +4824,8 @@ static int effective_bits_per_component(gavl_pixelformat_t fmt)
     case GAVL_YUVA_64:
     case GAVL_YUV_422_P_16:
     case GAVL_YUV_444_P_16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
       return 16;
       break;
     case GAVL_GRAY_FLOAT:
@@ -4498,12 +4919,40 @@ int gavl_pixelformat_conversion_penalty(gavl_pixelformat_t src,
     ret += 1;
   
   /* Remaining differences should be packing format.
-     Conversions here are lossless and efficient */
-  ret <<= 1;
-  ret += 1;
+     Conversions here are lossless and efficient. If the conversions
+     were calibrated, the measured speed decides. */
+  ret <<= 8;
+  ret += gavl_pixelformat_get_cost_rank(src, dst);
   return ret;
   }
 
+int gavl_pixelformat_covers(gavl_pixelformat_t fmt,
+                            gavl_pixelformat_t sub)
+  {
+  int sub_h, sub_v;
+  int sub_h_sub, sub_v_sub;
+
+  if(fmt == sub)
+    return 1;
+  
+  if((gavl_pixelformat_is_gray(fmt) != gavl_pixelformat_is_gray(sub)) ||
+     (gavl_pixelformat_is_rgb(fmt) != gavl_pixelformat_is_rgb(sub)) ||
+     (gavl_pixelformat_is_yuv(fmt) && 
+      (gavl_pixelformat_is_jpeg_scaled(fmt) != gavl_pixelformat_is_jpeg_scaled(sub))))
+    return 0;
+
+  if(gavl_pixelformat_has_alpha(sub) && !gavl_pixelformat_has_alpha(fmt))
+    return 0;
+  
+  gavl_pixelformat_chroma_sub(fmt, &sub_h, &sub_v);
+  gavl_pixelformat_chroma_sub(sub, &sub_h_sub, &sub_v_sub);
+
+  if((sub_h > sub_h_sub) || (sub_v > sub_v_sub))
+    return 0;
+  
+  return effective_bits_per_component(fmt) >= effective_bits_per_component(sub);
+  }
+
 gavl_pixelformat_t 
 gavl_pixelformat_get_best(gavl_pixelformat_t src,
                           const gavl_pixelformat_t * dst_supported,
@@ -4540,6 +4989,26 @@ gavl_pixelformat_get_best(gavl_pixelformat_t src,
 
 
 
+/* The scale functions are selected from the source format, so packed
+   formats can only be scaled into 8 bit planes if they have 8 bit
+   components themselves */
+
+static int packed_is_8bit(gavl_pixelformat_t csp)
+  {
+  switch(csp)
+    {
+    case GAVL_YUY2:
+    case GAVL_UYVY:
+    case GAVL_YUVA_32:
+    case GAVL_GRAY_8:
+    case GAVL_GRAYA_16:
+      return 1;
+    default:
+      break;
+    }
+  return 0;
+  }
+
 /* Check if a pixelformat can be converted by simple scaling */
 
 int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out_csp)
@@ -4552,6 +5021,13 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
     return 0;
     }
 
+  /* The scaler doesn't handle interleaved chroma planes */
+  if(gavl_pixelformat_is_semiplanar(in_csp) ||
+     gavl_pixelformat_is_semiplanar(out_csp))
+    {
+    return 0;
+    }
+
   if(gavl_pixelformat_is_jpeg_scaled(in_csp) !=
      gavl_pixelformat_is_jpeg_scaled(out_csp))
     {
@@ -4579,7 +5055,8 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
     //         gavl_pixelformat_bytes_per_component(out_csp));
     
     if(gavl_pixelformat_is_planar(out_csp) &&
-       (gavl_pixelformat_bytes_per_component(out_csp) == 1))
+       (gavl_pixelformat_bytes_per_component(out_csp) == 1) &&
+       packed_is_8bit(in_csp))
       return 1;
     else
       return 0;
@@ -4587,7 +5064,8 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
   else
     {
     if(!gavl_pixelformat_is_planar(out_csp) &&
-       (gavl_pixelformat_bytes_per_component(in_csp) == 1))
+       (gavl_pixelformat_bytes_per_component(in_csp) == 1) &&
+       packed_is_8bit(out_csp))
       return 1;
     else if(gavl_pixelformat_bytes_per_component(in_csp) ==
             gavl_pixelformat_bytes_per_component(out_csp))
@@ -4604,11 +5082,16 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
  *  RGB -> YUV420P, we can do RGB -> YUV444P -> YUV420P with proper chroma scaling
  */
 
-gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
-                                                   gavl_pixelformat_t out_csp)
+static gavl_pixelformat_t get_intermediate(gavl_pixelformat_t in_csp,
+                                           gavl_pixelformat_t out_csp)
   {
   switch(in_csp)
     {
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE: return GAVL_PIXELFORMAT_NONE; break;
     case GAVL_GRAY_8:
     case GAVL_GRAY_16:
@@ -4636,6 +5119,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
       /*4:4:4 -> */
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
         case GAVL_BGR_15:
@@ -4683,6 +5171,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_422_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
           return GAVL_PIXELFORMAT_NONE; break;
           /* YUV422 -> RGB */
@@ -4732,6 +5225,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_420_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
           return GAVL_PIXELFORMAT_NONE; break;
           /* YUV420 -> RGB */
@@ -4781,6 +5279,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_444_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
         case GAVL_BGR_15:
@@ -4829,6 +5332,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_410_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -4879,6 +5387,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUVJ_420_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -4928,6 +5441,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUVJ_422_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -4974,6 +5492,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUVJ_444_P:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -5021,6 +5544,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_444_P_16:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_GRAY_8:
         case GAVL_GRAY_16:
@@ -5065,6 +5593,11 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
     case GAVL_YUV_422_P_16:
       switch(out_csp)
         {
+        case GAVL_NV12:
+        case GAVL_NV21:
+        case GAVL_NV16:
+        case GAVL_YUV_420_P_16:
+        case GAVL_P016:
         case GAVL_PIXELFORMAT_NONE:
         case GAVL_RGB_15:
         case GAVL_BGR_15:
@@ -5112,6 +5645,66 @@ gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
   return GAVL_PIXELFORMAT_NONE;
   }
 
+static float get_path_cost(gavl_pixelformat_t in_csp,
+                           gavl_pixelformat_t tmp_csp,
+                           gavl_pixelformat_t out_csp)
+  {
+  float c1 = gavl_pixelformat_get_cost(in_csp, tmp_csp);
+  float c2 = gavl_pixelformat_get_cost(tmp_csp, out_csp);
+
+  if((c1 < 0.0) || (c2 < 0.0))
+    return -1.0;
+  return c1 + c2;
+  }
+
+gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
+                                                   gavl_pixelformat_t out_csp)
+  {
+  int i;
+  float cost, test_cost;
+  gavl_pixelformat_t ret, test;
+  gavl_pixelformat_t in_planar;
+  
+  /* Intermediate formats, which can replace the default one if they
+     lose nothing and are measured to be faster */
+  static const gavl_pixelformat_t candidates[] =
+    {
+      GAVL_YUV_444_P,
+      GAVL_YUV_444_P_16,
+      GAVL_YUV_422_P,
+      GAVL_YUV_422_P_16,
+      GAVL_PIXELFORMAT_NONE,
+    };
+  
+  ret = get_intermediate(in_csp, out_csp);
+  
+  if((ret == GAVL_PIXELFORMAT_NONE) ||
+     ((cost = get_path_cost(in_csp, ret, out_csp)) < 0.0))
+    return ret;
+
+  in_planar = gavl_pixelformat_get_planar(in_csp);
+  
+  for(i = 0; candidates[i] != GAVL_PIXELFORMAT_NONE; i++)
+    {
+    test = candidates[i];
+
+    /* The converter needs to scale from the input or to the output */
+    if((test == ret) || (test == in_csp) || (test == out_csp) ||
+       !gavl_pixelformat_covers(test, ret) ||
+       (!gavl_pixelformat_can_scale(in_planar, test) &&
+        !gavl_pixelformat_can_scale(test, out_csp)))
+      continue;
+
+    if(((test_cost = get_path_cost(in_csp, test, out_csp)) >= 0.0) &&
+       (test_cost < cost))
+      {
+      ret = test;
+      cost = test_cost;
+      }
+    }
+  return ret;
+  }
+
 void gavl_pixelformat_get_offset(gavl_pixelformat_t pixelformat,
                                  int plane,
                                  int * advance, int * offset)
@@ -5199,11 +5792,28 @@ void gavl_pixelformat_get_offset(gavl_pixelformat_t pixelformat,
       *advance = 1;
       *offset = 0;
       break;
+    case GAVL_NV12:
+    case GAVL_NV16:
+      /* Y Plane, then CbCr */
+      *advance = plane ? 2 : 1;
+      *offset = (plane == 2) ? 1 : 0;
+      break;
+    case GAVL_NV21:
+      /* Y Plane, then CrCb */
+      *advance = plane ? 2 : 1;
+      *offset = (plane == 1) ? 1 : 0;
+      break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       *advance = 2;
       *offset = 0;
       break;
+    case GAVL_P016:
+      /* Y Plane, then CbCr (16 bit words) */
+      *advance = plane ? 4 : 2;
+      *offset = (plane == 2) ? 2 : 0;
+      break;
     case GAVL_RGB_48:
       *advance = 6;
       *offset = 0;
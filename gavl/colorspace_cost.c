@@ -0,0 +1,429 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Measured cost of pixelformat conversions */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <gavl/utils.h>
+#include <gavl/log.h>
+#define LOG_DOMAIN "colorspace"
+
+#include <video.h>
+#include <accel.h>
+
+/*
+ *  The conversion functions, which are selected under the current
+ *  acceleration flags, are timed on a small image. Conversions, which
+ *  only change the chroma subsampling, are timed with the scaler. The results are
+ *  cached in a file, since measuring all combinations takes a while.
+ */
+
+/* Size of the test images */
+#define CALIBRATE_WIDTH   256
+#define CALIBRATE_HEIGHT   64
+
+/* Number of timed conversions per pair, the fastest one counts */
+#define CALIBRATE_RUNS      4
+
+#define COST_FILE "pixelformat_costs"
+#define COST_ENV  "GAVL_PIXELFORMAT_COSTS"
+
+/* Cost per pixel in units of gavl_benchmark_get_time(), indexed like
+   gavl_get_pixelformat(). Negative for unknown conversions. */
+
+static float * cost_tab = NULL;
+static int cost_num = 0;
+
+static int env_checked = 0;
+static pthread_mutex_t cost_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int get_index(gavl_pixelformat_t fmt)
+  {
+  int i;
+  for(i = 1; i <= gavl_num_pixelformats(); i++)
+    {
+    if(gavl_get_pixelformat(i) == fmt)
+      return i;
+    }
+  return -1;
+  }
+
+static float * create_tab(int num)
+  {
+  int i;
+  float * ret = malloc(num * num * sizeof(*ret));
+  for(i = 0; i < num * num; i++)
+    ret[i] = -1.0;
+  return ret;
+  }
+
+/* Time one conversion function */
+
+static float measure(gavl_video_convert_context_t * ctx,
+                     gavl_video_func_t func)
+  {
+  int i;
+  uint64_t t, min_t = 0;
+  int accel = ctx->options->accel_flags;
+
+  ctx->output_frame = gavl_video_frame_create(&ctx->output_format);
+
+  /* Warm up */
+  func(ctx);
+
+  for(i = 0; i < CALIBRATE_RUNS; i++)
+    {
+    t = gavl_benchmark_get_time(accel);
+    func(ctx);
+    t = gavl_benchmark_get_time(accel) - t;
+    if(!i || (t < min_t))
+      min_t = t;
+    }
+  gavl_video_frame_destroy(ctx->output_frame);
+  ctx->output_frame = NULL;
+  return (float)min_t / (CALIBRATE_WIDTH * CALIBRATE_HEIGHT);
+  }
+
+/* Time chroma scaling, which the converter uses instead of a conversion
+   function if only the subsampling changes */
+
+static float measure_scale(gavl_video_scaler_t * scaler,
+                           const gavl_video_format_t * in_format,
+                           const gavl_video_format_t * out_format,
+                           const gavl_video_frame_t * in_frame)
+  {
+  int i;
+  uint64_t t, min_t = 0;
+  gavl_video_frame_t * out_frame;
+  int accel = gavl_video_scaler_get_options(scaler)->accel_flags;
+
+  if(!gavl_video_scaler_init(scaler, in_format, out_format))
+    return -1.0;
+  
+  out_frame = gavl_video_frame_create(out_format);
+  
+  gavl_video_scaler_scale(scaler, in_frame, out_frame);
+
+  for(i = 0; i < CALIBRATE_RUNS; i++)
+    {
+    t = gavl_benchmark_get_time(accel);
+    gavl_video_scaler_scale(scaler, in_frame, out_frame);
+    t = gavl_benchmark_get_time(accel) - t;
+    if(!i || (t < min_t))
+      min_t = t;
+    }
+  gavl_video_frame_destroy(out_frame);
+  return (float)min_t / (CALIBRATE_WIDTH * CALIBRATE_HEIGHT);
+  }
+
+/*
+ *  Conversions without a direct function are done in several steps.
+ *  Estimate them as the cheapest combination of two measured steps.
+ */
+
+static void estimate_indirect(float * tab, int num)
+  {
+  int i, j, k;
+  float test;
+  
+  for(i = 1; i < num; i++)
+    {
+    for(j = 1; j < num; j++)
+      {
+      if((i == j) || (tab[i * num + j] >= 0.0))
+        continue;
+
+      for(k = 1; k < num; k++)
+        {
+        if((tab[i * num + k] < 0.0) || (tab[k * num + j] < 0.0) ||
+           (k == i) || (k == j))
+          continue;
+        
+        test = tab[i * num + k] + tab[k * num + j];
+        if((tab[i * num + j] < 0.0) || (test < tab[i * num + j]))
+          tab[i * num + j] = test;
+        }
+      }
+    }
+  }
+
+static float * calibrate(int num, int accel)
+  {
+  int i, j;
+  float * ret;
+  gavl_video_options_t opt;
+  gavl_video_convert_context_t ctx;
+  gavl_video_func_t func;
+  gavl_video_scaler_t * scaler;
+  
+  ret = create_tab(num);
+
+  gavl_video_options_set_defaults(&opt);
+  gavl_video_options_set_accel_flags(&opt, accel);
+  scaler = gavl_video_scaler_create();
+  gavl_video_options_set_accel_flags(gavl_video_scaler_get_options(scaler),
+                                     accel);
+  
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.options = &opt;
+  ctx.input_format.image_width  = CALIBRATE_WIDTH;
+  ctx.input_format.image_height = CALIBRATE_HEIGHT;
+  ctx.input_format.frame_width  = CALIBRATE_WIDTH;
+  ctx.input_format.frame_height = CALIBRATE_HEIGHT;
+  ctx.input_format.pixel_width  = 1;
+  ctx.input_format.pixel_height = 1;
+  
+  for(i = 1; i < num; i++)
+    {
+    gavl_video_frame_t * in_frame;
+    
+    ctx.input_format.pixelformat = gavl_get_pixelformat(i);
+    in_frame = gavl_video_frame_create(&ctx.input_format);
+    gavl_video_frame_clear(in_frame, &ctx.input_format);
+    ctx.input_frame = in_frame;
+    
+    for(j = 1; j < num; j++)
+      {
+      if(i == j)
+        continue;
+      
+      gavl_video_format_copy(&ctx.output_format, &ctx.input_format);
+      ctx.output_format.pixelformat = gavl_get_pixelformat(j);
+      
+      if(gavl_pixelformat_can_scale(ctx.input_format.pixelformat,
+                                    ctx.output_format.pixelformat))
+        ret[i * num + j] = measure_scale(scaler, &ctx.input_format,
+                                         &ctx.output_format, in_frame);
+      else if((func = gavl_find_pixelformat_converter(&opt,
+                                                 ctx.input_format.pixelformat,
+                                                 ctx.output_format.pixelformat,
+                                                 CALIBRATE_WIDTH, CALIBRATE_HEIGHT)))
+        ret[i * num + j] = measure(&ctx, func);
+      }
+    gavl_video_frame_destroy(in_frame);
+    }
+  gavl_video_scaler_destroy(scaler);
+  
+  estimate_indirect(ret, num);
+  return ret;
+  }
+
+/* Cache file. The header contains the flags, under which the
+   costs were measured */
+
+static char * get_header(int accel)
+  {
+  return gavl_sprintf("gavl-pixelformat-costs %s 0x%08x", VERSION, accel);
+  }
+
+static float * load_costs(const char * filename, int num, int accel)
+  {
+  FILE * f;
+  char line[256];
+  char src[64];
+  char dst[64];
+  float val;
+  int i, j;
+  char * header;
+  float * ret = NULL;
+
+  if(!(f = fopen(filename, "r")))
+    return NULL;
+
+  header = get_header(accel);
+
+  /* Outdated or from another CPU */
+  if(!fgets(line, sizeof(line), f) ||
+     strncmp(line, header, strlen(header)))
+    goto fail;
+
+  ret = create_tab(num);
+
+  while(fgets(line, sizeof(line), f))
+    {
+    if(sscanf(line, "%63s %63s %f", src, dst, &val) < 3)
+      continue;
+    i = get_index(gavl_short_string_to_pixelformat(src));
+    j = get_index(gavl_short_string_to_pixelformat(dst));
+    if((i > 0) && (j > 0))
+      ret[i * num + j] = val;
+    }
+
+  fail:
+  free(header);
+  fclose(f);
+  return ret;
+  }
+
+static void save_costs(const char * filename, const float * tab, int num,
+                       int accel)
+  {
+  FILE * f;
+  int i, j;
+  char * header;
+
+  if(!(f = fopen(filename, "w")))
+    {
+    gavl_log(GAVL_LOG_WARNING, LOG_DOMAIN, "Cannot write %s", filename);
+    return;
+    }
+  header = get_header(accel);
+  fprintf(f, "%s\n", header);
+  free(header);
+
+  for(i = 1; i < num; i++)
+    {
+    for(j = 1; j < num; j++)
+      {
+      if(tab[i * num + j] < 0.0)
+        continue;
+      fprintf(f, "%s %s %f\n",
+              gavl_pixelformat_to_short_string(gavl_get_pixelformat(i)),
+              gavl_pixelformat_to_short_string(gavl_get_pixelformat(j)),
+              tab[i * num + j]);
+      }
+    }
+  fclose(f);
+  }
+
+int gavl_pixelformat_calibrate(const char * cache_file)
+  {
+  float * tab;
+  char * dir = NULL;
+  char * filename = NULL;
+  int num = gavl_num_pixelformats() + 1;
+  int accel = gavl_accel_supported();
+  
+  if(cache_file)
+    filename = gavl_strdup(cache_file);
+  else if((dir = gavl_search_cache_dir(PACKAGE, NULL, NULL)))
+    {
+    filename = gavl_sprintf("%s/%s", dir, COST_FILE);
+    free(dir);
+    }
+
+  if(!filename || !(tab = load_costs(filename, num, accel)))
+    {
+    gavl_log(GAVL_LOG_INFO, LOG_DOMAIN, "Measuring pixelformat conversions");
+    tab = calibrate(num, accel);
+    if(filename)
+      save_costs(filename, tab, num, accel);
+    }
+
+  if(filename)
+    free(filename);
+
+  pthread_mutex_lock(&cost_mutex);
+  if(cost_tab)
+    free(cost_tab);
+  cost_tab = tab;
+  cost_num = num;
+  pthread_mutex_unlock(&cost_mutex);
+  return 1;
+  }
+
+/* Calibrate on first use if the environment variable is set.
+   An empty value means the default cache file */
+
+static void check_env(void)
+  {
+  const char * var;
+
+  /* The calibration itself calls this again */
+  pthread_mutex_lock(&cost_mutex);
+  if(env_checked)
+    {
+    pthread_mutex_unlock(&cost_mutex);
+    return;
+    }
+  env_checked = 1;
+  pthread_mutex_unlock(&cost_mutex);
+  
+  if((var = getenv(COST_ENV)))
+    gavl_pixelformat_calibrate(*var ? var : NULL);
+  }
+
+/* Calibrated is set under the same lock, since the table can be
+   replaced by gavl_pixelformat_calibrate() at any time */
+
+static float get_cost(gavl_pixelformat_t src,
+                      gavl_pixelformat_t dst, int * calibrated)
+  {
+  int i, j;
+  float ret = -1.0;
+
+  check_env();
+
+  i = get_index(src);
+  j = get_index(dst);
+
+  pthread_mutex_lock(&cost_mutex);
+  if(cost_tab && (i > 0) && (j > 0) && (i < cost_num) && (j < cost_num))
+    ret = cost_tab[i * cost_num + j];
+  if(calibrated)
+    *calibrated = !!cost_tab;
+  pthread_mutex_unlock(&cost_mutex);
+  return ret;
+  }
+
+float gavl_pixelformat_get_cost(gavl_pixelformat_t src,
+                                gavl_pixelformat_t dst)
+  {
+  return get_cost(src, dst, NULL);
+  }
+
+/*
+ *  Map the cost to 1..255 for the lowest bits of the conversion penalty.
+ *  The scale is logarithmic, 16 steps per factor of 2.
+ */
+
+int gavl_pixelformat_get_cost_rank(gavl_pixelformat_t src,
+                                   gavl_pixelformat_t dst)
+  {
+  int ret, calibrated;
+  float cost = get_cost(src, dst, &calibrated);
+
+  /* Not calibrated */
+  if(!calibrated)
+    return 1;
+
+  /* No conversion path known */
+  if(cost < 0.0)
+    return 255;
+
+  if(cost == 0.0)
+    return 1;
+
+  ret = 128 + (int)(log2f(cost) * 16.0);
+
+  if(ret < 1)
+    ret = 1;
+  if(ret > 255)
+    ret = 255;
+  return ret;
+  }
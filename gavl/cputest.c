@@ -43,6 +43,8 @@
 #define MM_SSSE3    GAVL_ACCEL_SSSE3
 #define MM_3DNOW    GAVL_ACCEL_3DNOW
 #define MM_3DNOWEXT GAVL_ACCEL_3DNOWEXT
+#define MM_AVX      GAVL_ACCEL_AVX
+#define MM_AVX2     GAVL_ACCEL_AVX2
 
 #ifdef ARCH_X86_64
 #  define REG_b "rbx"
@@ -62,6 +64,23 @@
            "=c" (ecx), "=d" (edx)\
          : "0" (index));
 
+/* Same as above for leafs with subleafs (passed in ecx) */
+#define cpuid_count(index,count,eax,ebx,ecx,edx)\
+    __asm __volatile\
+        ("mov %%"REG_b", %%"REG_S"\n\t"\
+         "cpuid\n\t"\
+         "xchg %%"REG_b", %%"REG_S\
+         : "=a" (eax), "=S" (ebx),\
+           "=c" (ecx), "=d" (edx)\
+         : "0" (index), "2" (count));
+
+/* Check if the OS saves the upper halves of the ymm registers */
+#define xgetbv(index,eax,edx)\
+    __asm __volatile\
+        (".byte 0x0f, 0x01, 0xd0"\
+         : "=a" (eax), "=d" (edx)\
+         : "c" (index));
+
 /* Function to test if multimedia instructions are supported...  */
 
 int gavl_accel_supported()
@@ -69,7 +88,7 @@ int gavl_accel_supported()
 #ifdef ARCH_X86
      int rval = 0;
     int eax, ebx, ecx, edx;
-    int max_std_level, max_ext_level, std_caps=0, ext_caps=0;
+    int max_std_level, max_ext_level, std_caps=0, ext_caps=0, has_fma=0;
 
 #ifndef ARCH_X86_64
     long a, c;
@@ -114,6 +133,21 @@ int gavl_accel_supported()
         if (ecx & 0x00000200 )
           rval |= MM_SSSE3;
 
+        /* AVX needs OSXSAVE and the OS enabling the xmm and ymm state */
+        if((ecx & (1<<27)) && (ecx & (1<<28)))
+          {
+          xgetbv(0, eax, edx);
+          if((eax & 0x06) == 0x06)
+            rval |= MM_AVX;
+          }
+        /* The AVX2 routines are compiled with -mfma */
+        has_fma = !!(ecx & (1<<12));
+    }
+
+    if((max_std_level >= 7) && (rval & MM_AVX) && has_fma){
+        cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if (ebx & (1<<5))
+            rval |= MM_AVX2;
     }
 
     cpuid(0x80000000, max_ext_level, ebx, ecx, edx);
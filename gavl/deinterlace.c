@@ -49,6 +49,16 @@ void gavl_video_deinterlacer_destroy(gavl_video_deinterlacer_t * d)
 
   if(d->scaler)
     gavl_video_scaler_destroy(d->scaler);
+
+  if(d->prev_frame)
+    gavl_video_frame_destroy(d->prev_frame);
+  if(d->save_frame)
+    gavl_video_frame_destroy(d->save_frame);
+
+  gavl_video_jobs_free(&d->jobs);
+  
+  if(d->tp_priv)
+    gavl_thread_pool_destroy(d->tp_priv);
   
   free(d);
   }
@@ -79,6 +89,19 @@ int gavl_video_deinterlacer_init(gavl_video_deinterlacer_t * d,
 
   d->num_planes = gavl_pixelformat_num_planes(d->format.pixelformat);
   gavl_pixelformat_chroma_sub(d->format.pixelformat, &d->sub_h, &d->sub_v);
+
+  /* Previous frames are only allocated by the adaptive deinterlacer */
+  if(d->prev_frame)
+    {
+    gavl_video_frame_destroy(d->prev_frame);
+    d->prev_frame = NULL;
+    }
+  if(d->save_frame)
+    {
+    gavl_video_frame_destroy(d->save_frame);
+    d->save_frame = NULL;
+    }
+  d->have_prev = 0;
   
   switch(d->opt.deinterlace_mode)
     {
@@ -94,6 +117,10 @@ int gavl_video_deinterlacer_init(gavl_video_deinterlacer_t * d,
       if(!gavl_deinterlacer_init_blend(d))
         return 0;
       break;
+    case GAVL_DEINTERLACE_ADAPTIVE:
+      if(!gavl_deinterlacer_init_adaptive(d))
+        return 0;
+      break;
     }
   return 1;
   }
@@ -108,9 +135,23 @@ void gavl_video_deinterlacer_deinterlace(gavl_video_deinterlacer_t * d,
        (d->opt.conversion_flags & GAVL_FORCE_DEINTERLACE))
       d->func(d, input_frame, output_frame);
     else
+      {
       gavl_video_frame_copy(&d->format, output_frame, input_frame);
+
+      /* Progressive frames are the previous frame for the next one */
+      if(d->prev_frame)
+        {
+        gavl_video_frame_copy(&d->format, d->prev_frame, input_frame);
+        d->have_prev = 1;
+        }
+      }
     }
   else
     d->func(d, input_frame, output_frame);
   }
 
+void gavl_video_deinterlacer_reset(gavl_video_deinterlacer_t * d)
+  {
+  d->have_prev = 0;
+  }
+
@@ -0,0 +1,271 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <deinterlace.h>
+#include <accel.h>
+
+/*
+ *  Motion adaptive deinterlacing: The lines of the first field are
+ *  kept, the ones of the second field are interpolated from the
+ *  current and the previous frame. The scanlines of all planes are
+ *  processed in one parallel loop. Each scanline of the input frame
+ *  is also copied into save_frame, which becomes the previous frame
+ *  for the next call.
+ */
+
+/* Line y + delta, mirrored at the image borders */
+
+static int get_line(int y, int delta, int height)
+  {
+  int ret = y + delta;
+  if((ret < 0) || (ret >= height))
+    ret = y - delta;
+  if((ret < 0) || (ret >= height))
+    ret = y;
+  return ret;
+  }
+
+static void adaptive_rows(void * data, int start, int end)
+  {
+  int i, y;
+  const uint8_t * cur[5];
+  const uint8_t * prev[5];
+  const uint8_t * src;
+  uint8_t * dst;
+
+  gavl_video_deinterlace_plane_t * p = data;
+  gavl_video_deinterlacer_t * d = p->d;
+
+  int plane = p->plane;
+  int src_stride  = d->input_frame->strides[plane];
+  int prev_stride = d->prev_frame->strides[plane];
+
+  for(y = start; y < end; y++)
+    {
+    src = d->input_frame->planes[plane] + y * src_stride;
+    dst = d->output_frame->planes[plane] + y * d->output_frame->strides[plane];
+
+    if((y & 1) == d->field)
+      gavl_memcpy(dst, src, p->bytes);
+    else
+      {
+      for(i = 0; i < 5; i++)
+        {
+        cur[i] = d->input_frame->planes[plane] +
+          get_line(y, i - 2, p->height) * src_stride;
+        prev[i] = d->prev_frame->planes[plane] +
+          get_line(y, i - 2, p->height) * prev_stride;
+        }
+      d->adaptive_func(d->have_prev ? prev : NULL, cur, dst,
+                       0, p->num, p->num, d->advance);
+      }
+
+    gavl_memcpy(d->save_frame->planes[plane] +
+                y * d->save_frame->strides[plane], src, p->bytes);
+    }
+  }
+
+static void deinterlace_adaptive(gavl_video_deinterlacer_t * d,
+                                 const gavl_video_frame_t * input_frame,
+                                 gavl_video_frame_t * output_frame)
+  {
+  int i;
+  gavl_video_frame_t * swp;
+  gavl_interlace_mode_t mode;
+
+  /* Keep the field, which comes first */
+  mode = d->mixed ? input_frame->interlace_mode : d->format.interlace_mode;
+  d->field = (mode == GAVL_INTERLACE_BOTTOM_FIRST) ? 1 : 0;
+
+  d->input_frame = input_frame;
+  d->output_frame = output_frame;
+
+  gavl_video_jobs_reset(&d->jobs);
+  for(i = 0; i < d->num_planes; i++)
+    gavl_video_jobs_add(&d->jobs, adaptive_rows, &d->planes[i],
+                        d->planes[i].height);
+  gavl_video_jobs_run(&d->jobs, d->opt.tp);
+
+  swp = d->prev_frame;
+  d->prev_frame = d->save_frame;
+  d->save_frame = swp;
+  d->have_prev = 1;
+  }
+
+int gavl_deinterlacer_init_adaptive(gavl_video_deinterlacer_t * d)
+  {
+  int i, bytes_per_sample;
+  gavl_video_deinterlace_adaptive_func_table_t tab;
+
+  memset(&tab, 0, sizeof(tab));
+  if(d->opt.quality || (d->opt.accel_flags & GAVL_ACCEL_C))
+    gavl_find_deinterlacer_adaptive_funcs_c(&tab, &d->opt, &d->format);
+
+#ifdef HAVE_SSE2
+  if(d->opt.accel_flags & GAVL_ACCEL_SSE2)
+    gavl_find_deinterlacer_adaptive_funcs_sse2(&tab, &d->opt, &d->format);
+#endif
+
+  d->advance = 1;
+  d->adaptive_func = NULL;
+
+  switch(d->format.pixelformat)
+    {
+    case GAVL_GRAY_8:
+    case GAVL_YUV_420_P:
+    case GAVL_YUVJ_420_P:
+    case GAVL_YUV_410_P:
+    case GAVL_YUV_422_P:
+    case GAVL_YUV_411_P:
+    case GAVL_YUV_444_P:
+    case GAVL_YUVJ_422_P:
+    case GAVL_YUVJ_444_P:
+      d->adaptive_func = tab.func_8;
+      break;
+    case GAVL_GRAYA_16:
+      d->advance = 2;
+      d->adaptive_func = tab.func_8;
+      break;
+    case GAVL_RGB_24:
+    case GAVL_BGR_24:
+      d->advance = 3;
+      d->adaptive_func = tab.func_8;
+      break;
+    case GAVL_RGB_32:
+    case GAVL_BGR_32:
+    case GAVL_RGBA_32:
+    case GAVL_YUVA_32:
+      d->advance = 4;
+      d->adaptive_func = tab.func_8;
+      break;
+    case GAVL_YUY2:
+      d->advance = 2;
+      d->adaptive_func = tab.func_yuy2;
+      break;
+    case GAVL_UYVY:
+      d->advance = 2;
+      d->adaptive_func = tab.func_uyvy;
+      break;
+    case GAVL_GRAY_16:
+    case GAVL_YUV_444_P_16:
+    case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
+      d->adaptive_func = tab.func_16;
+      break;
+    case GAVL_GRAYA_32:
+      d->advance = 2;
+      d->adaptive_func = tab.func_16;
+      break;
+    case GAVL_RGB_48:
+      d->advance = 3;
+      d->adaptive_func = tab.func_16;
+      break;
+    case GAVL_RGBA_64:
+    case GAVL_YUVA_64:
+      d->advance = 4;
+      d->adaptive_func = tab.func_16;
+      break;
+    case GAVL_GRAY_FLOAT:
+      d->adaptive_func = tab.func_float;
+      break;
+    case GAVL_GRAYA_FLOAT:
+      d->advance = 2;
+      d->adaptive_func = tab.func_float;
+      break;
+    case GAVL_RGB_FLOAT:
+    case GAVL_YUV_FLOAT:
+      d->advance = 3;
+      d->adaptive_func = tab.func_float;
+      break;
+    case GAVL_RGBA_FLOAT:
+    case GAVL_YUVA_FLOAT:
+      d->advance = 4;
+      d->adaptive_func = tab.func_float;
+      break;
+    case GAVL_RGB_15:
+    case GAVL_BGR_15:
+    case GAVL_RGB_16:
+    case GAVL_BGR_16:
+      /* Packed components: Blend instead */
+      return gavl_deinterlacer_init_blend(d);
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
+    case GAVL_PIXELFORMAT_NONE:
+      break;
+    }
+
+  if(!d->adaptive_func)
+    return 0;
+
+  if(gavl_pixelformat_is_planar(d->format.pixelformat))
+    bytes_per_sample =
+      gavl_pixelformat_bytes_per_component(d->format.pixelformat);
+  else
+    bytes_per_sample =
+      gavl_pixelformat_bytes_per_pixel(d->format.pixelformat) / d->advance;
+
+  if((d->format.pixelformat == GAVL_YUY2) ||
+     (d->format.pixelformat == GAVL_UYVY))
+    bytes_per_sample = 1;
+
+  for(i = 0; i < d->num_planes; i++)
+    {
+    d->planes[i].d = d;
+    d->planes[i].plane = i;
+    d->planes[i].height = d->format.image_height;
+    if(gavl_pixelformat_is_planar(d->format.pixelformat))
+      d->planes[i].num = d->format.image_width;
+    else
+      d->planes[i].num = d->format.image_width *
+        gavl_pixelformat_bytes_per_pixel(d->format.pixelformat) /
+        bytes_per_sample;
+
+    if(i)
+      {
+      d->planes[i].height /= d->sub_v;
+      d->planes[i].num /= d->sub_h;
+      }
+    d->planes[i].bytes = d->planes[i].num * bytes_per_sample;
+    }
+
+  d->prev_frame = gavl_video_frame_create(&d->format);
+  d->save_frame = gavl_video_frame_create(&d->format);
+
+  if(!d->opt.tp)
+    {
+    if(!d->tp_priv)
+      d->tp_priv = gavl_thread_pool_get_shared();
+    d->opt.tp = d->tp_priv;
+    }
+  
+  gavl_init_memcpy();
+
+  d->func = deinterlace_adaptive;
+  return 1;
+  }
@@ -170,6 +170,7 @@ int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d)
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       d->line_width = d->format.image_width;
       d->blend_func = tab.func_16;
       break;
@@ -184,6 +185,10 @@ int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d)
       d->line_width = d->format.image_width;
       d->blend_func = tab.func_8;
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
       
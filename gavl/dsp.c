@@ -45,6 +45,16 @@ static void init_table(gavl_dsp_context_t* ctx)
     gavl_dsp_init_sse(&ctx->funcs, ctx->quality);
 #endif       
 
+#ifdef HAVE_SSE2
+  if(ctx->accel_flags & GAVL_ACCEL_SSE2)
+    gavl_dsp_init_sse2(&ctx->funcs, ctx->quality);
+#endif       
+
+#ifdef HAVE_AVX2
+  if(ctx->accel_flags & GAVL_ACCEL_AVX2)
+    gavl_dsp_init_avx2(&ctx->funcs, ctx->quality);
+#endif       
+
 
   }
 
@@ -128,10 +128,15 @@ int gavl_dsp_interpolate_video_frame(gavl_dsp_context_t * ctx,
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
     case GAVL_YUV_422_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
       interpolate = ctx->funcs.interpolate_8;
       break;
     case GAVL_YUV_422_P_16:
     case GAVL_YUV_444_P_16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
       interpolate = ctx->funcs.interpolate_16;
       break;
     case GAVL_PIXELFORMAT_NONE:
@@ -159,6 +164,9 @@ int gavl_dsp_interpolate_video_frame(gavl_dsp_context_t * ctx,
       {
       width /= sub_h;
       height /= sub_v;
+      /* Interleaved chroma */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        width *= 2;
       }
     }
   return 1;
@@ -299,9 +307,14 @@ int gavl_dsp_video_frame_swap_endian(gavl_dsp_context_t * ctx,
       num_planes = 3;
       break;
     case GAVL_YUV_444_P_16:
+    case GAVL_YUV_420_P_16:
       do_swap = ctx->funcs.bswap_16;
       num_planes = 3;
       break;
+    case GAVL_P016:
+      do_swap = ctx->funcs.bswap_16;
+      num_planes = 2;
+      break;
     case GAVL_YUY2:
     case GAVL_UYVY:
     case GAVL_RGB_24:
@@ -314,6 +327,9 @@ int gavl_dsp_video_frame_swap_endian(gavl_dsp_context_t * ctx,
     case GAVL_YUVJ_420_P:
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
     case GAVL_PIXELFORMAT_NONE:
     case GAVL_GRAY_8:
     case GAVL_GRAYA_16:
@@ -334,6 +350,9 @@ int gavl_dsp_video_frame_swap_endian(gavl_dsp_context_t * ctx,
       {
       height /= sub_v;
       len /= sub_h;
+      /* Interleaved chroma */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        len *= 2;
       }
     
     src = frame->planes[i];
@@ -372,13 +391,13 @@ gavl_dsp_video_frame_shift_bits(gavl_dsp_context_t * ctx,
     if(gavl_pixelformat_bytes_per_component(format->pixelformat) != 2)
       return;
     channels = 1;
+    gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
     }
   else
     {
     channels = gavl_pixelformat_num_channels(format->pixelformat);
     if(gavl_pixelformat_bytes_per_pixel(format->pixelformat) != 2*channels)
       return;
-    gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
     }
 
   if(bits < 0)
@@ -398,6 +417,9 @@ gavl_dsp_video_frame_shift_bits(gavl_dsp_context_t * ctx,
       {
       height /= sub_v;
       len /= sub_h;
+      /* Interleaved chroma */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        len *= 2;
       }
 
     src = frame->planes[i];
@@ -440,13 +462,13 @@ gavl_dsp_video_frame_shift_bits_copy(gavl_dsp_context_t * ctx,
     if(gavl_pixelformat_bytes_per_component(format->pixelformat) != 2)
       return;
     channels = 1;
+    gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
     }
   else
     {
     channels = gavl_pixelformat_num_channels(format->pixelformat);
     if(gavl_pixelformat_bytes_per_pixel(format->pixelformat) != 2*channels)
       return;
-    gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
     }
 
   if(bits < 0)
@@ -466,6 +488,9 @@ gavl_dsp_video_frame_shift_bits_copy(gavl_dsp_context_t * ctx,
       {
       height /= sub_v;
       len /= sub_h;
+      /* Interleaved chroma */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        len *= 2;
       }
 
     src_ptr = src->planes[i];
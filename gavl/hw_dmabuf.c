@@ -126,6 +126,15 @@ drm_formats[] =
     { DRM_FORMAT_YVU422,   GAVL_YUVJ_422_P, GAVL_DMABUF_FLAG_SWAP_CHROMA },
     { DRM_FORMAT_YUV444,   GAVL_YUVJ_444_P                               },
     { DRM_FORMAT_YVU444,   GAVL_YUVJ_444_P, GAVL_DMABUF_FLAG_SWAP_CHROMA },
+    { DRM_FORMAT_NV12,     GAVL_NV12                                     },
+    { DRM_FORMAT_NV21,     GAVL_NV21                                     },
+    { DRM_FORMAT_NV16,     GAVL_NV16                                     },
+#ifdef DRM_FORMAT_P016
+    /* P010 and P012 are MSB aligned and can be handled as P016 */
+    { DRM_FORMAT_P016,     GAVL_P016                                     },
+    { DRM_FORMAT_P010,     GAVL_P016                                     },
+    { DRM_FORMAT_P012,     GAVL_P016                                     },
+#endif
 
     /*
      *  Creating Image failed 00003009
@@ -68,6 +68,10 @@
 #define DRM_FORMAT_YUV422   0
 #define DRM_FORMAT_YUYV     0
 #define DRM_FORMAT_UYVY     0
+#define DRM_FORMAT_NV12     0
+#define DRM_FORMAT_NV21     0
+#define DRM_FORMAT_NV16     0
+#define DRM_FORMAT_P010     0
 #endif
 
 
@@ -3353,7 +3357,15 @@ pixelformats[] =
 
 /* two planes -- one Y, one Cr + Cb interleaved  */
     // #define V4L2_PIX_FMT_NV12    v4l2_fourcc('N','V','1','2') /* 12  Y/CbCr 4:2:0  */
+   { V4L2_PIX_FMT_NV12, GAVL_NV12, GAVL_CODEC_ID_NONE, DRM_FORMAT_NV12 },
     // #define V4L2_PIX_FMT_NV21    v4l2_fourcc('N','V','2','1') /* 12  Y/CrCb 4:2:0  */
+   { V4L2_PIX_FMT_NV21, GAVL_NV21, GAVL_CODEC_ID_NONE, DRM_FORMAT_NV21 },
+    // #define V4L2_PIX_FMT_NV16    v4l2_fourcc('N','V','1','6') /* 16  Y/CbCr 4:2:2  */
+   { V4L2_PIX_FMT_NV16, GAVL_NV16, GAVL_CODEC_ID_NONE, DRM_FORMAT_NV16 },
+    // #define V4L2_PIX_FMT_P010    v4l2_fourcc('P','0','1','0') /* 24  Y/CbCr 4:2:0 10-bit per component */
+#ifdef V4L2_PIX_FMT_P010
+   { V4L2_PIX_FMT_P010, GAVL_P016, GAVL_CODEC_ID_NONE, DRM_FORMAT_P010 },
+#endif
 
 /*  The following formats are not defined in the V4L2 specification */
     // #define V4L2_PIX_FMT_YUV410  v4l2_fourcc('Y','U','V','9') /*  9  YUV 4:1:0     */
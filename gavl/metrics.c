@@ -0,0 +1,814 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <accel.h>
+#include <metrics.h>
+
+/*
+ *  Frames of both streams are queued until the frame with the same
+ *  timestamp arrives in the other stream. For each pair, the downscaled
+ *  planes for the MS-SSIM are made in one parallel loop per scale.
+ *  Then the PSNR and SSIM of all planes and scales are calculated in
+ *  one parallel loop.
+ *
+ *  Each stream converts its frames with its own converter, so only the
+ *  queues are locked while a frame is put. The calculation is serialized
+ *  with a separate mutex, so the other stream can queue frames meanwhile.
+ */
+
+/* Weights of the scales, from Wang, Simoncelli, Bovik:
+   "Multi-scale structural similarity for image quality assessment" */
+
+static const double ms_ssim_weights[GAVL_METRICS_SCALES] =
+  { 0.0448, 0.2856, 0.3001, 0.2363, 0.1333 };
+
+static const gavl_pixelformat_t gray_formats[] =
+  {
+    GAVL_GRAY_8,
+    GAVL_GRAY_16,
+    GAVL_GRAY_FLOAT,
+    GAVL_PIXELFORMAT_NONE,
+  };
+
+static const gavl_pixelformat_t yuv_formats[] =
+  {
+    GAVL_YUV_420_P,
+    GAVL_YUV_410_P,
+    GAVL_YUV_411_P,
+    GAVL_YUV_422_P,
+    GAVL_YUV_444_P,
+    GAVL_YUVJ_420_P,
+    GAVL_YUVJ_422_P,
+    GAVL_YUVJ_444_P,
+    GAVL_YUV_420_P_16,
+    GAVL_YUV_422_P_16,
+    GAVL_YUV_444_P_16,
+    GAVL_PIXELFORMAT_NONE,
+  };
+
+static int has_format(const gavl_pixelformat_t * formats,
+                      gavl_pixelformat_t fmt)
+  {
+  int i = 0;
+  while(formats[i] != GAVL_PIXELFORMAT_NONE)
+    {
+    if(formats[i] == fmt)
+      return 1;
+    i++;
+    }
+  return 0;
+  }
+
+/* Frame pool */
+
+static gavl_video_frame_t * get_frame(gavl_video_metrics_t * m)
+  {
+  if(m->pool_size)
+    return m->pool[--m->pool_size];
+  return gavl_video_frame_create(&m->metrics_format);
+  }
+
+static void release_frame(gavl_video_metrics_t * m, gavl_video_frame_t * f)
+  {
+  m->pool[m->pool_size++] = f;
+  }
+
+/* Remove the first num frames from a queue */
+
+static void dequeue(gavl_video_metrics_t * m, gavl_metrics_stream_t * s,
+                    int num)
+  {
+  int i;
+  for(i = 0; i < num; i++)
+    release_frame(m, s->queue[i]);
+  if(num < s->num_queued)
+    memmove(s->queue, s->queue + num,
+            (s->num_queued - num) * sizeof(s->queue[0]));
+  s->num_queued -= num;
+  }
+
+static void reset(gavl_video_metrics_t * m)
+  {
+  int i, j, k;
+
+  for(i = 0; i < 2; i++)
+    {
+    dequeue(m, &m->streams[i], m->streams[i].num_queued);
+    if(m->streams[i].sink)
+      {
+      gavl_video_sink_destroy(m->streams[i].sink);
+      m->streams[i].sink = NULL;
+      }
+    }
+  
+  for(i = 0; i < m->pool_size; i++)
+    gavl_video_frame_destroy(m->pool[i]);
+  m->pool_size = 0;
+
+  for(i = 0; i < m->num_planes; i++)
+    {
+    for(j = 0; j < 2; j++)
+      {
+      for(k = 0; k < GAVL_METRICS_SCALES; k++)
+        {
+        if(m->planes[i].scaled[j][k])
+          {
+          free(m->planes[i].scaled[j][k]);
+          m->planes[i].scaled[j][k] = NULL;
+          }
+        }
+      }
+    }
+  m->num_planes = 0;
+  m->num_frames = 0;
+  m->frames_start = 0;
+  memset(m->stats, 0, sizeof(m->stats));
+  }
+
+gavl_video_metrics_t * gavl_video_metrics_create()
+  {
+  int i;
+  gavl_video_metrics_t * ret;
+  ret = calloc(1, sizeof(*ret));
+  
+  for(i = 0; i < 2; i++)
+    ret->streams[i].m = ret;
+  
+  gavl_video_options_set_defaults(&ret->opt);
+  pthread_mutex_init(&ret->mutex, NULL);
+  pthread_mutex_init(&ret->compare_mutex, NULL);
+  return ret;
+  }
+
+void gavl_video_metrics_destroy(gavl_video_metrics_t * m)
+  {
+  int i;
+  reset(m);
+
+  for(i = 0; i < 2; i++)
+    {
+    if(m->streams[i].cnv)
+      gavl_video_converter_destroy(m->streams[i].cnv);
+    }
+  if(m->frames)
+    free(m->frames);
+
+  gavl_video_jobs_free(&m->jobs);
+  
+  if(m->tp_priv)
+    gavl_thread_pool_destroy(m->tp_priv);
+  
+  pthread_mutex_destroy(&m->mutex);
+  pthread_mutex_destroy(&m->compare_mutex);
+  free(m);
+  }
+
+gavl_video_options_t *
+gavl_video_metrics_get_options(gavl_video_metrics_t * m)
+  {
+  return &m->opt;
+  }
+
+void gavl_video_metrics_set_callback(gavl_video_metrics_t * m,
+                                     gavl_video_metrics_callback cb,
+                                     void * data)
+  {
+  m->cb = cb;
+  m->cb_data = data;
+  }
+
+/* PSNR */
+
+static void psnr_rows(void * data, int start, int end)
+  {
+  int i;
+  const uint8_t * src1;
+  const uint8_t * src2;
+  gavl_metrics_plane_t * p = data;
+
+  for(i = start; i < end; i++)
+    {
+    src1 = p->src[0] + i * p->strides[0];
+    src2 = p->src[1] + i * p->strides[1];
+
+    switch(p->bytes)
+      {
+      case 1:
+        p->row_sums[i] = p->m->funcs.sse_8(src1, src2, p->width);
+        break;
+      case 2:
+        p->row_sums[i] = p->m->funcs.sse_16((const uint16_t*)src1,
+                                            (const uint16_t*)src2,
+                                            p->width);
+        break;
+      case 4:
+        p->row_sums[i] = p->m->funcs.sse_float((const float*)src1,
+                                               (const float*)src2,
+                                               p->width);
+        break;
+      }
+    }
+  }
+
+static double get_psnr(gavl_metrics_plane_t * p)
+  {
+  int i;
+  double mse = 0.0;
+  double max;
+  double ret;
+  
+  for(i = 0; i < p->height; i++)
+    mse += p->row_sums[i];
+  mse /= (double)p->width * p->height;
+
+  switch(p->bytes)
+    {
+    case 1:
+      max = 255.0;
+      break;
+    case 2:
+      max = 65535.0;
+      break;
+    default:
+      max = 1.0;
+      break;
+    }
+  
+  if(mse <= 0.0)
+    return GAVL_METRICS_PSNR_MAX;
+  
+  ret = 10.0 * log10(max * max / mse);
+  if(ret > GAVL_METRICS_PSNR_MAX)
+    ret = GAVL_METRICS_PSNR_MAX;
+  return ret;
+  }
+
+/* Downscale by averaging 2x2 pixels. The first scale is made from
+   the source plane, the others from the previous scale */
+
+static void scale_rows(void * data, int start, int end)
+  {
+  int i, j;
+  float * dst;
+  const uint8_t * src;
+  const float * src_f;
+  int stride;
+  gavl_metrics_scale_job_t * job = data;
+  gavl_metrics_plane_t * p = job->p;
+  int width = p->scaled_width[job->scale];
+
+  for(i = start; i < end; i++)
+    {
+    dst = p->scaled[job->stream][job->scale] + i * width;
+    
+    if(job->scale > 1)
+      {
+      stride = p->scaled_width[job->scale-1];
+      src_f = p->scaled[job->stream][job->scale-1] + 2 * i * stride;
+      for(j = 0; j < width; j++)
+        dst[j] = (src_f[2*j] + src_f[2*j+1] +
+                  src_f[stride + 2*j] + src_f[stride + 2*j+1]) * 0.25f;
+      continue;
+      }
+
+    stride = p->strides[job->stream];
+    src = p->src[job->stream] + 2 * i * stride;
+    
+    switch(p->bytes)
+      {
+      case 1:
+        for(j = 0; j < width; j++)
+          dst[j] = (src[2*j] + src[2*j+1] +
+                    src[stride + 2*j] + src[stride + 2*j+1]) *
+            (0.25f / 255.0f);
+        break;
+      case 2:
+        {
+        const uint16_t * s0 = (const uint16_t*)src;
+        const uint16_t * s1 = (const uint16_t*)(src + stride);
+        for(j = 0; j < width; j++)
+          dst[j] = (s0[2*j] + s0[2*j+1] + s1[2*j] + s1[2*j+1]) *
+            (0.25f / 65535.0f);
+        }
+        break;
+      case 4:
+        {
+        const float * s0 = (const float*)src;
+        const float * s1 = (const float*)(src + stride);
+        for(j = 0; j < width; j++)
+          dst[j] = (s0[2*j] + s0[2*j+1] + s1[2*j] + s1[2*j+1]) * 0.25f;
+        }
+        break;
+      }
+    }
+  }
+
+static void compare(gavl_video_metrics_t * m,
+                    const gavl_video_frame_t * ref,
+                    const gavl_video_frame_t * dist,
+                    gavl_video_metrics_frame_t * f)
+  {
+  int i, j, s, num;
+  double ssim, cs, ms_ssim, weight_sum;
+  double cs_scales[GAVL_METRICS_SCALES];
+  gavl_metrics_plane_t * p;
+  gavl_ssim_plane_t ssim_planes[GAVL_SSIM_MAX_PLANES];
+  int do_ssim = m->flags & (GAVL_METRICS_SSIM | GAVL_METRICS_MS_SSIM);
+
+  if(do_ssim)
+    gavl_ssim_init_planes(ssim_planes, ref, dist,
+                          &m->metrics_format, &m->ssim_funcs);
+  
+  for(i = 0; i < m->num_planes; i++)
+    {
+    p = &m->planes[i];
+    p->src[0] = ref->planes[i];
+    p->src[1] = dist->planes[i];
+    p->strides[0] = ref->strides[i];
+    p->strides[1] = dist->strides[i];
+
+    if(do_ssim)
+      {
+      p->ssim[0] = ssim_planes[i];
+      p->ssim[0].cs = (p->num_scales > 1);
+      }
+    }
+
+  /* Downscale */
+  
+  if(m->flags & GAVL_METRICS_MS_SSIM)
+    {
+    for(s = 1; s < GAVL_METRICS_SCALES; s++)
+      {
+      num = 0;
+      gavl_video_jobs_reset(&m->jobs);
+
+      for(i = 0; i < m->num_planes; i++)
+        {
+        p = &m->planes[i];
+        if(s >= p->num_scales)
+          continue;
+        for(j = 0; j < 2; j++)
+          {
+          m->scale_jobs[num].p = p;
+          m->scale_jobs[num].stream = j;
+          m->scale_jobs[num].scale = s;
+          gavl_video_jobs_add(&m->jobs, scale_rows, &m->scale_jobs[num],
+                              p->scaled_height[s]);
+          num++;
+          }
+        }
+      if(!num)
+        break;
+      gavl_video_jobs_run(&m->jobs, m->opt.tp);
+      }
+    }
+  
+  /* PSNR and SSIM of all planes and scales */
+
+  gavl_video_jobs_reset(&m->jobs);
+  
+  for(i = 0; i < m->num_planes; i++)
+    {
+    p = &m->planes[i];
+
+    if(m->flags & GAVL_METRICS_PSNR)
+      {
+      p->row_sums = malloc(p->height * sizeof(*p->row_sums));
+      gavl_video_jobs_add(&m->jobs, psnr_rows, p, p->height);
+      }
+    if(do_ssim)
+      {
+      gavl_ssim_add_jobs(&p->ssim[0], &m->jobs);
+
+      if(m->flags & GAVL_METRICS_MS_SSIM)
+        {
+        for(s = 1; s < p->num_scales; s++)
+          gavl_ssim_add_jobs(&p->ssim[s], &m->jobs);
+        }
+      }
+    }
+
+  gavl_video_jobs_run(&m->jobs, m->opt.tp);
+
+  /* Collect the results */
+
+  memset(f, 0, sizeof(*f));
+  f->pts = ref->timestamp;
+
+  for(i = 0; i < m->num_planes; i++)
+    {
+    p = &m->planes[i];
+
+    if(m->flags & GAVL_METRICS_PSNR)
+      {
+      f->values[GAVL_METRIC_PSNR][i] = get_psnr(p);
+      free(p->row_sums);
+      p->row_sums = NULL;
+      }
+
+    if(!do_ssim)
+      continue;
+    
+    gavl_ssim_get_result(&p->ssim[0], &ssim, &cs_scales[0]);
+    f->values[GAVL_METRIC_SSIM][i] = ssim;
+
+    if(!(m->flags & GAVL_METRICS_MS_SSIM))
+      continue;
+
+    /* The luminance term is only used on the last scale */
+    
+    for(s = 1; s < p->num_scales; s++)
+      gavl_ssim_get_result(&p->ssim[s], &ssim, &cs_scales[s]);
+
+    weight_sum = 0.0;
+    for(s = 0; s < p->num_scales; s++)
+      weight_sum += ms_ssim_weights[s];
+    
+    ms_ssim = 1.0;
+    for(s = 0; s < p->num_scales; s++)
+      {
+      cs = (s < p->num_scales - 1) ? cs_scales[s] : ssim;
+      if(cs < 0.0)
+        cs = 0.0;
+      ms_ssim *= pow(cs, ms_ssim_weights[s] / weight_sum);
+      }
+    f->values[GAVL_METRIC_MS_SSIM][i] = ms_ssim;
+    }
+  }
+
+/* Keep the results of a frame pair and update the statistics.
+   Called with the mutex locked */
+
+static void store_result(gavl_video_metrics_t * m,
+                         const gavl_video_metrics_frame_t * f)
+  {
+  int i, j;
+  gavl_video_metrics_stats_t * st;
+
+  if(m->num_frames < m->frames_alloc)
+    m->frames[(m->frames_start + m->num_frames++) % m->frames_alloc] = *f;
+  else if(m->frames_alloc < GAVL_METRICS_MAX_FRAMES)
+    {
+    m->frames_alloc += 1024;
+    m->frames = realloc(m->frames, m->frames_alloc * sizeof(*m->frames));
+    m->frames[m->num_frames++] = *f;
+    }
+  else
+    {
+    /* Drop the oldest frame */
+    m->frames[m->frames_start] = *f;
+    m->frames_start = (m->frames_start + 1) % m->frames_alloc;
+    }
+  
+  /* Update statistics */
+
+  for(i = 0; i < GAVL_METRIC_NUM; i++)
+    {
+    if(!(m->flags & (1<<i)))
+      continue;
+
+    for(j = 0; j < m->num_planes; j++)
+      {
+      st = &m->stats[i][j];
+      
+      if(!st->num_frames || (f->values[i][j] < st->min))
+        st->min = f->values[i][j];
+      if(!st->num_frames || (f->values[i][j] > st->max))
+        st->max = f->values[i][j];
+      
+      st->num_frames++;
+      st->mean += (f->values[i][j] - st->mean) / st->num_frames;
+      }
+    }
+  }
+
+static gavl_sink_status_t put_frame(void * priv, gavl_video_frame_t * in)
+  {
+  int i, index;
+  gavl_video_frame_t * frame;
+  gavl_video_frame_t * partner;
+  gavl_video_metrics_frame_t f;
+  gavl_metrics_stream_t * s = priv;
+  gavl_metrics_stream_t * other;
+  gavl_video_metrics_t * m = s->m;
+
+  index = s - m->streams;
+  other = &m->streams[!index];
+  
+  pthread_mutex_lock(&m->mutex);
+  frame = get_frame(m);
+  pthread_mutex_unlock(&m->mutex);
+  
+  if(m->do_convert)
+    gavl_video_convert(s->cnv, in, frame);
+  else
+    gavl_video_frame_copy(&m->format, frame, in);
+  gavl_video_frame_copy_metadata(frame, in);
+
+  pthread_mutex_lock(&m->mutex);
+  
+  for(i = 0; i < other->num_queued; i++)
+    {
+    if(other->queue[i]->timestamp == frame->timestamp)
+      break;
+    }
+
+  if(i == other->num_queued)
+    {
+    if(s->num_queued == GAVL_METRICS_QUEUE)
+      dequeue(m, s, 1);
+    s->queue[s->num_queued++] = frame;
+    pthread_mutex_unlock(&m->mutex);
+    return GAVL_SINK_OK;
+    }
+  
+  /* Take the partner out of the queue. Earlier frames
+     won't get a partner anymore */
+  dequeue(m, other, i);
+  partner = other->queue[0];
+  other->num_queued--;
+  memmove(other->queue, other->queue + 1,
+          other->num_queued * sizeof(other->queue[0]));
+  dequeue(m, s, s->num_queued);
+  
+  pthread_mutex_unlock(&m->mutex);
+
+  pthread_mutex_lock(&m->compare_mutex);
+  if(!index)
+    compare(m, frame, partner, &f);
+  else
+    compare(m, partner, frame, &f);
+  
+  pthread_mutex_lock(&m->mutex);
+  store_result(m, &f);
+  release_frame(m, frame);
+  release_frame(m, partner);
+  pthread_mutex_unlock(&m->mutex);
+
+  /* Callbacks are called in the order of the results */
+  if(m->cb)
+    m->cb(m->cb_data, &f);
+  pthread_mutex_unlock(&m->compare_mutex);
+  
+  return GAVL_SINK_OK;
+  }
+
+int gavl_video_metrics_init(gavl_video_metrics_t * m,
+                            const gavl_video_format_t * format,
+                            int flags)
+  {
+  int i, j, s, sub_h, sub_v, bytes;
+  gavl_metrics_plane_t * p;
+  
+  reset(m);
+
+  gavl_video_format_copy(&m->format, format);
+  gavl_video_format_copy(&m->metrics_format, format);
+  m->flags = flags;
+  
+  /* Get the format for the calculation */
+
+  m->do_convert = 0;
+  
+  if(!has_format(gray_formats, format->pixelformat) &&
+     !has_format(yuv_formats, format->pixelformat))
+    {
+    m->metrics_format.pixelformat =
+      gavl_pixelformat_get_best(format->pixelformat,
+                                gavl_pixelformat_is_gray(format->pixelformat) ?
+                                gray_formats : yuv_formats, NULL);
+    
+    /* One converter for each stream, so both can convert at once */
+    for(i = 0; i < 2; i++)
+      {
+      if(!m->streams[i].cnv)
+        m->streams[i].cnv = gavl_video_converter_create();
+      gavl_video_options_copy(gavl_video_converter_get_options(m->streams[i].cnv),
+                              &m->opt);
+    
+      if(gavl_video_converter_init(m->streams[i].cnv, &m->format,
+                                   &m->metrics_format) < 0)
+        return 0;
+      }
+    m->do_convert = 1;
+    }
+  
+  gavl_ssim_funcs_init(&m->ssim_funcs, m->opt.accel_flags);
+  gavl_init_metrics_funcs_c(&m->funcs);
+#ifdef HAVE_SSE2
+  if(m->opt.accel_flags & GAVL_ACCEL_SSE2)
+    gavl_init_metrics_funcs_sse2(&m->funcs);
+#endif
+  
+  /* Set up planes */
+
+  if(gavl_pixelformat_is_gray(m->metrics_format.pixelformat))
+    bytes = gavl_pixelformat_bytes_per_pixel(m->metrics_format.pixelformat);
+  else
+    bytes = gavl_pixelformat_bytes_per_component(m->metrics_format.pixelformat);
+
+  gavl_pixelformat_chroma_sub(m->metrics_format.pixelformat, &sub_h, &sub_v);
+  
+  m->num_planes = gavl_pixelformat_num_planes(m->metrics_format.pixelformat);
+
+  for(i = 0; i < m->num_planes; i++)
+    {
+    p = &m->planes[i];
+    p->m = m;
+    p->bytes = bytes;
+    p->width  = m->metrics_format.image_width;
+    p->height = m->metrics_format.image_height;
+
+    if(i)
+      {
+      p->width  /= sub_h;
+      p->height /= sub_v;
+      }
+
+    if((flags & (GAVL_METRICS_SSIM | GAVL_METRICS_MS_SSIM)) &&
+       ((p->width < GAVL_SSIM_MIN_SIZE) || (p->height < GAVL_SSIM_MIN_SIZE)))
+      {
+      m->num_planes = 0;
+      return 0;
+      }
+
+    /* Use as many scales as possible */
+    
+    p->num_scales = 1;
+
+    if(!(flags & GAVL_METRICS_MS_SSIM))
+      continue;
+    
+    while((p->num_scales < GAVL_METRICS_SCALES) &&
+          ((p->width  >> p->num_scales) >= GAVL_SSIM_MIN_SIZE) &&
+          ((p->height >> p->num_scales) >= GAVL_SSIM_MIN_SIZE))
+      p->num_scales++;
+
+    for(s = 1; s < p->num_scales; s++)
+      {
+      p->scaled_width[s]  = p->width  >> s;
+      p->scaled_height[s] = p->height >> s;
+
+      for(j = 0; j < 2; j++)
+        p->scaled[j][s] = malloc(p->scaled_width[s] * p->scaled_height[s] *
+                                 sizeof(*p->scaled[j][s]));
+
+      memset(&p->ssim[s], 0, sizeof(p->ssim[s]));
+      p->ssim[s].src1    = (const uint8_t*)p->scaled[0][s];
+      p->ssim[s].src2    = (const uint8_t*)p->scaled[1][s];
+      p->ssim[s].stride1 = p->scaled_width[s] * sizeof(float);
+      p->ssim[s].stride2 = p->scaled_width[s] * sizeof(float);
+      p->ssim[s].width   = p->scaled_width[s];
+      p->ssim[s].height  = p->scaled_height[s];
+      p->ssim[s].bytes   = 4;
+      p->ssim[s].cs      = (s < p->num_scales - 1);
+      p->ssim[s].funcs   = &m->ssim_funcs;
+      }
+    }
+
+  for(i = 0; i < 2; i++)
+    m->streams[i].sink =
+      gavl_video_sink_create(NULL, put_frame, &m->streams[i], &m->format);
+  
+  if(!m->opt.tp)
+    {
+    if(!m->tp_priv)
+      m->tp_priv = gavl_thread_pool_get_shared();
+    m->opt.tp = m->tp_priv;
+    }
+  
+  return m->num_planes;
+  }
+
+gavl_video_sink_t *
+gavl_video_metrics_get_reference_sink(gavl_video_metrics_t * m)
+  {
+  return m->streams[0].sink;
+  }
+
+gavl_video_sink_t *
+gavl_video_metrics_get_distorted_sink(gavl_video_metrics_t * m)
+  {
+  return m->streams[1].sink;
+  }
+
+int gavl_video_metrics_get_num_frames(gavl_video_metrics_t * m)
+  {
+  int ret;
+  pthread_mutex_lock(&m->mutex);
+  ret = m->num_frames;
+  pthread_mutex_unlock(&m->mutex);
+  return ret;
+  }
+
+const gavl_video_metrics_frame_t *
+gavl_video_metrics_get_frame(gavl_video_metrics_t * m, int index)
+  {
+  const gavl_video_metrics_frame_t * ret = NULL;
+  
+  pthread_mutex_lock(&m->mutex);
+  if((index >= 0) && (index < m->num_frames))
+    ret = &m->frames[(m->frames_start + index) % m->frames_alloc];
+  pthread_mutex_unlock(&m->mutex);
+  return ret;
+  }
+
+static int check_metric(gavl_video_metrics_t * m,
+                        gavl_metric_t metric, int plane)
+  {
+  if((metric < 0) || (metric >= GAVL_METRIC_NUM) ||
+     !(m->flags & (1<<metric)) ||
+     (plane < 0) || (plane >= m->num_planes) ||
+     !m->num_frames)
+    return 0;
+  return 1;
+  }
+
+int gavl_video_metrics_get_stats(gavl_video_metrics_t * m,
+                                 gavl_metric_t metric, int plane,
+                                 gavl_video_metrics_stats_t * ret)
+  {
+  pthread_mutex_lock(&m->mutex);
+  if(!check_metric(m, metric, plane))
+    {
+    pthread_mutex_unlock(&m->mutex);
+    return 0;
+    }
+  *ret = m->stats[metric][plane];
+  pthread_mutex_unlock(&m->mutex);
+  return 1;
+  }
+
+static int compare_double(const void * p1, const void * p2)
+  {
+  double d1 = *(const double*)p1;
+  double d2 = *(const double*)p2;
+  return (d1 < d2) ? -1 : (d1 > d2);
+  }
+
+int gavl_video_metrics_get_percentile(gavl_video_metrics_t * m,
+                                      gavl_metric_t metric, int plane,
+                                      double percent, double * ret)
+  {
+  int i, num;
+  double * values;
+  double pos;
+
+  pthread_mutex_lock(&m->mutex);
+  if(!check_metric(m, metric, plane))
+    {
+    pthread_mutex_unlock(&m->mutex);
+    return 0;
+    }
+
+  /* The order doesn't matter here */
+  num = m->num_frames;
+  values = malloc(num * sizeof(*values));
+  for(i = 0; i < num; i++)
+    values[i] = m->frames[i].values[metric][plane];
+  pthread_mutex_unlock(&m->mutex);
+  
+  qsort(values, num, sizeof(*values), compare_double);
+  
+  if(percent < 0.0)
+    percent = 0.0;
+  if(percent > 100.0)
+    percent = 100.0;
+  
+  pos = percent * 0.01 * (num - 1);
+  i = (int)pos;
+
+  if(i >= num - 1)
+    *ret = values[num - 1];
+  else
+    *ret = values[i] + (pos - i) * (values[i+1] - values[i]);
+  
+  free(values);
+  return 1;
+  }
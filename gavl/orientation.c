@@ -416,6 +416,30 @@ void gavl_video_format_normalize_orientation(gavl_video_format_t * in_format,
       if(in_format->chroma_placement != GAVL_CHROMA_PLACEMENT_DEFAULT)
         in_format->pixelformat = GAVL_YUV_444_P;
       break;
+    case GAVL_YUV_420_P_16:
+      if(in_format->chroma_placement != GAVL_CHROMA_PLACEMENT_DEFAULT)
+        in_format->pixelformat = GAVL_YUV_444_P_16;
+      break;
+      /* Semiplanar formats are rotated in their planar counterparts */
+    case GAVL_NV12:
+    case GAVL_NV21:
+      if(in_format->chroma_placement != GAVL_CHROMA_PLACEMENT_DEFAULT)
+        in_format->pixelformat = GAVL_YUV_444_P;
+      else
+        in_format->pixelformat = GAVL_YUV_420_P;
+      break;
+    case GAVL_NV16:
+      if(in_format->orientation != GAVL_IMAGE_ORIENT_FH_ROT180_CW)
+        in_format->pixelformat = GAVL_YUV_444_P;
+      else
+        in_format->pixelformat = GAVL_YUV_422_P;
+      break;
+    case GAVL_P016:
+      if(in_format->chroma_placement != GAVL_CHROMA_PLACEMENT_DEFAULT)
+        in_format->pixelformat = GAVL_YUV_444_P_16;
+      else
+        in_format->pixelformat = GAVL_YUV_420_P_16;
+      break;
     case GAVL_YUVJ_422_P:
       if(in_format->orientation != GAVL_IMAGE_ORIENT_FH_ROT180_CW)
         in_format->pixelformat = GAVL_YUV_444_P_16;
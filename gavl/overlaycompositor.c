@@ -0,0 +1,467 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <blend.h>
+
+/*
+ *  Each layer has its own blend context, which crops and aligns the
+ *  overlay. Layers with overlapping rectangles are merged into clusters.
+ *  The overlays of a cluster are blended into a composite in z-order,
+ *  which is then blended onto the frame in one pass. Composites are kept
+ *  until one of their layers changes.
+ */
+
+static void free_clusters(gavl_overlay_cluster_t * clusters, int num)
+  {
+  int i;
+  for(i = 0; i < num; i++)
+    {
+    if(clusters[i].ovl)
+      {
+      gavl_video_frame_destroy(clusters[i].ovl);
+      clusters[i].ovl = NULL;
+      }
+    }
+  }
+
+static void reset(gavl_overlay_compositor_t * c)
+  {
+  int i;
+
+  for(i = 0; i < c->num_layers; i++)
+    {
+    gavl_video_sink_destroy(c->layers[i]->sink);
+    gavl_overlay_blend_context_destroy(c->layers[i]->ctx);
+    free(c->layers[i]);
+    }
+  c->num_layers = 0;
+
+  free_clusters(c->clusters, c->num_clusters);
+  free_clusters(c->old_clusters, c->num_old_clusters);
+  c->num_clusters = 0;
+  c->num_old_clusters = 0;
+
+  if(c->comp_ctx)
+    {
+    gavl_overlay_blend_context_destroy(c->comp_ctx);
+    c->comp_ctx = NULL;
+    }
+  if(c->dst_ctx)
+    {
+    gavl_overlay_blend_context_destroy(c->dst_ctx);
+    c->dst_ctx = NULL;
+    }
+  c->changed = 1;
+  }
+
+gavl_overlay_compositor_t * gavl_overlay_compositor_create()
+  {
+  gavl_overlay_compositor_t * ret;
+  ret = calloc(1, sizeof(*ret));
+  ret->comp_win = gavl_video_frame_create(NULL);
+  gavl_video_options_set_defaults(&ret->opt);
+  return ret;
+  }
+
+void gavl_overlay_compositor_destroy(gavl_overlay_compositor_t * c)
+  {
+  int i;
+
+  reset(c);
+
+  for(i = 0; i < c->clusters_alloc; i++)
+    {
+    if(c->clusters[i].layers)
+      free(c->clusters[i].layers);
+    if(c->old_clusters[i].layers)
+      free(c->old_clusters[i].layers);
+    }
+
+  if(c->clusters)
+    free(c->clusters);
+  if(c->old_clusters)
+    free(c->old_clusters);
+  if(c->layers)
+    free(c->layers);
+
+  gavl_video_frame_null(c->comp_win);
+  gavl_video_frame_destroy(c->comp_win);
+  free(c);
+  }
+
+gavl_video_options_t *
+gavl_overlay_compositor_get_options(gavl_overlay_compositor_t * c)
+  {
+  return &c->opt;
+  }
+
+int gavl_overlay_compositor_init(gavl_overlay_compositor_t * c,
+                                 const gavl_video_format_t * frame_format)
+  {
+  gavl_video_format_t fmt;
+
+  reset(c);
+
+  gavl_video_format_copy(&c->dst_format, frame_format);
+
+  /* Composites are blended onto the frame. They can have the size
+     of the whole frame */
+
+  c->dst_ctx = gavl_overlay_blend_context_create();
+  gavl_video_options_copy(gavl_overlay_blend_context_get_options(c->dst_ctx),
+                          &c->opt);
+
+  gavl_video_format_copy(&c->ovl_format, frame_format);
+  if(!gavl_overlay_blend_context_init(c->dst_ctx, frame_format, &c->ovl_format))
+    return 0;
+
+  /* Overlays are blended into composites */
+
+  c->comp_ctx = gavl_overlay_blend_context_create();
+  gavl_video_format_copy(&fmt, &c->ovl_format);
+  if(!gavl_overlay_blend_context_init(c->comp_ctx, &c->ovl_format, &fmt) ||
+     (fmt.pixelformat != c->ovl_format.pixelformat))
+    return 0;
+
+  return 1;
+  }
+
+static gavl_sink_status_t put_frame(void * priv, gavl_overlay_t * ovl)
+  {
+  gavl_overlay_layer_t * l = priv;
+
+  l->changed = 1;
+  l->c->changed = 1;
+
+  return gavl_video_sink_put_frame(gavl_overlay_blend_context_get_sink(l->ctx), ovl);
+  }
+
+int gavl_overlay_compositor_add_layer(gavl_overlay_compositor_t * c,
+                                      gavl_video_format_t * overlay_format,
+                                      int z_order)
+  {
+  gavl_overlay_layer_t * l;
+
+  if(!c->dst_ctx)
+    return -1;
+
+  if(c->num_layers == c->layers_alloc)
+    {
+    c->layers_alloc += 8;
+    c->layers = realloc(c->layers, c->layers_alloc * sizeof(*c->layers));
+    }
+
+  l = calloc(1, sizeof(*l));
+
+  l->c = c;
+  l->z = z_order;
+  l->ctx = gavl_overlay_blend_context_create();
+  gavl_video_options_copy(gavl_overlay_blend_context_get_options(l->ctx),
+                          &c->opt);
+
+  if(!gavl_overlay_blend_context_init(l->ctx, &c->dst_format, overlay_format))
+    {
+    gavl_overlay_blend_context_destroy(l->ctx);
+    free(l);
+    return -1;
+    }
+  l->sink = gavl_video_sink_create(NULL, put_frame, l, overlay_format);
+
+  c->layers[c->num_layers] = l;
+  c->num_layers++;
+  return c->num_layers - 1;
+  }
+
+gavl_video_sink_t *
+gavl_overlay_compositor_get_sink(gavl_overlay_compositor_t * c, int layer)
+  {
+  return c->layers[layer]->sink;
+  }
+
+void gavl_overlay_compositor_set_overlay(gavl_overlay_compositor_t * c,
+                                         int layer, gavl_overlay_t * ovl)
+  {
+  gavl_video_sink_put_frame(c->layers[layer]->sink, ovl);
+  }
+
+/* Cluster handling */
+
+static int layer_cmp(const gavl_overlay_compositor_t * c, int a, int b)
+  {
+  if(c->layers[a]->z != c->layers[b]->z)
+    return c->layers[a]->z - c->layers[b]->z;
+  return a - b;
+  }
+
+static void cluster_add_layer(gavl_overlay_compositor_t * c,
+                              gavl_overlay_cluster_t * cl, int layer)
+  {
+  int i;
+
+  if(cl->num_layers == cl->layers_alloc)
+    {
+    cl->layers_alloc += 8;
+    cl->layers = realloc(cl->layers, cl->layers_alloc * sizeof(*cl->layers));
+    }
+
+  /* Insert sorted */
+  i = cl->num_layers;
+  while(i && (layer_cmp(c, cl->layers[i-1], layer) > 0))
+    {
+    cl->layers[i] = cl->layers[i-1];
+    i--;
+    }
+  cl->layers[i] = layer;
+  cl->num_layers++;
+  }
+
+static int rect_overlap(const gavl_rectangle_i_t * r1,
+                        const gavl_rectangle_i_t * r2)
+  {
+  return (r1->x < r2->x + r2->w) && (r2->x < r1->x + r1->w) &&
+    (r1->y < r2->y + r2->h) && (r2->y < r1->y + r1->h);
+  }
+
+static void rect_union(gavl_rectangle_i_t * r1,
+                       const gavl_rectangle_i_t * r2)
+  {
+  int x2, y2;
+
+  x2 = r1->x + r1->w;
+  if(x2 < r2->x + r2->w)
+    x2 = r2->x + r2->w;
+
+  y2 = r1->y + r1->h;
+  if(y2 < r2->y + r2->h)
+    y2 = r2->y + r2->h;
+
+  if(r1->x > r2->x)
+    r1->x = r2->x;
+  if(r1->y > r2->y)
+    r1->y = r2->y;
+
+  r1->w = x2 - r1->x;
+  r1->h = y2 - r1->y;
+  }
+
+static void merge_clusters(gavl_overlay_compositor_t * c)
+  {
+  int i, j, k;
+  gavl_overlay_cluster_t * ci, * cj;
+  gavl_overlay_cluster_t swp;
+  int merged = 1;
+
+  while(merged)
+    {
+    merged = 0;
+
+    for(i = 0; i < c->num_clusters; i++)
+      {
+      ci = c->clusters + i;
+
+      for(j = i + 1; j < c->num_clusters; j++)
+        {
+        cj = c->clusters + j;
+        if(!rect_overlap(&ci->rect, &cj->rect))
+          continue;
+
+        rect_union(&ci->rect, &cj->rect);
+        for(k = 0; k < cj->num_layers; k++)
+          cluster_add_layer(c, ci, cj->layers[k]);
+
+        /* Move the last cluster to position j, keep the layer arrays */
+        swp = *cj;
+        *cj = c->clusters[c->num_clusters-1];
+        c->clusters[c->num_clusters-1] = swp;
+        c->num_clusters--;
+
+        merged = 1;
+        j--;
+        }
+      }
+    }
+  }
+
+/* Take the composite from the last frame if nothing changed */
+
+static int reuse_composite(gavl_overlay_compositor_t * c,
+                           gavl_overlay_cluster_t * cl)
+  {
+  int i, j;
+  gavl_overlay_cluster_t * old;
+
+  for(i = 0; i < cl->num_layers; i++)
+    {
+    if(c->layers[cl->layers[i]]->changed)
+      return 0;
+    }
+
+  for(i = 0; i < c->num_old_clusters; i++)
+    {
+    old = c->old_clusters + i;
+
+    if(!old->ovl ||
+       (old->num_layers != cl->num_layers) ||
+       memcmp(&old->rect, &cl->rect, sizeof(cl->rect)))
+      continue;
+
+    for(j = 0; j < cl->num_layers; j++)
+      {
+      if(old->layers[j] != cl->layers[j])
+        break;
+      }
+    if(j < cl->num_layers)
+      continue;
+
+    cl->ovl = old->ovl;
+    old->ovl = NULL;
+    return 1;
+    }
+  return 0;
+  }
+
+static void make_composite(gavl_overlay_compositor_t * c,
+                           gavl_overlay_cluster_t * cl)
+  {
+  int i;
+  gavl_video_format_t fmt;
+  gavl_rectangle_i_t r;
+  gavl_overlay_blend_context_t * ctx;
+  const float transparent[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+  gavl_video_format_copy(&fmt, &c->ovl_format);
+  fmt.image_width  = cl->rect.w;
+  fmt.image_height = cl->rect.h;
+  fmt.frame_width  = cl->rect.w;
+  fmt.frame_height = cl->rect.h;
+
+  cl->ovl = gavl_video_frame_create(&fmt);
+  gavl_video_frame_fill(cl->ovl, &fmt, transparent);
+
+  for(i = 0; i < cl->num_layers; i++)
+    {
+    ctx = c->layers[cl->layers[i]]->ctx;
+
+    r.x = ctx->dst_rect.x - cl->rect.x;
+    r.y = ctx->dst_rect.y - cl->rect.y;
+    r.w = ctx->dst_rect.w;
+    r.h = ctx->dst_rect.h;
+
+    gavl_video_frame_get_subframe(fmt.pixelformat, cl->ovl, c->comp_win, &r);
+
+    c->comp_ctx->func(c->comp_win, ctx->ovl_win, r.w, r.h);
+    }
+
+  cl->ovl->src_rect.x = 0;
+  cl->ovl->src_rect.y = 0;
+  cl->ovl->src_rect.w = cl->rect.w;
+  cl->ovl->src_rect.h = cl->rect.h;
+  }
+
+static void update_clusters(gavl_overlay_compositor_t * c)
+  {
+  int i;
+  gavl_overlay_cluster_t * swp;
+  gavl_overlay_cluster_t * cl;
+
+  /* Remember the clusters of the last frame */
+
+  swp = c->old_clusters;
+  c->old_clusters = c->clusters;
+  c->clusters = swp;
+
+  c->num_old_clusters = c->num_clusters;
+  c->num_clusters = 0;
+
+  if(c->clusters_alloc < c->num_layers)
+    {
+    c->clusters = realloc(c->clusters, c->num_layers * sizeof(*c->clusters));
+    c->old_clusters = realloc(c->old_clusters,
+                              c->num_layers * sizeof(*c->old_clusters));
+    memset(c->clusters + c->clusters_alloc, 0,
+           (c->num_layers - c->clusters_alloc) * sizeof(*c->clusters));
+    memset(c->old_clusters + c->clusters_alloc, 0,
+           (c->num_layers - c->clusters_alloc) * sizeof(*c->old_clusters));
+    c->clusters_alloc = c->num_layers;
+    }
+
+  /* One cluster for each visible layer */
+
+  for(i = 0; i < c->num_layers; i++)
+    {
+    if(!c->layers[i]->ctx->ovl)
+      continue;
+
+    cl = c->clusters + c->num_clusters;
+    cl->rect = c->layers[i]->ctx->dst_rect;
+    cl->num_layers = 0;
+    cl->ovl = NULL;
+    cluster_add_layer(c, cl, i);
+    c->num_clusters++;
+    }
+
+  merge_clusters(c);
+
+  for(i = 0; i < c->num_clusters; i++)
+    {
+    cl = c->clusters + i;
+    if(cl->num_layers < 2)
+      continue;
+    if(!reuse_composite(c, cl))
+      make_composite(c, cl);
+    }
+
+  free_clusters(c->old_clusters, c->num_old_clusters);
+  c->num_old_clusters = 0;
+
+  for(i = 0; i < c->num_layers; i++)
+    c->layers[i]->changed = 0;
+  c->changed = 0;
+  }
+
+void gavl_overlay_compositor_blend(gavl_overlay_compositor_t * c,
+                                   gavl_video_frame_t * dst_frame)
+  {
+  int i;
+  gavl_overlay_cluster_t * cl;
+
+  if(c->changed)
+    update_clusters(c);
+
+  for(i = 0; i < c->num_clusters; i++)
+    {
+    cl = c->clusters + i;
+
+    if(!cl->ovl)
+      gavl_overlay_blend(c->layers[cl->layers[0]]->ctx, dst_frame);
+    else
+      {
+      cl->ovl->dst_x = cl->rect.x;
+      cl->ovl->dst_y = cl->rect.y;
+      gavl_overlay_blend_context_set_overlay(c->dst_ctx, cl->ovl);
+      gavl_overlay_blend(c->dst_ctx, dst_frame);
+      }
+    }
+  }
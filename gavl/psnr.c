@@ -551,6 +551,7 @@ void gavl_video_frame_psnr(double * psnr,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       gavl_pixelformat_chroma_sub(format->pixelformat,
                                   &sub_h, &sub_v);
       psnr[0] = psnr_y_16(src1->planes[0], src1->strides[0],
@@ -565,6 +566,10 @@ void gavl_video_frame_psnr(double * psnr,
                           src2->planes[2], src2->strides[2],
                           format->image_width/sub_h, format->image_height/sub_v, 1);
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -49,6 +49,21 @@ void gavl_video_scaler_destroy(gavl_video_scaler_t * s)
   gavl_video_frame_destroy(s->src);
   gavl_video_frame_destroy(s->dst);
 
+  for(i = 0; i < 2; i++)
+    {
+    if(s->src_field[i])
+      {
+      gavl_video_frame_null(s->src_field[i]);
+      gavl_video_frame_destroy(s->src_field[i]);
+      }
+    if(s->dst_field[i])
+      {
+      gavl_video_frame_null(s->dst_field[i]);
+      gavl_video_frame_destroy(s->dst_field[i]);
+      }
+    }
+  gavl_video_jobs_free(&s->jobs);
+
   for(i = 0; i < 3; i++)
     {
     for(j = 0; j < GAVL_MAX_PLANES; j++)
@@ -56,6 +71,8 @@ void gavl_video_scaler_destroy(gavl_video_scaler_t * s)
       gavl_video_scale_context_cleanup(&s->contexts[i][j]);
       }
     }
+  if(s->tp_priv)
+    gavl_thread_pool_destroy(s->tp_priv);
   free(s);  
   }
 
@@ -79,6 +96,34 @@ gavl_video_scaler_t * gavl_video_scaler_create()
   return ret;
   }
 
+static void alloc_fields(gavl_video_scaler_t * s)
+  {
+  int i;
+  for(i = 0; i < 2; i++)
+    {
+    if((s->src_fields == 2) && (!s->src_field[i]))
+      s->src_field[i] = gavl_video_frame_create(NULL);
+    if((s->dst_fields == 2) && (!s->dst_field[i]))
+      s->dst_field[i] = gavl_video_frame_create(NULL);
+    }
+  }
+
+/* Use the shared thread pool unless the application set one */
+
+static void get_thread_pool(gavl_video_scaler_t * s)
+  {
+  if(s->opt.tp)
+    return;
+  if(!s->tp_priv)
+    s->tp_priv = gavl_thread_pool_get_shared();
+  s->opt.tp = s->tp_priv;
+  }
+
+/* Minimum number of taps, for which the sliding window is faster
+   than the (vectorized) generic x-functions also for packed formats */
+
+#define SLIDE_MIN_TAPS 17
+
 void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
                            gavl_video_options_t * opt,
                            int src_advance, int dst_advance,
@@ -86,15 +131,32 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
                            gavl_video_scale_table_t * tab_v)
   {
   gavl_video_scale_table_t * scale_table;
+  int box_h, box_v;
 
   memset(tab, 0, sizeof(*tab));
-  /* Only nearest is faster for x && y */
+  /* Only nearest and box filters are faster for x && y. The box kernels
+     round differently than the generic ones, so other modes,
+     which happen to produce box tables (e.g. 2:1 bilinear), don't take
+     this path */
   if(tab_h && tab_v)
     {
     if((tab_h->factors_per_pixel == 1) &&
        (tab_v->factors_per_pixel == 1) &&
        ((opt->quality > 0) || (opt->accel_flags & GAVL_ACCEL_C)))
       gavl_init_scale_funcs_nearest_c(tab, src_advance, dst_advance);
+    else if((opt->downscale_filter == GAVL_DOWNSCALE_FILTER_BOX) &&
+            (box_h = gavl_video_scale_table_get_box(tab_h)) &&
+            (box_v = gavl_video_scale_table_get_box(tab_v)))
+      {
+      if((opt->quality > 0) || (opt->accel_flags & GAVL_ACCEL_C))
+        gavl_init_scale_funcs_box_c(tab);
+#ifdef HAVE_SSSE3
+      /* Bit exact with the C version */
+      if(opt->accel_flags & GAVL_ACCEL_SSSE3)
+        gavl_init_scale_funcs_box_ssse3(tab, box_h, box_v,
+                                        src_advance, dst_advance);
+#endif
+      }
     return;
     }
   
@@ -182,6 +244,13 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
         gavl_init_scale_funcs_quadratic_y_sse2(tab, src_advance, dst_advance);
         //        gavl_init_scale_funcs_quadratic_x_sse2(tab, src_advance, dst_advance);
         }
+#endif
+#ifdef HAVE_AVX2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+        {
+        gavl_init_scale_funcs_y_avx2(tab, src_advance, dst_advance);
+        gavl_init_scale_funcs_x_avx2(tab);
+        }
 #endif
       break;
     case 4:
@@ -220,6 +289,13 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
           {
           gavl_init_scale_funcs_bicubic_x_noclip_sse3(tab);
           }
+#endif
+#ifdef HAVE_AVX2
+        if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+          {
+          gavl_init_scale_funcs_y_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_x_avx2(tab);
+          }
 #endif
         }
       else
@@ -257,6 +333,13 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
           {
           gavl_init_scale_funcs_bicubic_x_sse3(tab);
           }
+#endif
+#ifdef HAVE_AVX2
+        if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+          {
+          gavl_init_scale_funcs_y_avx2(tab, src_advance, dst_advance);
+          gavl_init_scale_funcs_x_avx2(tab);
+          }
 #endif
         }
       break;
@@ -294,9 +377,22 @@ void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
         {
         gavl_init_scale_funcs_generic_x_sse3(tab);
         }
+#endif
+#ifdef HAVE_AVX2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+        {
+        gavl_init_scale_funcs_y_avx2(tab, src_advance, dst_advance);
+        gavl_init_scale_funcs_x_avx2(tab);
+        }
 #endif
       break;
     }
+
+  /* Long box kernels (convolution only): Sliding window in x-direction */
+  if(tab_h && (tab_h->factors_per_pixel >= SLIDE_MIN_TAPS) &&
+     ((opt->quality > 0) || (opt->accel_flags & GAVL_ACCEL_C)) &&
+     gavl_video_scale_table_is_box_convolve(tab_h))
+    gavl_init_scale_funcs_slide_x_c(tab);
   }
 
 
@@ -312,6 +408,8 @@ int gavl_video_scaler_init(gavl_video_scaler_t * scaler,
  
   int sub_h_out = 1, sub_v_out = 1;
   
+  get_thread_pool(scaler);
+  
   /* Copy options because we want to change them */
 
   gavl_video_options_copy(&opt, &scaler->opt);
@@ -409,12 +507,14 @@ int gavl_video_scaler_init(gavl_video_scaler_t * scaler,
     scaler->num_planes = 3;
   else
     scaler->num_planes = gavl_pixelformat_num_planes(scaler->src_format.pixelformat);
+
+  /* For gray output, only the luma plane is scaled. The chroma contexts
+     would write the same destination plane, while the luma context
+     runs concurrently */
+  if(gavl_pixelformat_is_gray(scaler->dst_format.pixelformat))
+    scaler->num_planes = 1;
   
-  if((scaler->src_fields == 2) && (!scaler->src_field))
-    scaler->src_field = gavl_video_frame_create(NULL);
-  
-  if((scaler->dst_fields == 2) && (!scaler->dst_field))
-    scaler->dst_field = gavl_video_frame_create(NULL);
+  alloc_fields(scaler);
   
   
 #if 0
@@ -501,6 +601,8 @@ int gavl_video_scaler_init_convolve(gavl_video_scaler_t * scaler,
 
   int field, plane;
  
+  get_thread_pool(scaler);
+  
   /* Copy options because we want to change them */
 
   gavl_video_options_copy(&opt, &scaler->opt);
@@ -539,11 +641,7 @@ int gavl_video_scaler_init_convolve(gavl_video_scaler_t * scaler,
     scaler->num_planes = 
       gavl_pixelformat_num_planes(scaler->src_format.pixelformat);
   
-  if((scaler->src_fields == 2) && (!scaler->src_field))
-    scaler->src_field = gavl_video_frame_create(NULL);
-  
-  if((scaler->dst_fields == 2) && (!scaler->dst_field))
-    scaler->dst_field = gavl_video_frame_create(NULL);
+  alloc_fields(scaler);
   
   /* Now, initialize all fields and planes */
   
@@ -582,11 +680,21 @@ gavl_video_scaler_get_options(gavl_video_scaler_t * s)
   return &s->opt;
   }
 
+/* Add all planes of one field */
+
+static void add_jobs(gavl_video_scaler_t * s, int field,
+                     const gavl_video_frame_t * src, gavl_video_frame_t * dst)
+  {
+  int i;
+  for(i = 0; i < s->num_planes; i++)
+    gavl_video_scale_context_add_jobs(&s->contexts[field][i], &s->jobs, src, dst);
+  }
+
 void gavl_video_scaler_scale(gavl_video_scaler_t * s,
                              const gavl_video_frame_t * src,
                              gavl_video_frame_t * dst)
   {
-  int i, field;
+  int field;
   /* Set the destination subframe */
   gavl_video_frame_get_subframe(s->dst_format.pixelformat, dst, s->dst, 
                                 &s->dst_rect);
@@ -595,6 +703,10 @@ void gavl_video_scaler_scale(gavl_video_scaler_t * s,
   gavl_rectangle_i_dump(&s->dst_rect);
   fprintf(stderr, "\n");
 #endif
+
+  /* All planes and fields are scaled in one go */
+  gavl_video_jobs_reset(&s->jobs);
+  
   if(s->src_fields > s->dst_fields)
     {
     /* Progressive scaling for mixed mode */
@@ -602,18 +714,14 @@ void gavl_video_scaler_scale(gavl_video_scaler_t * s,
        (src->interlace_mode == GAVL_INTERLACE_NONE) &&
        !(s->opt.conversion_flags & GAVL_FORCE_DEINTERLACE))
       {
-      for(i = 0; i < s->num_planes; i++)
-        gavl_video_scale_context_scale(&s->contexts[2][i], src, s->dst);
+      add_jobs(s, 2, src, s->dst);
       }
     else /* Deinterlace mode */
       {
       field = (s->opt.deinterlace_drop_mode == GAVL_DEINTERLACE_DROP_BOTTOM) ? 0 : 1;
       gavl_video_frame_get_field(s->src_format.pixelformat, src, 
-                                 s->src_field, field);
-      
-      for(i = 0; i < s->num_planes; i++)
-        gavl_video_scale_context_scale(&s->contexts[field][i], 
-                                       s->src_field, s->dst);
+                                 s->src_field[0], field);
+      add_jobs(s, field, s->src_field[0], s->dst);
       }
     }
   else if(s->src_fields == 2)
@@ -623,37 +731,75 @@ void gavl_video_scaler_scale(gavl_video_scaler_t * s,
        (src->interlace_mode == GAVL_INTERLACE_NONE) &&
        !(s->opt.conversion_flags & GAVL_FORCE_DEINTERLACE))
       {
-      for(i = 0; i < s->num_planes; i++)
-        gavl_video_scale_context_scale(&s->contexts[2][i], src, s->dst);
+      add_jobs(s, 2, src, s->dst);
       }
     else
       {
-      /* First field */
-      gavl_video_frame_get_field(s->src_format.pixelformat, src,    s->src_field, 0);
-      gavl_video_frame_get_field(s->dst_format.pixelformat, s->dst, s->dst_field, 0);
-      for(i = 0; i < s->num_planes; i++)
+      for(field = 0; field < 2; field++)
         {
-        //      fprintf(stderr, "Field: 0, plane: %d\n", i);
-        gavl_video_scale_context_scale(&s->contexts[0][i], s->src_field, s->dst_field);
-        }
-      
-      /* Second field */
-      gavl_video_frame_get_field(s->src_format.pixelformat, src,    s->src_field, 1);
-      gavl_video_frame_get_field(s->dst_format.pixelformat, s->dst, s->dst_field, 1);
-      for(i = 0; i < s->num_planes; i++)
-        {
-        //      fprintf(stderr, "Field: 1, plane: %d\n", i);
-        gavl_video_scale_context_scale(&s->contexts[1][i], s->src_field, s->dst_field);
+        gavl_video_frame_get_field(s->src_format.pixelformat, src,
+                                   s->src_field[field], field);
+        gavl_video_frame_get_field(s->dst_format.pixelformat, s->dst,
+                                   s->dst_field[field], field);
+        add_jobs(s, field, s->src_field[field], s->dst_field[field]);
         }
       }
     }
   else
+    add_jobs(s, 0, src, s->dst);
+
+  gavl_video_jobs_run(&s->jobs, s->opt.tp);
+  }
+
+int gavl_video_scaler_can_scale_rows(const gavl_video_scaler_t * s)
+  {
+  if((s->src_fields != 1) || (s->dst_fields != 1) ||
+     s->dst_rect.x || s->dst_rect.y ||
+     (s->dst_rect.w != s->dst_format.image_width) ||
+     (s->dst_rect.h != s->dst_format.image_height))
+    return 0;
+  return 1;
+  }
+
+void gavl_video_scaler_scale_prepare(gavl_video_scaler_t * s,
+                                     const gavl_video_frame_t * src)
+  {
+  int i;
+  for(i = 0; i < s->num_planes; i++)
+    gavl_video_scale_context_scale_prepare(&s->contexts[0][i], src);
+  }
+
+void gavl_video_scaler_scale_rows(gavl_video_scaler_t * s,
+                                  gavl_video_frame_t * dst,
+                                  int start, int end)
+  {
+  int i;
+  int sub_h, sub_v;
+  int plane_start, plane_end;
+  gavl_video_scale_context_t * ctx;
+  
+  gavl_pixelformat_chroma_sub(s->dst_format.pixelformat, &sub_h, &sub_v);
+
+  for(i = 0; i < s->num_planes; i++)
     {
-    for(i = 0; i < s->num_planes; i++)
+    ctx = &s->contexts[0][i];
+
+    if(ctx->dst_frame_plane)
+      {
+      plane_start = start / sub_v;
+      plane_end = (end + sub_v - 1) / sub_v;
+      }
+    else
       {
-      //      fprintf(stderr, "Scale %d, %p\n", i, &s->contexts[0][i]);
-      //      fprintf(stderr, "Field: 0 (progressive), plane: %d\n", i);
-      gavl_video_scale_context_scale(&s->contexts[0][i], src, s->dst);
+      plane_start = start;
+      plane_end = end;
       }
+    
+    if(plane_end > ctx->dst_rect.h)
+      plane_end = ctx->dst_rect.h;
+    
+    gavl_video_scale_context_scale_rows(ctx, dst->planes[ctx->dst_frame_plane],
+                                        dst->strides[ctx->dst_frame_plane],
+                                        plane_start, plane_end);
     }
   }
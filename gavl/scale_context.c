@@ -85,6 +85,11 @@ static gavl_video_scale_scanline_func get_func(gavl_scale_func_tab_t * tab,
   {
   switch(pixelformat)
     {
+    /* Semiplanar formats are scaled by the converter in their planar counterparts */
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
     case GAVL_RGB_15:
@@ -146,6 +151,7 @@ static gavl_video_scale_scanline_func get_func(gavl_scale_func_tab_t * tab,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       *bits = tab->bits_uint16;
       return tab->scale_uint16_x_1;
       break;
@@ -194,6 +200,10 @@ static void get_minmax(gavl_pixelformat_t pixelformat,
 
   switch(pixelformat)
     {
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
     case GAVL_RGB_15:
@@ -259,6 +269,7 @@ static void get_minmax(gavl_pixelformat_t pixelformat,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
     case GAVL_YUVA_64:
       min[0] = 16<<8;
       min[1] = 16<<8;
@@ -302,9 +313,124 @@ static void get_minmax(gavl_pixelformat_t pixelformat,
     }
   }
 
+/* Intermediate scanlines of a band, which should stay in the cache */
+#define BAND_BYTES (128*1024)
+#define MAX_BAND_ROWS 64
+
+/* Maximum number of intermediate scanlines needed for band_rows output scanlines */
+
+static int get_ring_lines(gavl_video_scale_context_t * ctx, int band_rows)
+  {
+  int i, end, lines, ret = 0;
+
+  if(!ctx->x_first)
+    return band_rows;
+  
+  for(i = 0; i < ctx->dst_rect.h; i++)
+    {
+    end = i + band_rows;
+    if(end > ctx->dst_rect.h)
+      end = ctx->dst_rect.h;
+    
+    lines = ctx->table_v.pixels[end-1].index - ctx->table_v.pixels[i].index +
+      ctx->table_v.factors_per_pixel;
+    if(lines > ret)
+      ret = lines;
+    }
+  return ret;
+  }
+
+static void init_bands(gavl_video_scale_context_t * ctx)
+  {
+  int i;
+  ctx->band_rows = 0;
+  ctx->ring_lines = 0;
+
+  /* Sliding the window needs increasing source indices */
+  if(ctx->x_first)
+    {
+    for(i = 1; i < ctx->dst_rect.h; i++)
+      {
+      if(ctx->table_v.pixels[i].index < ctx->table_v.pixels[i-1].index)
+        return;
+      }
+    }
+  
+  ctx->band_rows = MAX_BAND_ROWS;
+
+  while(ctx->band_rows > 1)
+    {
+    if(get_ring_lines(ctx, ctx->band_rows) * ctx->buffer_stride <= BAND_BYTES)
+      break;
+    ctx->band_rows /= 2;
+    }
+  ctx->ring_lines = get_ring_lines(ctx, ctx->band_rows);
+  }
+
+static void free_bands(gavl_video_scale_context_t * ctx)
+  {
+  gavl_video_scale_bands_t * b = ctx->bands;
+
+  if(!b)
+    return;
+
+  pthread_mutex_destroy(&b->mutex);
+  if(b->free)
+    free(b->free);
+  if(b->ctx)
+    free(b->ctx);
+  if(b->rings)
+    free(b->rings);
+  free(b);
+  ctx->bands = NULL;
+  }
+
+/* Called at the end of init, since the slots get copies of the context */
+
+static void init_band_slots(gavl_video_scale_context_t * ctx)
+  {
+  int i, num_slots, ring_size;
+  gavl_video_scale_bands_t * b;
+
+  if(!ctx->band_rows)
+    return;
+  
+  num_slots = 1;
+  if(ctx->opt->tp)
+    num_slots += gavl_thread_pool_get_num_threads(ctx->opt->tp);
+
+  ring_size = ctx->ring_lines * ctx->buffer_stride;
+
+  if(ctx->bands &&
+     ((ctx->bands->num_slots != num_slots) || (ctx->bands->ring_size < ring_size)))
+    free_bands(ctx);
+  
+  if(!ctx->bands)
+    {
+    b = calloc(1, sizeof(*b));
+    pthread_mutex_init(&b->mutex, NULL);
+    b->num_slots = num_slots;
+    b->ring_size = ring_size;
+    b->free  = malloc(num_slots * sizeof(*b->free));
+    b->ctx   = malloc(num_slots * sizeof(*b->ctx));
+    b->rings = gavl_memalign(ALIGNMENT_BYTES, num_slots * ring_size);
+    ctx->bands = b;
+    }
+
+  b = ctx->bands;
+  b->num_free = num_slots;
+  
+  for(i = 0; i < num_slots; i++)
+    {
+    b->free[i] = i;
+    b->ctx[i] = *ctx;
+    b->ctx[i].bands = NULL;
+    b->ctx[i].buffer = NULL;
+    }
+  }
+
 static void alloc_temp(gavl_video_scale_context_t * ctx, gavl_pixelformat_t pixelformat)
   {
-  int size;
   if((pixelformat == GAVL_YUY2) || (pixelformat == GAVL_UYVY))
     ctx->buffer_stride = ctx->buffer_width;
   else if(gavl_pixelformat_is_planar(pixelformat))
@@ -316,7 +442,15 @@ static void alloc_temp(gavl_video_scale_context_t * ctx, gavl_pixelformat_t pixe
   
   ALIGN(ctx->buffer_stride);
 
-  size = ctx->buffer_stride * ctx->buffer_height;
+  init_bands(ctx);
+  }
+
+/* The full intermediate plane is only allocated if the passes are
+   done separately */
+
+static void alloc_buffer(gavl_video_scale_context_t * ctx)
+  {
+  int size = ctx->buffer_stride * ctx->buffer_height;
 
   if(ctx->buffer_alloc < size)
     {
@@ -449,6 +583,9 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
   gavl_scale_funcs_t funcs;
 
   ctx->first_scanline = 0;
+  ctx->x_first = 0;
+  ctx->first_pass = NULL;
+  ctx->band_rows = 0;
 
 #if 0  
   fprintf(stderr, "scale_context_init: src_field: %d, dst_field: %d plane: %d\n",
@@ -699,6 +836,7 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
         {
         //        fprintf(stderr, "X then Y\n");
         /* X then Y */
+        ctx->x_first = 1;
 
         ctx->buffer_width  = ctx->dst_rect.w;
         ctx->buffer_height = src_rect_i.h;
@@ -824,7 +962,9 @@ int gavl_video_scale_context_init(gavl_video_scale_context_t*ctx,
           ctx->max_values_h[1],
           ctx->max_values_h[2]);
 #endif
-    
+
+  init_band_slots(ctx);
+  
   return 1;
   }
 
@@ -936,6 +1076,9 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
   gavl_rectangle_i_set_all(&ctx->dst_rect, format);
 
   ctx->first_scanline = 0;
+  ctx->x_first = 0;
+  ctx->first_pass = NULL;
+  ctx->band_rows = 0;
   
   ctx->plane = plane;
   
@@ -1159,6 +1302,7 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
       
       //        fprintf(stderr, "X then Y\n");
       /* X then Y */
+      ctx->x_first = 1;
       
       ctx->buffer_width  = ctx->dst_rect.w;
       ctx->buffer_height = src_rect_i.h;
@@ -1239,6 +1383,8 @@ gavl_video_scale_context_init_convolve(gavl_video_scale_context_t* ctx,
 
   if(h_c) free(h_c);
   if(v_c) free(v_c);
+
+  init_band_slots(ctx);
   
   return 1;
   }
@@ -1249,6 +1395,7 @@ void gavl_video_scale_context_cleanup(gavl_video_scale_context_t * ctx)
   gavl_video_scale_table_cleanup(&ctx->table_v);
   if(ctx->buffer)
     free(ctx->buffer);
+  free_bands(ctx);
   }
 
 static void func_1(void* p, int start, int end)
@@ -1310,206 +1457,370 @@ static void func_2_of_2(void* p, int start, int end)
   }
 
 
-static void scale_context_scale_mt(gavl_video_scale_context_t * ctx,
-                                   const gavl_video_frame_t * src,
-                                   gavl_video_frame_t * dst)
+/*
+ *  2 pass scaling in bands: Each call produces the output scanlines
+ *  start..end-1 in bands of band_rows scanlines. The intermediate scanlines
+ *  of a band are kept in a small ring, which slides over the intermediate
+ *  plane. Scanlines still needed by the next band are moved to the
+ *  beginning and only the new ones are calculated. ctx->src must point to
+ *  the source for the first pass.
+ */
+
+static void func_bands(void* p, int start, int end)
   {
-  int delta;
-  int scanline;
-  int nt;
-  int i;
+  int i, band_start, band_end;
+  int ring_start = 0, ring_end = 0;  /* Intermediate scanlines in the ring */
+  int first, last;                   /* Intermediate scanlines for the band */
+  int slot = -1;
+  uint8_t * ring;
+  uint8_t * dst_save;
+  gavl_video_scale_context_t * c;
+  gavl_video_scale_context_t * ctx = p;
+  gavl_video_scale_bands_t * b = ctx->bands;
+
+  pthread_mutex_lock(&b->mutex);
+  if(b->num_free)
+    slot = b->free[--b->num_free];
+  pthread_mutex_unlock(&b->mutex);
+
+  if(slot >= 0)
+    {
+    c = &b->ctx[slot];
+    ring = b->rings + slot * b->ring_size;
+    }
+  else
+    {
+    /* More threads than slots (e.g. gavl_thread_pool_help() from outside
+       the pool) */
+    c = malloc(sizeof(*c));
+    *c = *ctx;
+    ring = gavl_memalign(ALIGNMENT_BYTES, b->ring_size);
+    }
+
+  dst_save = ctx->dst_frame->planes[ctx->dst_frame_plane] + ctx->offset2.dst_offset +
+    start * ctx->dst_frame->strides[ctx->dst_frame_plane];
+  
+  for(band_start = start; band_start < end; band_start = band_end)
+    {
+    band_end = band_start + ctx->band_rows;
+    if(band_end > end)
+      band_end = end;
+
+    if(ctx->x_first)
+      {
+      first = ctx->table_v.pixels[band_start].index;
+      last = ctx->table_v.pixels[band_end-1].index + ctx->table_v.factors_per_pixel;
+      }
+    else
+      {
+      first = band_start;
+      last = band_end;
+      }
+
+    /* Keep the scanlines we already have */
+    if((first < ring_end) && (ring_end > ring_start))
+      {
+      if(first > ring_start)
+        memmove(ring, ring + (first - ring_start) * ctx->buffer_stride,
+                (ring_end - first) * ctx->buffer_stride);
+      i = ring_end;
+      }
+    else
+      i = first;
+    
+    ring_start = first;
+    ring_end = last;
+
+    /* First step */
+    c->offset = &ctx->offset1;
+    c->src = ctx->src;
+    c->src_stride = ctx->src_stride;
+    c->dst_size = ctx->buffer_width;
+    
+    for(; i < last; i++)
+      ctx->func1(c, i, ring + (i - first) * ctx->buffer_stride);
+    
+    /* Second step: The ring holds the intermediate scanlines first..last-1 */
+    c->offset = &ctx->offset2;
+    c->src = ring - first * ctx->buffer_stride;
+    c->src_stride = ctx->buffer_stride;
+    c->dst_size = ctx->dst_rect.w;
+    
+    for(i = band_start; i < band_end; i++)
+      {
+      ctx->func2(c, i, dst_save);
+      dst_save += ctx->dst_frame->strides[ctx->dst_frame_plane];
+      }
+    }
+#ifdef HAVE_MMX
+  __asm__ __volatile__ ("emms");
+#endif
+
+  if(slot >= 0)
+    {
+    pthread_mutex_lock(&b->mutex);
+    b->free[b->num_free++] = slot;
+    pthread_mutex_unlock(&b->mutex);
+    }
+  else
+    {
+    free(c);
+    free(ring);
+    }
+  }
+
+/* Distribute the scanlines 0..height-1 among the threads */
+
+static void scale_context_run_mt(gavl_video_scale_context_t * ctx,
+                                 void (*func)(void*, int, int), int height)
+  {
+  gavl_thread_pool_parallel_for(ctx->opt->tp, func, ctx, 0, height, 0);
+  }
+
+/*
+ *  Full frame scaling. The scanlines are added to a job set, so all
+ *  planes and fields of a frame can be scaled in one parallel loop.
+ *  Only if the intermediate plane can't be processed in bands, the first
+ *  pass is done here already.
+ */
+
+void gavl_video_scale_context_add_jobs(gavl_video_scale_context_t * ctx,
+                                       gavl_video_jobs_t * jobs,
+                                       const gavl_video_frame_t * src,
+                                       gavl_video_frame_t * dst)
+  {
+  ctx->dst_frame = dst;
+  
   switch(ctx->num_directions)
     {
     case 1:
       /* Only step */
       ctx->src = src->planes[ctx->src_frame_plane] + ctx->offset->src_offset;
       ctx->src_stride = src->strides[ctx->src_frame_plane];
-      ctx->dst_frame = dst;
-      
-      nt = gavl_thread_pool_get_num_threads(ctx->opt->tp);
-      if(nt > ctx->dst_rect.h)
-        nt = ctx->dst_rect.h;
-
-      //  fprintf(stderr, "Scaling 1 direction (%d threads)\n", nt);
-      
-      delta = ctx->dst_rect.h / nt;
-      scanline = 0;
-      for(i = 0; i < nt - 1; i++)
-        {
-        gavl_thread_pool_run(func_1, ctx, scanline, scanline+delta, ctx->opt->tp, i);
-        
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        scanline += delta;
-        }
-      gavl_thread_pool_run(func_1, ctx, scanline, ctx->dst_rect.h, ctx->opt->tp, nt - 1);
       
-      for(i = 0; i < nt; i++)
-        gavl_thread_pool_stop(ctx->opt->tp, i);
+      gavl_video_jobs_add(jobs, func_1, ctx, ctx->dst_rect.h);
       break;
     case 2:
-      /* First step */
-      ctx->offset = &ctx->offset1;
-      
-      ctx->src = src->planes[ctx->src_frame_plane] +
-        ctx->offset->src_offset +
-        src->strides[ctx->src_frame_plane] * ctx->first_scanline;
-      
-      ctx->src_stride = src->strides[ctx->src_frame_plane];
-      ctx->dst_size = ctx->buffer_width;
-
-#if 0
-      fprintf(stderr, "First direction\n");
-      dump_offset(ctx->offset);
-#endif
-      
-      nt = gavl_thread_pool_get_num_threads(ctx->opt->tp);
-      if(nt > ctx->buffer_height)
-        nt = ctx->buffer_height;
-
-      //      fprintf(stderr, "Scaling 2 directions (%d threads)\n", nt);
-      
-      delta = ctx->buffer_height / nt;
-      scanline = 0;
-      for(i = 0; i < nt - 1; i++)
+      if(ctx->band_rows)
         {
-        gavl_thread_pool_run(func_1_of_2, ctx, scanline, scanline+delta, ctx->opt->tp, i);
+        /* Both steps in one go */
+        ctx->src = src->planes[ctx->src_frame_plane] +
+          ctx->offset1.src_offset +
+          src->strides[ctx->src_frame_plane] * ctx->first_scanline;
+        ctx->src_stride = src->strides[ctx->src_frame_plane];
         
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        scanline += delta;
+        gavl_video_jobs_add(jobs, func_bands, ctx, ctx->dst_rect.h);
+        break;
         }
-      gavl_thread_pool_run(func_1_of_2, ctx, scanline, ctx->buffer_height,
-                         ctx->opt->tp, nt - 1);
-      
-      for(i = 0; i < nt; i++)
-        gavl_thread_pool_stop(ctx->opt->tp, i);
-      
-      //      fprintf(stderr, "done\n");
 
-      /* Second step */
-      ctx->offset = &ctx->offset2;
-#if 0
-      fprintf(stderr, "Second direction\n");
-      dump_offset(ctx->offset);
-#endif
-      ctx->src = ctx->buffer;
-      ctx->src_stride = ctx->buffer_stride;
-      ctx->dst_size = ctx->dst_rect.w;
-      ctx->dst_frame = dst;
-      
-      nt = gavl_thread_pool_get_num_threads(ctx->opt->tp);
-      if(nt > ctx->dst_rect.h)
-        nt = ctx->dst_rect.h;
+      /* First step */
+      gavl_video_scale_context_pass_prepare(ctx, 0, src, dst);
       
-      delta = ctx->dst_rect.h / nt;
-
-      scanline = 0;
-      for(i = 0; i < nt - 1; i++)
-        {
-        gavl_thread_pool_run(func_2_of_2, ctx, scanline, scanline+delta, ctx->opt->tp, i);
-        
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        scanline += delta;
-        }
-      gavl_thread_pool_run(func_2_of_2, ctx, scanline, ctx->dst_rect.h,
-                         ctx->opt->tp, nt - 1);
+      if(ctx->opt->tp)
+        scale_context_run_mt(ctx, func_1_of_2, ctx->buffer_height);
+      else
+        func_1_of_2(ctx, 0, ctx->buffer_height);
       
-      for(i = 0; i < nt; i++)
-        gavl_thread_pool_stop(ctx->opt->tp, i);
-      //      fprintf(stderr, "done\n");
+      /* Second step */
+      gavl_video_scale_context_pass_prepare(ctx, 1, src, dst);
+      gavl_video_jobs_add(jobs, func_2_of_2, ctx, ctx->dst_rect.h);
       break;
     }
   }
 
-#ifdef HAVE_MMX
-#define EMMS                       \
-  if(ctx->need_emms)               \
-    {                              \
-    __asm__ __volatile__ ("emms"); \
-    ctx->need_emms = 0;            \
-    }
-#else
-#define EMMS
-#endif
-
-
 void gavl_video_scale_context_scale(gavl_video_scale_context_t * ctx,
                                     const gavl_video_frame_t * src,
                                     gavl_video_frame_t * dst)
   {
-  uint8_t * dst_save;
-  int i;
+  gavl_video_jobs_t jobs;
+  gavl_video_job_t job;
+
+  /* Single job, no need to allocate anything */
+  jobs.jobs = &job;
+  jobs.jobs_alloc = 1;
+  gavl_video_jobs_reset(&jobs);
   
-  if(ctx->opt->tp)
-    {
-    scale_context_scale_mt(ctx, src, dst);
+  gavl_video_scale_context_add_jobs(ctx, &jobs, src, dst);
+  gavl_video_jobs_run(&jobs, ctx->opt->tp);
+  }
+
+
+/*
+ *  Strip based scaling. gavl_video_scale_context_scale_prepare() does
+ *  everything which needs the whole source plane (i.e. the first pass of
+ *  2 pass scaling). Afterwards, gavl_video_scale_context_scale_rows()
+ *  can be called (also from several threads at once) for arbitrary ranges
+ *  of output scanlines.
+ */
+
+void gavl_video_scale_context_scale_prepare(gavl_video_scale_context_t * ctx,
+                                            const gavl_video_frame_t * src)
+  {
+  gavl_video_scale_context_pass_prepare(ctx, 0, src, NULL);
+
+  if(ctx->num_directions == 1)
     return;
-    }
+
+  /* First step */
+  if(ctx->opt->tp)
+    scale_context_run_mt(ctx, func_1_of_2, ctx->buffer_height);
+  else
+    func_1_of_2(ctx, 0, ctx->buffer_height);
   
-  //  fprintf(stderr, "gavl_video_scale_context_scale, plane %d\n",
-  //          ctx->dst_frame_plane);
-  switch(ctx->num_directions)
-    {
-    case 1:
-      /* Only step */
-      ctx->src = src->planes[ctx->src_frame_plane] + ctx->offset->src_offset;
-      ctx->src_stride = src->strides[ctx->src_frame_plane];
+  /* Setup second step */
+  gavl_video_scale_context_pass_prepare(ctx, 1, NULL, NULL);
+  }
 
-      dst_save = dst->planes[ctx->dst_frame_plane] + ctx->offset->dst_offset;
-            
-      for(i = 0; i < ctx->dst_rect.h; i++)
-        {
-        //        fprintf(stderr, "scanline: %d (%d)\n", ctx->scanline, ctx->dst_rect.h);
-        ctx->func1(ctx, i, dst_save);
-        dst_save += dst->strides[ctx->dst_frame_plane];
-        }
-      EMMS
-      break;
-    case 2:
-      /* First step */
-      ctx->offset = &ctx->offset1;
-      
-      ctx->src = src->planes[ctx->src_frame_plane] +
-        ctx->offset->src_offset +
-        src->strides[ctx->src_frame_plane] * ctx->first_scanline;
-      
-      ctx->src_stride = src->strides[ctx->src_frame_plane];
-      ctx->dst_size = ctx->buffer_width;
+void gavl_video_scale_context_scale_rows(gavl_video_scale_context_t * ctx,
+                                         uint8_t * dst, int dst_stride,
+                                         int start, int end)
+  {
+  int i;
+  gavl_video_scale_scanline_func func;
 
-      dst_save = ctx->buffer;
-#if 0
-      fprintf(stderr, "First direction\n");
-      dump_offset(ctx->offset);
+  if(ctx->num_directions == 2)
+    func = ctx->func2;
+  else
+    func = ctx->func1;
+  
+  dst += ctx->offset->dst_offset;
+  
+  for(i = start; i < end; i++)
+    {
+    func(ctx, i, dst);
+    dst += dst_stride;
+    }
+#ifdef HAVE_MMX
+  __asm__ __volatile__ ("emms");
 #endif
+  }
+
+/* Pass based scaling */
+
+int gavl_video_scale_context_pass_height(const gavl_video_scale_context_t * ctx,
+                                         int pass)
+  {
+  if(ctx->num_directions == 1)
+    return pass ? 0 : ctx->dst_rect.h;
+
+  if(pass)
+    return ctx->dst_rect.h;
+  else if(ctx->first_pass)
+    return 0;
+  else
+    return ctx->buffer_height;
+  }
+
+void gavl_video_scale_context_pass_prepare(gavl_video_scale_context_t * ctx,
+                                           int pass,
+                                           const gavl_video_frame_t * src,
+                                           gavl_video_frame_t * dst)
+  {
+  ctx->dst_frame = dst;
+
+  if(ctx->num_directions == 1)
+    {
+    ctx->src = src->planes[ctx->src_frame_plane] + ctx->offset->src_offset;
+    ctx->src_stride = src->strides[ctx->src_frame_plane];
+    }
+  else if(!pass)
+    {
+    ctx->offset = &ctx->offset1;
+    alloc_buffer(ctx);
       
-      for(i = 0; i < ctx->buffer_height; i++)
-        {
-        ctx->func1(ctx, i, dst_save);
-        dst_save += ctx->buffer_stride;
-        }
-      EMMS
-      //      fprintf(stderr, "done\n");
+    ctx->src = src->planes[ctx->src_frame_plane] +
+      ctx->offset->src_offset +
+      src->strides[ctx->src_frame_plane] * ctx->first_scanline;
+      
+    ctx->src_stride = src->strides[ctx->src_frame_plane];
+    ctx->dst_size = ctx->buffer_width;
+    }
+  else
+    {
+    ctx->offset = &ctx->offset2;
 
-      /* Second step */
-      ctx->offset = &ctx->offset2;
-#if 0
-      fprintf(stderr, "Second direction\n");
-      dump_offset(ctx->offset);
-#endif
+    if(ctx->first_pass)
+      ctx->src = ctx->first_pass->buffer + ctx->first_pass_offset;
+    else
       ctx->src = ctx->buffer;
-      ctx->src_stride = ctx->buffer_stride;
-      ctx->dst_size = ctx->dst_rect.w;
-      dst_save =
-        dst->planes[ctx->dst_frame_plane] + ctx->offset->dst_offset;
+    
+    ctx->src_stride = ctx->buffer_stride;
+    ctx->dst_size = ctx->dst_rect.w;
+    }
+  }
 
-      for(i = 0; i < ctx->dst_rect.h; i++)
-        {
-        //        fprintf(stderr, "i: %d\n", ctx->scanline);
-        ctx->func2(ctx, i, dst_save);
-        dst_save += dst->strides[ctx->dst_frame_plane];
-        }
-      EMMS
-      //      fprintf(stderr, "done\n");
-      break;
+void gavl_video_scale_context_pass_rows(gavl_video_scale_context_t * ctx,
+                                        int pass, int start, int end)
+  {
+  if(ctx->num_directions == 1)
+    func_1(ctx, start, end);
+  else if(!pass)
+    func_1_of_2(ctx, start, end);
+  else
+    func_2_of_2(ctx, start, end);
+  }
+
+static int tables_equal(const gavl_video_scale_table_t * t1,
+                        const gavl_video_scale_table_t * t2)
+  {
+  int i;
+  
+  if((t1->num_pixels != t2->num_pixels) ||
+     (t1->factors_per_pixel != t2->factors_per_pixel))
+    return 0;
+
+  for(i = 0; i < t1->num_pixels; i++)
+    {
+    if(t1->pixels[i].index != t2->pixels[i].index)
+      return 0;
     }
+
+  /* The integer factors are calculated from these (if at all) */
+  if(memcmp(t1->factors_f, t2->factors_f,
+            t1->num_pixels * t1->factors_per_pixel * sizeof(*t1->factors_f)))
+    return 0;
+  return 1;
   }
 
+int gavl_video_scale_context_share_first_pass(gavl_video_scale_context_t * ctx,
+                                              const gavl_video_scale_context_t * src_ctx)
+  {
+  if((ctx->num_directions != 2) || (src_ctx->num_directions != 2) ||
+     src_ctx->first_pass ||
+     (ctx->x_first != src_ctx->x_first) ||
+     (ctx->func1 != src_ctx->func1) ||
+     (ctx->src_frame_plane != src_ctx->src_frame_plane) ||
+     memcmp(&ctx->offset1, &src_ctx->offset1, sizeof(ctx->offset1)) ||
+     (ctx->buffer_width != src_ctx->buffer_width) ||
+     (ctx->buffer_stride != src_ctx->buffer_stride))
+    return 0;
+  
+  if(ctx->x_first)
+    {
+    /* Our scanlines must be a subset of the ones in the buffer */
+    if(!tables_equal(&ctx->table_h, &src_ctx->table_h) ||
+       (ctx->first_scanline < src_ctx->first_scanline) ||
+       (ctx->first_scanline + ctx->buffer_height >
+        src_ctx->first_scanline + src_ctx->buffer_height))
+      return 0;
+    }
+  else
+    {
+    if(!tables_equal(&ctx->table_v, &src_ctx->table_v) ||
+       (ctx->buffer_height != src_ctx->buffer_height))
+      return 0;
+    }
+
+  ctx->first_pass = src_ctx;
+  ctx->first_pass_offset =
+    (ctx->first_scanline - src_ctx->first_scanline) * ctx->buffer_stride;
+
+  /* Not needed anymore */
+  if(ctx->buffer)
+    {
+    free(ctx->buffer);
+    ctx->buffer = NULL;
+    ctx->buffer_alloc = 0;
+    }
+  return 1;
+  }
@@ -0,0 +1,281 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Scale one input frame to several output sizes */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+/*
+ *  Each output has its own scaler. If all of them can be driven pass by
+ *  pass (progressive scaling into the whole frame), the scanlines of
+ *  all planes and outputs are processed in one parallel loop per pass.
+ *  Outputs of the same width (or height) share the result of the first
+ *  pass if it goes in the same direction. The pass order is the one a
+ *  standalone scaler would choose, so the results are identical to
+ *  scaling each output separately.
+ *
+ *  With cascaded scaling, outputs are scaled from the next larger output.
+ *  They are then processed in stages, where each stage only depends on
+ *  the previous ones.
+ */
+
+struct gavl_video_ladder_scaler_s
+  {
+  gavl_video_options_t opt;
+
+  gavl_video_scaler_t ** scalers;
+  int num_outputs;
+  int outputs_alloc;
+
+  int * src_idx; /* Source output for cascaded scaling, -1 means input frame */
+  int * stage;
+  int num_stages;
+
+  /* Scalers can be driven pass by pass */
+  int passes;
+
+  gavl_video_jobs_t jobs;
+
+  /* Shared pool, used if none was set in the options */
+  gavl_thread_pool_t * tp_priv;
+  };
+
+gavl_video_ladder_scaler_t * gavl_video_ladder_scaler_create(void)
+  {
+  gavl_video_ladder_scaler_t * ret = calloc(1, sizeof(*ret));
+  gavl_video_options_set_defaults(&ret->opt);
+  return ret;
+  }
+
+void gavl_video_ladder_scaler_destroy(gavl_video_ladder_scaler_t * l)
+  {
+  int i;
+  for(i = 0; i < l->outputs_alloc; i++)
+    gavl_video_scaler_destroy(l->scalers[i]);
+
+  if(l->scalers)
+    free(l->scalers);
+  if(l->src_idx)
+    free(l->src_idx);
+  if(l->stage)
+    free(l->stage);
+  gavl_video_jobs_free(&l->jobs);
+  if(l->tp_priv)
+    gavl_thread_pool_destroy(l->tp_priv);
+  free(l);
+  }
+
+gavl_video_options_t *
+gavl_video_ladder_scaler_get_options(gavl_video_ladder_scaler_t * l)
+  {
+  return &l->opt;
+  }
+
+static int get_area(const gavl_video_format_t * f)
+  {
+  return f->image_width * f->image_height;
+  }
+
+/* Find the smallest output, which is larger than output idx in both directions */
+
+static int get_cascade_src(const gavl_video_format_t * dst_formats, int num, int idx)
+  {
+  int i, ret = -1;
+  for(i = 0; i < num; i++)
+    {
+    if((i == idx) ||
+       (dst_formats[i].image_width  < dst_formats[idx].image_width) ||
+       (dst_formats[i].image_height < dst_formats[idx].image_height) ||
+       (dst_formats[i].interlace_mode != dst_formats[idx].interlace_mode))
+      continue;
+
+    /* gavl_pixelformat_can_scale() is false for equal subsampling */
+    if((dst_formats[i].pixelformat != dst_formats[idx].pixelformat) &&
+       !gavl_pixelformat_can_scale(dst_formats[i].pixelformat,
+                                   dst_formats[idx].pixelformat))
+      continue;
+
+    /* Equal sizes: Take the first one to avoid cycles */
+    if((get_area(&dst_formats[i]) == get_area(&dst_formats[idx])) && (i > idx))
+      continue;
+
+    if((ret < 0) || (get_area(&dst_formats[i]) < get_area(&dst_formats[ret])))
+      ret = i;
+    }
+  return ret;
+  }
+
+static int get_stage(gavl_video_ladder_scaler_t * l, int idx)
+  {
+  if(l->src_idx[idx] < 0)
+    return 0;
+  return get_stage(l, l->src_idx[idx]) + 1;
+  }
+
+int gavl_video_ladder_scaler_init(gavl_video_ladder_scaler_t * l,
+                                  const gavl_video_format_t * src_format,
+                                  const gavl_video_format_t * dst_formats,
+                                  int num_outputs)
+  {
+  int i, j, plane;
+  gavl_video_options_t * opt;
+  const gavl_video_format_t * src;
+
+  if(!l->opt.tp)
+    {
+    if(!l->tp_priv)
+      l->tp_priv = gavl_thread_pool_get_shared();
+    l->opt.tp = l->tp_priv;
+    }
+
+  if(l->outputs_alloc < num_outputs)
+    {
+    l->scalers = realloc(l->scalers, num_outputs * sizeof(*l->scalers));
+    l->src_idx = realloc(l->src_idx, num_outputs * sizeof(*l->src_idx));
+    l->stage   = realloc(l->stage,   num_outputs * sizeof(*l->stage));
+
+    for(i = l->outputs_alloc; i < num_outputs; i++)
+      l->scalers[i] = gavl_video_scaler_create();
+    l->outputs_alloc = num_outputs;
+    }
+  l->num_outputs = num_outputs;
+
+  /* Sources */
+  l->num_stages = 0;
+  for(i = 0; i < num_outputs; i++)
+    {
+    if(l->opt.conversion_flags & GAVL_SCALE_CASCADE)
+      l->src_idx[i] = get_cascade_src(dst_formats, num_outputs, i);
+    else
+      l->src_idx[i] = -1;
+    }
+  for(i = 0; i < num_outputs; i++)
+    {
+    l->stage[i] = get_stage(l, i);
+    if(l->num_stages < l->stage[i] + 1)
+      l->num_stages = l->stage[i] + 1;
+    }
+
+  /* Initialize scalers */
+  l->passes = 1;
+
+  for(i = 0; i < num_outputs; i++)
+    {
+    opt = gavl_video_scaler_get_options(l->scalers[i]);
+    gavl_video_options_copy(opt, &l->opt);
+    gavl_video_options_set_rectangles(opt, NULL, NULL);
+
+    src = (l->src_idx[i] < 0) ? src_format : &dst_formats[l->src_idx[i]];
+
+    if(!gavl_video_scaler_init(l->scalers[i], src, &dst_formats[i]))
+      return 0;
+
+    if(!gavl_video_scaler_can_scale_rows(l->scalers[i]))
+      l->passes = 0;
+    }
+
+  /* Share first passes */
+  if(l->passes)
+    {
+    for(i = 0; i < num_outputs; i++)
+      {
+      for(plane = 0; plane < l->scalers[i]->num_planes; plane++)
+        {
+        for(j = 0; j < i; j++)
+          {
+          if((l->src_idx[j] == l->src_idx[i]) &&
+             (plane < l->scalers[j]->num_planes) &&
+             gavl_video_scale_context_share_first_pass(&l->scalers[i]->contexts[0][plane],
+                                                       &l->scalers[j]->contexts[0][plane]))
+            break;
+          }
+        }
+      }
+    }
+
+  return 1;
+  }
+
+static void first_pass(void * data, int start, int end)
+  {
+  gavl_video_scale_context_pass_rows(data, 0, start, end);
+  }
+
+static void second_pass(void * data, int start, int end)
+  {
+  gavl_video_scale_context_pass_rows(data, 1, start, end);
+  }
+
+void gavl_video_ladder_scaler_scale(gavl_video_ladder_scaler_t * l,
+                                    const gavl_video_frame_t * input_frame,
+                                    gavl_video_frame_t ** output_frames)
+  {
+  int i, stage, plane, pass, height;
+  gavl_video_scale_context_t * ctx;
+  const gavl_video_frame_t * src;
+
+  for(stage = 0; stage < l->num_stages; stage++)
+    {
+    if(!l->passes)
+      {
+      for(i = 0; i < l->num_outputs; i++)
+        {
+        if(l->stage[i] != stage)
+          continue;
+        src = (l->src_idx[i] < 0) ? input_frame : output_frames[l->src_idx[i]];
+        gavl_video_scaler_scale(l->scalers[i], src, output_frames[i]);
+        }
+      continue;
+      }
+
+    for(pass = 0; pass < 2; pass++)
+      {
+      /* Collect the scanlines of all contexts */
+      gavl_video_jobs_reset(&l->jobs);
+
+      for(i = 0; i < l->num_outputs; i++)
+        {
+        if(l->stage[i] != stage)
+          continue;
+
+        src = (l->src_idx[i] < 0) ? input_frame : output_frames[l->src_idx[i]];
+
+        for(plane = 0; plane < l->scalers[i]->num_planes; plane++)
+          {
+          ctx = &l->scalers[i]->contexts[0][plane];
+
+          if(!(height = gavl_video_scale_context_pass_height(ctx, pass)))
+            continue;
+
+          gavl_video_scale_context_pass_prepare(ctx, pass, src, output_frames[i]);
+          gavl_video_jobs_add(&l->jobs, pass ? second_pass : first_pass, ctx, height);
+          }
+        }
+      gavl_video_jobs_run(&l->jobs, l->opt.tp);
+      }
+    }
+  }
@@ -22,8 +22,10 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <float.h>
 #include <math.h>
+#include <pthread.h>
 
 #include <gavl/gavl.h>
 #include <scale.h>
@@ -47,6 +49,15 @@ static void alloc_table(gavl_video_scale_table_t * tab,
 
 static void check_clip(gavl_video_scale_table_t * tab);
 
+static void release_entry(gavl_video_scale_table_t * tab);
+
+static void init_int(const float * factors_f, int32_t * factors_i,
+                     int num_pixels, int factors_per_pixel, int bits);
+
+static int init_box(gavl_video_scale_table_t * tab,
+                    double src_off, double scale_factor,
+                    int dst_size, int src_width);
+
 static void get_preblur_coeffs(double scale_factor,
                                gavl_video_options_t * opt,
                                int * num_ret,
@@ -91,10 +102,10 @@ static void convolve_preblur(float * src_1, int src_len_1,
  *
  */
                     
-void gavl_video_scale_table_init(gavl_video_scale_table_t * tab,
-                                 gavl_video_options_t * opt,
-                                 double src_off, double src_size,
-                                 int dst_size, int src_width)
+static void init_table(gavl_video_scale_table_t * tab,
+                       gavl_video_options_t * opt,
+                       double src_off, double src_size,
+                       int dst_size, int src_width)
   {
   int widen;
 
@@ -144,6 +155,18 @@ void gavl_video_scale_table_init(gavl_video_scale_table_t * tab,
                            &num_preblur_factors,
                            &preblur_factors);
         break;
+      case GAVL_DOWNSCALE_FILTER_BOX: //!< Average the covered source pixels
+        if(init_box(tab, src_off, scale_factor, dst_size, src_width))
+          {
+          shift_borders(tab, src_width);
+          normalize_table(tab);
+          check_clip(tab);
+#ifdef DUMP_TABLE
+          gavl_video_scale_table_dump(tab);
+#endif
+          return;
+          }
+        break;
       }
     }
   
@@ -303,6 +326,260 @@ void gavl_video_scale_table_init(gavl_video_scale_table_t * tab,
 #endif  
   }
 
+/*
+ *  Table cache: Contexts with the same geometry and options share
+ *  the finished tables. Only the pixels (with the source indices, which
+ *  can be shifted later) are private, the factors are read only.
+ *  Entries are refcounted and freed when the last table is released.
+ */
+
+typedef struct
+  {
+  double src_off;
+  double src_size;
+  int dst_size;
+  int src_width;
+
+  gavl_scale_mode_t scale_mode;
+  int scale_order;
+  int quality;
+  gavl_downscale_filter_t downscale_filter;
+  float downscale_blur;
+  } table_key_t;
+
+typedef struct gavl_video_scale_table_entry_s table_entry_t;
+
+struct gavl_video_scale_table_entry_s
+  {
+  table_key_t key;
+  int refcount;
+
+  /* Scale mode, can be changed for very small images */
+  gavl_scale_mode_t scale_mode;
+
+  int num_pixels;
+  int factors_per_pixel;
+  int do_clip;
+  int normalized;
+
+  int * indices;
+  float * factors_f;
+
+  /* Integer factors for each requested resolution */
+  int num_int;
+  int * int_bits;
+  int32_t ** factors_i;
+
+  table_entry_t * next;
+  };
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static table_entry_t * cache = NULL;
+
+static void get_key(table_key_t * key, const gavl_video_options_t * opt,
+                    double src_off, double src_size,
+                    int dst_size, int src_width)
+  {
+  /* Clear the padding, keys are compared with memcmp */
+  memset(key, 0, sizeof(*key));
+  key->src_off          = src_off;
+  key->src_size         = src_size;
+  key->dst_size         = dst_size;
+  key->src_width        = src_width;
+  key->scale_mode       = opt->scale_mode;
+  key->scale_order      = opt->scale_order;
+  key->quality          = opt->quality;
+  key->downscale_filter = opt->downscale_filter;
+  key->downscale_blur   = opt->downscale_blur;
+  }
+
+/* Must be called with the cache locked */
+
+static table_entry_t * find_entry(const table_key_t * key)
+  {
+  table_entry_t * e = cache;
+  while(e)
+    {
+    if(!memcmp(&e->key, key, sizeof(*key)))
+      return e;
+    e = e->next;
+    }
+  return NULL;
+  }
+
+static table_entry_t * create_entry(const table_key_t * key,
+                                    gavl_video_options_t * opt)
+  {
+  int i;
+  gavl_video_scale_table_t tab;
+  table_entry_t * ret;
+
+  memset(&tab, 0, sizeof(tab));
+  init_table(&tab, opt, key->src_off, key->src_size,
+             key->dst_size, key->src_width);
+
+  ret = calloc(1, sizeof(*ret));
+  ret->key = *key;
+  ret->scale_mode        = opt->scale_mode;
+  ret->num_pixels        = tab.num_pixels;
+  ret->factors_per_pixel = tab.factors_per_pixel;
+  ret->do_clip           = tab.do_clip;
+  ret->normalized        = tab.normalized;
+
+  ret->indices = malloc(tab.num_pixels * sizeof(*ret->indices));
+  for(i = 0; i < tab.num_pixels; i++)
+    ret->indices[i] = tab.pixels[i].index;
+
+  /* Take over the float factors */
+  ret->factors_f = tab.factors_f;
+
+  free(tab.pixels);
+  free(tab.factors_i);
+  return ret;
+  }
+
+static void destroy_entry(table_entry_t * e)
+  {
+  int i;
+  for(i = 0; i < e->num_int; i++)
+    free(e->factors_i[i]);
+  if(e->factors_i)
+    free(e->factors_i);
+  if(e->int_bits)
+    free(e->int_bits);
+  free(e->indices);
+  free(e->factors_f);
+  free(e);
+  }
+
+static int32_t * get_entry_int(table_entry_t * e, int bits)
+  {
+  int i;
+  int32_t * ret;
+
+  pthread_mutex_lock(&cache_mutex);
+
+  for(i = 0; i < e->num_int; i++)
+    {
+    if(e->int_bits[i] == bits)
+      {
+      ret = e->factors_i[i];
+      pthread_mutex_unlock(&cache_mutex);
+      return ret;
+      }
+    }
+
+  ret = malloc(e->num_pixels * e->factors_per_pixel * sizeof(*ret));
+  init_int(e->factors_f, ret, e->num_pixels, e->factors_per_pixel, bits);
+
+  e->int_bits  = realloc(e->int_bits,  (e->num_int+1) * sizeof(*e->int_bits));
+  e->factors_i = realloc(e->factors_i, (e->num_int+1) * sizeof(*e->factors_i));
+  e->int_bits[e->num_int]  = bits;
+  e->factors_i[e->num_int] = ret;
+  e->num_int++;
+
+  pthread_mutex_unlock(&cache_mutex);
+  return ret;
+  }
+
+static void release_entry(gavl_video_scale_table_t * tab)
+  {
+  table_entry_t ** e;
+
+  if(tab->entry)
+    {
+    pthread_mutex_lock(&cache_mutex);
+    if(!(--tab->entry->refcount))
+      {
+      e = &cache;
+      while(*e != tab->entry)
+        e = &(*e)->next;
+      *e = tab->entry->next;
+      destroy_entry(tab->entry);
+      }
+    pthread_mutex_unlock(&cache_mutex);
+    tab->entry = NULL;
+    }
+  else
+    {
+    if(tab->factors_f)
+      free(tab->factors_f);
+    if(tab->factors_i)
+      free(tab->factors_i);
+    }
+  tab->factors_f = NULL;
+  tab->factors_i = NULL;
+  tab->factors_alloc = 0;
+  }
+
+void gavl_video_scale_table_init(gavl_video_scale_table_t * tab,
+                                 gavl_video_options_t * opt,
+                                 double src_off, double src_size,
+                                 int dst_size, int src_width)
+  {
+  int i;
+  table_key_t key;
+  table_entry_t * e, * new_entry = NULL;
+
+  if(!dst_size)
+    return;
+
+  get_key(&key, opt, src_off, src_size, dst_size, src_width);
+
+  pthread_mutex_lock(&cache_mutex);
+  if((e = find_entry(&key)))
+    e->refcount++;
+  pthread_mutex_unlock(&cache_mutex);
+
+  if(!e)
+    {
+    /* Calculate the table unlocked, another thread might be faster though */
+    new_entry = create_entry(&key, opt);
+
+    pthread_mutex_lock(&cache_mutex);
+    if((e = find_entry(&key)))
+      e->refcount++;
+    else
+      {
+      e = new_entry;
+      e->refcount = 1;
+      e->next = cache;
+      cache = e;
+      new_entry = NULL;
+      }
+    pthread_mutex_unlock(&cache_mutex);
+
+    if(new_entry)
+      destroy_entry(new_entry);
+    }
+
+  /* Release the old table after the lookup, so re-initializing with the
+     same parameters finds the entry */
+  release_entry(tab);
+  tab->entry = e;
+
+  opt->scale_mode = e->scale_mode;
+
+  tab->num_pixels        = e->num_pixels;
+  tab->factors_per_pixel = e->factors_per_pixel;
+  tab->do_clip           = e->do_clip;
+  tab->normalized        = e->normalized;
+  tab->factors_f         = e->factors_f;
+
+  if(tab->pixels_alloc < e->num_pixels)
+    {
+    tab->pixels_alloc = e->num_pixels + 128;
+    tab->pixels = realloc(tab->pixels, tab->pixels_alloc * sizeof(*(tab->pixels)));
+    }
+
+  for(i = 0; i < e->num_pixels; i++)
+    {
+    tab->pixels[i].index    = e->indices[i];
+    tab->pixels[i].factor_f = e->factors_f + i * e->factors_per_pixel;
+    tab->pixels[i].factor_i = NULL;
+    }
+  }
+
 void 
 gavl_video_scale_table_init_convolve(gavl_video_scale_table_t * tab,
                                      gavl_video_options_t * opt,
@@ -310,6 +587,8 @@ gavl_video_scale_table_init_convolve(gavl_video_scale_table_t * tab,
                                      int size)
   {
   int i, j;
+  release_entry(tab);
+
   tab->factors_per_pixel = num_coeffs * 2 + 1;
   alloc_table(tab, size);
   
@@ -332,6 +611,125 @@ gavl_video_scale_table_init_convolve(gavl_video_scale_table_t * tab,
   //  gavl_video_scale_table_dump(tab);
   }
 
+/* Box filter: Each destination pixel is the average of the source pixels
+   covered by it. Source pixels, which are covered only partly, get
+   smaller weights */
+
+#define BOX_EPS 1.0e-6
+
+static void get_box_range(double center, double width, int * first, int * last)
+  {
+  *first = (int)floor(center - 0.5 * width + 0.5 + BOX_EPS);
+  *last  = (int)ceil(center + 0.5 * width - 0.5 - BOX_EPS);
+  }
+
+static int init_box(gavl_video_scale_table_t * tab,
+                    double src_off, double scale_factor,
+                    int dst_size, int src_width)
+  {
+  int i, j, first, last;
+  double src_index_f, width, start, end, lo, hi;
+
+  width = 1.0 / scale_factor;
+
+  /* Get the maximum footprint */
+  tab->factors_per_pixel = 2;
+  for(i = 0; i < dst_size; i++)
+    {
+    get_box_range(DST_TO_SRC((double)i), width, &first, &last);
+    if(tab->factors_per_pixel < last - first + 1)
+      tab->factors_per_pixel = last - first + 1;
+    }
+
+  if(tab->factors_per_pixel > src_width)
+    return 0;
+
+  alloc_table(tab, dst_size);
+
+  for(i = 0; i < dst_size; i++)
+    {
+    src_index_f = DST_TO_SRC((double)i);
+    get_box_range(src_index_f, width, &first, &last);
+
+    start = src_index_f - 0.5 * width;
+    end   = src_index_f + 0.5 * width;
+
+    tab->pixels[i].index = first;
+
+    for(j = 0; j < tab->factors_per_pixel; j++)
+      {
+      lo = first + j - 0.5;
+      hi = first + j + 0.5;
+      if(lo < start)
+        lo = start;
+      if(hi > end)
+        hi = end;
+      tab->pixels[i].factor_f[j] = (hi > lo) ? (hi - lo) / width : 0.0;
+      }
+    }
+  return 1;
+  }
+
+/* Check if a table averages equally sized, adjacent source areas.
+   Returns the number of source pixels per destination pixel or 0 */
+
+int gavl_video_scale_table_get_box(const gavl_video_scale_table_t * tab)
+  {
+  int i, j, num = tab->factors_per_pixel;
+
+  if((num < 2) || !tab->num_pixels)
+    return 0;
+
+  for(i = 0; i < tab->num_pixels; i++)
+    {
+    if(tab->pixels[i].index != tab->pixels[0].index + i * num)
+      return 0;
+
+    for(j = 0; j < num; j++)
+      {
+      if(fabs(tab->pixels[i].factor_f[j] * num - 1.0) > 1.0e-4)
+        return 0;
+      }
+    }
+  return num;
+  }
+
+/* Check if a convolution table has equal, positive factors for
+   all taps. The borders must be repeated like shift_borders() does.
+   Such tables can be applied with a sliding window */
+
+int gavl_video_scale_table_is_box_convolve(const gavl_video_scale_table_t * tab)
+  {
+  int i, j, radius;
+  float fac;
+
+  if(!(tab->factors_per_pixel & 1) ||
+     (tab->num_pixels < tab->factors_per_pixel) ||
+     (tab->pixels[0].index != 0) ||
+     (tab->pixels[tab->num_pixels-1].index !=
+      tab->num_pixels - tab->factors_per_pixel))
+    return 0;
+
+  radius = tab->factors_per_pixel / 2;
+  fac = tab->pixels[radius].factor_f[0];
+
+  if(fac <= 0.0)
+    return 0;
+
+  for(i = radius; i < tab->num_pixels - radius; i++)
+    {
+    if(tab->pixels[i].index != i - radius)
+      return 0;
+
+    for(j = 0; j < tab->factors_per_pixel; j++)
+      {
+      if(fabs(tab->pixels[i].factor_f[j] - fac) > 1.0e-6 * fac)
+        return 0;
+      }
+    }
+  return 1;
+  }
+
 static void alloc_table(gavl_video_scale_table_t * tab,
                         int dst_size)
   {
@@ -531,8 +929,8 @@ static void gavl_video_scale_table_dump_int(gavl_video_scale_table_t * tab)
   }
 #endif
 
-void gavl_video_scale_table_init_int(gavl_video_scale_table_t * tab,
-                                     int bits)
+static void init_int(const float * factors_f, int32_t * factors_i,
+                     int num_pixels, int factors_per_pixel, int bits)
   {
   int fac_max_i, i, j;
   float fac_max_f, sum_f;
@@ -546,7 +944,7 @@ void gavl_video_scale_table_init_int(gavl_video_scale_table_t * tab,
 
   index = 0;
   
-  for(i = 0; i < tab->num_pixels; i++)
+  for(i = 0; i < num_pixels; i++)
     {
     min_index = index;
     max_index = index;
@@ -554,18 +952,18 @@ void gavl_video_scale_table_init_int(gavl_video_scale_table_t * tab,
     sum_i = 0;
     sum_f = 0.0;
     
-    for(j = 0; j < tab->factors_per_pixel; j++)
+    for(j = 0; j < factors_per_pixel; j++)
       {
-      tab->factors_i[index] =
-        (int)(fac_max_f * tab->factors_f[index]+0.5);
-      sum_i += tab->factors_i[index];
-      sum_f += tab->factors_f[index];
+      factors_i[index] =
+        (int)(fac_max_f * factors_f[index]+0.5);
+      sum_i += factors_i[index];
+      sum_f += factors_f[index];
       
       if(j)
         {
-        if(tab->factors_i[index] > tab->factors_i[max_index])
+        if(factors_i[index] > factors_i[max_index])
           max_index = index;
-        if(tab->factors_i[index] < tab->factors_i[min_index])
+        if(factors_i[index] < factors_i[min_index])
           min_index = index;
         }
       index++;
@@ -574,21 +972,34 @@ void gavl_video_scale_table_init_int(gavl_video_scale_table_t * tab,
       fac_i_norm = (int)(sum_f * fac_max_i + 0.5);
     
     if(sum_i > fac_i_norm)
-      tab->factors_i[max_index] -= (sum_i - fac_i_norm);
+      factors_i[max_index] -= (sum_i - fac_i_norm);
     else if(sum_i < fac_i_norm)
-      tab->factors_i[min_index] += (fac_i_norm - sum_i);
+      factors_i[min_index] += (fac_i_norm - sum_i);
     }
+  }
+
+void gavl_video_scale_table_init_int(gavl_video_scale_table_t * tab,
+                                     int bits)
+  {
+  int i;
+
+  if(tab->entry)
+    {
+    tab->factors_i = get_entry_int(tab->entry, bits);
+    for(i = 0; i < tab->num_pixels; i++)
+      tab->pixels[i].factor_i = tab->factors_i + i * tab->factors_per_pixel;
+    }
+  else
+    init_int(tab->factors_f, tab->factors_i,
+             tab->num_pixels, tab->factors_per_pixel, bits);
   //  gavl_video_scale_table_dump_int(tab);
   }
 
 void gavl_video_scale_table_cleanup(gavl_video_scale_table_t * tab)
   {
+  release_entry(tab);
   if(tab->pixels)
     free(tab->pixels);
-  if(tab->factors_f)
-    free(tab->factors_f);
-  if(tab->factors_i)
-    free(tab->factors_i);
   }
 
 void gavl_video_scale_table_get_src_indices(gavl_video_scale_table_t * tab,
@@ -0,0 +1,746 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <blend.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 blend functions. They calculate exactly the same as the
+ *  C versions: 8 bit samples are blended in 16 bit words, 16 bit samples
+ *  with the high and low words of the products. The remaining pixels
+ *  of each line are done with the scalar macros.
+ */
+
+#define BLEND_8(s, d, a) \
+  d = (((s - d) * a)>>8) + d;
+
+#define BLEND_16(s, d, a)                        \
+  d = (((s - d) * a)>>16) + d;
+
+#define BLEND_FLOAT(s, d, a)                       \
+  d = (s - d) * a + d;
+
+/* d + ((s - d) * a) >> 8 for 8 words */
+
+static inline __m128i blend_8(__m128i s, __m128i d, __m128i a)
+  {
+  __m128i x = _mm_sub_epi16(s, d);
+  return _mm_add_epi16(d,
+                       _mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(x, a), 8),
+                                    _mm_srli_epi16(_mm_mullo_epi16(x, a), 8)));
+  }
+
+/* d + ((s - d) * a) >> 16 for 8 unsigned words: The high words of
+   s * a and d * a are subtracted, a borrow from the low words is
+   subtracted as well */
+
+static inline __m128i blend_16(__m128i s, __m128i d, __m128i a)
+  {
+  const __m128i sign = _mm_set1_epi16(0x8000);
+  __m128i borrow = _mm_cmplt_epi16(_mm_xor_si128(_mm_mullo_epi16(s, a), sign),
+                                   _mm_xor_si128(_mm_mullo_epi16(d, a), sign));
+  return _mm_add_epi16(_mm_add_epi16(d, borrow),
+                       _mm_sub_epi16(_mm_mulhi_epu16(s, a),
+                                     _mm_mulhi_epu16(d, a)));
+  }
+
+/* Blend 16 bytes of dst */
+
+static inline __m128i blend_8x16(__m128i s_lo, __m128i s_hi,
+                                 __m128i a_lo, __m128i a_hi, __m128i d)
+  {
+  const __m128i zero = _mm_setzero_si128();
+  return _mm_packus_epi16(blend_8(s_lo, _mm_unpacklo_epi8(d, zero), a_lo),
+                          blend_8(s_hi, _mm_unpackhi_epi8(d, zero), a_hi));
+  }
+
+/* Blend 8 bytes of dst */
+
+static inline void blend_8x8(uint8_t * dst, __m128i s, __m128i a)
+  {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i d = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)dst), zero);
+  d = blend_8(s, d, a);
+  _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(d, d));
+  }
+
+/* Components of 8 packed 32 bit pixels as 16 bit words */
+
+#define COMPONENT(p0, p1, shift)                                \
+  _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, shift), mask_ff), \
+                  _mm_and_si128(_mm_srli_epi32(p1, shift), mask_ff))
+
+/* Even words of 2x8 words */
+
+#define EVEN(x0, x1) \
+  _mm_packs_epi32(_mm_and_si128(x0, mask_ffff), _mm_and_si128(x1, mask_ffff))
+
+/* ovl: GAVL_YUVA_32, 16 pixels at once */
+
+#define INIT_YUVA_32 \
+  __m128i p0, p1, p2, p3, y0, y1, a0, a1; \
+  const __m128i mask_ff = _mm_set1_epi32(0xff);
+
+#define INIT_EVEN \
+  const __m128i mask_ffff = _mm_set1_epi32(0xffff);
+
+#define LOAD_YUVA_32(ptr) \
+  p0 = _mm_loadu_si128((const __m128i*)(ptr)); \
+  p1 = _mm_loadu_si128((const __m128i*)((ptr)+16)); \
+  p2 = _mm_loadu_si128((const __m128i*)((ptr)+32)); \
+  p3 = _mm_loadu_si128((const __m128i*)((ptr)+48)); \
+  y0 = COMPONENT(p0, p1, 0); \
+  y1 = COMPONENT(p2, p3, 0); \
+  a0 = COMPONENT(p0, p1, 24); \
+  a1 = COMPONENT(p2, p3, 24);
+
+#define BLEND_Y(dst) \
+  _mm_storeu_si128((__m128i*)(dst), \
+                   blend_8x16(y0, y1, a0, a1, \
+                              _mm_loadu_si128((const __m128i*)(dst))));
+
+/* Chroma of every second pixel */
+
+#define BLEND_UV_EVEN(dst_u, dst_v)                                      \
+  a0 = EVEN(a0, a1);                                                    \
+  blend_8x8(dst_u, EVEN(COMPONENT(p0, p1, 8), COMPONENT(p2, p3, 8)), a0); \
+  blend_8x8(dst_v, EVEN(COMPONENT(p0, p1, 16), COMPONENT(p2, p3, 16)), a0);
+
+static void blend_yuv_420_p_sse2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr_y;
+  uint8_t * dst_ptr_u;
+  uint8_t * dst_ptr_v;
+  int w16 = width & ~15;
+  INIT_YUVA_32
+  INIT_EVEN
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr_y = frame->planes[0] + i * frame->strides[0];
+    dst_ptr_u = frame->planes[1] + (i/2) * frame->strides[1];
+    dst_ptr_v = frame->planes[2] + (i/2) * frame->strides[2];
+
+    for(j = 0; j < w16; j += 16)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_Y(dst_ptr_y);
+
+      if(!(i & 1))
+        {
+        BLEND_UV_EVEN(dst_ptr_u, dst_ptr_v);
+        dst_ptr_u += 8;
+        dst_ptr_v += 8;
+        }
+      ovl_ptr += 64;
+      dst_ptr_y += 16;
+      }
+
+    for(j = w16; j < width; j += 2)
+      {
+      tmp = dst_ptr_y[0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr_y[0] = tmp;
+
+      tmp = dst_ptr_y[1];
+      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
+      dst_ptr_y[1] = tmp;
+
+      if(!(i & 1))
+        {
+        tmp = *dst_ptr_u;
+        BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+        *(dst_ptr_u++) = tmp;
+
+        tmp = *dst_ptr_v;
+        BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+        *(dst_ptr_v++) = tmp;
+        }
+      ovl_ptr += 8;
+      dst_ptr_y += 2;
+      }
+    }
+  }
+
+static void blend_yuv_422_p_sse2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr_y;
+  uint8_t * dst_ptr_u;
+  uint8_t * dst_ptr_v;
+  int w16 = width & ~15;
+  INIT_YUVA_32
+  INIT_EVEN
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr_y = frame->planes[0] + i * frame->strides[0];
+    dst_ptr_u = frame->planes[1] + i * frame->strides[1];
+    dst_ptr_v = frame->planes[2] + i * frame->strides[2];
+
+    for(j = 0; j < w16; j += 16)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_Y(dst_ptr_y);
+      BLEND_UV_EVEN(dst_ptr_u, dst_ptr_v);
+      ovl_ptr += 64;
+      dst_ptr_y += 16;
+      dst_ptr_u += 8;
+      dst_ptr_v += 8;
+      }
+
+    for(j = w16; j < width; j += 2)
+      {
+      tmp = dst_ptr_y[0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr_y[0] = tmp;
+
+      tmp = dst_ptr_y[1];
+      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
+      dst_ptr_y[1] = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      *(dst_ptr_v++) = tmp;
+
+      ovl_ptr += 8;
+      dst_ptr_y += 2;
+      }
+    }
+  }
+
+static void blend_yuv_444_p_sse2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr_y;
+  uint8_t * dst_ptr_u;
+  uint8_t * dst_ptr_v;
+  int w16 = width & ~15;
+  INIT_YUVA_32
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr_y = frame->planes[0] + i * frame->strides[0];
+    dst_ptr_u = frame->planes[1] + i * frame->strides[1];
+    dst_ptr_v = frame->planes[2] + i * frame->strides[2];
+
+    for(j = 0; j < w16; j += 16)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_Y(dst_ptr_y);
+
+      _mm_storeu_si128((__m128i*)dst_ptr_u,
+                       blend_8x16(COMPONENT(p0, p1, 8), COMPONENT(p2, p3, 8),
+                                  a0, a1,
+                                  _mm_loadu_si128((const __m128i*)dst_ptr_u)));
+      _mm_storeu_si128((__m128i*)dst_ptr_v,
+                       blend_8x16(COMPONENT(p0, p1, 16), COMPONENT(p2, p3, 16),
+                                  a0, a1,
+                                  _mm_loadu_si128((const __m128i*)dst_ptr_v)));
+      ovl_ptr += 64;
+      dst_ptr_y += 16;
+      dst_ptr_u += 16;
+      dst_ptr_v += 16;
+      }
+
+    for(j = w16; j < width; j++)
+      {
+      tmp = *dst_ptr_y;
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      *(dst_ptr_y++) = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      *(dst_ptr_v++) = tmp;
+
+      ovl_ptr += 4;
+      }
+    }
+  }
+
+/* Packed 4:2:2: The chroma of the even pixels is interleaved with
+   the luma of all pixels */
+
+#define BLEND_PACKED_422(dst, y_first)                                  \
+  c0 = EVEN(COMPONENT(p0, p1, 8), COMPONENT(p2, p3, 8));                \
+  c1 = EVEN(COMPONENT(p0, p1, 16), COMPONENT(p2, p3, 16));              \
+  ca = EVEN(a0, a1);                                                    \
+  /* u0 v0 u2 v2 ... */                                                 \
+  c = _mm_unpacklo_epi16(c0, c1);                                       \
+  c1 = _mm_unpackhi_epi16(c0, c1);                                      \
+  c0 = c;                                                               \
+  c = _mm_unpacklo_epi16(ca, ca);                                       \
+  ca = _mm_unpackhi_epi16(ca, ca);                                      \
+  if(y_first)                                                           \
+    {                                                                   \
+    d = blend_8x16(_mm_unpacklo_epi16(y0, c0), _mm_unpackhi_epi16(y0, c0), \
+                   _mm_unpacklo_epi16(a0, c), _mm_unpackhi_epi16(a0, c), \
+                   _mm_loadu_si128((const __m128i*)(dst)));             \
+    _mm_storeu_si128((__m128i*)(dst), d);                               \
+    d = blend_8x16(_mm_unpacklo_epi16(y1, c1), _mm_unpackhi_epi16(y1, c1), \
+                   _mm_unpacklo_epi16(a1, ca), _mm_unpackhi_epi16(a1, ca), \
+                   _mm_loadu_si128((const __m128i*)((dst)+16)));        \
+    _mm_storeu_si128((__m128i*)((dst)+16), d);                          \
+    }                                                                   \
+  else                                                                  \
+    {                                                                   \
+    d = blend_8x16(_mm_unpacklo_epi16(c0, y0), _mm_unpackhi_epi16(c0, y0), \
+                   _mm_unpacklo_epi16(c, a0), _mm_unpackhi_epi16(c, a0), \
+                   _mm_loadu_si128((const __m128i*)(dst)));             \
+    _mm_storeu_si128((__m128i*)(dst), d);                               \
+    d = blend_8x16(_mm_unpacklo_epi16(c1, y1), _mm_unpackhi_epi16(c1, y1), \
+                   _mm_unpacklo_epi16(ca, a1), _mm_unpackhi_epi16(ca, a1), \
+                   _mm_loadu_si128((const __m128i*)((dst)+16)));        \
+    _mm_storeu_si128((__m128i*)((dst)+16), d);                          \
+    }
+
+static void blend_packed_422_sse2(gavl_video_frame_t * frame,
+                                  gavl_video_frame_t * overlay,
+                                  int width, int height, int y_first)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  __m128i c, c0, c1, ca, d;
+  int w16 = width & ~15;
+  /* Byte offsets of y0, u, y1, v */
+  int oy0 = y_first ? 0 : 1;
+  int ou  = y_first ? 1 : 0;
+  int oy1 = y_first ? 2 : 3;
+  int ov  = y_first ? 3 : 2;
+  INIT_YUVA_32
+  INIT_EVEN
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+
+    for(j = 0; j < w16; j += 16)
+      {
+      LOAD_YUVA_32(ovl_ptr);
+      BLEND_PACKED_422(dst_ptr, y_first);
+      ovl_ptr += 64;
+      dst_ptr += 32;
+      }
+
+    for(j = w16; j < width; j += 2)
+      {
+      tmp = dst_ptr[oy0];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr[oy0] = tmp;
+
+      tmp = dst_ptr[ou];
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      dst_ptr[ou] = tmp;
+
+      tmp = dst_ptr[ov];
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      dst_ptr[ov] = tmp;
+
+      tmp = dst_ptr[oy1];
+      BLEND_8(ovl_ptr[4], tmp, ovl_ptr[7]);
+      dst_ptr[oy1] = tmp;
+
+      ovl_ptr += 8;
+      dst_ptr += 4;
+      }
+    }
+  }
+
+static void blend_yuy2_sse2(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
+  {
+  blend_packed_422_sse2(frame, overlay, width, height, 1);
+  }
+
+static void blend_uyvy_sse2(gavl_video_frame_t * frame,
+                            gavl_video_frame_t * overlay,
+                            int width, int height)
+  {
+  blend_packed_422_sse2(frame, overlay, width, height, 0);
+  }
+
+/* ovl: GAVL_RGBA_32, 4 pixels at once. The 4th byte of the
+   destination is blended with zero alpha, so it stays unchanged */
+
+static void blend_rgb_32_common(gavl_video_frame_t * frame,
+                                gavl_video_frame_t * overlay,
+                                int width, int height, int swap)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  __m128i o, s_lo, s_hi, a_lo, a_hi;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+  int w4 = width & ~3;
+  /* Byte offsets of r and b */
+  int o_r = swap ? 2 : 0;
+  int o_b = swap ? 0 : 2;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+
+    for(j = 0; j < w4; j += 4)
+      {
+      o = _mm_loadu_si128((const __m128i*)ovl_ptr);
+      s_lo = _mm_unpacklo_epi8(o, zero);
+      s_hi = _mm_unpackhi_epi8(o, zero);
+
+      a_lo = _mm_and_si128(_mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xff), 0xff), mask);
+      a_hi = _mm_and_si128(_mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xff), 0xff), mask);
+
+      if(swap)
+        {
+        s_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, _MM_SHUFFLE(3, 0, 1, 2)),
+                                   _MM_SHUFFLE(3, 0, 1, 2));
+        s_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, _MM_SHUFFLE(3, 0, 1, 2)),
+                                   _MM_SHUFFLE(3, 0, 1, 2));
+        }
+
+      _mm_storeu_si128((__m128i*)dst_ptr,
+                       blend_8x16(s_lo, s_hi, a_lo, a_hi,
+                                  _mm_loadu_si128((const __m128i*)dst_ptr)));
+      ovl_ptr += 16;
+      dst_ptr += 16;
+      }
+
+    for(j = w4; j < width; j++)
+      {
+      tmp = dst_ptr[o_r];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr[o_r] = tmp;
+
+      tmp = dst_ptr[1];
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      dst_ptr[1] = tmp;
+
+      tmp = dst_ptr[o_b];
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      dst_ptr[o_b] = tmp;
+
+      ovl_ptr += 4;
+      dst_ptr += 4;
+      }
+    }
+  }
+
+static void blend_rgb_32_sse2(gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay,
+                              int width, int height)
+  {
+  blend_rgb_32_common(frame, overlay, width, height, 0);
+  }
+
+static void blend_bgr_32_sse2(gavl_video_frame_t * frame,
+                              gavl_video_frame_t * overlay,
+                              int width, int height)
+  {
+  blend_rgb_32_common(frame, overlay, width, height, 1);
+  }
+
+/* ovl: GAVL_YUVA_64, 8 pixels at once */
+
+/* Transpose 2 pixels from each of p0, p1 into the components
+   of 4 pixels: y in the lower and u in the upper half of yu */
+
+#define TRANSPOSE_64(p0, p1, yu, va)            \
+  t0 = _mm_unpacklo_epi16(p0, p1);              \
+  t1 = _mm_unpackhi_epi16(p0, p1);              \
+  yu = _mm_unpacklo_epi16(t0, t1);              \
+  va = _mm_unpackhi_epi16(t0, t1);
+
+#define LOAD_YUVA_64(ptr) \
+  p0 = _mm_loadu_si128((const __m128i*)(ptr)); \
+  p1 = _mm_loadu_si128((const __m128i*)((ptr)+16)); \
+  p2 = _mm_loadu_si128((const __m128i*)((ptr)+32)); \
+  p3 = _mm_loadu_si128((const __m128i*)((ptr)+48)); \
+  TRANSPOSE_64(p0, p1, yu0, va0); \
+  TRANSPOSE_64(p2, p3, yu1, va1); \
+  y = _mm_unpacklo_epi64(yu0, yu1); \
+  u = _mm_unpackhi_epi64(yu0, yu1); \
+  v = _mm_unpacklo_epi64(va0, va1); \
+  a = _mm_unpackhi_epi64(va0, va1);
+
+#define BLEND_16_STORE(dst, s, a) \
+  _mm_storeu_si128((__m128i*)(dst), \
+                   blend_16(s, _mm_loadu_si128((const __m128i*)(dst)), a));
+
+static void blend_yuv_444_p_16_sse2(gavl_video_frame_t * frame,
+                                    gavl_video_frame_t * overlay,
+                                    int width, int height)
+  {
+  int i, j;
+  uint16_t * ovl_ptr;
+  uint16_t * dst_ptr_y;
+  uint16_t * dst_ptr_u;
+  uint16_t * dst_ptr_v;
+  int64_t tmp, alpha;
+  __m128i p0, p1, p2, p3, t0, t1, yu0, yu1, va0, va1, y, u, v, a;
+  int w8 = width & ~7;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = (uint16_t*)(overlay->planes[0] + i * overlay->strides[0]);
+    dst_ptr_y = (uint16_t*)(frame->planes[0] + i * frame->strides[0]);
+    dst_ptr_u = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+    dst_ptr_v = (uint16_t*)(frame->planes[2] + i * frame->strides[2]);
+
+    for(j = 0; j < w8; j += 8)
+      {
+      LOAD_YUVA_64((uint8_t*)ovl_ptr);
+      BLEND_16_STORE(dst_ptr_y, y, a);
+      BLEND_16_STORE(dst_ptr_u, u, a);
+      BLEND_16_STORE(dst_ptr_v, v, a);
+      ovl_ptr += 32;
+      dst_ptr_y += 8;
+      dst_ptr_u += 8;
+      dst_ptr_v += 8;
+      }
+
+    for(j = w8; j < width; j++)
+      {
+      alpha = ovl_ptr[3];
+
+      tmp = *dst_ptr_y;
+      BLEND_16(ovl_ptr[0], tmp, alpha);
+      *(dst_ptr_y++) = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_16(ovl_ptr[1], tmp, alpha);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_16(ovl_ptr[2], tmp, alpha);
+      *(dst_ptr_v++) = tmp;
+
+      ovl_ptr += 4;
+      }
+    }
+  }
+
+static void blend_yuv_422_p_16_sse2(gavl_video_frame_t * frame,
+                                    gavl_video_frame_t * overlay,
+                                    int width, int height)
+  {
+  int i, j;
+  uint16_t * ovl_ptr;
+  uint16_t * dst_ptr_y;
+  uint16_t * dst_ptr_u;
+  uint16_t * dst_ptr_v;
+  int64_t tmp, alpha;
+  __m128i p0, p1, p2, p3, t0, t1, yu0, yu1, va0, va1, y, u, v, a;
+  __m128i u_even, v_even, a_even;
+  int w16 = width & ~15;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = (uint16_t*)(overlay->planes[0] + i * overlay->strides[0]);
+    dst_ptr_y = (uint16_t*)(frame->planes[0] + i * frame->strides[0]);
+    dst_ptr_u = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+    dst_ptr_v = (uint16_t*)(frame->planes[2] + i * frame->strides[2]);
+
+    for(j = 0; j < w16; j += 16)
+      {
+      /* The even pixels of 2x8 pixels */
+      LOAD_YUVA_64((uint8_t*)ovl_ptr);
+      BLEND_16_STORE(dst_ptr_y, y, a);
+      u_even = u;
+      v_even = v;
+      a_even = a;
+
+      LOAD_YUVA_64((uint8_t*)(ovl_ptr+32));
+      BLEND_16_STORE(dst_ptr_y + 8, y, a);
+
+      /* Select the even words with sign-extension safe shifts */
+      u_even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(u_even, 16), 16),
+                               _mm_srai_epi32(_mm_slli_epi32(u, 16), 16));
+      v_even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(v_even, 16), 16),
+                               _mm_srai_epi32(_mm_slli_epi32(v, 16), 16));
+      a_even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a_even, 16), 16),
+                               _mm_srai_epi32(_mm_slli_epi32(a, 16), 16));
+
+      BLEND_16_STORE(dst_ptr_u, u_even, a_even);
+      BLEND_16_STORE(dst_ptr_v, v_even, a_even);
+
+      ovl_ptr += 64;
+      dst_ptr_y += 16;
+      dst_ptr_u += 8;
+      dst_ptr_v += 8;
+      }
+
+    for(j = w16; j < width; j += 2)
+      {
+      alpha = ovl_ptr[3];
+
+      tmp = *dst_ptr_y;
+      BLEND_16(ovl_ptr[0], tmp, alpha);
+      *(dst_ptr_y++) = tmp;
+
+      tmp = *dst_ptr_u;
+      BLEND_16(ovl_ptr[1], tmp, alpha);
+      *(dst_ptr_u++) = tmp;
+
+      tmp = *dst_ptr_v;
+      BLEND_16(ovl_ptr[2], tmp, alpha);
+      *(dst_ptr_v++) = tmp;
+
+      alpha = ovl_ptr[7];
+
+      tmp = *dst_ptr_y;
+      BLEND_16(ovl_ptr[4], tmp, alpha);
+      *(dst_ptr_y++) = tmp;
+
+      ovl_ptr += 8;
+      }
+    }
+  }
+
+/* ovl: GAVL_RGBA_FLOAT, 4 pixels at once. The 3 vectors of the
+   destination are unpacked into 4 pixels, blended and packed again,
+   so no memory is accessed twice */
+
+static void blend_rgb_float_sse2(gavl_video_frame_t * frame,
+                                 gavl_video_frame_t * overlay,
+                                 int width, int height)
+  {
+  int i, j;
+  float * ovl_ptr;
+  float * dst_ptr;
+  __m128 d0, d1, d2, p0, p1, p2, p3, t;
+  int w4 = width & ~3;
+
+#define BLEND_PIXEL_FLOAT(p, o)                                        \
+  p = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(o, p),                          \
+                            _mm_shuffle_ps(o, o, _MM_SHUFFLE(3, 3, 3, 3))), p)
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = (float*)(overlay->planes[0] + i * overlay->strides[0]);
+    dst_ptr = (float*)(frame->planes[0] + i * frame->strides[0]);
+
+    for(j = 0; j < w4; j += 4)
+      {
+      d0 = _mm_loadu_ps(dst_ptr);
+      d1 = _mm_loadu_ps(dst_ptr + 4);
+      d2 = _mm_loadu_ps(dst_ptr + 8);
+
+      /* r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3 -> rgbx rgbx rgbx rgbx */
+      p0 = d0;
+      t  = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(0, 0, 3, 3));
+      p1 = _mm_shuffle_ps(t, d1, _MM_SHUFFLE(1, 1, 2, 0));
+      p2 = _mm_shuffle_ps(d1, d2, _MM_SHUFFLE(0, 0, 3, 2));
+      p3 = _mm_shuffle_ps(d2, d2, _MM_SHUFFLE(3, 3, 2, 1));
+
+      BLEND_PIXEL_FLOAT(p0, _mm_loadu_ps(ovl_ptr));
+      BLEND_PIXEL_FLOAT(p1, _mm_loadu_ps(ovl_ptr + 4));
+      BLEND_PIXEL_FLOAT(p2, _mm_loadu_ps(ovl_ptr + 8));
+      BLEND_PIXEL_FLOAT(p3, _mm_loadu_ps(ovl_ptr + 12));
+
+      /* Pack again */
+      t  = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(0, 0, 2, 2));
+      d0 = _mm_shuffle_ps(p0, t, _MM_SHUFFLE(2, 0, 1, 0));
+      d1 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(1, 0, 2, 1));
+      t  = _mm_shuffle_ps(p2, p3, _MM_SHUFFLE(0, 0, 2, 2));
+      d2 = _mm_shuffle_ps(t, p3, _MM_SHUFFLE(2, 1, 2, 0));
+
+      _mm_storeu_ps(dst_ptr,     d0);
+      _mm_storeu_ps(dst_ptr + 4, d1);
+      _mm_storeu_ps(dst_ptr + 8, d2);
+
+      ovl_ptr += 16;
+      dst_ptr += 12;
+      }
+
+    for(j = w4; j < width; j++)
+      {
+      BLEND_FLOAT(ovl_ptr[0], dst_ptr[0], ovl_ptr[3]);
+      BLEND_FLOAT(ovl_ptr[1], dst_ptr[1], ovl_ptr[3]);
+      BLEND_FLOAT(ovl_ptr[2], dst_ptr[2], ovl_ptr[3]);
+      ovl_ptr += 4;
+      dst_ptr += 3;
+      }
+    }
+#undef BLEND_PIXEL_FLOAT
+  }
+
+gavl_blend_func_t
+gavl_find_blend_func_sse2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format,
+                          gavl_pixelformat_t overlay_format)
+  {
+  switch(frame_format)
+    {
+    case GAVL_YUV_420_P:
+      return blend_yuv_420_p_sse2;
+    case GAVL_YUV_422_P:
+      return blend_yuv_422_p_sse2;
+    case GAVL_YUV_444_P:
+      return blend_yuv_444_p_sse2;
+    case GAVL_YUY2:
+      return blend_yuy2_sse2;
+    case GAVL_UYVY:
+      return blend_uyvy_sse2;
+    case GAVL_RGB_32:
+      return blend_rgb_32_sse2;
+    case GAVL_BGR_32:
+      return blend_bgr_32_sse2;
+    case GAVL_YUV_444_P_16:
+      return blend_yuv_444_p_16_sse2;
+    case GAVL_YUV_422_P_16:
+      return blend_yuv_422_p_16_sse2;
+    case GAVL_RGB_FLOAT:
+    case GAVL_YUV_FLOAT:
+      return blend_rgb_float_sse2;
+    default:
+      break;
+    }
+  return NULL;
+  }
@@ -0,0 +1,206 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <deinterlace.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 version of the motion adaptive deinterlacer for 8 bit samples.
+ *  8 samples are processed at once in 16 bit words, so the results
+ *  are identical to the C version. Samples near the line borders
+ *  and the first frame (no previous one) are done in C.
+ *
+ *  For packed 4:2:2, the luma and chroma samples have different
+ *  distances. The shifted lines are loaded for both and the luma
+ *  lanes are selected with luma_mask.
+ */
+
+#define LOAD(ptr) \
+  _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(ptr)), zero)
+
+#define ABSDIFF(a, b) \
+  _mm_max_epi16(_mm_sub_epi16(a, b), _mm_sub_epi16(b, a))
+
+#define HALF(a) _mm_srli_epi16(a, 1)
+
+#define SELECT(mask, a, b) \
+  _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+
+/* m[k] and p[k] are the lines above and below, shifted by k pixels */
+
+#define SCORE(j) \
+  _mm_add_epi16(_mm_add_epi16(ABSDIFF(m[3+(j)-1], p[3-(j)-1]), \
+                              ABSDIFF(m[3+(j)],   p[3-(j)])), \
+                ABSDIFF(m[3+(j)+1], p[3-(j)+1]))
+
+#define CHECK(j, mask) \
+  score = SCORE(j); \
+  mask = _mm_and_si128(mask, _mm_cmplt_epi16(score, spatial_score)); \
+  spatial_score = SELECT(mask, score, spatial_score); \
+  spatial_pred = SELECT(mask, HALF(_mm_add_epi16(m[3+(j)], p[3-(j)])), \
+                        spatial_pred);
+
+static inline void adaptive_sse2(const uint8_t * const * prev,
+                                 const uint8_t * const * cur,
+                                 uint8_t * dst,
+                                 int start, int end, int num,
+                                 int luma_advance, int chroma_advance,
+                                 __m128i luma_mask,
+                                 gavl_video_deinterlace_adaptive_func func_c)
+  {
+  int i, k;
+  int simd_start, simd_end;
+
+  __m128i m[7], p[7];
+  __m128i c, e, d, b, f, diff, min, max, score, mask;
+  __m128i spatial_pred, spatial_score;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one  = _mm_set1_epi16(1);
+  const __m128i all  = _mm_cmpeq_epi16(zero, zero);
+
+  if(!prev)
+    {
+    func_c(prev, cur, dst, start, end, num, luma_advance);
+    return;
+    }
+
+  /* Start at an even sample, so the lanes match luma_mask */
+  simd_start = 3 * chroma_advance;
+  if(simd_start < start)
+    simd_start = (start + 1) & ~1;
+
+  simd_end = num - 3 * chroma_advance;
+  if(simd_end > end)
+    simd_end = end;
+
+  if(simd_end - simd_start < 8)
+    {
+    func_c(prev, cur, dst, start, end, num, luma_advance);
+    return;
+    }
+
+  simd_end = simd_start + ((simd_end - simd_start) & ~7);
+
+  func_c(prev, cur, dst, start, simd_start, num, luma_advance);
+
+  for(i = simd_start; i < simd_end; i += 8)
+    {
+    for(k = 0; k < 7; k++)
+      {
+      m[k] = LOAD(cur[1] + i + (k - 3) * luma_advance);
+      p[k] = LOAD(cur[3] + i + (k - 3) * luma_advance);
+
+      if(chroma_advance != luma_advance)
+        {
+        m[k] = SELECT(luma_mask, m[k],
+                      LOAD(cur[1] + i + (k - 3) * chroma_advance));
+        p[k] = SELECT(luma_mask, p[k],
+                      LOAD(cur[3] + i + (k - 3) * chroma_advance));
+        }
+      }
+    c = m[3];
+    e = p[3];
+
+    /* Spatial prediction */
+    spatial_pred  = HALF(_mm_add_epi16(c, e));
+    spatial_score = _mm_sub_epi16(SCORE(0), one);
+
+    mask = all;
+    CHECK(-1, mask);
+    CHECK(-2, mask);
+    mask = all;
+    CHECK(1, mask);
+    CHECK(2, mask);
+
+    /* Temporal limits */
+    b = LOAD(prev[2] + i);
+    f = LOAD(cur[2] + i);
+    d = HALF(_mm_add_epi16(b, f));
+    diff = _mm_max_epi16(HALF(ABSDIFF(b, f)),
+                         HALF(_mm_add_epi16(ABSDIFF(LOAD(prev[1] + i), c),
+                                            ABSDIFF(LOAD(prev[3] + i), e))));
+
+    b = HALF(_mm_add_epi16(LOAD(prev[0] + i), LOAD(cur[0] + i)));
+    f = HALF(_mm_add_epi16(LOAD(prev[4] + i), LOAD(cur[4] + i)));
+
+    max = _mm_max_epi16(_mm_max_epi16(_mm_sub_epi16(d, e), _mm_sub_epi16(d, c)),
+                        _mm_min_epi16(_mm_sub_epi16(b, c), _mm_sub_epi16(f, e)));
+    min = _mm_min_epi16(_mm_min_epi16(_mm_sub_epi16(d, e), _mm_sub_epi16(d, c)),
+                        _mm_max_epi16(_mm_sub_epi16(b, c), _mm_sub_epi16(f, e)));
+    diff = _mm_max_epi16(_mm_max_epi16(diff, min), _mm_sub_epi16(zero, max));
+
+    spatial_pred = _mm_min_epi16(spatial_pred, _mm_add_epi16(d, diff));
+    spatial_pred = _mm_max_epi16(spatial_pred, _mm_sub_epi16(d, diff));
+
+    _mm_storel_epi64((__m128i*)(dst + i),
+                     _mm_packus_epi16(spatial_pred, spatial_pred));
+    }
+
+  func_c(prev, cur, dst, simd_end, end, num, luma_advance);
+  }
+
+static void adaptive_8_sse2(const uint8_t * const * prev,
+                            const uint8_t * const * cur,
+                            uint8_t * dst,
+                            int start, int end,
+                            int num, int advance)
+  {
+  adaptive_sse2(prev, cur, dst, start, end, num, advance, advance,
+                _mm_setzero_si128(), gavl_deinterlace_adaptive_8_c);
+  }
+
+/* Luma samples are in the even lanes for YUY2 and the odd ones for UYVY */
+
+static void adaptive_yuy2_sse2(const uint8_t * const * prev,
+                               const uint8_t * const * cur,
+                               uint8_t * dst,
+                               int start, int end,
+                               int num, int advance)
+  {
+  adaptive_sse2(prev, cur, dst, start, end, num, advance, 2 * advance,
+                _mm_set_epi16(0, -1, 0, -1, 0, -1, 0, -1),
+                gavl_deinterlace_adaptive_yuy2_c);
+  }
+
+static void adaptive_uyvy_sse2(const uint8_t * const * prev,
+                               const uint8_t * const * cur,
+                               uint8_t * dst,
+                               int start, int end,
+                               int num, int advance)
+  {
+  adaptive_sse2(prev, cur, dst, start, end, num, advance, 2 * advance,
+                _mm_set_epi16(-1, 0, -1, 0, -1, 0, -1, 0),
+                gavl_deinterlace_adaptive_uyvy_c);
+  }
+
+void
+gavl_find_deinterlacer_adaptive_funcs_sse2(gavl_video_deinterlace_adaptive_func_table_t * tab,
+                                           const gavl_video_options_t * opt,
+                                           const gavl_video_format_t * format)
+  {
+  tab->func_8    = adaptive_8_sse2;
+  tab->func_yuy2 = adaptive_yuy2_sse2;
+  tab->func_uyvy = adaptive_uyvy_sse2;
+  }
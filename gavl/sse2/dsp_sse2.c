@@ -0,0 +1,778 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <gavl/gavldsp.h>
+#include <dsp.h>
+#include <bswap.h>
+
+#include "../c/colorspace_tables.h"
+#include "../c/colorspace_macros.h"
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 versions of the dsp functions. Except for sad_f (which
+ *  sums up in a different order), the results are identical to the
+ *  C versions. The remaining samples of each line are done in C.
+ */
+
+#define LOAD(ptr)       _mm_loadu_si128((const __m128i*)(ptr))
+#define STORE(ptr, val) _mm_storeu_si128((__m128i*)(ptr), val)
+
+#define ABSDIFF_U8(a, b)  _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a))
+#define ABSDIFF_U16(a, b) _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a))
+
+#define CLIP(val, min, max) ((val)>(max)?(max):((val)<(min)?(min):(val)))
+
+/* 5 and 6 bit components to 8 bit, identical to gavl_rgb_5_to_8
+   and gavl_rgb_6_to_8 */
+
+#define EXPAND_5(x) \
+  _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(x, _mm_set1_epi16(527)), \
+                               _mm_set1_epi16(23)), 6)
+
+#define EXPAND_6(x) \
+  _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(x, _mm_set1_epi16(259)), \
+                               _mm_set1_epi16(33)), 6)
+
+#define FIELD(x, shift, mask) \
+  _mm_and_si128(_mm_srli_epi16(x, shift), _mm_set1_epi16(mask))
+
+static int sum_64(__m128i acc)
+  {
+  acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+  return _mm_cvtsi128_si32(acc);
+  }
+
+static int sum_32(__m128i acc)
+  {
+  acc = _mm_add_epi32(acc, _mm_unpackhi_epi64(acc, acc));
+  acc = _mm_add_epi32(acc, _mm_srli_epi64(acc, 32));
+  return _mm_cvtsi128_si32(acc);
+  }
+
+/* Sum of absolute differences */
+
+#define SAD_RGB(name, R_SHIFT, G_SHIFT, G_MASK, EXPAND_G, R_8, G_8, B_8) \
+static int name(const uint8_t * src_1, const uint8_t * src_2, \
+                int stride_1, int stride_2, \
+                int w, int h) \
+  { \
+  int ret = 0, i, j; \
+  const uint16_t * s1, *s2; \
+  __m128i a, b, ag, bg; \
+  __m128i acc = _mm_setzero_si128(); \
+  const __m128i zero = _mm_setzero_si128(); \
+  \
+  for(i = 0; i < h; i++) \
+    { \
+    s1 = (const uint16_t *)src_1; \
+    s2 = (const uint16_t *)src_2; \
+    \
+    for(j = 0; j < w - 7; j += 8) \
+      { \
+      a = LOAD(s1 + j); \
+      b = LOAD(s2 + j); \
+      ag = EXPAND_G(FIELD(a, G_SHIFT, G_MASK)); \
+      bg = EXPAND_G(FIELD(b, G_SHIFT, G_MASK)); \
+      acc = _mm_add_epi64(acc, \
+                          _mm_sad_epu8(_mm_packus_epi16(EXPAND_5(FIELD(a, R_SHIFT, 0x1f)), ag), \
+                                       _mm_packus_epi16(EXPAND_5(FIELD(b, R_SHIFT, 0x1f)), bg))); \
+      acc = _mm_add_epi64(acc, \
+                          _mm_sad_epu8(_mm_packus_epi16(EXPAND_5(FIELD(a, 0, 0x1f)), zero), \
+                                       _mm_packus_epi16(EXPAND_5(FIELD(b, 0, 0x1f)), zero))); \
+      } \
+    for(; j < w; j++) \
+      { \
+      ret += \
+        abs(R_8(s1[j])-R_8(s2[j])) + \
+        abs(G_8(s1[j])-G_8(s2[j])) + \
+        abs(B_8(s1[j])-B_8(s2[j])); \
+      } \
+    src_1 += stride_1; \
+    src_2 += stride_2; \
+    } \
+  return ret + sum_64(acc); \
+  }
+
+SAD_RGB(sad_rgb15_sse2, 10, 5, 0x1f, EXPAND_5,
+        RGB15_TO_R_8, RGB15_TO_G_8, RGB15_TO_B_8)
+SAD_RGB(sad_rgb16_sse2, 11, 5, 0x3f, EXPAND_6,
+        RGB16_TO_R_8, RGB16_TO_G_8, RGB16_TO_B_8)
+
+static int sad_8_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                      int stride_1, int stride_2,
+                      int w, int h)
+  {
+  int ret = 0, i, j;
+  __m128i acc = _mm_setzero_si128();
+
+  for(i = 0; i < h; i++)
+    {
+    for(j = 0; j < w - 15; j += 16)
+      acc = _mm_add_epi64(acc, _mm_sad_epu8(LOAD(src_1 + j), LOAD(src_2 + j)));
+    for(; j < w; j++)
+      ret += abs(src_1[j] - src_2[j]);
+    src_1 += stride_1;
+    src_2 += stride_2;
+    }
+  return ret + sum_64(acc);
+  }
+
+static int sad_16_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                       int stride_1, int stride_2,
+                       int w, int h)
+  {
+  int ret = 0, i, j;
+  const uint16_t * s1, *s2;
+  __m128i d;
+  __m128i acc = _mm_setzero_si128();
+  const __m128i zero = _mm_setzero_si128();
+
+  for(i = 0; i < h; i++)
+    {
+    s1 = (const uint16_t*)src_1;
+    s2 = (const uint16_t*)src_2;
+
+    for(j = 0; j < w - 7; j += 8)
+      {
+      d = ABSDIFF_U16(LOAD(s1 + j), LOAD(s2 + j));
+      acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_unpacklo_epi16(d, zero),
+                                             _mm_unpackhi_epi16(d, zero)));
+      }
+    for(; j < w; j++)
+      ret += abs(s1[j] - s2[j]);
+    src_1 += stride_1;
+    src_2 += stride_2;
+    }
+  return ret + sum_32(acc);
+  }
+
+static float sad_f_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                        int stride_1, int stride_2,
+                        int w, int h)
+  {
+  float ret = 0.0;
+  float sums[4];
+  int i, j;
+  const float * s1, *s2;
+  __m128 acc = _mm_setzero_ps();
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  for(i = 0; i < h; i++)
+    {
+    s1 = (const float*)src_1;
+    s2 = (const float*)src_2;
+
+    for(j = 0; j < w - 3; j += 4)
+      acc = _mm_add_ps(acc, _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(s1 + j),
+                                                  _mm_loadu_ps(s2 + j)),
+                                       abs_mask));
+    for(; j < w; j++)
+      ret += fabs(s1[j] - s2[j]);
+    src_1 += stride_1;
+    src_2 += stride_2;
+    }
+  _mm_storeu_ps(sums, acc);
+  return ret + ((sums[0] + sums[1]) + (sums[2] + sums[3]));
+  }
+
+/* Averaging */
+
+/*
+ *  (a & b) + ((a ^ b) >> 1) is the rounded down average. Clearing the
+ *  lowest bit of each component before shifting keeps the components
+ *  separated.
+ */
+
+#define AVERAGE_RGB(name, LSB_MASK, RESULT_MASK, LOWER, MIDDLE, UPPER) \
+static void name(const uint8_t * src_1, const uint8_t * src_2, \
+                 uint8_t * dst, int num) \
+  { \
+  int i; \
+  __m128i a, b; \
+  const uint16_t * s1 = (const uint16_t*)src_1; \
+  const uint16_t * s2 = (const uint16_t*)src_2; \
+  uint16_t * d = (uint16_t*)dst; \
+  const __m128i lsb_mask = _mm_set1_epi16(LSB_MASK); \
+  const __m128i result_mask = _mm_set1_epi16(RESULT_MASK); \
+  \
+  for(i = 0; i < num - 7; i += 8) \
+    { \
+    a = LOAD(s1 + i); \
+    b = LOAD(s2 + i); \
+    STORE(d + i, \
+          _mm_and_si128(_mm_add_epi16(_mm_and_si128(a, b), \
+                                      _mm_srli_epi16(_mm_and_si128(_mm_xor_si128(a, b), \
+                                                                   lsb_mask), 1)), \
+                        result_mask)); \
+    } \
+  for(; i < num; i++) \
+    { \
+    d[i] = (((s1[i] & LOWER) + (s2[i] & LOWER)) >> 1) & LOWER; \
+    d[i] |= (((s1[i] & MIDDLE) + (s2[i] & MIDDLE)) >> 1) & MIDDLE; \
+    d[i] |= (((s1[i] & UPPER) + (s2[i] & UPPER)) >> 1) & UPPER; \
+    } \
+  }
+
+AVERAGE_RGB(average_rgb15_sse2, 0x7bde, 0x7fff,
+            RGB15_LOWER_MASK, RGB15_MIDDLE_MASK, RGB15_UPPER_MASK)
+AVERAGE_RGB(average_rgb16_sse2, 0xf7de, 0xffff,
+            RGB16_LOWER_MASK, RGB16_MIDDLE_MASK, RGB16_UPPER_MASK)
+
+static void average_8_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                           uint8_t * dst, int num)
+  {
+  int i;
+  for(i = 0; i < num - 15; i += 16)
+    STORE(dst + i, _mm_avg_epu8(LOAD(src_1 + i), LOAD(src_2 + i)));
+  for(; i < num; i++)
+    dst[i] = (src_1[i] + src_2[i] + 1) >> 1;
+  }
+
+static void average_16_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                            uint8_t * dst, int num)
+  {
+  int i;
+  const uint16_t * s1 = (const uint16_t*)src_1;
+  const uint16_t * s2 = (const uint16_t*)src_2;
+  uint16_t * d = (uint16_t*)dst;
+
+  for(i = 0; i < num - 7; i += 8)
+    STORE(d + i, _mm_avg_epu16(LOAD(s1 + i), LOAD(s2 + i)));
+  for(; i < num; i++)
+    d[i] = (s1[i] + s2[i] + 1) >> 1;
+  }
+
+static void average_f_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                           uint8_t * dst, int num)
+  {
+  int i;
+  const float * s1 = (const float*)src_1;
+  const float * s2 = (const float*)src_2;
+  float * d = (float*)dst;
+  const __m128 half = _mm_set1_ps(0.5);
+
+  for(i = 0; i < num - 3; i += 4)
+    _mm_storeu_ps(d + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(s1 + i),
+                                               _mm_loadu_ps(s2 + i)), half));
+  for(; i < num; i++)
+    d[i] = (s1[i] + s2[i]) * 0.5;
+  }
+
+/* Interpolating */
+
+/*
+ *  (a * fac + b * (0x10000 - fac)) >> 16 is calculated as
+ *  b + (((a - b) * fac) >> 16). The high word of the product is
+ *  obtained with a signed multiplication, which sees factors >= 0x8000
+ *  as fac - 0x10000, so a - b is added again for them.
+ */
+
+static inline __m128i interpolate_16_bits(__m128i a, __m128i b,
+                                          __m128i fac, __m128i fac_corr)
+  {
+  __m128i diff = _mm_sub_epi16(a, b);
+  return _mm_add_epi16(_mm_add_epi16(b, _mm_mulhi_epi16(diff, fac)),
+                       _mm_and_si128(diff, fac_corr));
+  }
+
+#define INTERPOLATE_RGB(name, R_SHIFT, G_SHIFT, G_MASK, LOWER, MIDDLE, UPPER) \
+static void name(const uint8_t * src_1, const uint8_t * src_2, \
+                 uint8_t * dst, int num, float fac) \
+  { \
+  int i = 0; \
+  __m128i a, b, fac_v, fac_corr, r, g; \
+  const uint16_t * s1 = (const uint16_t*)src_1; \
+  const uint16_t * s2 = (const uint16_t*)src_2; \
+  uint16_t * d = (uint16_t*)dst; \
+  int fac_i = (int)(fac * 0x10000 + 0.5); \
+  int anti_fac = 0x10000 - fac_i; \
+  \
+  if((fac_i >= 0) && (fac_i <= 0x10000)) \
+    { \
+    fac_v = _mm_set1_epi16(fac_i); \
+    fac_corr = _mm_set1_epi16((fac_i >= 0x8000) ? -1 : 0); \
+    \
+    for(i = 0; i < num - 7; i += 8) \
+      { \
+      a = LOAD(s1 + i); \
+      b = LOAD(s2 + i); \
+      r = interpolate_16_bits(FIELD(a, R_SHIFT, 0x1f), FIELD(b, R_SHIFT, 0x1f), \
+                              fac_v, fac_corr); \
+      g = interpolate_16_bits(FIELD(a, G_SHIFT, G_MASK), FIELD(b, G_SHIFT, G_MASK), \
+                              fac_v, fac_corr); \
+      a = interpolate_16_bits(FIELD(a, 0, 0x1f), FIELD(b, 0, 0x1f), \
+                              fac_v, fac_corr); \
+      STORE(d + i, _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, R_SHIFT), \
+                                             _mm_slli_epi16(g, G_SHIFT)), a)); \
+      } \
+    } \
+  for(; i < num; i++) \
+    { \
+    d[i] = (((s1[i] & LOWER)*fac_i + (s2[i] & LOWER)*anti_fac) >> 16) & LOWER; \
+    d[i] |= (((s1[i] & MIDDLE)*fac_i + (s2[i] & MIDDLE)*anti_fac) >> 16) & MIDDLE; \
+    d[i] |= (((s1[i] & UPPER)*fac_i + (s2[i] & UPPER)*anti_fac) >> 16) & UPPER; \
+    } \
+  }
+
+INTERPOLATE_RGB(interpolate_rgb15_sse2, 10, 5, 0x1f,
+                RGB15_LOWER_MASK, RGB15_MIDDLE_MASK, RGB15_UPPER_MASK)
+INTERPOLATE_RGB(interpolate_rgb16_sse2, 11, 5, 0x3f,
+                RGB16_LOWER_MASK, RGB16_MIDDLE_MASK, RGB16_UPPER_MASK)
+
+static void interpolate_8_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                               uint8_t * dst, int num, float fac)
+  {
+  int i = 0;
+  __m128i a, b, fac_v, fac_corr, lo, hi;
+  const __m128i zero = _mm_setzero_si128();
+  int fac_i = (int)(fac * 0x10000 + 0.5);
+  int anti_fac = 0x10000 - fac_i;
+
+  if((fac_i >= 0) && (fac_i <= 0x10000))
+    {
+    fac_v = _mm_set1_epi16(fac_i);
+    fac_corr = _mm_set1_epi16((fac_i >= 0x8000) ? -1 : 0);
+
+    for(i = 0; i < num - 15; i += 16)
+      {
+      a = LOAD(src_1 + i);
+      b = LOAD(src_2 + i);
+      lo = interpolate_16_bits(_mm_unpacklo_epi8(a, zero),
+                               _mm_unpacklo_epi8(b, zero), fac_v, fac_corr);
+      hi = interpolate_16_bits(_mm_unpackhi_epi8(a, zero),
+                               _mm_unpackhi_epi8(b, zero), fac_v, fac_corr);
+      STORE(dst + i, _mm_packus_epi16(lo, hi));
+      }
+    }
+  for(; i < num; i++)
+    dst[i] = (src_1[i] * fac_i + src_2[i] * anti_fac) >> 16;
+  }
+
+static void interpolate_16_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                                uint8_t * dst, int num, float fac)
+  {
+  int i = 0;
+  __m128i a, b, a_hi, b_hi, fac_v, anti_fac_v, lo, hi;
+  const __m128i offset = _mm_set1_epi32(0x8000);
+  const __m128i sign = _mm_set1_epi16(0x8000);
+  const uint16_t * s1 = (const uint16_t*)src_1;
+  const uint16_t * s2 = (const uint16_t*)src_2;
+  uint16_t * d = (uint16_t*)dst;
+  int fac_i = (int)(fac * 0x8000 + 0.5);
+  int anti_fac = 0x8000 - fac_i;
+
+  if((fac_i >= 0) && (fac_i <= 0x8000))
+    {
+    fac_v = _mm_set1_epi16(fac_i);
+    anti_fac_v = _mm_set1_epi16(anti_fac);
+
+    for(i = 0; i < num - 7; i += 8)
+      {
+      /* Full 32 bit products */
+      a = LOAD(s1 + i);
+      b = LOAD(s2 + i);
+      a_hi = _mm_mulhi_epu16(a, fac_v);
+      b_hi = _mm_mulhi_epu16(b, anti_fac_v);
+      a = _mm_mullo_epi16(a, fac_v);
+      b = _mm_mullo_epi16(b, anti_fac_v);
+
+      lo = _mm_add_epi32(_mm_unpacklo_epi16(a, a_hi), _mm_unpacklo_epi16(b, b_hi));
+      hi = _mm_add_epi32(_mm_unpackhi_epi16(a, a_hi), _mm_unpackhi_epi16(b, b_hi));
+
+      /* Results are 0..0xffff, make them signed for packing */
+      lo = _mm_sub_epi32(_mm_srli_epi32(lo, 15), offset);
+      hi = _mm_sub_epi32(_mm_srli_epi32(hi, 15), offset);
+      STORE(d + i, _mm_xor_si128(_mm_packs_epi32(lo, hi), sign));
+      }
+    }
+  for(; i < num; i++)
+    d[i] = (s1[i] * fac_i + s2[i] * anti_fac) >> 15;
+  }
+
+static void interpolate_f_sse2(const uint8_t * src_1, const uint8_t * src_2,
+                               uint8_t * dst, int num, float fac)
+  {
+  int i;
+  const float * s1 = (const float*)src_1;
+  const float * s2 = (const float*)src_2;
+  float * d = (float*)dst;
+  float anti_fac = 1.0 - fac;
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 anti_fac_v = _mm_set1_ps(anti_fac);
+
+  for(i = 0; i < num - 3; i += 4)
+    _mm_storeu_ps(d + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(s1 + i), fac_v),
+                                    _mm_mul_ps(_mm_loadu_ps(s2 + i), anti_fac_v)));
+  for(; i < num; i++)
+    d[i] = s1[i] * fac + s2[i] * anti_fac;
+  }
+
+/* Endian swapping */
+
+#define SWAP_BYTES(x) _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8))
+
+static void bswap_16_sse2(void * data, int len)
+  {
+  int i;
+  uint16_t * ptr = (uint16_t*)data;
+  __m128i x;
+
+  for(i = 0; i < len - 7; i += 8)
+    {
+    x = LOAD(ptr + i);
+    STORE(ptr + i, SWAP_BYTES(x));
+    }
+  for(; i < len; i++)
+    ptr[i] = bswap_16(ptr[i]);
+  }
+
+static void bswap_32_sse2(void * data, int len)
+  {
+  int i;
+  uint32_t * ptr = (uint32_t*)data;
+  __m128i x;
+
+  for(i = 0; i < len - 3; i += 4)
+    {
+    x = LOAD(ptr + i);
+    x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1);
+    STORE(ptr + i, SWAP_BYTES(x));
+    }
+  for(; i < len; i++)
+    ptr[i] = bswap_32(ptr[i]);
+  }
+
+static void bswap_64_sse2(void * data, int len)
+  {
+  int i;
+  uint64_t * ptr = (uint64_t*)data;
+  __m128i x;
+
+  for(i = 0; i < len - 1; i += 2)
+    {
+    x = LOAD(ptr + i);
+    x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x1b), 0x1b);
+    STORE(ptr + i, SWAP_BYTES(x));
+    }
+  for(; i < len; i++)
+    ptr[i] = bswap_64(ptr[i]);
+  }
+
+/* Add and subtract functions */
+
+/* Unsigned values with offset are converted to signed by flipping
+   the sign bit */
+
+static inline __m128i adds_u8_s(__m128i a, __m128i b)
+  {
+  const __m128i sign = _mm_set1_epi8(0x80);
+  return _mm_xor_si128(_mm_adds_epi8(_mm_xor_si128(a, sign),
+                                     _mm_xor_si128(b, sign)), sign);
+  }
+
+static inline __m128i subs_u8_s(__m128i a, __m128i b)
+  {
+  const __m128i sign = _mm_set1_epi8(0x80);
+  return _mm_xor_si128(_mm_subs_epi8(_mm_xor_si128(a, sign),
+                                     _mm_xor_si128(b, sign)), sign);
+  }
+
+static inline __m128i adds_u16_s(__m128i a, __m128i b)
+  {
+  const __m128i sign = _mm_set1_epi16(0x8000);
+  return _mm_xor_si128(_mm_adds_epi16(_mm_xor_si128(a, sign),
+                                      _mm_xor_si128(b, sign)), sign);
+  }
+
+static inline __m128i subs_u16_s(__m128i a, __m128i b)
+  {
+  const __m128i sign = _mm_set1_epi16(0x8000);
+  return _mm_xor_si128(_mm_subs_epi16(_mm_xor_si128(a, sign),
+                                      _mm_xor_si128(b, sign)), sign);
+  }
+
+/* Signed 32 bit saturation: An overflow happened if the result has
+   a different sign than the first operand and the second operand has
+   the same (add) or a different (sub) sign. */
+
+static inline __m128i saturate_s32(__m128i a, __m128i sum, __m128i overflow)
+  {
+  __m128i max = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7fffffff));
+  overflow = _mm_srai_epi32(overflow, 31);
+  return _mm_or_si128(_mm_and_si128(overflow, max),
+                      _mm_andnot_si128(overflow, sum));
+  }
+
+static inline __m128i adds_s32(__m128i a, __m128i b)
+  {
+  __m128i sum = _mm_add_epi32(a, b);
+  return saturate_s32(a, sum, _mm_andnot_si128(_mm_xor_si128(a, b),
+                                               _mm_xor_si128(a, sum)));
+  }
+
+static inline __m128i subs_s32(__m128i a, __m128i b)
+  {
+  __m128i sum = _mm_sub_epi32(a, b);
+  return saturate_s32(a, sum, _mm_and_si128(_mm_xor_si128(a, b),
+                                            _mm_xor_si128(a, sum)));
+  }
+
+#define ADD(a, b) ((a) + (b))
+#define SUB(a, b) ((a) - (b))
+
+#define INT_FUNC(name, type, vec_op, op, min, max, offset) \
+static void name(const void * _src1, const void * _src2, \
+                 void * _dst, int num) \
+  { \
+  int i; \
+  int64_t tmp; \
+  const type * src1 = _src1; \
+  const type * src2 = _src2; \
+  type * dst = _dst; \
+  \
+  for(i = 0; i < num - (int)(16 / sizeof(type) - 1); i += 16 / sizeof(type)) \
+    STORE(dst + i, vec_op(LOAD(src1 + i), LOAD(src2 + i))); \
+  for(; i < num; i++) \
+    { \
+    tmp = op((int64_t)src1[i] - offset, (int64_t)src2[i] - offset); \
+    dst[i] = CLIP(tmp, min, max) + offset; \
+    } \
+  }
+
+INT_FUNC(add_u8_sse2,    uint8_t,  _mm_adds_epu8,  ADD, 0, 255, 0)
+INT_FUNC(add_s8_sse2,    int8_t,   _mm_adds_epi8,  ADD, -128, 127, 0)
+INT_FUNC(add_u8_s_sse2,  uint8_t,  adds_u8_s,      ADD, -128, 127, 128)
+INT_FUNC(add_u16_sse2,   uint16_t, _mm_adds_epu16, ADD, 0, 65535, 0)
+INT_FUNC(add_s16_sse2,   int16_t,  _mm_adds_epi16, ADD, -32768, 32767, 0)
+INT_FUNC(add_u16_s_sse2, uint16_t, adds_u16_s,     ADD, -32768, 32767, 32768)
+INT_FUNC(add_s32_sse2,   int32_t,  adds_s32,       ADD,
+         -2147483648LL, 2147483647LL, 0)
+
+INT_FUNC(sub_u8_sse2,    uint8_t,  _mm_subs_epu8,  SUB, 0, 255, 0)
+INT_FUNC(sub_s8_sse2,    int8_t,   _mm_subs_epi8,  SUB, -128, 127, 0)
+INT_FUNC(sub_u8_s_sse2,  uint8_t,  subs_u8_s,      SUB, -128, 127, 128)
+INT_FUNC(sub_u16_sse2,   uint16_t, _mm_subs_epu16, SUB, 0, 65535, 0)
+INT_FUNC(sub_s16_sse2,   int16_t,  _mm_subs_epi16, SUB, -32768, 32767, 0)
+INT_FUNC(sub_u16_s_sse2, uint16_t, subs_u16_s,     SUB, -32768, 32767, 32768)
+INT_FUNC(sub_s32_sse2,   int32_t,  subs_s32,       SUB,
+         -2147483648LL, 2147483647LL, 0)
+
+#define FLOAT_FUNC(name, type, n, load, store, vec_op, op) \
+static void name(const void * _src1, const void * _src2, \
+                 void * _dst, int num) \
+  { \
+  int i; \
+  const type * src1 = _src1; \
+  const type * src2 = _src2; \
+  type * dst = _dst; \
+  \
+  for(i = 0; i < num - (n - 1); i += n) \
+    store(dst + i, vec_op(load(src1 + i), load(src2 + i))); \
+  for(; i < num; i++) \
+    dst[i] = op(src1[i], src2[i]); \
+  }
+
+FLOAT_FUNC(add_float_sse2,  float,  4, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, ADD)
+FLOAT_FUNC(add_double_sse2, double, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, ADD)
+FLOAT_FUNC(sub_float_sse2,  float,  4, _mm_loadu_ps, _mm_storeu_ps, _mm_sub_ps, SUB)
+FLOAT_FUNC(sub_double_sse2, double, 2, _mm_loadu_pd, _mm_storeu_pd, _mm_sub_pd, SUB)
+
+/* Shifting */
+
+static void shift_up_copy_16_sse2(void * _dst, const void * _src, int num, int bits)
+  {
+  int i;
+  const uint16_t * src = _src;
+  uint16_t * dst = _dst;
+  const __m128i count = _mm_cvtsi32_si128(bits);
+
+  for(i = 0; i < num - 7; i += 8)
+    STORE(dst + i, _mm_sll_epi16(LOAD(src + i), count));
+  for(; i < num; i++)
+    dst[i] = src[i] << bits;
+  }
+
+static void shift_down_copy_16_sse2(void * _dst, const void * _src, int num, int bits)
+  {
+  int i;
+  const uint16_t * src = _src;
+  uint16_t * dst = _dst;
+  const __m128i count = _mm_cvtsi32_si128(bits);
+
+  for(i = 0; i < num - 7; i += 8)
+    STORE(dst + i, _mm_srl_epi16(LOAD(src + i), count));
+  for(; i < num; i++)
+    dst[i] = src[i] >> bits;
+  }
+
+static void shift_up_16_sse2(void * ptr, int num, int bits)
+  {
+  shift_up_copy_16_sse2(ptr, ptr, num, bits);
+  }
+
+static void shift_down_16_sse2(void * ptr, int num, int bits)
+  {
+  shift_down_copy_16_sse2(ptr, ptr, num, bits);
+  }
+
+/* Shuffling: Without pshufb, each destination component is shifted
+   to its place */
+
+static int check_indices(const int * indices)
+  {
+  int i;
+  for(i = 0; i < 4; i++)
+    {
+    if((indices[i] < 0) || (indices[i] > 3))
+      return 0;
+    }
+  return 1;
+  }
+
+static void shuffle_8_4_sse2(void * dst1, const void * src1, int num, int * indices)
+  {
+  int i = 0, j;
+  const uint8_t * src = src1;
+  uint8_t * dst = dst1;
+  __m128i x, y, src_shift[4], dst_shift[4];
+  const __m128i mask = _mm_set1_epi32(0xff);
+
+  if(check_indices(indices))
+    {
+    for(j = 0; j < 4; j++)
+      {
+      src_shift[j] = _mm_cvtsi32_si128(8 * indices[j]);
+      dst_shift[j] = _mm_cvtsi32_si128(8 * j);
+      }
+    for(i = 0; i < num - 3; i += 4)
+      {
+      x = LOAD(src + 4 * i);
+      y = _mm_and_si128(_mm_srl_epi32(x, src_shift[0]), mask);
+      for(j = 1; j < 4; j++)
+        y = _mm_or_si128(y, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(x, src_shift[j]),
+                                                        mask), dst_shift[j]));
+      STORE(dst + 4 * i, y);
+      }
+    }
+  for(; i < num; i++)
+    {
+    dst[4*i]   = src[4*i + indices[0]];
+    dst[4*i+1] = src[4*i + indices[1]];
+    dst[4*i+2] = src[4*i + indices[2]];
+    dst[4*i+3] = src[4*i + indices[3]];
+    }
+  }
+
+static void shuffle_16_4_sse2(void * dst1, const void * src1, int num, int * indices)
+  {
+  int i = 0, j;
+  const uint16_t * src = src1;
+  uint16_t * dst = dst1;
+  __m128i x, y, src_shift[4], dst_shift[4];
+  const __m128i mask = _mm_set_epi32(0, 0xffff, 0, 0xffff);
+
+  if(check_indices(indices))
+    {
+    for(j = 0; j < 4; j++)
+      {
+      src_shift[j] = _mm_cvtsi32_si128(16 * indices[j]);
+      dst_shift[j] = _mm_cvtsi32_si128(16 * j);
+      }
+    for(i = 0; i < num - 1; i += 2)
+      {
+      x = LOAD(src + 4 * i);
+      y = _mm_and_si128(_mm_srl_epi64(x, src_shift[0]), mask);
+      for(j = 1; j < 4; j++)
+        y = _mm_or_si128(y, _mm_sll_epi64(_mm_and_si128(_mm_srl_epi64(x, src_shift[j]),
+                                                        mask), dst_shift[j]));
+      STORE(dst + 4 * i, y);
+      }
+    }
+  for(; i < num; i++)
+    {
+    dst[4*i]   = src[4*i + indices[0]];
+    dst[4*i+1] = src[4*i + indices[1]];
+    dst[4*i+2] = src[4*i + indices[2]];
+    dst[4*i+3] = src[4*i + indices[3]];
+    }
+  }
+
+void gavl_dsp_init_sse2(gavl_dsp_funcs_t * funcs,
+                        int quality)
+  {
+  funcs->sad_rgb15 = sad_rgb15_sse2;
+  funcs->sad_rgb16 = sad_rgb16_sse2;
+  funcs->sad_8     = sad_8_sse2;
+  funcs->sad_16    = sad_16_sse2;
+  if(quality < 3)
+    funcs->sad_f   = sad_f_sse2;
+
+  funcs->average_rgb15 = average_rgb15_sse2;
+  funcs->average_rgb16 = average_rgb16_sse2;
+  funcs->average_8     = average_8_sse2;
+  funcs->average_16    = average_16_sse2;
+  funcs->average_f     = average_f_sse2;
+
+  funcs->interpolate_rgb15 = interpolate_rgb15_sse2;
+  funcs->interpolate_rgb16 = interpolate_rgb16_sse2;
+  funcs->interpolate_8     = interpolate_8_sse2;
+  funcs->interpolate_16    = interpolate_16_sse2;
+  funcs->interpolate_f     = interpolate_f_sse2;
+
+  funcs->bswap_16          = bswap_16_sse2;
+  funcs->bswap_32          = bswap_32_sse2;
+  funcs->bswap_64          = bswap_64_sse2;
+
+  funcs->add_u8            = add_u8_sse2;
+  funcs->add_s8            = add_s8_sse2;
+  funcs->add_u8_s          = add_u8_s_sse2;
+  funcs->add_u16           = add_u16_sse2;
+  funcs->add_s16           = add_s16_sse2;
+  funcs->add_u16_s         = add_u16_s_sse2;
+  funcs->add_s32           = add_s32_sse2;
+  funcs->add_float         = add_float_sse2;
+  funcs->add_double        = add_double_sse2;
+
+  funcs->sub_u8            = sub_u8_sse2;
+  funcs->sub_s8            = sub_s8_sse2;
+  funcs->sub_u8_s          = sub_u8_s_sse2;
+  funcs->sub_u16           = sub_u16_sse2;
+  funcs->sub_s16           = sub_s16_sse2;
+  funcs->sub_u16_s         = sub_u16_s_sse2;
+  funcs->sub_s32           = sub_s32_sse2;
+  funcs->sub_float         = sub_float_sse2;
+  funcs->sub_double        = sub_double_sse2;
+
+  funcs->shift_up_16       = shift_up_16_sse2;
+  funcs->shift_down_16     = shift_down_16_sse2;
+
+  funcs->shift_up_copy_16   = shift_up_copy_16_sse2;
+  funcs->shift_down_copy_16 = shift_down_copy_16_sse2;
+
+  funcs->shuffle_8_4        = shuffle_8_4_sse2;
+  funcs->shuffle_16_4       = shuffle_16_4_sse2;
+  }
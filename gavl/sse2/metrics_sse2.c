@@ -0,0 +1,114 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <metrics.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 sums of squared differences. The absolute differences are
+ *  squared and summed up in 64 bit integers, so the results are exact.
+ */
+
+static uint64_t sse_8_sse2(const uint8_t * src1, const uint8_t * src2, int num)
+  {
+  int i, diff;
+  uint64_t sums[2];
+  uint64_t ret;
+  __m128i a, b, d, lo, hi;
+  __m128i acc = _mm_setzero_si128();
+  const __m128i zero = _mm_setzero_si128();
+  int num16 = num & ~15;
+
+  for(i = 0; i < num16; i += 16)
+    {
+    a = _mm_loadu_si128((const __m128i*)(src1 + i));
+    b = _mm_loadu_si128((const __m128i*)(src2 + i));
+    d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+
+    lo = _mm_unpacklo_epi8(d, zero);
+    hi = _mm_unpackhi_epi8(d, zero);
+
+    /* 4 sums of 4 squares, each < 2^18 */
+    d = _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi));
+
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(d, zero));
+    acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(d, zero));
+    }
+
+  _mm_storeu_si128((__m128i*)sums, acc);
+  ret = sums[0] + sums[1];
+  
+  for(i = num16; i < num; i++)
+    {
+    diff = (int)src1[i] - (int)src2[i];
+    ret += diff * diff;
+    }
+  return ret;
+  }
+
+static uint64_t sse_16_sse2(const uint16_t * src1, const uint16_t * src2, int num)
+  {
+  int i;
+  int64_t diff;
+  uint64_t sums[2];
+  uint64_t ret;
+  __m128i a, b, d, lo, hi;
+  __m128i acc = _mm_setzero_si128();
+  const __m128i zero = _mm_setzero_si128();
+  int num8 = num & ~7;
+
+  for(i = 0; i < num8; i += 8)
+    {
+    a = _mm_loadu_si128((const __m128i*)(src1 + i));
+    b = _mm_loadu_si128((const __m128i*)(src2 + i));
+    d = _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+
+    lo = _mm_unpacklo_epi16(d, zero);
+    hi = _mm_unpackhi_epi16(d, zero);
+
+    /* Squares of the even and odd 32 bit values as 64 bit */
+    acc = _mm_add_epi64(acc, _mm_mul_epu32(lo, lo));
+    acc = _mm_add_epi64(acc, _mm_mul_epu32(hi, hi));
+    lo = _mm_srli_epi64(lo, 32);
+    hi = _mm_srli_epi64(hi, 32);
+    acc = _mm_add_epi64(acc, _mm_mul_epu32(lo, lo));
+    acc = _mm_add_epi64(acc, _mm_mul_epu32(hi, hi));
+    }
+
+  _mm_storeu_si128((__m128i*)sums, acc);
+  ret = sums[0] + sums[1];
+  
+  for(i = num8; i < num; i++)
+    {
+    diff = (int64_t)src1[i] - (int64_t)src2[i];
+    ret += diff * diff;
+    }
+  return ret;
+  }
+
+void gavl_init_metrics_funcs_sse2(gavl_metrics_funcs_t * funcs)
+  {
+  funcs->sse_8  = sse_8_sse2;
+  funcs->sse_16 = sse_16_sse2;
+  }
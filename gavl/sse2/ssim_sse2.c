@@ -0,0 +1,172 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <ssim.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 versions of the SSIM filters. 4 pixels are processed at once,
+ *  the sums are built in the same order as in C, so the results are
+ *  identical to the C version.
+ */
+
+static void filter_h_sse2(const float * src, float * dst,
+                          const float * coeffs, int taps, int num)
+  {
+  int i, t;
+  float sum;
+  __m128 acc;
+  int num4 = num & ~3;
+  
+  for(i = 0; i < num4; i += 4)
+    {
+    acc = _mm_setzero_ps();
+    for(t = 0; t < taps; t++)
+      acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(coeffs[t]),
+                                       _mm_loadu_ps(src + i + t)));
+    _mm_storeu_ps(dst + i, acc);
+    }
+  
+  for(i = num4; i < num; i++)
+    {
+    sum = 0.0f;
+    for(t = 0; t < taps; t++)
+      sum += coeffs[t] * src[i + t];
+    dst[i] = sum;
+    }
+  }
+
+static void filter_v_sse2(const float * const * src, float * dst,
+                          const float * coeffs, int taps, int num)
+  {
+  int i, t;
+  float sum;
+  __m128 acc;
+  int num4 = num & ~3;
+  
+  for(i = 0; i < num4; i += 4)
+    {
+    acc = _mm_setzero_ps();
+    for(t = 0; t < taps; t++)
+      acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(coeffs[t]),
+                                       _mm_loadu_ps(src[t] + i)));
+    _mm_storeu_ps(dst + i, acc);
+    }
+  
+  for(i = num4; i < num; i++)
+    {
+    sum = 0.0f;
+    for(t = 0; t < taps; t++)
+      sum += coeffs[t] * src[t][i];
+    dst[i] = sum;
+    }
+  }
+
+static double ssim_sse2(const float * const * mom, float * map, int num,
+                        float c1, float c2, double * cs)
+  {
+  int i;
+  float mu_x, mu_y, sigma_xy, sigma_xx, sigma_yy, s;
+  double sums[2];
+  double ret, cs_sum;
+  __m128 mx, my, sxy, sxx, syy, ssim, cs_num, cs_den;
+  __m128d acc = _mm_setzero_pd();
+  __m128d cs_acc = _mm_setzero_pd();
+  const __m128 c1_v = _mm_set1_ps(c1);
+  const __m128 c2_v = _mm_set1_ps(c2);
+  const __m128 two  = _mm_set1_ps(2.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  int num4 = num & ~3;
+  
+  for(i = 0; i < num4; i += 4)
+    {
+    mx = _mm_loadu_ps(mom[0] + i);
+    my = _mm_loadu_ps(mom[1] + i);
+    
+    sxy = _mm_sub_ps(_mm_loadu_ps(mom[4] + i), _mm_mul_ps(mx, my));
+    sxx = _mm_sub_ps(_mm_loadu_ps(mom[2] + i), _mm_mul_ps(mx, mx));
+    syy = _mm_sub_ps(_mm_loadu_ps(mom[3] + i), _mm_mul_ps(my, my));
+
+    mx = _mm_add_ps(mx, half);
+    my = _mm_add_ps(my, half);
+
+    cs_num = _mm_add_ps(_mm_mul_ps(two, sxy), c2_v);
+    cs_den = _mm_add_ps(_mm_add_ps(sxx, syy), c2_v);
+    
+    ssim =
+      _mm_div_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(two, mx), my), c1_v),
+                            cs_num),
+                 _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, mx),
+                                                  _mm_mul_ps(my, my)), c1_v),
+                            cs_den));
+    if(map)
+      _mm_storeu_ps(map + i, ssim);
+
+    acc = _mm_add_pd(acc, _mm_cvtps_pd(ssim));
+    acc = _mm_add_pd(acc, _mm_cvtps_pd(_mm_movehl_ps(ssim, ssim)));
+
+    if(cs)
+      {
+      cs_num = _mm_div_ps(cs_num, cs_den);
+      cs_acc = _mm_add_pd(cs_acc, _mm_cvtps_pd(cs_num));
+      cs_acc = _mm_add_pd(cs_acc, _mm_cvtps_pd(_mm_movehl_ps(cs_num, cs_num)));
+      }
+    }
+
+  _mm_storeu_pd(sums, acc);
+  ret = sums[0] + sums[1];
+  _mm_storeu_pd(sums, cs_acc);
+  cs_sum = sums[0] + sums[1];
+  
+  for(i = num4; i < num; i++)
+    {
+    sigma_xy = mom[4][i] - mom[0][i] * mom[1][i];
+    sigma_xx = mom[2][i] - mom[0][i] * mom[0][i];
+    sigma_yy = mom[3][i] - mom[1][i] * mom[1][i];
+
+    mu_x = mom[0][i] + 0.5f;
+    mu_y = mom[1][i] + 0.5f;
+    
+    s = ((2.0f * mu_x * mu_y + c1) * (2.0f * sigma_xy + c2)) /
+      ((mu_x * mu_x + mu_y * mu_y + c1) * (sigma_xx + sigma_yy + c2));
+    
+    if(map)
+      map[i] = s;
+    ret += s;
+
+    if(cs)
+      cs_sum += (2.0f * sigma_xy + c2) / (sigma_xx + sigma_yy + c2);
+    }
+  if(cs)
+    *cs = cs_sum;
+  return ret;
+  }
+
+void gavl_init_ssim_funcs_sse2(gavl_ssim_funcs_t * funcs)
+  {
+  funcs->filter_h = filter_h_sse2;
+  funcs->filter_v = filter_v_sse2;
+  funcs->ssim     = ssim_sse2;
+  }
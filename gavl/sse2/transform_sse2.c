@@ -0,0 +1,294 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <transform.h>
+
+#include <emmintrin.h>
+
+/*
+ *  Affine bilinear transform. The source positions of 4 pixels are
+ *  stepped in parallel. SSE2 has no 64 bit compares, so the fixed point
+ *  positions are split into the position on the phase grid and the
+ *  TRANSFORM_FIXED_BITS fractional bits, which are stepped with an explicit
+ *  carry. This gives exactly the positions of the generic path.
+ *
+ *  Pixels, whose taps are not all inside the source image, are done by the
+ *  generic scanline function.
+ */
+
+#define FRAC_MASK ((1 << TRANSFORM_FIXED_BITS) - 1)
+
+typedef struct
+  {
+  __m128i hi_x, lo_x;
+  __m128i hi_y, lo_y;
+  __m128i step_hi_x, step_lo_x;
+  __m128i step_hi_y, step_lo_y;
+  } pos_sse2_t;
+
+static void pos_init(pos_sse2_t * p, const gavl_transform_affine_t * pos)
+  {
+  int i;
+  int64_t x, y;
+  int32_t hi_x[4], lo_x[4], hi_y[4], lo_y[4];
+
+  for(i = 0; i < 4; i++)
+    {
+    x = pos->x + i * pos->step_x;
+    y = pos->y + i * pos->step_y;
+    hi_x[i] = x >> TRANSFORM_FIXED_BITS;
+    lo_x[i] = x & FRAC_MASK;
+    hi_y[i] = y >> TRANSFORM_FIXED_BITS;
+    lo_y[i] = y & FRAC_MASK;
+    }
+  p->hi_x = _mm_loadu_si128((const __m128i*)hi_x);
+  p->lo_x = _mm_loadu_si128((const __m128i*)lo_x);
+  p->hi_y = _mm_loadu_si128((const __m128i*)hi_y);
+  p->lo_y = _mm_loadu_si128((const __m128i*)lo_y);
+
+  x = 4 * pos->step_x;
+  y = 4 * pos->step_y;
+  p->step_hi_x = _mm_set1_epi32(x >> TRANSFORM_FIXED_BITS);
+  p->step_lo_x = _mm_set1_epi32(x & FRAC_MASK);
+  p->step_hi_y = _mm_set1_epi32(y >> TRANSFORM_FIXED_BITS);
+  p->step_lo_y = _mm_set1_epi32(y & FRAC_MASK);
+  }
+
+static inline void pos_step(pos_sse2_t * p)
+  {
+  const __m128i mask = _mm_set1_epi32(FRAC_MASK);
+
+  p->lo_x = _mm_add_epi32(p->lo_x, p->step_lo_x);
+  p->hi_x = _mm_add_epi32(p->hi_x, p->step_hi_x);
+  p->hi_x = _mm_add_epi32(p->hi_x,
+                          _mm_srli_epi32(p->lo_x, TRANSFORM_FIXED_BITS));
+  p->lo_x = _mm_and_si128(p->lo_x, mask);
+
+  p->lo_y = _mm_add_epi32(p->lo_y, p->step_lo_y);
+  p->hi_y = _mm_add_epi32(p->hi_y, p->step_hi_y);
+  p->hi_y = _mm_add_epi32(p->hi_y,
+                          _mm_srli_epi32(p->lo_y, TRANSFORM_FIXED_BITS));
+  p->lo_y = _mm_and_si128(p->lo_y, mask);
+  }
+
+/* Rounded position on the phase grid, shifted by half a pixel */
+
+static inline __m128i pos_get(__m128i hi, __m128i lo)
+  {
+  lo = _mm_add_epi32(lo, _mm_set1_epi32(1 << (TRANSFORM_FIXED_BITS - 1)));
+  hi = _mm_add_epi32(hi, _mm_set1_epi32(TRANSFORM_PHASES / 2));
+  return _mm_add_epi32(hi, _mm_srli_epi32(lo, TRANSFORM_FIXED_BITS));
+  }
+
+/* Pairs of 16 bit weights (1 - frac, frac) in 1/TRANSFORM_PHASES */
+
+static inline __m128i get_weights(__m128i pos)
+  {
+  __m128i frac = _mm_and_si128(pos, _mm_set1_epi32(TRANSFORM_PHASES - 1));
+  return _mm_or_si128(_mm_sub_epi32(_mm_set1_epi32(TRANSFORM_PHASES), frac),
+                      _mm_slli_epi32(frac, 16));
+  }
+
+/* Check if the first taps of 4 pixels are in [1 .. max - 1] */
+
+static inline int is_inside(__m128i idx_x, __m128i idx_y,
+                            __m128i max_x, __m128i max_y)
+  {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i m;
+
+  m = _mm_and_si128(_mm_cmpgt_epi32(idx_x, zero),
+                    _mm_cmplt_epi32(idx_x, max_x));
+  m = _mm_and_si128(m, _mm_cmpgt_epi32(idx_y, zero));
+  m = _mm_and_si128(m, _mm_cmplt_epi32(idx_y, max_y));
+  return _mm_movemask_epi8(m) == 0xffff;
+  }
+
+/*
+ *  Interpolate 2 rows with 10 bit weights, the result is
+ *  scaled down to 15 bits for the vertical pass
+ */
+
+static inline __m128i interpolate_x(__m128i src, __m128i w)
+  {
+  src = _mm_madd_epi16(src, w);
+  return _mm_srai_epi32(_mm_add_epi32(src, _mm_set1_epi32(4)), 3);
+  }
+
+static inline __m128i interpolate_y(__m128i src, __m128i w)
+  {
+  src = _mm_madd_epi16(src, w);
+  return _mm_srai_epi32(_mm_add_epi32(src, _mm_set1_epi32(1 << 16)), 17);
+  }
+
+static void affine_uint8_x_1_sse2(gavl_transform_context_t * ctx,
+                                  const gavl_transform_affine_t * pos,
+                                  int y, uint8_t * dest_start)
+  {
+  int i, j, start = 0;
+  pos_sse2_t p;
+  const uint8_t * src;
+  int32_t idx_x[4], idx_y[4];
+  uint32_t pix[4];
+  __m128i px, py, ix, iy, wx, wy, s, h_lo, h_hi;
+  
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i max_x = _mm_set1_epi32(ctx->tab.width);
+  const __m128i max_y = _mm_set1_epi32(ctx->tab.height);
+  
+  pos_init(&p, pos);
+
+  for(i = 0; i <= ctx->dst_width - 4; i += 4)
+    {
+    px = pos_get(p.hi_x, p.lo_x);
+    py = pos_get(p.hi_y, p.lo_y);
+    pos_step(&p);
+    
+    ix = _mm_srai_epi32(px, TRANSFORM_PHASE_BITS);
+    iy = _mm_srai_epi32(py, TRANSFORM_PHASE_BITS);
+
+    if(!is_inside(ix, iy, max_x, max_y))
+      continue;
+
+    if(start < i)
+      gavl_transform_context_scanline(ctx, y, start, i - start,
+                                      dest_start + start);
+    start = i + 4;
+    
+    _mm_storeu_si128((__m128i*)idx_x, ix);
+    _mm_storeu_si128((__m128i*)idx_y, iy);
+
+    /* 2x2 source pixels per destination pixel */
+    for(j = 0; j < 4; j++)
+      {
+      src = ctx->src + (idx_y[j] - 1) * ctx->src_stride + idx_x[j] - 1;
+      pix[j] = *((const uint16_t*)src) |
+        ((uint32_t)*((const uint16_t*)(src + ctx->src_stride)) << 16);
+      }
+    s = _mm_loadu_si128((const __m128i*)pix);
+
+    wx = get_weights(px);
+    wy = get_weights(py);
+    
+    h_lo = interpolate_x(_mm_unpacklo_epi8(s, zero),
+                         _mm_unpacklo_epi32(wx, wx));
+    h_hi = interpolate_x(_mm_unpackhi_epi8(s, zero),
+                         _mm_unpackhi_epi32(wx, wx));
+    
+    s = interpolate_y(_mm_packs_epi32(h_lo, h_hi), wy);
+    s = _mm_packs_epi32(s, s);
+    s = _mm_packus_epi16(s, s);
+    *((uint32_t*)(dest_start + i)) = _mm_cvtsi128_si32(s);
+    }
+  
+  if(start < ctx->dst_width)
+    gavl_transform_context_scanline(ctx, y, start, ctx->dst_width - start,
+                                    dest_start + start);
+  }
+
+/* Interpolate one pixel with 4 channels */
+
+static inline __m128i interpolate_x_4(const uint8_t * src, int stride,
+                                      int32_t wx, int32_t wy)
+  {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i a, b, w = _mm_set1_epi32(wx);
+  
+  a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src), zero);
+  b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + stride)),
+                        zero);
+
+  /* Interleave the channels of the left and right pixel */
+  a = interpolate_x(_mm_unpacklo_epi16(a, _mm_srli_si128(a, 8)), w);
+  b = interpolate_x(_mm_unpacklo_epi16(b, _mm_srli_si128(b, 8)), w);
+
+  a = _mm_packs_epi32(a, b);
+  a = _mm_unpacklo_epi16(a, _mm_srli_si128(a, 8));
+  return interpolate_y(a, _mm_set1_epi32(wy));
+  }
+
+static void affine_uint8_x_4_sse2(gavl_transform_context_t * ctx,
+                                  const gavl_transform_affine_t * pos,
+                                  int y, uint8_t * dest_start)
+  {
+  int i, j, start = 0;
+  pos_sse2_t p;
+  const uint8_t * src[4];
+  int32_t idx_x[4], idx_y[4], w_x[4], w_y[4];
+  __m128i px, py, ix, iy, r0, r1, r2, r3;
+  
+  const __m128i max_x = _mm_set1_epi32(ctx->tab.width);
+  const __m128i max_y = _mm_set1_epi32(ctx->tab.height);
+  
+  pos_init(&p, pos);
+
+  for(i = 0; i <= ctx->dst_width - 4; i += 4)
+    {
+    px = pos_get(p.hi_x, p.lo_x);
+    py = pos_get(p.hi_y, p.lo_y);
+    pos_step(&p);
+    
+    ix = _mm_srai_epi32(px, TRANSFORM_PHASE_BITS);
+    iy = _mm_srai_epi32(py, TRANSFORM_PHASE_BITS);
+
+    if(!is_inside(ix, iy, max_x, max_y))
+      continue;
+
+    if(start < i)
+      gavl_transform_context_scanline(ctx, y, start, i - start,
+                                      dest_start + start * 4);
+    start = i + 4;
+    
+    _mm_storeu_si128((__m128i*)idx_x, ix);
+    _mm_storeu_si128((__m128i*)idx_y, iy);
+    _mm_storeu_si128((__m128i*)w_x, get_weights(px));
+    _mm_storeu_si128((__m128i*)w_y, get_weights(py));
+
+    for(j = 0; j < 4; j++)
+      src[j] = ctx->src + (idx_y[j] - 1) * ctx->src_stride +
+        (idx_x[j] - 1) * 4;
+    
+    r0 = interpolate_x_4(src[0], ctx->src_stride, w_x[0], w_y[0]);
+    r1 = interpolate_x_4(src[1], ctx->src_stride, w_x[1], w_y[1]);
+    r2 = interpolate_x_4(src[2], ctx->src_stride, w_x[2], w_y[2]);
+    r3 = interpolate_x_4(src[3], ctx->src_stride, w_x[3], w_y[3]);
+
+    r0 = _mm_packus_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
+    _mm_storeu_si128((__m128i*)(dest_start + i * 4), r0);
+    }
+  
+  if(start < ctx->dst_width)
+    gavl_transform_context_scanline(ctx, y, start, ctx->dst_width - start,
+                                    dest_start + start * 4);
+  }
+
+void gavl_init_transform_funcs_bilinear_sse2(gavl_transform_funcs_t * tab,
+                                             int advance)
+  {
+  if(advance == 1)
+    tab->affine_uint8_x_1 = affine_uint8_x_1_sse2;
+  else if(advance == 4)
+    tab->affine_uint8_x_4 = affine_uint8_x_4_sse2;
+  }
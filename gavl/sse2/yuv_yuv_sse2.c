@@ -0,0 +1,412 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+#include <accel.h>
+
+#include <attributes.h>
+
+#include <emmintrin.h>
+
+/*
+ *  SSE2 YUV <-> YUV conversions, which only reorder the samples.
+ *  Packed formats are done 16 pixels at once, semiplanar chroma lines
+ *  16 pairs at once with the remaining pairs done in C.
+ */
+
+/* Packed -> Planar */
+
+#define INIT_PACKED_PLANAR \
+  __m128i p0, p1, y, uv; \
+  const __m128i mask_00ff = _mm_set1_epi16(0x00ff);
+
+/* Split 16 pixels into 16 luma bytes and 8 chroma pairs */
+
+#define SPLIT_YUY2 \
+  p0 = _mm_loadu_si128((const __m128i*)src); \
+  p1 = _mm_loadu_si128((const __m128i*)(src+16)); \
+  y  = _mm_packus_epi16(_mm_and_si128(p0, mask_00ff), _mm_and_si128(p1, mask_00ff)); \
+  uv = _mm_packus_epi16(_mm_srli_epi16(p0, 8), _mm_srli_epi16(p1, 8));
+
+#define SPLIT_UYVY \
+  p0 = _mm_loadu_si128((const __m128i*)src); \
+  p1 = _mm_loadu_si128((const __m128i*)(src+16)); \
+  y  = _mm_packus_epi16(_mm_srli_epi16(p0, 8), _mm_srli_epi16(p1, 8)); \
+  uv = _mm_packus_epi16(_mm_and_si128(p0, mask_00ff), _mm_and_si128(p1, mask_00ff));
+
+#define STORE_Y \
+  _mm_storeu_si128((__m128i*)dst_y, y);
+
+#define STORE_UV \
+  _mm_storel_epi64((__m128i*)dst_u, \
+                   _mm_packus_epi16(_mm_and_si128(uv, mask_00ff), uv)); \
+  _mm_storel_epi64((__m128i*)dst_v, \
+                   _mm_packus_epi16(_mm_srli_epi16(uv, 8), uv));
+
+/* Planar -> Packed */
+
+#define INIT_PLANAR_PACKED \
+  __m128i y, uv;
+
+#define LOAD_PLANAR \
+  y  = _mm_loadu_si128((const __m128i*)src_y); \
+  uv = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src_u), \
+                         _mm_loadl_epi64((const __m128i*)src_v));
+
+#define STORE_YUY2 \
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(y, uv)); \
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(y, uv));
+
+#define STORE_UYVY \
+  _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(uv, y)); \
+  _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(uv, y));
+
+/* yuy2_to_yuv_420_p_sse2 */
+
+#define FUNC_NAME      yuy2_to_yuv_420_p_sse2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_PACKED_PLANAR
+#define CONVERT_YUV    SPLIT_YUY2 STORE_Y STORE_UV
+#define CONVERT_Y      SPLIT_YUY2 STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* yuy2_to_yuv_422_p_sse2 */
+
+#define FUNC_NAME      yuy2_to_yuv_422_p_sse2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_PACKED_PLANAR
+#define CONVERT_YUV    SPLIT_YUY2 STORE_Y STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* uyvy_to_yuv_420_p_sse2 */
+
+#define FUNC_NAME      uyvy_to_yuv_420_p_sse2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     2
+#define INIT           INIT_PACKED_PLANAR
+#define CONVERT_YUV    SPLIT_UYVY STORE_Y STORE_UV
+#define CONVERT_Y      SPLIT_UYVY STORE_Y
+
+#include "../csp_packed_planar.h"
+
+/* uyvy_to_yuv_422_p_sse2 */
+
+#define FUNC_NAME      uyvy_to_yuv_422_p_sse2
+#define IN_TYPE        uint8_t
+#define OUT_TYPE       uint8_t
+#define IN_ADVANCE     32
+#define OUT_ADVANCE_Y  16
+#define OUT_ADVANCE_UV 8
+#define NUM_PIXELS     16
+#define CHROMA_SUB     1
+#define INIT           INIT_PACKED_PLANAR
+#define CONVERT_YUV    SPLIT_UYVY STORE_Y STORE_UV
+
+#include "../csp_packed_planar.h"
+
+/* yuv_420_p_to_yuy2_sse2 */
+
+#define FUNC_NAME     yuv_420_p_to_yuy2_sse2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_PLANAR_PACKED
+#define CONVERT       LOAD_PLANAR STORE_YUY2
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_uyvy_sse2 */
+
+#define FUNC_NAME     yuv_420_p_to_uyvy_sse2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    2
+#define INIT          INIT_PLANAR_PACKED
+#define CONVERT       LOAD_PLANAR STORE_UYVY
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_yuy2_sse2 */
+
+#define FUNC_NAME     yuv_422_p_to_yuy2_sse2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_PLANAR_PACKED
+#define CONVERT       LOAD_PLANAR STORE_YUY2
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_uyvy_sse2 */
+
+#define FUNC_NAME     yuv_422_p_to_uyvy_sse2
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  16
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    16
+#define CHROMA_SUB    1
+#define INIT          INIT_PLANAR_PACKED
+#define CONVERT       LOAD_PLANAR STORE_UYVY
+
+#include "../csp_planar_packed.h"
+
+/* uyvy_to_yuy2_sse2 (works in both directions) */
+
+#define FUNC_NAME   uyvy_to_yuy2_sse2
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  16
+#define INIT        __m128i p0, p1;
+#define CONVERT \
+  p0 = _mm_loadu_si128((const __m128i*)src); \
+  p1 = _mm_loadu_si128((const __m128i*)(src+16)); \
+  p0 = _mm_or_si128(_mm_slli_epi16(p0, 8), _mm_srli_epi16(p0, 8)); \
+  p1 = _mm_or_si128(_mm_slli_epi16(p1, 8), _mm_srli_epi16(p1, 8)); \
+  _mm_storeu_si128((__m128i*)dst,      p0); \
+  _mm_storeu_si128((__m128i*)(dst+16), p1);
+
+#include "../csp_packed_packed.h"
+
+/* Semiplanar <-> Planar */
+
+static inline void deinterleave_line(const uint8_t * src,
+                                     uint8_t * dst_1, uint8_t * dst_2,
+                                     int num)
+  {
+  int i;
+  __m128i p0, p1;
+  const __m128i mask_00ff = _mm_set1_epi16(0x00ff);
+  
+  for(i = 0; i < num / 16; i++)
+    {
+    p0 = _mm_loadu_si128((const __m128i*)src);
+    p1 = _mm_loadu_si128((const __m128i*)(src+16));
+    _mm_storeu_si128((__m128i*)dst_1,
+                     _mm_packus_epi16(_mm_and_si128(p0, mask_00ff),
+                                      _mm_and_si128(p1, mask_00ff)));
+    _mm_storeu_si128((__m128i*)dst_2,
+                     _mm_packus_epi16(_mm_srli_epi16(p0, 8),
+                                      _mm_srli_epi16(p1, 8)));
+    src += 32;
+    dst_1 += 16;
+    dst_2 += 16;
+    }
+  
+  for(i = 0; i < num % 16; i++)
+    {
+    *(dst_1++) = src[0];
+    *(dst_2++) = src[1];
+    src += 2;
+    }
+  }
+
+static inline void interleave_line(const uint8_t * src_1, const uint8_t * src_2,
+                                   uint8_t * dst, int num)
+  {
+  int i;
+  __m128i c1, c2;
+  
+  for(i = 0; i < num / 16; i++)
+    {
+    c1 = _mm_loadu_si128((const __m128i*)src_1);
+    c2 = _mm_loadu_si128((const __m128i*)src_2);
+    _mm_storeu_si128((__m128i*)dst,      _mm_unpacklo_epi8(c1, c2));
+    _mm_storeu_si128((__m128i*)(dst+16), _mm_unpackhi_epi8(c1, c2));
+    src_1 += 16;
+    src_2 += 16;
+    dst += 32;
+    }
+
+  for(i = 0; i < num % 16; i++)
+    {
+    dst[0] = *(src_1++);
+    dst[1] = *(src_2++);
+    dst += 2;
+    }
+  }
+
+static void copy_luma(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int y_size =
+    ctx->input_frame->strides[0] < ctx->output_frame->strides[0] ?
+    ctx->input_frame->strides[0] : ctx->output_frame->strides[0];
+  uint8_t * src_y = ctx->input_frame->planes[0];
+  uint8_t * dst_y = ctx->output_frame->planes[0];
+  
+  for(i = 0; i < ctx->input_format.image_height; i++)
+    {
+    gavl_memcpy(dst_y, src_y, y_size);
+    dst_y += ctx->output_frame->strides[0];
+    src_y += ctx->input_frame->strides[0];
+    }
+  }
+
+static void semiplanar_to_planar(gavl_video_convert_context_t * ctx,
+                                 int sub_v, int swap)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + sub_v - 1) / sub_v;
+  uint8_t * src = ctx->input_frame->planes[1];
+  uint8_t * dst_u = ctx->output_frame->planes[1];
+  uint8_t * dst_v = ctx->output_frame->planes[2];
+
+  copy_luma(ctx);
+  
+  for(i = 0; i < uv_height; i++)
+    {
+    if(swap)
+      deinterleave_line(src, dst_v, dst_u, uv_width);
+    else
+      deinterleave_line(src, dst_u, dst_v, uv_width);
+    
+    src += ctx->input_frame->strides[1];
+    dst_u += ctx->output_frame->strides[1];
+    dst_v += ctx->output_frame->strides[2];
+    }
+  }
+
+static void planar_to_semiplanar(gavl_video_convert_context_t * ctx,
+                                 int sub_v, int swap)
+  {
+  int i;
+  int uv_width = (ctx->input_format.image_width + 1) / 2;
+  int uv_height = (ctx->input_format.image_height + sub_v - 1) / sub_v;
+  uint8_t * src_u = ctx->input_frame->planes[1];
+  uint8_t * src_v = ctx->input_frame->planes[2];
+  uint8_t * dst = ctx->output_frame->planes[1];
+
+  copy_luma(ctx);
+  
+  for(i = 0; i < uv_height; i++)
+    {
+    if(swap)
+      interleave_line(src_v, src_u, dst, uv_width);
+    else
+      interleave_line(src_u, src_v, dst, uv_width);
+    
+    dst += ctx->output_frame->strides[1];
+    src_u += ctx->input_frame->strides[1];
+    src_v += ctx->input_frame->strides[2];
+    }
+  }
+
+static void nv12_to_yuv_420_p_sse2(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 2, 0);
+  }
+
+static void nv21_to_yuv_420_p_sse2(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 2, 1);
+  }
+
+static void nv16_to_yuv_422_p_sse2(gavl_video_convert_context_t * ctx)
+  {
+  semiplanar_to_planar(ctx, 1, 0);
+  }
+
+static void yuv_420_p_to_nv12_sse2(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 2, 0);
+  }
+
+static void yuv_420_p_to_nv21_sse2(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 2, 1);
+  }
+
+static void yuv_422_p_to_nv16_sse2(gavl_video_convert_context_t * ctx)
+  {
+  planar_to_semiplanar(ctx, 1, 0);
+  }
+
+void gavl_init_yuv_yuv_funcs_sse2(gavl_pixelformat_function_table_t * tab,
+                                  int width, const gavl_video_options_t * opt)
+  {
+  /* These are lossless, so they are used for any quality and width */
+  
+  tab->nv12_to_yuv_420_p = nv12_to_yuv_420_p_sse2;
+  tab->nv21_to_yuv_420_p = nv21_to_yuv_420_p_sse2;
+  tab->nv16_to_yuv_422_p = nv16_to_yuv_422_p_sse2;
+  tab->yuv_420_p_to_nv12 = yuv_420_p_to_nv12_sse2;
+  tab->yuv_420_p_to_nv21 = yuv_420_p_to_nv21_sse2;
+  tab->yuv_422_p_to_nv16 = yuv_422_p_to_nv16_sse2;
+
+  if(width % 16)
+    return;
+
+  /* These are as good as the C-Functions. Higher quality will invoke a scaler,
+     so this function won't get called anyway */
+  
+  tab->yuy2_to_yuv_420_p = yuy2_to_yuv_420_p_sse2;
+  tab->yuy2_to_yuv_422_p = yuy2_to_yuv_422_p_sse2;
+
+  tab->uyvy_to_yuv_420_p = uyvy_to_yuv_420_p_sse2;
+  tab->uyvy_to_yuv_422_p = uyvy_to_yuv_422_p_sse2;
+  
+  tab->yuv_420_p_to_yuy2 = yuv_420_p_to_yuy2_sse2;
+  tab->yuv_420_p_to_uyvy = yuv_420_p_to_uyvy_sse2;
+
+  tab->yuv_422_p_to_yuy2 = yuv_422_p_to_yuy2_sse2;
+  tab->yuv_422_p_to_uyvy = yuv_422_p_to_uyvy_sse2;
+
+  tab->uyvy_to_yuy2      = uyvy_to_yuy2_sse2;
+  }
@@ -0,0 +1,144 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <blend.h>
+
+#include "ssse3.h"
+
+/*
+ *  SSSE3 blending of RGBA overlays onto 24 bit RGB frames. The
+ *  overlay pixels are shuffled into the 24 bit layout, so 4 pixels
+ *  (12 bytes) are blended at once. The destination is read and
+ *  written as 8 + 4 bytes, so consecutive blocks never overlap.
+ */
+
+#define BLEND_8(s, d, a) \
+  d = (((s - d) * a)>>8) + d;
+
+/* d + ((s - d) * a) >> 8 for 8 words */
+
+static inline __m128i blend_8(__m128i s, __m128i d, __m128i a)
+  {
+  __m128i x = _mm_sub_epi16(s, d);
+  return _mm_add_epi16(d,
+                       _mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(x, a), 8),
+                                    _mm_srli_epi16(_mm_mullo_epi16(x, a), 8)));
+  }
+
+static void blend_rgb_24_common(gavl_video_frame_t * frame,
+                                gavl_video_frame_t * overlay,
+                                int width, int height, int swap)
+  {
+  int i, j, tmp;
+  uint8_t * ovl_ptr;
+  uint8_t * dst_ptr;
+  __m128i o, s, a, d;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rgb_mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                         -1, -1, -1, -1);
+  const __m128i bgr_mask = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                         -1, -1, -1, -1);
+  const __m128i alpha_mask = _mm_setr_epi8(3, 3, 3, 7, 7, 7, 11, 11, 11, 15, 15, 15,
+                                           -1, -1, -1, -1);
+  const __m128i src_mask = swap ? bgr_mask : rgb_mask;
+  /* Byte offsets of r and b */
+  int o_r = swap ? 2 : 0;
+  int o_b = swap ? 0 : 2;
+
+  int w4 = width & ~3;
+
+  for(i = 0; i < height; i++)
+    {
+    ovl_ptr = overlay->planes[0] + i * overlay->strides[0];
+    dst_ptr = frame->planes[0] + i * frame->strides[0];
+
+    for(j = 0; j < w4; j += 4)
+      {
+      o = _mm_loadu_si128((const __m128i*)ovl_ptr);
+      d = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)dst_ptr),
+                             _mm_cvtsi32_si128(*(const int*)(dst_ptr + 8)));
+      s = _mm_shuffle_epi8(o, src_mask);
+      a = _mm_shuffle_epi8(o, alpha_mask);
+
+      d = _mm_packus_epi16(blend_8(_mm_unpacklo_epi8(s, zero),
+                                   _mm_unpacklo_epi8(d, zero),
+                                   _mm_unpacklo_epi8(a, zero)),
+                           blend_8(_mm_unpackhi_epi8(s, zero),
+                                   _mm_unpackhi_epi8(d, zero),
+                                   _mm_unpackhi_epi8(a, zero)));
+      _mm_storel_epi64((__m128i*)dst_ptr, d);
+      *(int*)(dst_ptr + 8) = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+      ovl_ptr += 16;
+      dst_ptr += 12;
+      }
+
+    for(j = w4; j < width; j++)
+      {
+      tmp = dst_ptr[o_r];
+      BLEND_8(ovl_ptr[0], tmp, ovl_ptr[3]);
+      dst_ptr[o_r] = tmp;
+
+      tmp = dst_ptr[1];
+      BLEND_8(ovl_ptr[1], tmp, ovl_ptr[3]);
+      dst_ptr[1] = tmp;
+
+      tmp = dst_ptr[o_b];
+      BLEND_8(ovl_ptr[2], tmp, ovl_ptr[3]);
+      dst_ptr[o_b] = tmp;
+
+      ovl_ptr += 4;
+      dst_ptr += 3;
+      }
+    }
+  }
+
+static void blend_rgb_24_ssse3(gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay,
+                               int width, int height)
+  {
+  blend_rgb_24_common(frame, overlay, width, height, 0);
+  }
+
+static void blend_bgr_24_ssse3(gavl_video_frame_t * frame,
+                               gavl_video_frame_t * overlay,
+                               int width, int height)
+  {
+  blend_rgb_24_common(frame, overlay, width, height, 1);
+  }
+
+gavl_blend_func_t
+gavl_find_blend_func_ssse3(gavl_overlay_blend_context_t * ctx,
+                           gavl_pixelformat_t frame_format,
+                           gavl_pixelformat_t overlay_format)
+  {
+  switch(frame_format)
+    {
+    case GAVL_RGB_24:
+      return blend_rgb_24_ssse3;
+    case GAVL_BGR_24:
+      return blend_bgr_24_ssse3;
+    default:
+      break;
+    }
+  return NULL;
+  }
@@ -0,0 +1,241 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include <attributes.h>
+
+#include "ssse3.h"
+
+/*
+ *  SSSE3 RGB <-> RGB conversions between the 24 and 32 bit formats.
+ *  All byte reordering is done with _mm_shuffle_epi8, 8 pixels at once.
+ */
+
+/* Shuffle masks for 4 pixels in 32 bit */
+
+#define MASK_SWAP_32 \
+  _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15)
+
+/* 24 bit output: Drop the 4th byte of each pixel */
+
+#define MASK_24 \
+  _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)
+
+#define MASK_24_SWAP \
+  _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+
+static inline void store_24(uint8_t * dst, __m128i p0, __m128i p1, __m128i mask)
+  {
+  p0 = _mm_shuffle_epi8(p0, mask);
+  p1 = _mm_shuffle_epi8(p1, mask);
+  _mm_storeu_si128((__m128i*)dst, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+  _mm_storel_epi64((__m128i*)(dst+16), _mm_srli_si128(p1, 4));
+  }
+
+#define INIT_RGB __m128i p0, p1;
+
+#define LOAD_24 ssse3_load_24_as_32(src, &p0, &p1);
+#define LOAD_32 ssse3_load_32x8(src, &p0, &p1);
+
+#define SWAP \
+  p0 = _mm_shuffle_epi8(p0, MASK_SWAP_32); \
+  p1 = _mm_shuffle_epi8(p1, MASK_SWAP_32);
+
+#define SET_ALPHA \
+  p0 = _mm_or_si128(p0, _mm_set1_epi32(0xff000000)); \
+  p1 = _mm_or_si128(p1, _mm_set1_epi32(0xff000000));
+
+#define STORE_32 \
+  _mm_storeu_si128((__m128i*)dst,      p0); \
+  _mm_storeu_si128((__m128i*)(dst+16), p1);
+
+#define STORE_24      store_24(dst, p0, p1, MASK_24);
+#define STORE_24_SWAP store_24(dst, p0, p1, MASK_24_SWAP);
+
+/* swap_rgb_24_ssse3 */
+
+#define FUNC_NAME   swap_rgb_24_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  24
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_24 STORE_24_SWAP
+
+#include "../csp_packed_packed.h"
+
+/* swap_rgb_32_ssse3 */
+
+#define FUNC_NAME   swap_rgb_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_32 SWAP STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* rgb_24_to_rgba_32_ssse3 */
+
+#define FUNC_NAME   rgb_24_to_rgba_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  24
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_24 SET_ALPHA STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* bgr_24_to_rgba_32_ssse3 */
+
+#define FUNC_NAME   bgr_24_to_rgba_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  24
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_24 SWAP SET_ALPHA STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* rgb_32_to_rgba_32_ssse3 */
+
+#define FUNC_NAME   rgb_32_to_rgba_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_32 SET_ALPHA STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* bgr_32_to_rgba_32_ssse3 */
+
+#define FUNC_NAME   bgr_32_to_rgba_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_32 SWAP SET_ALPHA STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* rgb_24_to_32_ssse3 */
+
+#define FUNC_NAME   rgb_24_to_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  24
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_24 STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* rgb_24_to_32_swap_ssse3 */
+
+#define FUNC_NAME   rgb_24_to_32_swap_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  24
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_24 SWAP STORE_32
+
+#include "../csp_packed_packed.h"
+
+/* rgb_32_to_24_ssse3 */
+
+#define FUNC_NAME   rgb_32_to_24_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_32 STORE_24
+
+#include "../csp_packed_packed.h"
+
+/* rgb_32_to_24_swap_ssse3 */
+
+#define FUNC_NAME   rgb_32_to_24_swap_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  32
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_RGB
+#define CONVERT     LOAD_32 STORE_24_SWAP
+
+#include "../csp_packed_packed.h"
+
+void gavl_init_rgb_rgb_funcs_ssse3(gavl_pixelformat_function_table_t * tab,
+                                   int width, const gavl_video_options_t * opt)
+  {
+  if(width % 8)
+    return;
+
+  /* Lossless conversions */
+  
+  tab->swap_rgb_24 = swap_rgb_24_ssse3;
+  tab->swap_rgb_32 = swap_rgb_32_ssse3;
+
+  /* Conversion from RGB formats to RGBA (lossless) */
+
+  tab->rgb_24_to_rgba_32 = rgb_24_to_rgba_32_ssse3;
+  tab->bgr_24_to_rgba_32 = bgr_24_to_rgba_32_ssse3;
+  tab->rgb_32_to_rgba_32 = rgb_32_to_rgba_32_ssse3;
+  tab->bgr_32_to_rgba_32 = bgr_32_to_rgba_32_ssse3;
+
+  /* RGBA -> */
+
+  if(opt->alpha_mode == GAVL_ALPHA_IGNORE)
+    {
+    tab->rgba_32_to_rgb_24    = rgb_32_to_24_ssse3;
+    tab->rgba_32_to_bgr_24    = rgb_32_to_24_swap_ssse3;
+    tab->rgba_32_to_bgr_32    = swap_rgb_32_ssse3;
+    }
+
+  if(opt->quality < 4)
+    {
+    tab->rgb_24_to_32 = rgb_24_to_32_ssse3;
+    tab->rgb_32_to_24 = rgb_32_to_24_ssse3;
+    tab->rgb_24_to_32_swap = rgb_24_to_32_swap_ssse3;
+    tab->rgb_32_to_24_swap = rgb_32_to_24_swap_ssse3;
+    }
+  }
@@ -0,0 +1,260 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <scale.h>
+
+#include "ssse3.h"
+
+/*
+ *  SSSE3 box filter for downscaling by 2, 4 or 8 horizontally and
+ *  a power of 2 vertically. The horizontal sums are done with
+ *  _mm_maddubs_epi16 and _mm_hadd_epi16. The sums of at most
+ *  64 source bytes fit into 16 bits, the division is a rounded shift.
+ */
+
+/* Reorder 4 pixels in 32 bit such that the bytes of pixel pairs are adjacent */
+
+#define MASK_PAIRS_32 \
+  _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15)
+
+#define LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+
+/* Sums of num_h adjacent bytes for 8 destination pixels */
+
+static inline __m128i hsum_8(const uint8_t * src, int num_h)
+  {
+  const __m128i ones = _mm_set1_epi8(1);
+  __m128i s0, s1, s2, s3;
+
+  s0 = _mm_maddubs_epi16(LOAD(src), ones);
+  if(num_h == 2)
+    return s0;
+
+  s1 = _mm_maddubs_epi16(LOAD(src + 16), ones);
+  if(num_h == 4)
+    return _mm_hadd_epi16(s0, s1);
+
+  s2 = _mm_maddubs_epi16(LOAD(src + 32), ones);
+  s3 = _mm_maddubs_epi16(LOAD(src + 48), ones);
+  return _mm_hadd_epi16(_mm_hadd_epi16(s0, s1), _mm_hadd_epi16(s2, s3));
+  }
+
+/* Sums of num_h adjacent 32 bit pixels for 2 destination pixels */
+
+static inline __m128i hsum_32(const uint8_t * src, int num_h)
+  {
+  const __m128i ones = _mm_set1_epi8(1);
+  const __m128i mask = MASK_PAIRS_32;
+  __m128i s0, s1, s2, s3;
+
+  s0 = _mm_maddubs_epi16(_mm_shuffle_epi8(LOAD(src), mask), ones);
+  if(num_h == 2)
+    return s0;
+
+  s1 = _mm_maddubs_epi16(_mm_shuffle_epi8(LOAD(src + 16), mask), ones);
+  if(num_h == 8)
+    {
+    s2 = _mm_maddubs_epi16(_mm_shuffle_epi8(LOAD(src + 32), mask), ones);
+    s3 = _mm_maddubs_epi16(_mm_shuffle_epi8(LOAD(src + 48), mask), ones);
+    s0 = _mm_add_epi16(s0, s1);
+    s1 = _mm_add_epi16(s2, s3);
+    }
+  return _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+  }
+
+static int get_shift(int num)
+  {
+  int ret = 0;
+  while(num > 1)
+    {
+    num >>= 1;
+    ret++;
+    }
+  return ret;
+  }
+
+/* Remaining pixels, which don't fill a whole vector */
+
+static void box_tail(gavl_video_scale_context_t * ctx, uint8_t * src, uint8_t * dst,
+                     int start, int bytes, int num_h, int shift)
+  {
+  int i, j, k, c, sum;
+  uint8_t * row;
+  int num_v = ctx->table_v.factors_per_pixel;
+
+  for(i = start; i < ctx->dst_size; i++)
+    {
+    for(c = 0; c < bytes; c++)
+      {
+      sum = 0;
+      row = src + i * num_h * bytes + c;
+      for(j = 0; j < num_v; j++)
+        {
+        for(k = 0; k < num_h; k++)
+          sum += row[k * bytes];
+        row += ctx->src_stride;
+        }
+      dst[i * bytes + c] = (sum + (1 << (shift - 1))) >> shift;
+      }
+    }
+  }
+
+static inline void box_8(gavl_video_scale_context_t * ctx, int scanline,
+                         uint8_t * dst, int num_h)
+  {
+  int i, j;
+  uint8_t * src, * row;
+  __m128i sum, rnd, cnt;
+  int num_v = ctx->table_v.factors_per_pixel;
+  int shift = get_shift(num_h * num_v);
+  int width = ctx->dst_size & ~7;
+
+  rnd = _mm_set1_epi16(1 << (shift - 1));
+  cnt = _mm_cvtsi32_si128(shift);
+
+  src = ctx->src + ctx->table_v.pixels[scanline].index * ctx->src_stride +
+    ctx->table_h.pixels[0].index;
+
+  for(i = 0; i < width; i += 8)
+    {
+    row = src + i * num_h;
+    sum = hsum_8(row, num_h);
+    for(j = 1; j < num_v; j++)
+      {
+      row += ctx->src_stride;
+      sum = _mm_add_epi16(sum, hsum_8(row, num_h));
+      }
+    sum = _mm_srl_epi16(_mm_add_epi16(sum, rnd), cnt);
+    _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(sum, sum));
+    }
+  box_tail(ctx, src, dst, width, 1, num_h, shift);
+  }
+
+static inline void box_32(gavl_video_scale_context_t * ctx, int scanline,
+                          uint8_t * dst, int num_h)
+  {
+  int i, j;
+  uint8_t * src, * row;
+  __m128i sum, rnd, cnt;
+  int num_v = ctx->table_v.factors_per_pixel;
+  int shift = get_shift(num_h * num_v);
+  int width = ctx->dst_size & ~1;
+
+  rnd = _mm_set1_epi16(1 << (shift - 1));
+  cnt = _mm_cvtsi32_si128(shift);
+
+  src = ctx->src + ctx->table_v.pixels[scanline].index * ctx->src_stride +
+    ctx->table_h.pixels[0].index * 4;
+
+  for(i = 0; i < width; i += 2)
+    {
+    row = src + i * num_h * 4;
+    sum = hsum_32(row, num_h);
+    for(j = 1; j < num_v; j++)
+      {
+      row += ctx->src_stride;
+      sum = _mm_add_epi16(sum, hsum_32(row, num_h));
+      }
+    sum = _mm_srl_epi16(_mm_add_epi16(sum, rnd), cnt);
+    _mm_storel_epi64((__m128i*)(dst + i * 4), _mm_packus_epi16(sum, sum));
+    }
+  box_tail(ctx, src, dst, width, 4, num_h, shift);
+  }
+
+static void scale_uint8_x_1_xy_box_2_ssse3(gavl_video_scale_context_t * ctx,
+                                           int scanline, uint8_t * dst)
+  {
+  box_8(ctx, scanline, dst, 2);
+  }
+
+static void scale_uint8_x_1_xy_box_4_ssse3(gavl_video_scale_context_t * ctx,
+                                           int scanline, uint8_t * dst)
+  {
+  box_8(ctx, scanline, dst, 4);
+  }
+
+static void scale_uint8_x_1_xy_box_8_ssse3(gavl_video_scale_context_t * ctx,
+                                           int scanline, uint8_t * dst)
+  {
+  box_8(ctx, scanline, dst, 8);
+  }
+
+static void scale_uint8_x_4_xy_box_2_ssse3(gavl_video_scale_context_t * ctx,
+                                           int scanline, uint8_t * dst)
+  {
+  box_32(ctx, scanline, dst, 2);
+  }
+
+static void scale_uint8_x_4_xy_box_4_ssse3(gavl_video_scale_context_t * ctx,
+                                           int scanline, uint8_t * dst)
+  {
+  box_32(ctx, scanline, dst, 4);
+  }
+
+static void scale_uint8_x_4_xy_box_8_ssse3(gavl_video_scale_context_t * ctx,
+                                           int scanline, uint8_t * dst)
+  {
+  box_32(ctx, scanline, dst, 8);
+  }
+
+void gavl_init_scale_funcs_box_ssse3(gavl_scale_funcs_t * tab,
+                                     int num_h, int num_v,
+                                     int src_advance, int dst_advance)
+  {
+  gavl_video_scale_scanline_func func_8, func_32;
+
+  /* num_v must be a power of 2 and the sums must fit into 16 bit */
+  if((num_v & (num_v - 1)) || (num_h * num_v > 64))
+    return;
+
+  switch(num_h)
+    {
+    case 2:
+      func_8  = scale_uint8_x_1_xy_box_2_ssse3;
+      func_32 = scale_uint8_x_4_xy_box_2_ssse3;
+      break;
+    case 4:
+      func_8  = scale_uint8_x_1_xy_box_4_ssse3;
+      func_32 = scale_uint8_x_4_xy_box_4_ssse3;
+      break;
+    case 8:
+      func_8  = scale_uint8_x_1_xy_box_8_ssse3;
+      func_32 = scale_uint8_x_4_xy_box_8_ssse3;
+      break;
+    default:
+      return;
+    }
+
+  if((src_advance == 1) && (dst_advance == 1))
+    {
+    tab->funcs_xy.scale_uint8_x_1_noadvance = func_8;
+    tab->funcs_xy.scale_uint8_x_1_advance   = func_8;
+    }
+  else if((src_advance == 4) && (dst_advance == 4))
+    {
+    /* RGB with 32 bit per pixel: The padding byte is averaged as well */
+    tab->funcs_xy.scale_uint8_x_3 = func_32;
+    tab->funcs_xy.scale_uint8_x_4 = func_32;
+    }
+  }
@@ -0,0 +1,171 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/*
+ *  Common inline helpers for the SSSE3 routines. These are the 128 bit
+ *  counterparts of the ones in ../avx2/avx2.h and process 8 pixels at once.
+ *  The files using this are compiled with -mssse3, so they
+ *  must only be called if gavl_accel_supported() reports GAVL_ACCEL_SSSE3.
+ */
+
+#ifndef SSSE3_H_INCLUDED
+#define SSSE3_H_INCLUDED
+
+#include <string.h>
+#include <tmmintrin.h>
+
+/* Round a floating point coefficient to fixed point with <bits> fractional bits */
+
+#define SSSE3_FIX(x, bits) \
+  ((int)((x)*(double)(1<<(bits)) + (((x) < 0.0) ? -0.5 : 0.5)))
+
+/* Load 2 or 4 bytes into the lowest bits */
+
+static inline __m128i ssse3_load_16(const uint8_t * src)
+  {
+  uint16_t x;
+  memcpy(&x, src, 2);
+  return _mm_cvtsi32_si128(x);
+  }
+
+static inline __m128i ssse3_load_32(const uint8_t * src)
+  {
+  int32_t x;
+  memcpy(&x, src, 4);
+  return _mm_cvtsi32_si128(x);
+  }
+
+/* Store the lowest 2 or 4 bytes */
+
+static inline void ssse3_store_16(uint8_t * dst, __m128i x)
+  {
+  uint16_t v = _mm_cvtsi128_si32(x);
+  memcpy(dst, &v, 2);
+  }
+
+static inline void ssse3_store_32(uint8_t * dst, __m128i x)
+  {
+  int32_t v = _mm_cvtsi128_si32(x);
+  memcpy(dst, &v, 4);
+  }
+
+/* Pack 8 signed 16 bit values to 8 unsigned bytes (in the lower half) */
+
+static inline __m128i ssse3_pack_16_to_8(__m128i x)
+  {
+  return _mm_packus_epi16(x, x);
+  }
+
+/* Pack 2x4 signed 32 bit values to 8 unsigned bytes (in the lower half) */
+
+static inline __m128i ssse3_pack_32_to_8(__m128i lo, __m128i hi)
+  {
+  __m128i x = _mm_packs_epi32(lo, hi);
+  return _mm_packus_epi16(x, x);
+  }
+
+/* Get the even elements of 2x4 32 bit values */
+
+static inline __m128i ssse3_even_32(__m128i lo, __m128i hi)
+  {
+  return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo),
+                                         _mm_castsi128_ps(hi),
+                                         _MM_SHUFFLE(2, 0, 2, 0)));
+  }
+
+/* Load 8 bytes and expand them to 16 bit */
+
+static inline __m128i ssse3_load_8_to_16(const uint8_t * src)
+  {
+  return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src),
+                           _mm_setzero_si128());
+  }
+
+/* Load 4 bytes, expand them to 16 bit and duplicate each value */
+
+static inline __m128i ssse3_load_4_to_16_dup(const uint8_t * src)
+  {
+  __m128i x = _mm_unpacklo_epi8(ssse3_load_32(src), _mm_setzero_si128());
+  return _mm_unpacklo_epi16(x, x);
+  }
+
+/* Load 2 bytes, expand them to 16 bit and repeat each value 4 times */
+
+static inline __m128i ssse3_load_2_to_16_dup4(const uint8_t * src)
+  {
+  const __m128i mask = _mm_setr_epi8(0, -1, 0, -1, 0, -1, 0, -1,
+                                     1, -1, 1, -1, 1, -1, 1, -1);
+  return _mm_shuffle_epi8(ssse3_load_16(src), mask);
+  }
+
+/* Interleave 8 bytes of each component to 8 packed 32 bit pixels */
+
+static inline void ssse3_interleave_4x8(__m128i c1, __m128i c2,
+                                        __m128i c3, __m128i c4,
+                                        __m128i * p)
+  {
+  __m128i c12 = _mm_unpacklo_epi8(c1, c2);
+  __m128i c34 = _mm_unpacklo_epi8(c3, c4);
+  p[0] = _mm_unpacklo_epi16(c12, c34);
+  p[1] = _mm_unpackhi_epi16(c12, c34);
+  }
+
+/* Store 8 packed 32 bit pixels */
+
+static inline void ssse3_store_32x8(uint8_t * dst, const __m128i * p)
+  {
+  _mm_storeu_si128((__m128i*)dst,      p[0]);
+  _mm_storeu_si128((__m128i*)(dst+16), p[1]);
+  }
+
+/* Store 8 packed 32 bit pixels as 24 bit pixels (the 4th byte is dropped) */
+
+static inline void ssse3_store_32_as_24(uint8_t * dst, const __m128i * p)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                     -1, -1, -1, -1);
+  __m128i p0 = _mm_shuffle_epi8(p[0], mask);
+  __m128i p1 = _mm_shuffle_epi8(p[1], mask);
+
+  _mm_storeu_si128((__m128i*)dst, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+  _mm_storel_epi64((__m128i*)(dst+16), _mm_srli_si128(p1, 4));
+  }
+
+/* Load 8 24 bit pixels and expand them to 2x4 32 bit pixels */
+
+static inline void ssse3_load_24_as_32(const uint8_t * src, __m128i * lo, __m128i * hi)
+  {
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                     6, 7, 8, -1, 9, 10, 11, -1);
+  *lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), mask);
+  /* Load the last 4 pixels from the end to stay inside the buffer */
+  *hi = _mm_shuffle_epi8(_mm_srli_si128(_mm_loadu_si128((const __m128i*)(src+8)), 4),
+                         mask);
+  }
+
+/* Load 8 32 bit pixels */
+
+static inline void ssse3_load_32x8(const uint8_t * src, __m128i * lo, __m128i * hi)
+  {
+  *lo = _mm_loadu_si128((const __m128i*)src);
+  *hi = _mm_loadu_si128((const __m128i*)(src+16));
+  }
+
+#endif // SSSE3_H_INCLUDED
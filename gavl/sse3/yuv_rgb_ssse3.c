@@ -0,0 +1,1295 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+
+#include <config.h>
+#include <gavl/gavl.h>
+#include <video.h>
+#include <colorspace.h>
+
+#include <attributes.h>
+
+#include "ssse3.h"
+
+/*
+ *  SSSE3 YUV -> RGB conversions. 8 pixels are processed at once.
+ *  The calculation is the same as in ../avx2/yuv_rgb_avx2.c:
+ *  16 bit fixed point with 3 fractional bits.
+ */
+
+typedef struct
+  {
+  __m128i y_off;
+  __m128i uv_off;
+  __m128i y;
+  __m128i v_r;
+  __m128i u_g;
+  __m128i v_g;
+  __m128i u_b;
+  __m128i round;
+  } yuv_rgb_ssse3_t;
+
+/*
+ *  The inputs are shifted left by 7 bits and _mm_mulhrs_epi16 shifts the
+ *  product right by 15 bits. Scaling the coefficients by 2048 therefore
+ *  gives results with 3 fractional bits.
+ */
+
+#define Y_COEFF   (255.0/219.0)
+#define V_R_COEFF ( 1.40200*255.0/224.0)
+#define U_G_COEFF (-0.34414*255.0/224.0)
+#define V_G_COEFF (-0.71414*255.0/224.0)
+#define U_B_COEFF ( 1.77200*255.0/224.0)
+
+#define YJ_COEFF   1.0
+#define VJ_R_COEFF ( 1.40200)
+#define UJ_G_COEFF (-0.34414)
+#define VJ_G_COEFF (-0.71414)
+#define UJ_B_COEFF ( 1.77200)
+
+static inline void yuv_rgb_ssse3_init(yuv_rgb_ssse3_t * c, int jpeg)
+  {
+  c->uv_off = _mm_set1_epi16(0x80);
+  c->round  = _mm_set1_epi16(4);
+  
+  if(jpeg)
+    {
+    c->y_off = _mm_setzero_si128();
+    c->y     = _mm_set1_epi16(SSSE3_FIX(YJ_COEFF,   11));
+    c->v_r   = _mm_set1_epi16(SSSE3_FIX(VJ_R_COEFF, 11));
+    c->u_g   = _mm_set1_epi16(SSSE3_FIX(UJ_G_COEFF, 11));
+    c->v_g   = _mm_set1_epi16(SSSE3_FIX(VJ_G_COEFF, 11));
+    c->u_b   = _mm_set1_epi16(SSSE3_FIX(UJ_B_COEFF, 11));
+    }
+  else
+    {
+    c->y_off = _mm_set1_epi16(0x10);
+    c->y     = _mm_set1_epi16(SSSE3_FIX(Y_COEFF,   11));
+    c->v_r   = _mm_set1_epi16(SSSE3_FIX(V_R_COEFF, 11));
+    c->u_g   = _mm_set1_epi16(SSSE3_FIX(U_G_COEFF, 11));
+    c->v_g   = _mm_set1_epi16(SSSE3_FIX(V_G_COEFF, 11));
+    c->u_b   = _mm_set1_epi16(SSSE3_FIX(U_B_COEFF, 11));
+    }
+  }
+
+/* 8 YUV values (16 bit) -> 8 RGB values (16 bit, 0..255 range) */
+
+static inline void yuv_to_rgb_ssse3(const yuv_rgb_ssse3_t * c,
+                                    __m128i y, __m128i u, __m128i v,
+                                    __m128i * r, __m128i * g, __m128i * b)
+  {
+  y = _mm_slli_epi16(_mm_sub_epi16(y, c->y_off), 7);
+  u = _mm_slli_epi16(_mm_sub_epi16(u, c->uv_off), 7);
+  v = _mm_slli_epi16(_mm_sub_epi16(v, c->uv_off), 7);
+
+  y = _mm_add_epi16(_mm_mulhrs_epi16(y, c->y), c->round);
+  
+  *r = _mm_add_epi16(y, _mm_mulhrs_epi16(v, c->v_r));
+  *g = _mm_add_epi16(y, _mm_add_epi16(_mm_mulhrs_epi16(u, c->u_g),
+                                      _mm_mulhrs_epi16(v, c->v_g)));
+  *b = _mm_add_epi16(y, _mm_mulhrs_epi16(u, c->u_b));
+
+  *r = _mm_srai_epi16(*r, 3);
+  *g = _mm_srai_epi16(*g, 3);
+  *b = _mm_srai_epi16(*b, 3);
+  }
+
+/* Loading */
+
+#define INIT_LOAD_PLANAR \
+  __m128i y, u, v;
+
+#define INIT_LOAD_PACKED \
+  __m128i y, u, v, p; \
+  const __m128i mask_00ff = _mm_set1_epi16(0x00ff); \
+  const __m128i mask_0000ffff = _mm_set1_epi32(0x0000ffff);
+
+/* 4:4:4: 8 luma and 8 chroma samples */
+
+#define LOAD_YUV_PLANAR_1 \
+  y = ssse3_load_8_to_16(src_y); \
+  u = ssse3_load_8_to_16(src_u); \
+  v = ssse3_load_8_to_16(src_v);
+
+/* 4:2:x: 8 luma and 4 chroma samples */
+
+#define LOAD_YUV_PLANAR_2 \
+  y = ssse3_load_8_to_16(src_y); \
+  u = ssse3_load_4_to_16_dup(src_u); \
+  v = ssse3_load_4_to_16_dup(src_v);
+
+/* 4:1:x: 8 luma and 2 chroma samples */
+
+#define LOAD_YUV_PLANAR_4 \
+  y = ssse3_load_8_to_16(src_y); \
+  u = ssse3_load_2_to_16_dup4(src_u); \
+  v = ssse3_load_2_to_16_dup4(src_v);
+
+/* Chroma is in the lower 16 bits (U) and upper 16 bits (V) of each 32 bit word */
+
+#define EXPAND_UV \
+  v = _mm_srli_epi32(u, 16); \
+  u = _mm_and_si128(u, mask_0000ffff); \
+  u = _mm_or_si128(u, _mm_slli_epi32(u, 16)); \
+  v = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+
+#define LOAD_YUY2 \
+  p = _mm_loadu_si128((const __m128i*)src); \
+  y = _mm_and_si128(p, mask_00ff); \
+  u = _mm_srli_epi16(p, 8); \
+  EXPAND_UV
+
+#define LOAD_UYVY \
+  p = _mm_loadu_si128((const __m128i*)src); \
+  y = _mm_srli_epi16(p, 8); \
+  u = _mm_and_si128(p, mask_00ff); \
+  EXPAND_UV
+
+/* Storing */
+
+#define INIT_STORE_8 \
+  __m128i r, g, b; \
+  __m128i pix[2]; \
+  const __m128i alpha = _mm_set1_epi8(-1);
+
+#define INIT_COEFFS \
+  yuv_rgb_ssse3_t c; \
+  yuv_rgb_ssse3_init(&c, 0);
+
+#define INIT_COEFFS_J \
+  yuv_rgb_ssse3_t c; \
+  yuv_rgb_ssse3_init(&c, 1);
+
+#define STORE_RGB_24 \
+  yuv_to_rgb_ssse3(&c, y, u, v, &r, &g, &b); \
+  ssse3_interleave_4x8(ssse3_pack_16_to_8(r), ssse3_pack_16_to_8(g), \
+                       ssse3_pack_16_to_8(b), alpha, pix); \
+  ssse3_store_32_as_24(dst, pix);
+
+#define STORE_BGR_24 \
+  yuv_to_rgb_ssse3(&c, y, u, v, &r, &g, &b); \
+  ssse3_interleave_4x8(ssse3_pack_16_to_8(b), ssse3_pack_16_to_8(g), \
+                       ssse3_pack_16_to_8(r), alpha, pix); \
+  ssse3_store_32_as_24(dst, pix);
+
+#define STORE_RGB_32 \
+  yuv_to_rgb_ssse3(&c, y, u, v, &r, &g, &b); \
+  ssse3_interleave_4x8(ssse3_pack_16_to_8(r), ssse3_pack_16_to_8(g), \
+                       ssse3_pack_16_to_8(b), alpha, pix); \
+  ssse3_store_32x8(dst, pix);
+
+#define STORE_BGR_32 \
+  yuv_to_rgb_ssse3(&c, y, u, v, &r, &g, &b); \
+  ssse3_interleave_4x8(ssse3_pack_16_to_8(b), ssse3_pack_16_to_8(g), \
+                       ssse3_pack_16_to_8(r), alpha, pix); \
+  ssse3_store_32x8(dst, pix);
+
+#define STORE_RGBA_32 STORE_RGB_32
+
+/* YUV_420P */
+
+/* yuv_420_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuv_420_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuv_420_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuv_420_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_420_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuv_420_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUV_422P */
+
+/* yuv_422_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuv_422_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuv_422_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuv_422_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_422_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuv_422_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUV_444P */
+
+/* yuv_444_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuv_444_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuv_444_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuv_444_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_444_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuv_444_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUV_411P */
+
+/* yuv_411_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuv_411_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_411_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuv_411_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_411_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuv_411_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_411_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuv_411_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_411_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuv_411_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUV_410P */
+
+/* yuv_410_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuv_410_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    4
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_410_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuv_410_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    4
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuv_410_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuv_410_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    4
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_410_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuv_410_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    4
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuv_410_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuv_410_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 2
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    4
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_YUV_PLANAR_4 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUVJ_420P */
+
+/* yuvj_420_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuvj_420_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuvj_420_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_420_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuvj_420_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUVJ_422P */
+
+/* yuvj_422_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuvj_422_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuvj_422_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_422_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuvj_422_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 4
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_2 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUVJ_444P */
+
+/* yuvj_444_p_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     yuvj_444_p_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     yuvj_444_p_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* yuvj_444_p_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     yuvj_444_p_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_PLANAR INIT_STORE_8 INIT_COEFFS_J
+#define CONVERT       LOAD_YUV_PLANAR_1 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* YUY2 */
+
+/* yuy2_to_rgb_24_ssse3 */
+
+#define FUNC_NAME   yuy2_to_rgb_24_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGB_24
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_bgr_24_ssse3 */
+
+#define FUNC_NAME   yuy2_to_bgr_24_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_BGR_24
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgb_32_ssse3 */
+
+#define FUNC_NAME   yuy2_to_rgb_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGB_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_bgr_32_ssse3 */
+
+#define FUNC_NAME   yuy2_to_bgr_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_BGR_32
+
+#include "../csp_packed_packed.h"
+
+/* yuy2_to_rgba_32_ssse3 */
+
+#define FUNC_NAME   yuy2_to_rgba_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_YUY2 STORE_RGBA_32
+
+#include "../csp_packed_packed.h"
+
+/* UYVY */
+
+/* uyvy_to_rgb_24_ssse3 */
+
+#define FUNC_NAME   uyvy_to_rgb_24_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGB_24
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_bgr_24_ssse3 */
+
+#define FUNC_NAME   uyvy_to_bgr_24_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 24
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_BGR_24
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgb_32_ssse3 */
+
+#define FUNC_NAME   uyvy_to_rgb_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGB_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_bgr_32_ssse3 */
+
+#define FUNC_NAME   uyvy_to_bgr_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_BGR_32
+
+#include "../csp_packed_packed.h"
+
+/* uyvy_to_rgba_32_ssse3 */
+
+#define FUNC_NAME   uyvy_to_rgba_32_ssse3
+#define IN_TYPE     uint8_t
+#define OUT_TYPE    uint8_t
+#define IN_ADVANCE  16
+#define OUT_ADVANCE 32
+#define NUM_PIXELS  8
+#define INIT        INIT_LOAD_PACKED INIT_STORE_8 INIT_COEFFS
+#define CONVERT     LOAD_UYVY STORE_RGBA_32
+
+#include "../csp_packed_packed.h"
+
+/*
+ *  Semiplanar formats: 8 luma and 4 interleaved chroma pairs.
+ *  The chroma pointer is advanced by 8 bytes per step, src_v is unused.
+ */
+
+#define INIT_LOAD_SEMIPLANAR \
+  __m128i y, u, v; \
+  const __m128i mask_0000ffff = _mm_set1_epi32(0x0000ffff);
+
+#define LOAD_NV12 \
+  y = ssse3_load_8_to_16(src_y); \
+  u = ssse3_load_8_to_16(src_u); \
+  EXPAND_UV
+
+#define LOAD_NV21 \
+  y = ssse3_load_8_to_16(src_y); \
+  v = ssse3_load_8_to_16(src_u); \
+  u = _mm_srli_epi32(v, 16); \
+  v = _mm_and_si128(v, mask_0000ffff); \
+  u = _mm_or_si128(u, _mm_slli_epi32(u, 16)); \
+  v = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+
+/* NV12 */
+
+/* nv12_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     nv12_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     nv12_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     nv12_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     nv12_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* nv12_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     nv12_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* NV21 */
+
+/* nv21_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     nv21_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     nv21_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     nv21_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     nv21_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* nv21_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     nv21_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    2
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV21 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+/* NV16 */
+
+/* nv16_to_rgb_24_ssse3 */
+
+#define FUNC_NAME     nv16_to_rgb_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_24
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_bgr_24_ssse3 */
+
+#define FUNC_NAME     nv16_to_bgr_24_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   24
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_24
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_rgb_32_ssse3 */
+
+#define FUNC_NAME     nv16_to_rgb_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGB_32
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_bgr_32_ssse3 */
+
+#define FUNC_NAME     nv16_to_bgr_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_BGR_32
+
+#include "../csp_planar_packed.h"
+
+/* nv16_to_rgba_32_ssse3 */
+
+#define FUNC_NAME     nv16_to_rgba_32_ssse3
+#define IN_TYPE       uint8_t
+#define OUT_TYPE      uint8_t
+#define IN_ADVANCE_Y  8
+#define IN_ADVANCE_UV 8
+#define OUT_ADVANCE   32
+#define NUM_PIXELS    8
+#define CHROMA_SUB    1
+#define INIT          INIT_LOAD_SEMIPLANAR INIT_STORE_8 INIT_COEFFS
+#define CONVERT       LOAD_NV12 STORE_RGBA_32
+
+#include "../csp_planar_packed.h"
+
+void gavl_init_yuv_rgb_funcs_ssse3(gavl_pixelformat_function_table_t * tab,
+                                   int width, const gavl_video_options_t * opt)
+  {
+  if(width % 8)
+    return;
+
+  if(opt->quality && (opt->quality >= 3))
+    return;
+
+  tab->yuv_420_p_to_rgb_24 = yuv_420_p_to_rgb_24_ssse3;
+  tab->yuv_420_p_to_bgr_24 = yuv_420_p_to_bgr_24_ssse3;
+  tab->yuv_420_p_to_rgb_32 = yuv_420_p_to_rgb_32_ssse3;
+  tab->yuv_420_p_to_bgr_32 = yuv_420_p_to_bgr_32_ssse3;
+  tab->yuv_420_p_to_rgba_32 = yuv_420_p_to_rgba_32_ssse3;
+
+  tab->yuv_422_p_to_rgb_24 = yuv_422_p_to_rgb_24_ssse3;
+  tab->yuv_422_p_to_bgr_24 = yuv_422_p_to_bgr_24_ssse3;
+  tab->yuv_422_p_to_rgb_32 = yuv_422_p_to_rgb_32_ssse3;
+  tab->yuv_422_p_to_bgr_32 = yuv_422_p_to_bgr_32_ssse3;
+  tab->yuv_422_p_to_rgba_32 = yuv_422_p_to_rgba_32_ssse3;
+
+  tab->yuv_444_p_to_rgb_24 = yuv_444_p_to_rgb_24_ssse3;
+  tab->yuv_444_p_to_bgr_24 = yuv_444_p_to_bgr_24_ssse3;
+  tab->yuv_444_p_to_rgb_32 = yuv_444_p_to_rgb_32_ssse3;
+  tab->yuv_444_p_to_bgr_32 = yuv_444_p_to_bgr_32_ssse3;
+  tab->yuv_444_p_to_rgba_32 = yuv_444_p_to_rgba_32_ssse3;
+
+  tab->yuv_411_p_to_rgb_24 = yuv_411_p_to_rgb_24_ssse3;
+  tab->yuv_411_p_to_bgr_24 = yuv_411_p_to_bgr_24_ssse3;
+  tab->yuv_411_p_to_rgb_32 = yuv_411_p_to_rgb_32_ssse3;
+  tab->yuv_411_p_to_bgr_32 = yuv_411_p_to_bgr_32_ssse3;
+  tab->yuv_411_p_to_rgba_32 = yuv_411_p_to_rgba_32_ssse3;
+
+  tab->yuv_410_p_to_rgb_24 = yuv_410_p_to_rgb_24_ssse3;
+  tab->yuv_410_p_to_bgr_24 = yuv_410_p_to_bgr_24_ssse3;
+  tab->yuv_410_p_to_rgb_32 = yuv_410_p_to_rgb_32_ssse3;
+  tab->yuv_410_p_to_bgr_32 = yuv_410_p_to_bgr_32_ssse3;
+  tab->yuv_410_p_to_rgba_32 = yuv_410_p_to_rgba_32_ssse3;
+
+  tab->yuvj_420_p_to_rgb_24 = yuvj_420_p_to_rgb_24_ssse3;
+  tab->yuvj_420_p_to_bgr_24 = yuvj_420_p_to_bgr_24_ssse3;
+  tab->yuvj_420_p_to_rgb_32 = yuvj_420_p_to_rgb_32_ssse3;
+  tab->yuvj_420_p_to_bgr_32 = yuvj_420_p_to_bgr_32_ssse3;
+  tab->yuvj_420_p_to_rgba_32 = yuvj_420_p_to_rgba_32_ssse3;
+
+  tab->yuvj_422_p_to_rgb_24 = yuvj_422_p_to_rgb_24_ssse3;
+  tab->yuvj_422_p_to_bgr_24 = yuvj_422_p_to_bgr_24_ssse3;
+  tab->yuvj_422_p_to_rgb_32 = yuvj_422_p_to_rgb_32_ssse3;
+  tab->yuvj_422_p_to_bgr_32 = yuvj_422_p_to_bgr_32_ssse3;
+  tab->yuvj_422_p_to_rgba_32 = yuvj_422_p_to_rgba_32_ssse3;
+
+  tab->yuvj_444_p_to_rgb_24 = yuvj_444_p_to_rgb_24_ssse3;
+  tab->yuvj_444_p_to_bgr_24 = yuvj_444_p_to_bgr_24_ssse3;
+  tab->yuvj_444_p_to_rgb_32 = yuvj_444_p_to_rgb_32_ssse3;
+  tab->yuvj_444_p_to_bgr_32 = yuvj_444_p_to_bgr_32_ssse3;
+  tab->yuvj_444_p_to_rgba_32 = yuvj_444_p_to_rgba_32_ssse3;
+
+  tab->yuy2_to_rgb_24 = yuy2_to_rgb_24_ssse3;
+  tab->yuy2_to_bgr_24 = yuy2_to_bgr_24_ssse3;
+  tab->yuy2_to_rgb_32 = yuy2_to_rgb_32_ssse3;
+  tab->yuy2_to_bgr_32 = yuy2_to_bgr_32_ssse3;
+  tab->yuy2_to_rgba_32 = yuy2_to_rgba_32_ssse3;
+
+  tab->uyvy_to_rgb_24 = uyvy_to_rgb_24_ssse3;
+  tab->uyvy_to_bgr_24 = uyvy_to_bgr_24_ssse3;
+  tab->uyvy_to_rgb_32 = uyvy_to_rgb_32_ssse3;
+  tab->uyvy_to_bgr_32 = uyvy_to_bgr_32_ssse3;
+  tab->uyvy_to_rgba_32 = uyvy_to_rgba_32_ssse3;
+
+  tab->nv12_to_rgb_24 = nv12_to_rgb_24_ssse3;
+  tab->nv12_to_bgr_24 = nv12_to_bgr_24_ssse3;
+  tab->nv12_to_rgb_32 = nv12_to_rgb_32_ssse3;
+  tab->nv12_to_bgr_32 = nv12_to_bgr_32_ssse3;
+  tab->nv12_to_rgba_32 = nv12_to_rgba_32_ssse3;
+
+  tab->nv21_to_rgb_24 = nv21_to_rgb_24_ssse3;
+  tab->nv21_to_bgr_24 = nv21_to_bgr_24_ssse3;
+  tab->nv21_to_rgb_32 = nv21_to_rgb_32_ssse3;
+  tab->nv21_to_bgr_32 = nv21_to_bgr_32_ssse3;
+  tab->nv21_to_rgba_32 = nv21_to_rgba_32_ssse3;
+
+  tab->nv16_to_rgb_24 = nv16_to_rgb_24_ssse3;
+  tab->nv16_to_bgr_24 = nv16_to_bgr_24_ssse3;
+  tab->nv16_to_rgb_32 = nv16_to_rgb_32_ssse3;
+  tab->nv16_to_bgr_32 = nv16_to_bgr_32_ssse3;
+  tab->nv16_to_rgba_32 = nv16_to_rgba_32_ssse3;
+  }
@@ -20,22 +20,31 @@
 
 
 
-#include <math.h>
-#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <config.h>
 
 #include <gavl/gavl.h>
+#include <video.h>
+#include <ssim.h>
+#include <accel.h>
 
 #include "ssim_tab.h"
 
-
-
 /* Constants for suppressing instabilities for almost equal images */
-static const double K1 = 0.01;
-static const double K2 = 0.03;
-
+static const float K1 = 0.01;
+static const float K2 = 0.03;
 
 /*
- *  Note: SSIM calculation is optimized for *accuracy*, not for *speed* !!
+ *  The gaussian window is separable, and the variances and the
+ *  covariance can be written as E(x*x) - E(x)*E(x) etc. So we filter
+ *  the 5 moments of each scanline horizontally and keep the last
+ *  SSIM_GAUSS_TAPS results in a ring buffer, from which the moments
+ *  of the output lines are filtered vertically.
+ *
+ *  The samples are shifted by -0.5 before, which makes the
+ *  cancellation in E(x*x) - E(x)*E(x) much smaller.
  */
 
 /* Range for iterating through a frame */
@@ -43,165 +52,368 @@ typedef struct
   {
   int start;
   int len;
-  const double * w;
   int coeffs_index;
   } range_t;
 
-/* Wang, eq. 14 */
-
-static double get_mu(range_t * ri, range_t * rj,
-                     const float * data, int stride)
+static void setup_range(range_t * r, int center, int size)
   {
-  int i, j;
-  double ret = 0.0;
+  int diff;
+  
+  r->start = center - SSIM_GAUSS_TAPS/2;
+  r->len   = SSIM_GAUSS_TAPS;
   
-  for(i = 0; i < ri->len; i++)
+  r->coeffs_index = SSIM_GAUSS_TAPS/2;
+  
+  if(r->start < 0)
     {
-    for(j = 0; j < rj->len; j++)
-      {
-      ret += ri->w[i] * rj->w[j] * data[j];
-      }
-    data += stride;
+    diff = -r->start;
+
+    r->len -= diff;
+    r->coeffs_index -= diff;
+    r->start = 0;
+    }
+  else if(r->start + r->len > size)
+    {
+    diff = r->start + r->len - size;
+    
+    r->len -= diff;
+    r->coeffs_index += diff;
     }
-  return ret;
   }
 
-/* Wang, eq. 15 */
+/* Buffers for one parallel chunk */
+
+typedef struct
+  {
+  float coeffs[SSIM_GAUSS_TAPS][SSIM_GAUSS_TAPS];
+  float * moments[GAVL_SSIM_MOMENTS];    /* Moments of one scanline */
+  float * ring[SSIM_GAUSS_TAPS][GAVL_SSIM_MOMENTS];
+  float * filtered[GAVL_SSIM_MOMENTS];
+  float * mem;
+  } scratch_t;
 
-static double get_sigma(range_t * ri, range_t * rj,
-                        const float * data, int stride,
-                        double mu)
+static void scratch_init(scratch_t * s, int width)
   {
   int i, j;
-  double ret = 0.0;
-  double diff;
+  float * ptr;
+
+  for(i = 0; i < SSIM_GAUSS_TAPS; i++)
+    {
+    for(j = 0; j < SSIM_GAUSS_TAPS; j++)
+      s->coeffs[i][j] = ssim_gauss_coeffs[i][j];
+    }
   
-  for(i = 0; i < ri->len; i++)
+  s->mem = malloc((SSIM_GAUSS_TAPS + 2) * GAVL_SSIM_MOMENTS *
+                  width * sizeof(*s->mem));
+  ptr = s->mem;
+
+  for(i = 0; i < GAVL_SSIM_MOMENTS; i++)
     {
-    for(j = 0; j < rj->len; j++)
+    s->moments[i] = ptr;
+    ptr += width;
+    s->filtered[i] = ptr;
+    ptr += width;
+
+    for(j = 0; j < SSIM_GAUSS_TAPS; j++)
       {
-      diff = data[j] - mu;
-      ret += ri->w[i] * rj->w[j] * diff * diff;
+      s->ring[j][i] = ptr;
+      ptr += width;
       }
-    data += stride;
     }
-  return sqrt(ret);
   }
 
-/* Wang, eq. 16 */
+/* Filter the moments of scanline y horizontally */
 
-static double get_sigma_xy(range_t * ri, range_t * rj,
-                           const float * data_x, int stride_x,
-                           const float * data_y, int stride_y,
-                           double mu_x, double mu_y)
+static void filter_row(gavl_ssim_plane_t * p, scratch_t * s, int y)
   {
-  int i, j;
-  double ret = 0.0;
+  int i, j, k;
+  range_t r;
+  float sum;
+  float * x_f = s->moments[0];
+  float * y_f = s->moments[1];
+  float ** dst = s->ring[y % SSIM_GAUSS_TAPS];
+  const uint8_t * src1 = p->src1 + y * p->stride1;
+  const uint8_t * src2 = p->src2 + y * p->stride2;
+  const int half = SSIM_GAUSS_TAPS/2;
   
-  for(i = 0; i < ri->len; i++)
+  switch(p->bytes)
     {
-    for(j = 0; j < rj->len; j++)
+    case 1:
+      for(i = 0; i < p->width; i++)
+        {
+        x_f[i] = src1[i] * (1.0f / 255.0f) - 0.5f;
+        y_f[i] = src2[i] * (1.0f / 255.0f) - 0.5f;
+        }
+      break;
+    case 2:
+      for(i = 0; i < p->width; i++)
+        {
+        x_f[i] = ((const uint16_t*)src1)[i] * (1.0f / 65535.0f) - 0.5f;
+        y_f[i] = ((const uint16_t*)src2)[i] * (1.0f / 65535.0f) - 0.5f;
+        }
+      break;
+    case 4:
+      for(i = 0; i < p->width; i++)
+        {
+        x_f[i] = ((const float*)src1)[i] - 0.5f;
+        y_f[i] = ((const float*)src2)[i] - 0.5f;
+        }
+      break;
+    }
+
+  for(i = 0; i < p->width; i++)
+    {
+    s->moments[2][i] = x_f[i] * x_f[i];
+    s->moments[3][i] = y_f[i] * y_f[i];
+    s->moments[4][i] = x_f[i] * y_f[i];
+    }
+
+  for(k = 0; k < GAVL_SSIM_MOMENTS; k++)
+    {
+    /* Borders with truncated windows */
+    for(i = 0; i < half; i++)
       {
-      ret += ri->w[i]*rj->w[j]*(data_x[j]-mu_x)*(data_y[j]-mu_y);
+      setup_range(&r, i, p->width);
+      sum = 0.0f;
+      for(j = 0; j < r.len; j++)
+        sum += s->coeffs[r.coeffs_index][j] * s->moments[k][r.start + j];
+      dst[k][i] = sum;
+
+      setup_range(&r, p->width - 1 - i, p->width);
+      sum = 0.0f;
+      for(j = 0; j < r.len; j++)
+        sum += s->coeffs[r.coeffs_index][j] * s->moments[k][r.start + j];
+      dst[k][p->width - 1 - i] = sum;
       }
-    data_x += stride_x;
-    data_y += stride_y;
+    
+    p->funcs->filter_h(s->moments[k], dst[k] + half, s->coeffs[half],
+                       SSIM_GAUSS_TAPS, p->width - 2 * half);
     }
-  return ret;
   }
 
-static void setup_range(range_t * r, int center, int size)
+static void ssim_rows(void * data, int start, int end)
   {
-  int diff;
-  
-  r->start = center - SSIM_GAUSS_TAPS/2;
-  r->len   = SSIM_GAUSS_TAPS;
+  int i, k, t;
+  range_t r;
+  int next_row;
+  scratch_t s;
+  const float * src[SSIM_GAUSS_TAPS];
+  gavl_ssim_plane_t * p = data;
+
+  /* Dynamic range is 1.0 */
+  const float C1 = K1 * K1;
+  const float C2 = K2 * K2;
   
-  r->coeffs_index = SSIM_GAUSS_TAPS/2;
+  scratch_init(&s, p->width);
+
+  setup_range(&r, start, p->height);
+  next_row = r.start;
   
-  if(r->start < 0)
+  for(i = start; i < end; i++)
     {
-    diff = -r->start;
+    setup_range(&r, i, p->height);
 
-    r->len -= diff;
-    r->coeffs_index -= diff;
-    r->start = 0;
-    }
-  else if(r->start + r->len > size)
-    {
-    diff = r->start + r->len - size;
+    while(next_row < r.start + r.len)
+      {
+      filter_row(p, &s, next_row);
+      next_row++;
+      }
     
-    r->len -= diff;
-    r->coeffs_index += diff;
-    }
+    for(k = 0; k < GAVL_SSIM_MOMENTS; k++)
+      {
+      for(t = 0; t < r.len; t++)
+        src[t] = s.ring[(r.start + t) % SSIM_GAUSS_TAPS][k];
+      p->funcs->filter_v(src, s.filtered[k],
+                         s.coeffs[r.coeffs_index], r.len, p->width);
+      }
 
-  r->w = ssim_gauss_coeffs[r->coeffs_index];
+    p->row_sums[i] =
+      p->funcs->ssim((const float * const *)s.filtered,
+                     p->map ?
+                     (float*)((uint8_t*)p->map + i * p->map_stride) : NULL,
+                     p->width, C1, C2, p->cs ? &p->cs_sums[i] : NULL);
+    }
+  free(s.mem);
+  }
 
+void gavl_ssim_funcs_init(gavl_ssim_funcs_t * funcs, int accel_flags)
+  {
+  gavl_init_ssim_funcs_c(funcs);
+#ifdef HAVE_SSE2
+  if(accel_flags & GAVL_ACCEL_SSE2)
+    gavl_init_ssim_funcs_sse2(funcs);
+#endif
   }
 
-int gavl_video_frame_ssim(const gavl_video_frame_t * x,
-                          const gavl_video_frame_t * y,
-                          gavl_video_frame_t * dst,
-                          const gavl_video_format_t * format)
+int gavl_ssim_init_planes(gavl_ssim_plane_t * planes,
+                          const gavl_video_frame_t * src1,
+                          const gavl_video_frame_t * src2,
+                          const gavl_video_format_t * format,
+                          const gavl_ssim_funcs_t * funcs)
   {
-  int i, j;
+  int i, num_planes, bytes, sub_h, sub_v;
+
+  switch(format->pixelformat)
+    {
+    case GAVL_GRAY_8:
+      num_planes = 1;
+      bytes = 1;
+      break;
+    case GAVL_GRAY_16:
+      num_planes = 1;
+      bytes = 2;
+      break;
+    case GAVL_GRAY_FLOAT:
+      num_planes = 1;
+      bytes = 4;
+      break;
+    case GAVL_YUV_420_P:
+    case GAVL_YUV_410_P:
+    case GAVL_YUV_411_P:
+    case GAVL_YUV_422_P:
+    case GAVL_YUV_444_P:
+    case GAVL_YUVJ_420_P:
+    case GAVL_YUVJ_422_P:
+    case GAVL_YUVJ_444_P:
+      num_planes = 3;
+      bytes = 1;
+      break;
+    case GAVL_YUV_420_P_16:
+    case GAVL_YUV_422_P_16:
+    case GAVL_YUV_444_P_16:
+      num_planes = 3;
+      bytes = 2;
+      break;
+    default:
+      return 0;
+    }
 
-  double sigma_x, sigma_y, mu_x, mu_y, sigma_xy;
-  range_t ri, rj;
-  float * dst_ptr;
+  gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
   
-  const float * data_x;
-  const float * data_y;
-  const float * data_start_x;
-  const float * data_start_y;
+  for(i = 0; i < num_planes; i++)
+    {
+    memset(&planes[i], 0, sizeof(planes[i]));
+    planes[i].src1    = src1->planes[i];
+    planes[i].src2    = src2->planes[i];
+    planes[i].stride1 = src1->strides[i];
+    planes[i].stride2 = src2->strides[i];
+    planes[i].width   = format->image_width;
+    planes[i].height  = format->image_height;
+    planes[i].bytes   = bytes;
+    planes[i].funcs   = funcs;
+    
+    if(i)
+      {
+      planes[i].width  /= sub_h;
+      planes[i].height /= sub_v;
+      }
+    
+    if((planes[i].width < GAVL_SSIM_MIN_SIZE) ||
+       (planes[i].height < GAVL_SSIM_MIN_SIZE))
+      return 0;
+    }
+  return num_planes;
+  }
 
-  /* Dynamic range is 1.0 for our grayscale images */
-  const float C1 = K1 * K1;
-  const float C2 = K2 * K2;
+void gavl_ssim_add_jobs(gavl_ssim_plane_t * plane, gavl_video_jobs_t * jobs)
+  {
+  plane->row_sums = malloc(plane->height * sizeof(*plane->row_sums));
+  if(plane->cs)
+    plane->cs_sums = malloc(plane->height * sizeof(*plane->cs_sums));
+  gavl_video_jobs_add(jobs, ssim_rows, plane, plane->height);
+  }
 
-  int stride_x, stride_y;
+/* Sum up in a fixed order, so the result doesn't depend on the threads */
 
-  stride_x = x->strides[0] / sizeof(float);
-  stride_y = y->strides[0] / sizeof(float);
+static double get_mean(double * sums, int width, int height)
+  {
+  int i;
+  double ret = 0.0;
+  for(i = 0; i < height; i++)
+    ret += sums[i];
+  free(sums);
+  return ret / ((double)width * height);
+  }
+
+void gavl_ssim_get_result(gavl_ssim_plane_t * plane, double * ssim,
+                          double * cs)
+  {
+  *ssim = get_mean(plane->row_sums, plane->width, plane->height);
+  plane->row_sums = NULL;
+
+  if(plane->cs)
+    {
+    *cs = get_mean(plane->cs_sums, plane->width, plane->height);
+    plane->cs_sums = NULL;
+    }
+  }
+
+static int do_ssim(const gavl_video_frame_t * x,
+                   const gavl_video_frame_t * y,
+                   gavl_video_frame_t * dst,
+                   const gavl_video_format_t * format,
+                   const gavl_video_options_t * opt,
+                   double * ssim)
+  {
+  int i, num_planes;
+  gavl_ssim_funcs_t funcs;
+  gavl_ssim_plane_t planes[GAVL_SSIM_MAX_PLANES];
+  double ssim_priv[GAVL_SSIM_MAX_PLANES];
+  gavl_video_jobs_t jobs;
+  gavl_thread_pool_t * tp = NULL;
+  gavl_thread_pool_t * tp_priv = NULL;
   
-  if(format->pixelformat != GAVL_GRAY_FLOAT)
+  gavl_ssim_funcs_init(&funcs,
+                       opt ? opt->accel_flags : gavl_accel_supported());
+  
+  if(!(num_planes = gavl_ssim_init_planes(planes, x, y, format, &funcs)))
     return 0;
 
-  if((format->image_width < SSIM_GAUSS_TAPS) ||
-     (format->image_height < SSIM_GAUSS_TAPS))
-    return 0;
-  
-  for(i = 0; i < format->image_height; i++)
+  if(dst)
     {
-    dst_ptr = (float*)(dst->planes[0] + i * dst->strides[0]);
-    setup_range(&ri, i, format->image_height);
-    
-    data_start_x = (float*)(x->planes[0] + ri.start * x->strides[0]);
-    data_start_y = (float*)(y->planes[0] + ri.start * y->strides[0]);
-    
-    for(j = 0; j < format->image_width; j++)
-      {
-      setup_range(&rj, j, format->image_width);
-
-      data_x = data_start_x + rj.start;
-      data_y = data_start_y + rj.start;
-      
-      mu_x = get_mu(&ri, &rj, data_x, stride_x);
-      mu_y = get_mu(&ri, &rj, data_y, stride_y);
-      sigma_x =  get_sigma(&ri, &rj, data_x, stride_x, mu_x);
-      sigma_y =  get_sigma(&ri, &rj, data_y, stride_y, mu_y);
-      sigma_xy = get_sigma_xy(&ri, &rj,
-                              data_x, stride_x,
-                              data_y, stride_y,
-                              mu_x, mu_y);
-      
-      /* Wang, eq. 13 */
-      
-      *dst_ptr = (2.0*mu_x*mu_y+C1)*(2.0*sigma_xy+C2) /
-        ((mu_x*mu_x+mu_y*mu_y+C1)*(sigma_x*sigma_x+sigma_y*sigma_y+C2));
-      dst_ptr++;
-      }
+    /* Only the luminance */
+    num_planes = 1;
+    planes[0].map = (float*)dst->planes[0];
+    planes[0].map_stride = dst->strides[0];
     }
+
+  if(!ssim)
+    ssim = ssim_priv;
+  
+  memset(&jobs, 0, sizeof(jobs));
+  if(opt)
+    tp = opt->tp;
+  if(!tp)
+    tp = tp_priv = gavl_thread_pool_get_shared();
+  
+  gavl_video_jobs_reset(&jobs);
+  for(i = 0; i < num_planes; i++)
+    gavl_ssim_add_jobs(&planes[i], &jobs);
   
-  return 1;
+  gavl_video_jobs_run(&jobs, tp);
+
+  for(i = 0; i < num_planes; i++)
+    gavl_ssim_get_result(&planes[i], &ssim[i], NULL);
+
+  gavl_video_jobs_free(&jobs);
+  if(tp_priv)
+    gavl_thread_pool_destroy(tp_priv);
+  return num_planes;
+  }
+
+int gavl_video_frame_ssim(const gavl_video_frame_t * x,
+                          const gavl_video_frame_t * y,
+                          gavl_video_frame_t * dst,
+                          const gavl_video_format_t * format)
+  {
+  return !!do_ssim(x, y, dst, format, NULL, NULL);
+  }
+
+int gavl_video_frame_ssim_mean(double * ssim,
+                               const gavl_video_frame_t * x,
+                               const gavl_video_frame_t * y,
+                               const gavl_video_format_t * format,
+                               const gavl_video_options_t * opt)
+  {
+  return do_ssim(x, y, NULL, format, opt, ssim);
   }
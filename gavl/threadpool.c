@@ -22,54 +22,234 @@
 
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <gavl/gavl.h>
 #include <gavl/threadpool.h>
 #include <gavl/utils.h>
 
-//#include <gmerlin/parameter.h>
-//#include <gmerlin/bggavl.h>
-//#include <gmerlin/bg_sem.h>
+/*
+ *  Task queue with work stealing
+ *
+ *  Each worker has a deque of tasks. It takes tasks from the back
+ *  of its own deque and, if that is empty, steals from the front
+ *  of the other deques. Threads waiting for a group of tasks
+ *  (gavl_thread_pool_stop(), gavl_thread_pool_parallel_for()) don't
+ *  sleep as long as there is work left in the queues.
+ */
+
+/* Default number of parallel_for chunks per thread */
+#define CHUNKS_PER_THREAD 4
 
-#include <semaphore.h>
+/* Tasks, which are waited for together */
+
+typedef struct group_s
+  {
+  int remaining; // Protected by the pool mutex
+  struct group_s * next;
+  } group_t;
 
 typedef struct
   {
-  pthread_t t;
-  sem_t run_sem;
-  sem_t done_sem;
-  pthread_mutex_t stop_mutex;
-  int do_stop;
   void (*func)(void*, int, int);
   void * data;
   int start;
-  int len;
+  int end;
+  group_t * group;
+  } task_t;
+
+typedef struct
+  {
+  pthread_t t;
+  gavl_thread_pool_t * p;
+  int index;
+
+  pthread_mutex_t mutex;
+  task_t * tasks;
+  int tasks_alloc;
+  int head; // Next task to steal
+  int tail; // One behind the last task
   } thread_t;
 
+/*
+ *  The slots used by gavl_thread_pool_run() and gavl_thread_pool_stop()
+ *  belong to the pool. Since a pool can be used by several converters,
+ *  which might run in different threads, only one caller at a time can
+ *  use them: The first gavl_thread_pool_run() of a round
+ *  blocks until the previous round is finished, the last
+ *  gavl_thread_pool_stop() ends the round. gavl_thread_pool_parallel_for()
+ *  doesn't need the slots and isn't serialized.
+ *
+ *  The owner can start a nested round on the same slot from a task it
+ *  runs while waiting. So each gavl_thread_pool_run() gets its own
+ *  group, which is pushed onto a stack per slot and popped by the
+ *  matching gavl_thread_pool_stop().
+ */
+
 struct gavl_thread_pool_s
   {
   int num_threads;
   thread_t * threads;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t work_cond;  // Signalled when tasks are queued
+  pthread_cond_t done_cond;  // Signalled when a group is finished
+
+  int queued;       // Number of tasks in all deques
+  int do_stop;
+  int next_thread;  // Deque for the next parallel_for chunk
+  
+  int refcount;
+
+  group_t ** slots;   // Stack of running groups per thread
+  group_t * free_groups;
+  int busy;          // A round is in progress
+  pthread_t owner;   // Thread, which started the round
+  int pending;       // Number of jobs not yet stopped
   };
 
-static void * thread_func(void * data)
+static gavl_thread_pool_t * shared_pool = NULL;
+static pthread_once_t shared_pool_once = PTHREAD_ONCE_INIT;
+
+static void push_task(gavl_thread_pool_t * p, int thread, const task_t * task)
   {
-  thread_t * t = data;
-  int do_stop;
+  thread_t * t = &p->threads[thread];
+
+  pthread_mutex_lock(&t->mutex);
+  if(t->tail == t->tasks_alloc)
+    {
+    if(t->head)
+      {
+      memmove(t->tasks, t->tasks + t->head,
+              (t->tail - t->head) * sizeof(*t->tasks));
+      t->tail -= t->head;
+      t->head = 0;
+      }
+    else
+      {
+      t->tasks_alloc += 64;
+      t->tasks = realloc(t->tasks, t->tasks_alloc * sizeof(*t->tasks));
+      }
+    }
+  t->tasks[t->tail++] = *task;
+  pthread_mutex_unlock(&t->mutex);
+
+  pthread_mutex_lock(&p->mutex);
+  p->queued++;
+  pthread_cond_signal(&p->work_cond);
+  pthread_mutex_unlock(&p->mutex);
+  }
+
+/* Get a task from the own deque (if self >= 0) or steal one. */
+
+static int get_task(gavl_thread_pool_t * p, int self, task_t * ret)
+  {
+  int i;
+  int found = 0;
+  thread_t * t;
+
+  if(self >= 0)
+    {
+    t = &p->threads[self];
+    pthread_mutex_lock(&t->mutex);
+    if(t->tail > t->head)
+      {
+      *ret = t->tasks[--t->tail];
+      found = 1;
+      }
+    pthread_mutex_unlock(&t->mutex);
+    }
+  else
+    self = 0;
+  
+  for(i = 0; !found && (i < p->num_threads); i++)
+    {
+    t = &p->threads[(self + i) % p->num_threads];
+    pthread_mutex_lock(&t->mutex);
+    if(t->tail > t->head)
+      {
+      *ret = t->tasks[t->head++];
+      if(t->head == t->tail)
+        t->head = t->tail = 0;
+      found = 1;
+      }
+    pthread_mutex_unlock(&t->mutex);
+    }
+
+  if(found)
+    {
+    pthread_mutex_lock(&p->mutex);
+    p->queued--;
+    pthread_mutex_unlock(&p->mutex);
+    }
+  return found;
+  }
+
+static void do_task(gavl_thread_pool_t * p, task_t * task)
+  {
+  task->func(task->data, task->start, task->end);
+
+  /* Submitted task: Nobody waits for it */
+  if(!task->group)
+    return;
+  
+  pthread_mutex_lock(&p->mutex);
+  task->group->remaining--;
+  if(!task->group->remaining)
+    pthread_cond_broadcast(&p->done_cond);
+  pthread_mutex_unlock(&p->mutex);
+  }
+
+/* Wait until all tasks of a group are done and help while waiting */
+
+static void wait_group(gavl_thread_pool_t * p, group_t * g)
+  {
+  task_t task;
+  
   while(1)
     {
-    //    fprintf(stderr, "thread_func %p\n", t->func);
+    if(get_task(p, -1, &task))
+      {
+      do_task(p, &task);
+      continue;
+      }
     
-    sem_wait(&t->run_sem);
+    pthread_mutex_lock(&p->mutex);
+    if(!g->remaining)
+      {
+      pthread_mutex_unlock(&p->mutex);
+      break;
+      }
+    if(!p->queued)
+      pthread_cond_wait(&p->done_cond, &p->mutex);
+    pthread_mutex_unlock(&p->mutex);
+    }
+  }
 
-    pthread_mutex_lock(&t->stop_mutex);
-    do_stop = t->do_stop;
-    pthread_mutex_unlock(&t->stop_mutex);
+static void * thread_func(void * data)
+  {
+  thread_t * t = data;
+  gavl_thread_pool_t * p = t->p;
+  task_t task;
+  
+  while(1)
+    {
+    if(get_task(p, t->index, &task))
+      {
+      do_task(p, &task);
+      continue;
+      }
 
-    if(do_stop)
+    pthread_mutex_lock(&p->mutex);
+    while(!p->queued && !p->do_stop)
+      pthread_cond_wait(&p->work_cond, &p->mutex);
+    
+    if(!p->queued && p->do_stop)
+      {
+      pthread_mutex_unlock(&p->mutex);
       break;
-    t->func(t->data, t->start, t->len);
-    sem_post(&t->done_sem);
+      }
+    pthread_mutex_unlock(&p->mutex);
     }
   return NULL;
   }
@@ -84,12 +264,18 @@ gavl_thread_pool_t * gavl_thread_pool_create(int num_threads)
 
   ret->num_threads = num_threads;
   ret->threads = calloc(num_threads, sizeof(*ret->threads));
+  ret->slots = calloc(num_threads, sizeof(*ret->slots));
+  ret->refcount = 1;
+
+  pthread_mutex_init(&ret->mutex, NULL);
+  pthread_cond_init(&ret->work_cond, NULL);
+  pthread_cond_init(&ret->done_cond, NULL);
 
   for(i = 0; i < ret->num_threads; i++)
     {
-    pthread_mutex_init(&ret->threads[i].stop_mutex, NULL);
-    sem_init(&ret->threads[i].run_sem, 0, 0);
-    sem_init(&ret->threads[i].done_sem, 0, 0);
+    ret->threads[i].p = ret;
+    ret->threads[i].index = i;
+    pthread_mutex_init(&ret->threads[i].mutex, NULL);
     pthread_create(&ret->threads[i].t,
                    NULL,
                    thread_func, &ret->threads[i]);
@@ -97,6 +283,25 @@ gavl_thread_pool_t * gavl_thread_pool_create(int num_threads)
   return ret;
   }
 
+static void create_shared_pool(void)
+  {
+  shared_pool = gavl_thread_pool_create(-1);
+  }
+
+gavl_thread_pool_t * gavl_thread_pool_get_shared(void)
+  {
+  pthread_once(&shared_pool_once, create_shared_pool);
+  return gavl_thread_pool_ref(shared_pool);
+  }
+
+gavl_thread_pool_t * gavl_thread_pool_ref(gavl_thread_pool_t * p)
+  {
+  pthread_mutex_lock(&p->mutex);
+  p->refcount++;
+  pthread_mutex_unlock(&p->mutex);
+  return p;
+  }
+
 int gavl_thread_pool_get_num_threads(gavl_thread_pool_t * p)
   {
   return p->num_threads;
@@ -106,20 +311,39 @@ int gavl_thread_pool_get_num_threads(gavl_thread_pool_t * p)
 void gavl_thread_pool_destroy(gavl_thread_pool_t * p)
   {
   int i;
+
+  pthread_mutex_lock(&p->mutex);
+  p->refcount--;
+  i = p->refcount;
+  
+  if(i > 0)
+    {
+    pthread_mutex_unlock(&p->mutex);
+    return;
+    }
+  p->do_stop = 1;
+  pthread_cond_broadcast(&p->work_cond);
+  pthread_mutex_unlock(&p->mutex);
+  
   for(i = 0; i < p->num_threads; i++)
     {
-    pthread_mutex_lock(&p->threads[i].stop_mutex);
-    p->threads[i].do_stop = 1;
-    pthread_mutex_unlock(&p->threads[i].stop_mutex);
-    
-    sem_post(&p->threads[i].run_sem);
-    
     pthread_join(p->threads[i].t, NULL);
-    pthread_mutex_destroy(&p->threads[i].stop_mutex);
-    sem_destroy(&p->threads[i].run_sem);
-    sem_destroy(&p->threads[i].done_sem);
+    pthread_mutex_destroy(&p->threads[i].mutex);
+    if(p->threads[i].tasks)
+      free(p->threads[i].tasks);
     }
+  pthread_mutex_destroy(&p->mutex);
+  pthread_cond_destroy(&p->work_cond);
+  pthread_cond_destroy(&p->done_cond);
   free(p->threads);
+  free(p->slots);
+
+  while(p->free_groups)
+    {
+    group_t * g = p->free_groups;
+    p->free_groups = g->next;
+    free(g);
+    }
   free(p);
   }
 
@@ -128,19 +352,142 @@ void gavl_thread_pool_run(void (*func)(void*,int start, int len),
                         int start, int len,
                         void * client_data, int thread)
   {
+  task_t task;
+  group_t * g;
   gavl_thread_pool_t * p     = client_data;
 
-  p->threads[thread].func  = func;
-  p->threads[thread].data  = gavl_data;
-  p->threads[thread].start = start;
-  p->threads[thread].len   = len;
+  pthread_mutex_lock(&p->mutex);
+  if(!p->busy || !pthread_equal(p->owner, pthread_self()))
+    {
+    while(p->busy)
+      pthread_cond_wait(&p->done_cond, &p->mutex);
+    p->busy = 1;
+    p->owner = pthread_self();
+    }
+  p->pending++;
+
+  if(p->free_groups)
+    {
+    g = p->free_groups;
+    p->free_groups = g->next;
+    }
+  else
+    g = malloc(sizeof(*g));
   
-  sem_post(&p->threads[thread].run_sem);
+  g->remaining = 1;
+  g->next = p->slots[thread];
+  p->slots[thread] = g;
+  pthread_mutex_unlock(&p->mutex);
+
+  task.func  = func;
+  task.data  = gavl_data;
+  task.start = start;
+  task.end   = len;
+  task.group = g;
+  
+  push_task(p, thread, &task);
   }
 
 void gavl_thread_pool_stop(void * client_data, int thread)
   {
+  group_t * g;
   gavl_thread_pool_t * p     = client_data;
-  sem_wait(&p->threads[thread].done_sem);
+
+  pthread_mutex_lock(&p->mutex);
+  g = p->slots[thread];
+  pthread_mutex_unlock(&p->mutex);
+  
+  wait_group(p, g);
+  
+  pthread_mutex_lock(&p->mutex);
+  /* Nested rounds on this slot are stopped already */
+  p->slots[thread] = g->next;
+  g->next = p->free_groups;
+  p->free_groups = g;
+  
+  p->pending--;
+  if(!p->pending)
+    {
+    p->busy = 0;
+    pthread_cond_broadcast(&p->done_cond);
+    }
+  pthread_mutex_unlock(&p->mutex);
   }
 
+void gavl_thread_pool_submit(gavl_thread_pool_t * p,
+                             void (*func)(void*, int start, int end),
+                             void * data, int start, int end)
+  {
+  task_t task;
+  int thread;
+  
+  pthread_mutex_lock(&p->mutex);
+  thread = p->next_thread;
+  p->next_thread = (p->next_thread + 1) % p->num_threads;
+  pthread_mutex_unlock(&p->mutex);
+
+  task.func  = func;
+  task.data  = data;
+  task.start = start;
+  task.end   = end;
+  task.group = NULL;
+  push_task(p, thread, &task);
+  }
+
+int gavl_thread_pool_help(gavl_thread_pool_t * p)
+  {
+  task_t task;
+
+  if(!get_task(p, -1, &task))
+    return 0;
+  do_task(p, &task);
+  return 1;
+  }
+
+void gavl_thread_pool_parallel_for(gavl_thread_pool_t * p,
+                                   void (*func)(void*, int start, int end),
+                                   void * data,
+                                   int start, int end, int chunk)
+  {
+  task_t task;
+  group_t g;
+  int thread;
+  
+  if(end <= start)
+    return;
+  
+  if(chunk < 1)
+    {
+    chunk = (end - start) / (p->num_threads * CHUNKS_PER_THREAD);
+    if(chunk < 1)
+      chunk = 1;
+    }
+
+  /* Only one chunk: Don't bother the pool */
+  if(end - start <= chunk)
+    {
+    func(data, start, end);
+    return;
+    }
+  
+  g.remaining = (end - start + chunk - 1) / chunk;
+  
+  pthread_mutex_lock(&p->mutex);
+  thread = p->next_thread;
+  p->next_thread = (p->next_thread + 1) % p->num_threads;
+  pthread_mutex_unlock(&p->mutex);
+  
+  task.func  = func;
+  task.data  = data;
+  task.group = &g;
+  
+  for(task.start = start; task.start < end; task.start += chunk)
+    {
+    task.end = task.start + chunk;
+    if(task.end > end)
+      task.end = end;
+    push_task(p, thread, &task);
+    thread = (thread + 1) % p->num_threads;
+    }
+  wait_group(p, &g);
+  }
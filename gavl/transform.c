@@ -55,29 +55,28 @@ void gavl_image_transform_destroy(gavl_image_transform_t * t)
       }
     }
 
+  gavl_video_jobs_free(&t->jobs);
+  
   if(t->tp_priv)
     gavl_thread_pool_destroy(t->tp_priv);
   
   free(t);
   }
 
-/** \brief Destroy a transformation engine
- *  \param A transformation engine
- *  \param Format (can be changed)
- *  \param func Coordinate transform function
- *  \param priv The priv argument for func
- */
+/* Either func or matrix is used */
 
-int gavl_image_transform_init(gavl_image_transform_t * t,
-                               gavl_video_format_t * format,
-                               gavl_image_transform_func func, void * priv)
+static int transform_init(gavl_image_transform_t * t,
+                          gavl_video_format_t * format,
+                          gavl_image_transform_func func, void * priv,
+                          const double matrix[3][3])
   {
   int i, j;
   gavl_video_options_t opt;
 
   if(!t->opt.tp)
     {
-    t->tp_priv = gavl_thread_pool_create(-1);
+    if(!t->tp_priv)
+      t->tp_priv = gavl_thread_pool_get_shared();
     t->opt.tp = t->tp_priv;
     }
   
@@ -132,12 +131,42 @@ int gavl_image_transform_init(gavl_image_transform_t * t,
   for(i = 0; i < t->num_fields; i++)
     for(j = 0; j < t->num_planes; j++)
       {
-      if(!gavl_transform_context_init(t, &opt, i, j, func, priv))
+      if(!gavl_transform_context_init(t, &opt, i, j, func, priv, matrix))
         return 0;
       }
   return 1;
   }
 
+/** \brief Destroy a transformation engine
+ *  \param A transformation engine
+ *  \param Format (can be changed)
+ *  \param func Coordinate transform function
+ *  \param priv The priv argument for func
+ */
+
+int gavl_image_transform_init(gavl_image_transform_t * t,
+                               gavl_video_format_t * format,
+                               gavl_image_transform_func func, void * priv)
+  {
+  return transform_init(t, format, func, priv, NULL);
+  }
+
+int gavl_image_transform_init_matrix(gavl_image_transform_t * t,
+                                     gavl_video_format_t * format,
+                                     const double matrix[3][3])
+  {
+  return transform_init(t, format, NULL, NULL, matrix);
+  }
+
+void gavl_image_transform_set_matrix(gavl_image_transform_t * t,
+                                     const double matrix[3][3])
+  {
+  int i, j;
+  for(i = 0; i < t->num_fields; i++)
+    for(j = 0; j < t->num_planes; j++)
+      gavl_transform_context_set_matrix(&t->contexts[i][j], matrix);
+  }
+
 /** \brief Transform an image
  *  \param A transformation engine
  *  \param Input frame
@@ -166,13 +195,15 @@ void gavl_image_transform_transform(gavl_image_transform_t * t,
   else
     num_fields = 2;
 
+  gavl_video_jobs_reset(&t->jobs);
+  
   if(num_fields == 1)
     {
     for(j = 0; j < t->num_planes; j++)
       {
       //      fprintf(stderr, "Transform: %d\n", field);
-      gavl_transform_context_transform(&t->contexts[field][j],
-                                       in_frame, out_frame);
+      gavl_transform_context_add_jobs(&t->contexts[field][j], &t->jobs,
+                                      in_frame, out_frame);
       }
     }
   else
@@ -181,12 +212,14 @@ void gavl_image_transform_transform(gavl_image_transform_t * t,
       {
       for(j = 0; j < t->num_planes; j++)
         {
-        gavl_transform_context_transform(&t->contexts[i][j],
-                                         in_frame, out_frame);
+        gavl_transform_context_add_jobs(&t->contexts[i][j], &t->jobs,
+                                        in_frame, out_frame);
         }
       }
     }
-  
+
+  /* All planes and fields in one parallel loop */
+  gavl_video_jobs_run(&t->jobs, t->opt.tp);
   }
 
 gavl_video_options_t *
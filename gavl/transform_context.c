@@ -33,6 +33,10 @@ static gavl_transform_scanline_func get_func(gavl_transform_funcs_t * tab,
   {
   switch(pixelformat)
     {
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+    case GAVL_P016:
     case GAVL_PIXELFORMAT_NONE:
       break;
     case GAVL_RGB_15:
@@ -94,6 +98,7 @@ static gavl_transform_scanline_func get_func(gavl_transform_funcs_t * tab,
       break;
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
       *bits = tab->bits_uint16_x_1;
       return tab->transform_uint16_x_1;
       break;
@@ -129,12 +134,68 @@ static gavl_transform_scanline_func get_func(gavl_transform_funcs_t * tab,
   }
 
 
+/* The compact tables round the source positions to 1/TRANSFORM_PHASES
+   pixels. This is fine for 8 bit, but not for 16 bit and float formats,
+   which get full precision tables */
+
+static int is_precise(gavl_pixelformat_t pixelformat)
+  {
+  switch(pixelformat)
+    {
+    case GAVL_GRAY_16:
+    case GAVL_GRAYA_32:
+    case GAVL_YUV_444_P_16:
+    case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_RGB_48:
+    case GAVL_RGBA_64:
+    case GAVL_YUVA_64:
+    case GAVL_GRAY_FLOAT:
+    case GAVL_GRAYA_FLOAT:
+    case GAVL_YUV_FLOAT:
+    case GAVL_RGB_FLOAT:
+    case GAVL_RGBA_FLOAT:
+    case GAVL_YUVA_FLOAT:
+      return 1;
+    default:
+      break;
+    }
+  return 0;
+  }
+
+/* The affine kernels calculate the source positions themselves,
+   so they exist only for a few common formats */
+
+static gavl_transform_affine_func
+get_affine_func(gavl_transform_funcs_t * tab,
+                gavl_pixelformat_t pixelformat)
+  {
+  switch(pixelformat)
+    {
+    case GAVL_YUV_420_P:
+    case GAVL_YUV_422_P:
+    case GAVL_YUV_444_P:
+    case GAVL_YUV_411_P:
+    case GAVL_YUV_410_P:
+    case GAVL_YUVJ_420_P:
+    case GAVL_YUVJ_422_P:
+    case GAVL_YUVJ_444_P:
+    case GAVL_GRAY_8:
+      return tab->affine_uint8_x_1;
+    case GAVL_YUVA_32:
+    case GAVL_RGBA_32:
+      return tab->affine_uint8_x_4;
+    default:
+      break;
+    }
+  return NULL;
+  }
+
 static void init_func_tab(gavl_video_options_t * opt,
                           gavl_transform_context_t * ctx,
                           gavl_transform_funcs_t * func_tab)
   {
-  if(!opt->quality)
-    memset(func_tab, 0, sizeof(*func_tab));
+  memset(func_tab, 0, sizeof(*func_tab));
   
   switch(ctx->tab.factors_per_pixel)
     {
@@ -150,7 +211,14 @@ static void init_func_tab(gavl_video_options_t * opt,
         gavl_init_transform_funcs_bilinear_mmx(func_tab, ctx->advance);
       if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_MMXEXT))
         gavl_init_transform_funcs_bilinear_mmxext(func_tab, ctx->advance);
-      
+#endif
+#ifdef HAVE_SSE2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_SSE2))
+        gavl_init_transform_funcs_bilinear_sse2(func_tab, ctx->advance);
+#endif
+#ifdef HAVE_AVX2
+      if((opt->quality < 3) && (opt->accel_flags & GAVL_ACCEL_AVX2))
+        gavl_init_transform_funcs_bilinear_avx2(func_tab, ctx->advance);
 #endif
       break;
     case 3:
@@ -183,7 +251,8 @@ int
 gavl_transform_context_init(gavl_image_transform_t * t,
                             gavl_video_options_t * opt,
                             int field_index, int plane_index,
-                            gavl_image_transform_func func, void * priv)
+                            gavl_image_transform_func func, void * priv,
+                            const double matrix[3][3])
   {
   gavl_transform_funcs_t func_tab;
   int bits = 0;
@@ -266,11 +335,25 @@ gavl_transform_context_init(gavl_image_transform_t * t,
       }
     }
 
-  gavl_transform_table_init(&ctx->tab, opt,
-                            func, priv,
-                            off_x, off_y, scale_x,
-                            scale_y,
-                            ctx->dst_width, ctx->dst_height);
+  ctx->off_x = off_x;
+  ctx->off_y = off_y;
+  ctx->scale_x = scale_x;
+  ctx->scale_y = scale_y;
+  
+  if(func)
+    gavl_transform_table_init(&ctx->tab, opt,
+                              func, priv,
+                              off_x, off_y, scale_x,
+                              scale_y,
+                              ctx->dst_width, ctx->dst_height,
+                              is_precise(t->format.pixelformat));
+  else
+    {
+    gavl_transform_table_init_matrix(&ctx->tab, opt,
+                                     ctx->dst_width, ctx->dst_height,
+                                     is_precise(t->format.pixelformat));
+    gavl_transform_context_set_matrix(ctx, matrix);
+    }
 
   /* Get function */
 
@@ -282,19 +365,54 @@ gavl_transform_context_init(gavl_image_transform_t * t,
 
   if(!ctx->func)
     return 0;
+
+  /* Only for bilinear: Sinc with order 1 has 2 taps as well */
+  if(!func && (opt->scale_mode == GAVL_SCALE_BILINEAR))
+    ctx->affine_func = get_affine_func(&func_tab, t->format.pixelformat);
+  else
+    ctx->affine_func = NULL;
   
   /* Now we know the bits, convert to int */
   if(bits)
-    gavl_transform_table_init_int(&ctx->tab,
-                                  bits, ctx->dst_width, ctx->dst_height);
+    gavl_transform_table_init_int(&ctx->tab, bits);
   return 1;
   }
 
+void gavl_transform_context_set_matrix(gavl_transform_context_t * ctx,
+                                       const double matrix[3][3])
+  {
+  gavl_transform_table_set_matrix(&ctx->tab, matrix,
+                                  ctx->off_x, ctx->off_y,
+                                  ctx->scale_x, ctx->scale_y);
+  }
+
+void gavl_transform_context_scanline(gavl_transform_context_t * ctx,
+                                     int y, int x, int num,
+                                     uint8_t * dest_start)
+  {
+  int n;
+  gavl_transform_pixel_t pixels[TRANSFORM_CHUNK_SIZE];
+
+  /* Expand the table in small pieces, which stay in the cache */
+  while(num > 0)
+    {
+    n = (num > TRANSFORM_CHUNK_SIZE) ? TRANSFORM_CHUNK_SIZE : num;
+    
+    gavl_transform_table_get_pixels(&ctx->tab, y, x, n, pixels);
+    ctx->func(ctx, pixels, n, dest_start);
+    
+    x += n;
+    num -= n;
+    dest_start += n * ctx->advance;
+    }
+  }
+
 static void func_1(void* p, int start, int end)
   {
   int i;
   uint8_t * dst_save;
   int dst_stride;
+  gavl_transform_affine_t pos;
   
   gavl_transform_context_t * ctx = p;
   dst_stride =
@@ -307,7 +425,11 @@ static void func_1(void* p, int start, int end)
   
   for(i = start; i < end; i++)
     {
-    ctx->func(ctx, ctx->tab.pixels[i], dst_save);
+    if(ctx->affine_func &&
+       gavl_transform_table_get_affine(&ctx->tab, i, &pos))
+      ctx->affine_func(ctx, &pos, i, dst_save);
+    else
+      gavl_transform_context_scanline(ctx, i, 0, ctx->dst_width, dst_save);
     dst_save += dst_stride;
     }
 #ifdef HAVE_MMX
@@ -319,71 +441,21 @@ static void func_1(void* p, int start, int end)
   }
 
 
-void gavl_transform_context_transform(gavl_transform_context_t * ctx,
-                                 const gavl_video_frame_t * src,
-                                 gavl_video_frame_t * dst)
+/* Add the scanlines to a job set, so all planes and fields
+   can be transformed in one parallel loop */
+
+void gavl_transform_context_add_jobs(gavl_transform_context_t * ctx,
+                                     gavl_video_jobs_t * jobs,
+                                     const gavl_video_frame_t * src,
+                                     gavl_video_frame_t * dst)
   {
-  int i;
-  /* Things set while transforming */
-  //  uint8_t * src; /* Beginning of plane */
-  //  int src_stride;
-  
-  //  uint8_t * dst; /* Current scanline */
-  //  int dst_stride;
-  
   ctx->src = src->planes[ctx->plane] +
     ctx->offset + ctx->field * src->strides[ctx->plane];
   
   ctx->src_stride = src->strides[ctx->plane] * ctx->num_fields;
-  
-  if(ctx->opt->tp)
-    {
-    int delta;
-    int scanline;
-    int nt;
-    
-    ctx->dst_frame = dst;
-    nt = gavl_thread_pool_get_num_threads(ctx->opt->tp);
-    if(nt > ctx->dst_height)
-      nt = ctx->dst_height;
-    
-    delta = ctx->dst_height / nt;
-    scanline = 0;
-    for(i = 0; i < nt - 1; i++)
-      {
-      gavl_thread_pool_run(func_1, ctx, scanline,
-                           scanline+delta, ctx->opt->tp, i);
-      scanline += delta;
-      }
-    gavl_thread_pool_run(func_1, ctx, scanline, ctx->dst_height,
-                         ctx->opt->tp, nt - 1);
-    
-    for(i = 0; i < nt; i++)
-      gavl_thread_pool_stop(ctx->opt->tp, i);
-    }
-  else
-    {
-    int dst_stride;
-    uint8_t * dst_save;
+  ctx->dst_frame = dst;
 
-    dst_save = dst->planes[ctx->plane] +
-      ctx->offset + ctx->field * dst->strides[ctx->plane];
-    
-    dst_stride = dst->strides[ctx->plane] * ctx->num_fields;
-    for(i = 0; i < ctx->dst_height; i++)
-      {
-      ctx->func(ctx, ctx->tab.pixels[i], dst_save);
-      dst_save += dst_stride;
-      }
-#ifdef HAVE_MMX
-    if(ctx->need_emms)
-      {
-      __asm__ __volatile__ ("emms");
-      // fprintf(stderr, "emms");
-      }
-#endif
-    }
-  
+  gavl_video_jobs_add(jobs, func_1, ctx, ctx->dst_height);
   }
 
 void
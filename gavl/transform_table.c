@@ -22,6 +22,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 
 #include <gavl/gavl.h>
 #include <video.h>
@@ -30,148 +31,217 @@
 
 #define ROUND(val) (val >= 0.0) ? (int)(val+0.5):(int)(val-0.5)
 
+/*
+ *  Weight vectors are indexed by the subpixel phase and the number of
+ *  taps shifted in from the left and right border:
+ *  ((shift_l * factors_per_pixel) + shift_r) * (TRANSFORM_PHASES + 1) + phase
+ */
+
 /* 1234 */
-/*  S340  */
-/*   S400 */
+/* S400 */
 
-static void shift_right(gavl_transform_pixel_t * p, int factors_per_pixel,
-                        int delta)
+static void shift_right(float * f, int factors_per_pixel, int delta)
   {
-  int i, j;
-  for(i = 0; i < factors_per_pixel; i++)
-    {
-    /* Sum up */
-    for(j = 1; j < delta; j++)
-      p->factors[i][0] += p->factors[i][j];
-    /* Shift */
-    for(j = 1; j < factors_per_pixel - delta; j++)
-      p->factors[i][j] = p->factors[i][j + delta];
-    /* Clear */
-    for(j = factors_per_pixel - delta; j < factors_per_pixel; j++)
-      p->factors[i][j] = 0.0;
-    }
-  p->index_x += delta;
+  int j;
+  /* Sum up */
+  for(j = 1; j <= delta; j++)
+    f[0] += f[j];
+  /* Shift */
+  for(j = 1; j < factors_per_pixel - delta; j++)
+    f[j] = f[j + delta];
+  /* Clear */
+  for(j = factors_per_pixel - delta; j < factors_per_pixel; j++)
+    f[j] = 0.0;
   }
 
 /*   1234 */
 /* 001S */
 
-static void shift_left(gavl_transform_pixel_t * p, int factors_per_pixel,
-                       int delta)
+static void shift_left(float * f, int factors_per_pixel, int delta)
   {
-  int i, j;
-
-  for(i = 0; i < factors_per_pixel; i++)
-    {
-    /* Sum up */
-    for(j = factors_per_pixel - delta; j < factors_per_pixel; j++)
-      p->factors[i][factors_per_pixel - 1 - delta] += p->factors[i][j];
-    /* Shift */
- 
-    for(j = factors_per_pixel - 1; j >= delta; j--)
-      p->factors[i][j] = p->factors[i][j - delta];
-    /* Clear */
-    for(j = 0; j < delta; j++)
-      p->factors[i][j] = 0.0;
-    }
-  p->index_x -= delta;
+  int j;
+  /* Sum up */
+  for(j = factors_per_pixel - delta; j < factors_per_pixel; j++)
+    f[factors_per_pixel - 1 - delta] += f[j];
+  /* Shift */
+  for(j = factors_per_pixel - 1; j >= delta; j--)
+    f[j] = f[j - delta];
+  /* Clear */
+  for(j = 0; j < delta; j++)
+    f[j] = 0.0;
   }
 
-static void shift_down(gavl_transform_pixel_t * p, int factors_per_pixel,
-                       int delta)
+static void init_weights(gavl_transform_table_t * tab,
+                         gavl_video_options_t * opt,
+                         gavl_video_scale_get_weight weight_func)
   {
-  int i, j;
+  int i, j, phase, shift_l, shift_r;
+  float * f;
+  double t, sum;
+  int fpp = tab->factors_per_pixel;
+  
+  tab->num_weights = fpp * fpp * (TRANSFORM_PHASES + 1);
+  tab->weights_f = malloc(tab->num_weights * fpp * sizeof(*tab->weights_f));
 
-  for(i = 0; i < factors_per_pixel; i++)
+  f = tab->weights_f;
+  
+  for(i = 0; i < tab->num_weights; i++)
     {
-    /* Sum up */
-    for(j = 1; j < delta; j++)
-      p->factors[0][i] += p->factors[j][i];
-    /* Shift */
-    for(j = 1; j < factors_per_pixel - delta; j++)
-      p->factors[j][i] = p->factors[j + delta][i];
-    /* Clear */
-    for(j = factors_per_pixel - delta; j < factors_per_pixel; j++)
-      p->factors[j][i] = 0.0;
+    phase   = i % (TRANSFORM_PHASES + 1);
+    shift_r = (i / (TRANSFORM_PHASES + 1)) % fpp;
+    shift_l = (i / (TRANSFORM_PHASES + 1)) / fpp;
+
+    /* Distance of the first tap */
+    t = (double)(fpp / 2) - (double)phase / (double)TRANSFORM_PHASES;
+    for(j = 0; j < fpp; j++)
+      {
+      f[j] = weight_func(opt, t);
+      t -= 1.0;
+      }
+
+    if(shift_l)
+      shift_right(f, fpp, shift_l);
+    if(shift_r)
+      shift_left(f, fpp, shift_r);
+
+    /* Normalize */
+    sum = 0.0;
+    for(j = 0; j < fpp; j++)
+      sum += f[j];
+    for(j = 0; j < fpp; j++)
+      f[j] /= sum;
     
+    f += fpp;
     }
-  p->index_y += delta;
   }
 
-static void shift_up(gavl_transform_pixel_t * p, int factors_per_pixel,
-                     int delta)
+/*
+ *  Get the first index and the weight vector for a source position
+ *  in 1/TRANSFORM_PHASES pixels, shifted by half a pixel. The nearest
+ *  pixel and the phase (1..TRANSFORM_PHASES) are taken from the integer.
+ */
+
+static int get_weights(int fpp, int pos, int size, int * index)
   {
-  int i, j;
+  int idx, phase, shift_l = 0, shift_r = 0;
 
-  for(i = 0; i < factors_per_pixel; i++)
+  phase = TRANSFORM_PHASES - (pos & (TRANSFORM_PHASES - 1));
+  idx = (pos >> TRANSFORM_PHASE_BITS) - (fpp >> 1);
+
+  /* Check left overshot */
+  if(idx < 0)
+    {
+    shift_l = -idx;
+    idx = 0;
+    }
+  /* Check right overshot */
+  if(idx + fpp > size)
     {
-    /* Sum up */
-    for(j = factors_per_pixel - delta; j < factors_per_pixel; j++)
-      p->factors[factors_per_pixel - 1 - delta][i] += p->factors[j][i];
-    /* Shift */
- 
-    for(j = factors_per_pixel - 1; j >= delta; j--)
-      p->factors[j][i] = p->factors[j - delta][i];
-    /* Clear */
-    for(j = 0; j < delta; j++)
-      p->factors[j][i] = 0.0;
+    shift_r = idx + fpp - size;
+    idx -= shift_r;
     }
-  p->index_y -= delta;
+  *index = idx;
+  return (shift_l * fpp + shift_r) * (TRANSFORM_PHASES + 1) + phase;
   }
 
-static void shift_borders(gavl_transform_table_t * tab,
-                          int width, int i, int height)
+/*
+ *  Full precision: Get the first index and the weights for a source
+ *  position in 1/2^32 pixels. The weights are interpolated between the
+ *  two neighboring phases. This is exact for bilinear and the error of
+ *  the other kernels is far below the float precision.
+ */
+
+#define FRAC_BITS (32 - TRANSFORM_PHASE_BITS)
+
+static inline void get_weights_precise(const gavl_transform_table_t * tab,
+                                       int64_t pos, int size, int * index,
+                                       float * f, int fpp)
   {
-  int j;
+  int j, w;
+  float frac;
+  const float * f1;
+  const float * f2;
+
+  frac = (float)(pos & ((1 << FRAC_BITS) - 1)) * (1.0f / (1 << FRAC_BITS));
+  
+  w = get_weights(fpp, (int)(pos >> FRAC_BITS) + TRANSFORM_PHASES / 2,
+                  size, index);
+
+  /* The phase decreases with the position. Phase 0 exists, so
+     the neighbor is always there */
+  f1 = tab->weights_f + w * fpp;
+  f2 = f1 - fpp;
+  
+  for(j = 0; j < fpp; j++)
+    f[j] = f1[j] + frac * (f2[j] - f1[j]);
+  }
 
-  for(j = 0; j < width; j++)
+/* Source indices and weights of a pixel, which is inside the source image */
+
+static inline void get_index(const gavl_transform_table_t * tab,
+                             int pos_x, int pos_y,
+                             int * index_x, int * index_y,
+                             int * wx, int * wy)
+  {
+  if(tab->factors_per_pixel == 1)
     {
-    /* Check left overshot */
-    if(tab->pixels[i][j].index_x < 0)
-      shift_right(&tab->pixels[i][j], tab->factors_per_pixel,
-                  -tab->pixels[i][j].index_x);
-      
-    /* Check right overshot */
-    if(tab->pixels[i][j].index_x + tab->factors_per_pixel > width)
-      shift_left(&tab->pixels[i][j], tab->factors_per_pixel,
-                 tab->pixels[i][j].index_x +
-                 tab->factors_per_pixel - width);
-      
-    /* Check top overshot */
-    if(tab->pixels[i][j].index_y < 0)
-      shift_down(&tab->pixels[i][j], tab->factors_per_pixel,
-                 -tab->pixels[i][j].index_y);
-      
-    /* Check bottom overshot */
-    if(tab->pixels[i][j].index_y + tab->factors_per_pixel > height)
-      shift_up(&tab->pixels[i][j], tab->factors_per_pixel,
-               tab->pixels[i][j].index_y +
-               tab->factors_per_pixel - height);
+    pos_x >>= TRANSFORM_PHASE_BITS;
+    pos_y >>= TRANSFORM_PHASE_BITS;
+    
+    *index_x = (pos_x < tab->width)  ? pos_x : tab->width - 1;
+    *index_y = (pos_y < tab->height) ? pos_y : tab->height - 1;
     }
+  else
+    {
+    *wx = get_weights(tab->factors_per_pixel, pos_x,
+                      tab->width, index_x);
+    *wy = get_weights(tab->factors_per_pixel, pos_y,
+                      tab->height, index_y);
+    }
+  }
+
+/*
+ *  Get the source position and weights for one pixel in plane
+ *  coordinates. Returns 0 if the position is outside the source image.
+ */
+
+#define TO_POS(f) (int)((f) * TRANSFORM_PHASES + (TRANSFORM_PHASES / 2 + 0.5))
+
+static inline int is_inside(const gavl_transform_table_t * tab,
+                            double x_src_f, double y_src_f)
+  {
+  return !((x_src_f < 0.0) || (x_src_f > (double)tab->width) || 
+           (y_src_f < 0.0) || (y_src_f > (double)tab->height));
+  }
+
+static inline int get_position(const gavl_transform_table_t * tab,
+                               double x_src_f, double y_src_f,
+                               int * index_x, int * index_y,
+                               int * wx, int * wy)
+  {
+  if(!is_inside(tab, x_src_f, y_src_f))
+    return 0;
+
+  get_index(tab, TO_POS(x_src_f), TO_POS(y_src_f),
+            index_x, index_y, wx, wy);
+  return 1;
   }
 
-static void normalize(gavl_transform_table_t * tab,
-                      int width, int i)
+/* Full precision positions in 1/2^32 pixels */
+
+#define FRAC_SCALE 4294967296.0 /* 2^32 */
+#define TO_PRECISE(f) (int64_t)((f) * FRAC_SCALE)
+
+static void set_precise(gavl_transform_entry_precise_t * e,
+                        double x_src_f, double y_src_f, int x, int y)
   {
-  int j, k, l;
-  float sum;
+  double x_i = floor(x_src_f);
+  double y_i = floor(y_src_f);
   
-  for(j = 0; j < width; j++)
-    {
-    sum = 0.0;
-    for(k = 0; k < tab->factors_per_pixel; k++)
-      {
-      for(l = 0; l < tab->factors_per_pixel; l++)
-        {
-        sum += tab->pixels[i][j].factors[k][l];
-        }
-      }
-    for(k = 0; k < tab->factors_per_pixel; k++)
-      {
-      for(l = 0; l < tab->factors_per_pixel; l++)
-        tab->pixels[i][j].factors[k][l] /= sum;
-      }
-    }
+  e->dx = (int)x_i - x;
+  e->dy = (int)y_i - y;
+  e->fx = (uint32_t)((x_src_f - x_i) * FRAC_SCALE);
+  e->fy = (uint32_t)((y_src_f - y_i) * FRAC_SCALE);
   }
 
 typedef struct
@@ -179,255 +249,518 @@ typedef struct
   float off_x;
   float off_y;
   float scale_x, scale_y;
-  int width;
-  int height;
   gavl_image_transform_func func;
-  gavl_video_scale_get_weight weight_func;
   gavl_transform_table_t * tab;
   void * func_priv;
-  gavl_video_options_t * opt;
   } slice_data_t;
 
 static void init_slice(void* p, int start, int end)
   {
-  int i, j, k, l;
+  int i, j;
   slice_data_t * sd = p;
-
+  gavl_transform_entry_t * e;
+  gavl_transform_table_t * tab = sd->tab;
+  
   double x_src_f, y_src_f, x_dst_f, y_dst_f;
-  int x_src_nearest, y_src_nearest;
-  double t;
-  double w_x[MAX_TRANSFORM_FILTER];
-  double w_y;
+  int index_x, index_y, wx = 0, wy = 0;
   
   for(i = start; i < end; i++)
     {
     y_dst_f = sd->scale_y * (double)i + sd->off_y;
-    for(j = 0; j < sd->width; j++)
+    e = tab->entries + i * tab->width;
+    
+    for(j = 0; j < tab->width; j++)
       {
       x_dst_f = sd->scale_x * (double)j + sd->off_x;
       
       sd->func(sd->func_priv, x_dst_f, y_dst_f, &x_src_f, &y_src_f);
 
-      //      fprintf(stderr, "Transform: src: %f %f -> dst: %f %f\n",
-      //              x_src_f, y_src_f, x_dst_f, y_dst_f);
-
-      //      x_src_f = (x_src_f - sd->off_x) / sd->scale_x;
-      //      y_src_f = (y_src_f - sd->off_y) / sd->scale_y;
-
       x_src_f = (x_src_f) / sd->scale_x;
       y_src_f = (y_src_f) / sd->scale_y;
-      
-      if((x_src_f < 0.0) || (x_src_f > (double)sd->width) || 
-         (y_src_f < 0.0) || (y_src_f > (double)sd->height))
-        {
-        sd->tab->pixels[i][j].outside = 1;
-        //        fprintf(stderr, "Outside\n");
-        continue;
-        }
-
-      /* ... */
-      x_src_nearest = ROUND(x_src_f);
-      y_src_nearest = ROUND(y_src_f);
 
-      sd->tab->pixels[i][j].index_x =
-        x_src_nearest - sd->tab->factors_per_pixel/2;
-      sd->tab->pixels[i][j].index_y =
-        y_src_nearest - sd->tab->factors_per_pixel/2;
-      
-      if(sd->tab->factors_per_pixel == 1)
+      if(tab->precise)
         {
-        if(sd->tab->pixels[i][j].index_x < 0)
-          sd->tab->pixels[i][j].index_x = 0;
-        if(sd->tab->pixels[i][j].index_x > sd->width - 1)
-          sd->tab->pixels[i][j].index_x = sd->width - 1;
-        if(sd->tab->pixels[i][j].index_y < 0)
-          sd->tab->pixels[i][j].index_y = 0;
-        if(sd->tab->pixels[i][j].index_y > sd->height - 1)
-          sd->tab->pixels[i][j].index_y = sd->height - 1;
+        if(is_inside(tab, x_src_f, y_src_f))
+          set_precise(&tab->entries_precise[i * tab->width + j],
+                      x_src_f, y_src_f, j, i);
+        else
+          tab->entries_precise[i * tab->width + j].dx = TRANSFORM_OUTSIDE;
         continue;
         }
       
-      /* x weights */
-      t = (x_src_f - 0.5 - sd->tab->pixels[i][j].index_x);
-      //      t = (x_src_f - sd->tab->pixels[i][j].index_x);
-      for(k = 0; k < sd->tab->factors_per_pixel; k++)
-        {
-        //        fprintf(stderr, "%d w_x(%f)\n", k, t);
-        
-        w_x[k] = sd->weight_func(sd->opt, t);
-
-
-        t -= 1.0;
-        }
-
-      t = (y_src_f - 0.5 - sd->tab->pixels[i][j].index_y);
-      //      t = (y_src_f - sd->tab->pixels[i][j].index_y);
-      
-      for(k = 0; k < sd->tab->factors_per_pixel; k++)
+      if(!get_position(tab, x_src_f, y_src_f,
+                       &index_x, &index_y, &wx, &wy))
         {
-        /* Y-weight */
-        w_y = sd->weight_func(sd->opt, t);
-        
-        //        fprintf(stderr, "%d w_y(%f)\n", k, t);
-        
-        for(l = 0; l < sd->tab->factors_per_pixel; l++)
-          sd->tab->pixels[i][j].factors[k][l] = w_y * w_x[l];
-        t -= 1.0;
+        e[j].dx = TRANSFORM_OUTSIDE;
+        continue;
         }
-      
+      e[j].wx = wx;
+      e[j].wy = wy;
+      e[j].dx = index_x - j;
+      e[j].dy = index_y - i;
       }
-    shift_borders(sd->tab, sd->width, i, sd->height);
-    normalize(sd->tab, sd->width, i);
     }
-  
   }
      
+/* Common part: Free the old table and create the weight vectors */
+
+static int init_common(gavl_transform_table_t * tab,
+                       gavl_video_options_t * opt,
+                       int width, int height, int precise)
+  {
+  gavl_video_scale_get_weight weight_func;
+  
+  /* (re)alloc */
+  
+  gavl_transform_table_free(tab);
+  
+  /* Get factors per pixel and filter_func */
+  weight_func =
+    gavl_video_scale_get_weight_func(opt, &tab->factors_per_pixel);
+  
+  if(tab->factors_per_pixel > MAX_TRANSFORM_FILTER)
+    {
+    fprintf(stderr, "BUG: tab->factors_per_pixel > MAX_TRANSFORM_FILTER\n");
+    return 0;
+    }
+
+  tab->width  = width;
+  tab->height = height;
+
+  /* Nearest neighbor has no weights */
+  tab->precise = precise && (tab->factors_per_pixel > 1);
+
+  if(tab->factors_per_pixel > 1)
+    init_weights(tab, opt, weight_func);
+  return 1;
+  }
+
 void gavl_transform_table_init(gavl_transform_table_t * tab,
                                gavl_video_options_t * opt,
                                gavl_image_transform_func func, void * priv,
                                float off_x, float off_y, float scale_x,
-                               float scale_y, int width, int height)
+                               float scale_y, int width, int height,
+                               int precise)
   {
-  int delta;
-  int scanline;
-  int nt;
-  int i;
-  
   slice_data_t sd;
-
+  
   sd.off_x = off_x;
   sd.off_y = off_y;
   sd.scale_x = scale_x;
   sd.scale_y = scale_y;
-  sd.width = width;
-  sd.height = height;
   sd.tab = tab;
   sd.func = func;
   sd.func_priv = priv;
-  sd.opt = opt;
   
-  /* (re)alloc */
+  if(!init_common(tab, opt, width, height, precise))
+    return;
+
+  if(tab->precise)
+    tab->entries_precise = calloc(width * height,
+                                  sizeof(*tab->entries_precise));
+  else
+    tab->entries = calloc(width * height, sizeof(*tab->entries));
   
-  gavl_transform_table_free(tab);
+  gavl_thread_pool_parallel_for(opt->tp, init_slice, &sd, 0, height, 0);
+  }
+
+void gavl_transform_table_init_matrix(gavl_transform_table_t * tab,
+                                      gavl_video_options_t * opt,
+                                      int width, int height, int precise)
+  {
+  init_common(tab, opt, width, height, precise);
+  }
+
+/*
+ *  Convert the matrix from frame coordinates to plane coordinates:
+ *  x_frame = scale_x * x_plane + off_x (same for y)
+ */
+
+void gavl_transform_table_set_matrix(gavl_transform_table_t * tab,
+                                     const double matrix[3][3],
+                                     float off_x, float off_y,
+                                     float scale_x, float scale_y)
+  {
+  int i;
+  double fac;
   
+  for(i = 0; i < 3; i++)
+    {
+    if(i == 0)
+      fac = 1.0 / scale_x;
+    else if(i == 1)
+      fac = 1.0 / scale_y;
+    else
+      fac = 1.0;
+    
+    tab->matrix[i][0] = fac * matrix[i][0] * scale_x;
+    tab->matrix[i][1] = fac * matrix[i][1] * scale_y;
+    tab->matrix[i][2] = fac * (matrix[i][0] * off_x +
+                               matrix[i][1] * off_y +
+                               matrix[i][2]);
+    }
+  }
+
+void gavl_transform_table_init_int(gavl_transform_table_t * tab,
+                                   int bits)
+  {
+  int i, j, fpp = tab->factors_per_pixel;
+  int * w;
   
-  /* Get factors per pixel and filter_func */
-  sd.weight_func =
-    gavl_video_scale_get_weight_func(opt, &tab->factors_per_pixel);
+  tab->bits = bits;
+
+  if((fpp < 2) || tab->precise)
+    return;
   
-  if(tab->factors_per_pixel > MAX_TRANSFORM_FILTER)
+  tab->weights_i   = malloc(tab->num_weights * fpp * sizeof(*tab->weights_i));
+  tab->weights_max = malloc(tab->num_weights * sizeof(*tab->weights_max));
+
+  w = tab->weights_i;
+  
+  for(i = 0; i < tab->num_weights; i++)
     {
-    fprintf(stderr, "BUG: tab->factors_per_pixel > MAX_TRANSFORM_FILTER\n");
-    return;
+    tab->weights_max[i] = 0;
+    for(j = 0; j < fpp; j++)
+      {
+      w[j] = ROUND(tab->weights_f[i * fpp + j] * 32768.0);
+      if(w[j] > w[tab->weights_max[i]])
+        tab->weights_max[i] = j;
+      }
+    w += fpp;
     }
+  }
+
+/* Inlined with constant fpp, so the loops get unrolled */
+
+static inline void expand_i(gavl_transform_pixel_t * ret,
+                            const int * wx, const int * wy,
+                            int max_x, int max_y,
+                            int fpp, int bits)
+  {
+  int k, l, sum = 0;
+  /* 15 bit x 15 bit -> bits */
+  int shift = 30 - bits;
+  int round = 1 << (shift - 1);
   
-  tab->pixels = malloc(height * sizeof(*tab->pixels));
-  tab->pixels[0] = calloc(width * height, sizeof(**tab->pixels));
-  
-  for(i = 1; i < height; i++)
-    tab->pixels[i] = tab->pixels[0] + i * width;
-
-  nt = gavl_thread_pool_get_num_threads(opt->tp);
-  if(nt > height)
-    nt = height;
-  if(nt < 1)
-    nt = 1;
+  for(k = 0; k < fpp; k++)
+    {
+    for(l = 0; l < fpp; l++)
+      {
+      ret->factors_i[k][l] = (wy[k] * wx[l] + round) >> shift;
+      sum += ret->factors_i[k][l];
+      }
+    }
+  /* Make the sum exactly 1.0 */
+  ret->factors_i[max_y][max_x] += (1 << bits) - sum;
+
+  /* A single factor of 1.0 doesn't fit into the signed 16 bit words
+     of the MMX functions */
+  if(ret->factors_i[max_y][max_x] == (1 << bits))
+    ret->factors_i[max_y][max_x]--;
+  }
+
+static inline void expand_f(gavl_transform_pixel_t * ret,
+                            const float * wx, const float * wy,
+                            int fpp)
+  {
+  int k, l;
+  for(k = 0; k < fpp; k++)
+    {
+    for(l = 0; l < fpp; l++)
+      ret->factors[k][l] = wy[k] * wx[l];
+    }
+  }
+
+/* Full precision: Get the weights for a source position in 1/2^32
+   pixels. The integer factors are rounded from the float ones.
+   Inlined with constant fpp like expand_i() */
+
+static inline void expand_precise(const gavl_transform_table_t * tab,
+                                  gavl_transform_pixel_t * ret,
+                                  int64_t x_src, int64_t y_src,
+                                  int fpp)
+  {
+  int k, l, sum = 0, max_k = 0, max_l = 0;
+  float wx[MAX_TRANSFORM_FILTER];
+  float wy[MAX_TRANSFORM_FILTER];
+  float fac_max_f;
+
+  get_weights_precise(tab, x_src, tab->width, &ret->index_x, wx, fpp);
+  get_weights_precise(tab, y_src, tab->height, &ret->index_y, wy, fpp);
   
-  delta = height / nt;
-  scanline = 0;
+  expand_f(ret, wx, wy, fpp);
+
+  if(!tab->bits)
+    return;
 
-  for(i = 0; i < nt - 1; i++)
+  fac_max_f = (float)(1 << tab->bits);
+  
+  for(k = 0; k < fpp; k++)
     {
-    gavl_thread_pool_run(init_slice, &sd, scanline, scanline+delta,
-                         opt->tp, i);
-        
-    scanline += delta;
+    for(l = 0; l < fpp; l++)
+      {
+      ret->factors_i[k][l] = ROUND(ret->factors[k][l] * fac_max_f);
+      sum += ret->factors_i[k][l];
+      if(ret->factors_i[k][l] > ret->factors_i[max_k][max_l])
+        {
+        max_k = k;
+        max_l = l;
+        }
+      }
+    }
+  /* Make the sum exactly 1.0 */
+  ret->factors_i[max_k][max_l] += (1 << tab->bits) - sum;
+
+  /* A single factor of 1.0 doesn't fit into the signed 16 bit words
+     of the MMX functions */
+  if(ret->factors_i[max_k][max_l] == (1 << tab->bits))
+    ret->factors_i[max_k][max_l]--;
+  }
+
+#define EXPAND(fpp)                                                     \
+  if(tab->bits)                                                         \
+    expand_i(ret, tab->weights_i + wx * fpp,                            \
+             tab->weights_i + wy * fpp,                                 \
+             tab->weights_max[wx], tab->weights_max[wy],                \
+             fpp, tab->bits);                                           \
+  else                                                                  \
+    expand_f(ret, tab->weights_f + wx * fpp,                            \
+             tab->weights_f + wy * fpp, fpp);
+
+/* Expanded inline for each pixel, so the weight vectors can be
+   unrolled for a constant factors_per_pixel */
+
+#define EXPAND_PIXEL                                                    \
+  switch(tab->factors_per_pixel)                                        \
+    {                                                                   \
+    case 2:                                                             \
+      EXPAND(2);                                                        \
+      break;                                                            \
+    case 3:                                                             \
+      EXPAND(3);                                                        \
+      break;                                                            \
+    case 4:                                                             \
+      EXPAND(4);                                                        \
+      break;                                                            \
+    }
+
+#define EXPAND_PRECISE(x_src, y_src)                                    \
+  switch(tab->factors_per_pixel)                                        \
+    {                                                                   \
+    case 2:                                                             \
+      expand_precise(tab, ret, x_src, y_src, 2);                        \
+      break;                                                            \
+    case 3:                                                             \
+      expand_precise(tab, ret, x_src, y_src, 3);                        \
+      break;                                                            \
+    case 4:                                                             \
+      expand_precise(tab, ret, x_src, y_src, 4);                        \
+      break;                                                            \
     }
-  gavl_thread_pool_run(init_slice, &sd, scanline, height,
-                       opt->tp, nt - 1);
+
+/* Fixed point positions in 1/TRANSFORM_PHASES pixels */
+
+#define FIXED_MAX  1048576.0 /* Keep far away from int64 overflows */
+#define STEP_MAX   1024.0    /* SIMD steps of 8 pixels must fit into 32 bit */
+#define TO_FIXED(f) \
+  llrint((f) * (double)(TRANSFORM_PHASES << TRANSFORM_FIXED_BITS))
+
+/*
+ *  Fixed point start position and steps of an affine scanline for the
+ *  SIMD kernels. Returns 0 if the matrix is not affine or the positions
+ *  don't fit.
+ */
+
+int gavl_transform_table_get_affine(const gavl_transform_table_t * tab,
+                                    int y, gavl_transform_affine_t * ret)
+  {
+  double src_x, src_y;
+  
+  if((tab->matrix[2][0] != 0.0) || (tab->matrix[2][1] != 0.0) ||
+     (tab->matrix[2][2] != 1.0))
+    return 0;
+
+  src_x = tab->matrix[0][1] * y + tab->matrix[0][2];
+  src_y = tab->matrix[1][1] * y + tab->matrix[1][2];
   
-  for(i = 0; i < nt; i++)
-    gavl_thread_pool_stop(opt->tp, i);
+  if((fabs(tab->matrix[0][0]) >= STEP_MAX) ||
+     (fabs(tab->matrix[1][0]) >= STEP_MAX) ||
+     (fabs(src_x) >= FIXED_MAX) || (fabs(src_y) >= FIXED_MAX) ||
+     (fabs(src_x + tab->width * tab->matrix[0][0]) >= FIXED_MAX) ||
+     (fabs(src_y + tab->width * tab->matrix[1][0]) >= FIXED_MAX))
+    return 0;
+
+  ret->x      = TO_FIXED(src_x);
+  ret->y      = TO_FIXED(src_y);
+  ret->step_x = TO_FIXED(tab->matrix[0][0]);
+  ret->step_y = TO_FIXED(tab->matrix[1][0]);
+  return 1;
   }
 
-void gavl_transform_table_init_int(gavl_transform_table_t * tab,
-                                   int bits, int width, int height)
+/*
+ *  No table: The source coordinates are calculated from the matrix.
+ *  They are updated incrementally along the scanline and
+ *  recalculated at the start of each chunk.
+ */
+
+static void get_pixels_matrix(const gavl_transform_table_t * tab,
+                              int y, int x, int num,
+                              gavl_transform_pixel_t * ret)
   {
-  int fac_max_i, i, j, k, l;
-  float fac_max_f, sum_f;
-  int sum_i;
-  int min_index_k, max_index_k;
-  int min_index_l, max_index_l;
+  int i, wx = 0, wy = 0;
+  double src_x, src_y, src_w;
+  gavl_transform_affine_t a;
+  
+  src_x = tab->matrix[0][0] * x + tab->matrix[0][1] * y + tab->matrix[0][2];
+  src_y = tab->matrix[1][0] * x + tab->matrix[1][1] * y + tab->matrix[1][2];
+  src_w = tab->matrix[2][0] * x + tab->matrix[2][1] * y + tab->matrix[2][2];
   
-  //  fac_max_i = (1<<bits) - 1;
-  //  fprintf(stderr, "Init int %d\n", bits);
-  fac_max_i = (1<<bits);
-  fac_max_f = (float)(fac_max_i);
+  /* Affine: The positions are stepped in fixed point. Not for full
+     precision, where they would be rounded to the phases */
+  if(!tab->precise && gavl_transform_table_get_affine(tab, y, &a))
+    {
+    int64_t pos_x, pos_y, max_x, max_y;
+    const int64_t round =
+      ((int64_t)(TRANSFORM_PHASES / 2) << TRANSFORM_FIXED_BITS) +
+      (1 << (TRANSFORM_FIXED_BITS - 1));
+
+    pos_x = TO_FIXED(src_x);
+    pos_y = TO_FIXED(src_y);
+    max_x = (int64_t)tab->width  * TRANSFORM_PHASES << TRANSFORM_FIXED_BITS;
+    max_y = (int64_t)tab->height * TRANSFORM_PHASES << TRANSFORM_FIXED_BITS;
+    
+    for(i = 0; i < num; i++)
+      {
+      if((pos_x < 0) || (pos_x > max_x) || (pos_y < 0) || (pos_y > max_y))
+        ret->outside = 1;
+      else
+        {
+        get_index(tab,
+                  (pos_x + round) >> TRANSFORM_FIXED_BITS,
+                  (pos_y + round) >> TRANSFORM_FIXED_BITS,
+                  &ret->index_x, &ret->index_y, &wx, &wy);
+        ret->outside = 0;
+        EXPAND_PIXEL;
+        }
+      pos_x += a.step_x;
+      pos_y += a.step_y;
+      ret++;
+      }
+    return;
+    }
   
-  for(i = 0; i < height; i++)
+  for(i = 0; i < num; i++)
     {
-    for(j = 0; j < width; j++)
+    /* w <= 0 is behind the viewer */
+    if(src_w <= 0.0)
+      ret->outside = 1;
+    else if(tab->precise)
+      {
+      if(is_inside(tab, src_x / src_w, src_y / src_w))
+        {
+        ret->outside = 0;
+        EXPAND_PRECISE(TO_PRECISE(src_x / src_w), TO_PRECISE(src_y / src_w));
+        }
+      else
+        ret->outside = 1;
+      }
+    else if(get_position(tab, src_x / src_w, src_y / src_w,
+                         &ret->index_x, &ret->index_y, &wx, &wy))
       {
-      //      if(tab->pixels[i][j].outside)
-      //       continue;
+      ret->outside = 0;
+      EXPAND_PIXEL;
+      }
+    else
+      ret->outside = 1;
 
-      if(tab->pixels[i][j].outside)
-        continue;
-      
-      min_index_k = 0;
-      max_index_k = 0;
-      min_index_l = 0;
-      max_index_l = 0;
-      
-      sum_i = 0;
-      sum_f = 0.0;
-      
-      for(k = 0; k < tab->factors_per_pixel; k++)
+    src_x += tab->matrix[0][0];
+    src_y += tab->matrix[1][0];
+    src_w += tab->matrix[2][0];
+    ret++;
+    }
+  }
+
+void gavl_transform_table_get_pixels(const gavl_transform_table_t * tab,
+                                     int y, int x, int num,
+                                     gavl_transform_pixel_t * ret)
+  {
+  int i, wx, wy;
+  const gavl_transform_entry_t * e;
+  const gavl_transform_entry_precise_t * ep;
+
+  if(tab->entries_precise)
+    {
+    ep = tab->entries_precise + y * tab->width + x;
+
+    for(i = 0; i < num; i++)
+      {
+      if(ep->dx == TRANSFORM_OUTSIDE)
+        ret->outside = 1;
+      else
         {
-        for(l = 0; l < tab->factors_per_pixel; l++)
-          {
-          tab->pixels[i][j].factors_i[k][l] =
-            (int)(fac_max_f * tab->pixels[i][j].factors[k][l]+0.5);
-          sum_i += tab->pixels[i][j].factors_i[k][l];
-          sum_f += tab->pixels[i][j].factors[k][l];
-
-          if(k || l)
-            {
-            if(tab->pixels[i][j].factors_i[k][l] >
-               tab->pixels[i][j].factors_i[max_index_k][max_index_l])
-              {
-              max_index_k = k;
-              max_index_l = l;
-              }
-            if(tab->pixels[i][j].factors_i[k][l] <
-               tab->pixels[i][j].factors_i[min_index_k][min_index_l])
-              {
-              min_index_k = k;
-              min_index_l = l;
-              }
-            }
-          }
+        ret->outside = 0;
+        EXPAND_PRECISE(((int64_t)(x + i + ep->dx) << 32) + ep->fx,
+                       ((int64_t)(y + ep->dy) << 32) + ep->fy);
         }
-      
-      if(sum_i > fac_max_i)
-        tab->pixels[i][j].factors_i[max_index_k][max_index_l]
-          -= (sum_i - fac_max_i);
-      else if(sum_i < fac_max_i)
-        tab->pixels[i][j].factors_i[min_index_k][min_index_l]
-          += (fac_max_i - sum_i);
-      //  gavl_video_scale_table_dump_int(tab);
+      ep++;
+      ret++;
+      }
+    return;
+    }
+  
+  if(!tab->entries)
+    {
+    get_pixels_matrix(tab, y, x, num, ret);
+    return;
+    }
+  
+  e = tab->entries + y * tab->width + x;
+
+  for(i = 0; i < num; i++)
+    {
+    if(e->dx == TRANSFORM_OUTSIDE)
+      ret->outside = 1;
+    else
+      {
+      ret->outside = 0;
+      ret->index_x = x + i + e->dx;
+      ret->index_y = y + e->dy;
+      wx = e->wx;
+      wy = e->wy;
+      EXPAND_PIXEL;
       }
+    e++;
+    ret++;
     }
   }
 
 void
 gavl_transform_table_free(gavl_transform_table_t * tab)
   {
-  if(tab->pixels)
+  if(tab->entries)
+    {
+    free(tab->entries);
+    tab->entries = NULL;
+    }
+  if(tab->entries_precise)
+    {
+    free(tab->entries_precise);
+    tab->entries_precise = NULL;
+    }
+  if(tab->weights_f)
+    {
+    free(tab->weights_f);
+    tab->weights_f = NULL;
+    }
+  if(tab->weights_i)
+    {
+    free(tab->weights_i);
+    tab->weights_i = NULL;
+    }
+  if(tab->weights_max)
     {
-    if(tab->pixels[0])
-      free(tab->pixels[0]);
-    free(tab->pixels);
-    tab->pixels = NULL;
+    free(tab->weights_max);
+    tab->weights_max = NULL;
     }
+  tab->bits = 0;
   }
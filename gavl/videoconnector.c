@@ -275,14 +275,60 @@ gavl_source_status_t gavl_video_connector_get_source_status(gavl_video_connector
   }
 
 
-#if 0
-static int get_penalty(gavl_video_converter_t * cnv,
-                       const gavl_video_format_t * src_fmt,
-                       const gavl_video_format_t * dst_fmt)
+/*
+ *  Total penalty of converting the source into fmt once and
+ *  from there for each sink. Returns -1 if converting through fmt would
+ *  lose something for a sink.
+ */
+
+static int get_penalty(gavl_video_connector_t * c,
+                       gavl_pixelformat_t src_fmt,
+                       gavl_pixelformat_t fmt)
   {
-  return 0;
+  int i;
+  int ret;
+  gavl_pixelformat_t sink_fmt;
+  
+  ret = gavl_pixelformat_conversion_penalty(src_fmt, fmt);
+  
+  for(i = 0; i < c->num_sinks; i++)
+    {
+    sink_fmt = c->sinks[i].fmt->pixelformat;
+    if(!gavl_pixelformat_covers(fmt, sink_fmt))
+      return -1;
+    ret += gavl_pixelformat_conversion_penalty(fmt, sink_fmt);
+    }
+  return ret;
+  }
+
+/* Find the pixelformat, in which the frames are passed to the sinks */
+
+static gavl_pixelformat_t get_process_pixelformat(gavl_video_connector_t * c)
+  {
+  int i;
+  int penalty, test_penalty;
+  gavl_pixelformat_t src_fmt = c->fmt->pixelformat;
+  gavl_pixelformat_t ret = src_fmt;
+  
+  penalty = get_penalty(c, src_fmt, src_fmt);
+
+  /* Converting in the source is only worth it if it's shared */
+  for(i = 0; i < c->num_sinks; i++)
+    {
+    if(c->sinks[i].fmt->pixelformat == ret)
+      continue;
+    
+    test_penalty = get_penalty(c, src_fmt, c->sinks[i].fmt->pixelformat);
+
+    if((test_penalty >= 0) &&
+       ((penalty < 0) || (test_penalty < penalty)))
+      {
+      penalty = test_penalty;
+      ret = c->sinks[i].fmt->pixelformat;
+      }
+    }
+  return ret;
   }
-#endif
 
 void gavl_video_connector_start(gavl_video_connector_t * c)
   {
@@ -299,7 +345,13 @@ void gavl_video_connector_start(gavl_video_connector_t * c)
     return;
     }
   else
-    gavl_video_source_set_dst(c->src, 0, NULL);
+    {
+    gavl_video_format_t fmt;
+    gavl_video_format_copy(&fmt, gavl_video_source_get_src_format(c->src));
+    fmt.pixelformat = get_process_pixelformat(c);
+    gavl_video_source_set_dst(c->src, 0, &fmt);
+    c->fmt = gavl_video_source_get_dst_format(c->src);
+    }
   
   cnv = gavl_video_converter_create();
   gavl_video_options_copy(gavl_video_converter_get_options(cnv), &c->opt);
@@ -36,6 +36,7 @@
 #define LOG_DOMAIN "videoconverter"
 
 #include <video.h>
+#include <scale.h>
 #include <gavl/connectors.h>
 
 #ifdef HAVE_V4L2
@@ -51,15 +52,123 @@ gavl_video_converter_t * gavl_video_converter_create()
   {
   gavl_video_converter_t * ret = calloc(1,sizeof(gavl_video_converter_t));
   gavl_video_options_set_defaults(&ret->options);
+  pthread_mutex_init(&ret->async_mutex, NULL);
+  pthread_cond_init(&ret->async_cond, NULL);
   return ret;
   }
 
+/* Don't split pixelformat conversions into slices smaller than this */
+#define CSP_MIN_SLICE_HEIGHT 16
+
+/* Size of the intermediate strips in pipeline mode. They should
+   stay in the L2 cache together with the corresponding output */
+#define PIPELINE_STRIP_BYTES (256*1024)
+
+static void destroy_slices(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  for(i = 0; i < ctx->num_slices; i++)
+    {
+    gavl_video_frame_null(ctx->slices[i].input_subframe);
+    gavl_video_frame_destroy(ctx->slices[i].input_subframe);
+    gavl_video_frame_null(ctx->slices[i].output_frame);
+    gavl_video_frame_destroy(ctx->slices[i].output_frame);
+    }
+  free(ctx->slices);
+  ctx->slices = NULL;
+  ctx->num_slices = 0;
+  }
+
+static void destroy_pipeline(gavl_video_converter_t * cnv)
+  {
+  int i;
+  for(i = 0; i < cnv->num_strips; i++)
+    {
+    gavl_video_frame_destroy(cnv->strips[i].strip);
+    gavl_video_frame_null(cnv->strips[i].dst);
+    gavl_video_frame_destroy(cnv->strips[i].dst);
+    }
+  free(cnv->strips);
+  cnv->strips = NULL;
+  cnv->num_strips = 0;
+  cnv->pipeline_ctx = NULL;
+  }
+
+/*
+ *  Wait until a frame is converted. Returns 0 if wait is zero and the
+ *  frame is not ready yet. While waiting, we help the pool. This also
+ *  makes progress if we are called from a pool thread or if the pool
+ *  has only one thread.
+ */
+
+static int wait_async(gavl_video_converter_t * cnv,
+                      gavl_video_convert_async_t * a, int wait)
+  {
+  pthread_mutex_lock(&cnv->async_mutex);
+  while(a->busy)
+    {
+    if(!wait)
+      {
+      pthread_mutex_unlock(&cnv->async_mutex);
+      return 0;
+      }
+    pthread_mutex_unlock(&cnv->async_mutex);
+
+    if(gavl_thread_pool_help(cnv->options.tp))
+      {
+      pthread_mutex_lock(&cnv->async_mutex);
+      continue;
+      }
+    
+    /* Nothing queued: The frame is being converted by another thread */
+    pthread_mutex_lock(&cnv->async_mutex);
+    if(a->busy)
+      pthread_cond_wait(&cnv->async_cond, &cnv->async_mutex);
+    }
+  pthread_mutex_unlock(&cnv->async_mutex);
+  return 1;
+  }
+
+/* Wait for the frames in flight and free the asynchronous converters */
+
+static void destroy_async(gavl_video_converter_t * cnv)
+  {
+  int i;
+  
+  for(i = 0; i < cnv->num_async; i++)
+    wait_async(cnv, &cnv->async[i], 1);
+
+  for(i = 0; i < cnv->num_async; i++)
+    {
+    if(cnv->async[i].cnv)
+      gavl_video_converter_destroy(cnv->async[i].cnv);
+    if(cnv->async[i].output_frame)
+      gavl_video_frame_destroy(cnv->async[i].output_frame);
+    }
+  free(cnv->async);
+  cnv->async = NULL;
+  cnv->num_async = 0;
+  cnv->async_first = 0;
+  cnv->async_count = 0;
+  cnv->async_delivered = 0;
+  cnv->async_sync = 0;
+  }
+
 static void video_converter_cleanup(gavl_video_converter_t* cnv)
   {
   gavl_video_convert_context_t * ctx;
+
+  if(cnv->async)
+    destroy_async(cnv);
+  
+  if(cnv->pipeline_ctx)
+    destroy_pipeline(cnv);
   while(cnv->first_context)
     {
     ctx = cnv->first_context->next;
+
+    if(cnv->first_context->slices)
+      destroy_slices(cnv->first_context);
     
     if(cnv->first_context->scaler)
       gavl_video_scaler_destroy(cnv->first_context->scaler);
@@ -71,22 +180,32 @@ static void video_converter_cleanup(gavl_video_converter_t* cnv)
   cnv->last_context = NULL;
   cnv->num_contexts = 0;
 
-  
-  if(cnv->tp_priv)
-    {
-    gavl_thread_pool_destroy(cnv->tp_priv);
-    cnv->tp_priv = NULL;
+  /* The pool itself is kept until the converter is destroyed */
+  if(cnv->tp_priv && (cnv->options.tp == cnv->tp_priv))
     cnv->options.tp = NULL;
-    }
-  
   }
 
 void gavl_video_converter_destroy(gavl_video_converter_t* cnv)
   {
   video_converter_cleanup(cnv);
+  if(cnv->tp_priv)
+    gavl_thread_pool_destroy(cnv->tp_priv);
+  pthread_mutex_destroy(&cnv->async_mutex);
+  pthread_cond_destroy(&cnv->async_cond);
   free(cnv);
   }
 
+/* Use the shared thread pool unless the application set one */
+
+static void get_thread_pool(gavl_video_converter_t * cnv)
+  {
+  if(cnv->options.tp)
+    return;
+  if(!cnv->tp_priv)
+    cnv->tp_priv = gavl_thread_pool_get_shared();
+  cnv->options.tp = cnv->tp_priv;
+  }
+
 /* Add a context to the converter */
 
 static gavl_video_convert_context_t *
@@ -117,19 +236,169 @@ add_context(gavl_video_converter_t * cnv,
   return ctx;
   }
 
+static void csp_slice_func(void * data, int start, int end)
+  {
+  int i;
+  gavl_video_convert_context_t * ctx = data;
+  for(i = start; i < end; i++)
+    ctx->slices[i].func(&ctx->slices[i]);
+  }
+
+static void csp_func_mt(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  gavl_rectangle_i_t rect;
+  gavl_video_convert_context_t * s;
+  
+  rect.x = 0;
+  rect.y = 0;
+  rect.w = ctx->input_format.image_width;
+  
+  for(i = 0; i < ctx->num_slices; i++)
+    {
+    s = &ctx->slices[i];
+    rect.h = s->input_format.image_height;
+    
+    gavl_video_frame_get_subframe(ctx->input_format.pixelformat,
+                                  ctx->input_frame, s->input_subframe, &rect);
+    gavl_video_frame_get_subframe(ctx->output_format.pixelformat,
+                                  ctx->output_frame, s->output_frame, &rect);
+    rect.y += rect.h;
+    }
+  gavl_thread_pool_parallel_for(ctx->options->tp, csp_slice_func, ctx,
+                                0, ctx->num_slices, 1);
+  }
+
+/* Split the pixelformat conversion into horizontal bands,
+   which are converted by the thread pool */
+
+static void init_slices(gavl_video_convert_context_t * ctx)
+  {
+  int i;
+  int nt;
+  int delta;
+  int sub_h, sub_v, sub_v_out;
+  int height = ctx->input_format.image_height;
+  gavl_video_convert_context_t * s;
+  
+  /* Slice boundaries must be at chroma lines of both formats */
+  gavl_pixelformat_chroma_sub(ctx->input_format.pixelformat, &sub_h, &sub_v);
+  gavl_pixelformat_chroma_sub(ctx->output_format.pixelformat, &sub_h, &sub_v_out);
+  if(sub_v < sub_v_out)
+    sub_v = sub_v_out;
+  
+  nt = gavl_thread_pool_get_num_threads(ctx->options->tp);
+  if(nt > height / CSP_MIN_SLICE_HEIGHT)
+    nt = height / CSP_MIN_SLICE_HEIGHT;
+  
+  if(nt < 2)
+    return;
+
+  delta = ((height / nt) / sub_v) * sub_v;
+  
+  ctx->slices = calloc(nt, sizeof(*ctx->slices));
+  ctx->num_slices = nt;
+  
+  for(i = 0; i < nt; i++)
+    {
+    s = &ctx->slices[i];
+    s->options = ctx->options;
+    s->func = ctx->func;
+    
+    gavl_video_format_copy(&s->input_format, &ctx->input_format);
+    gavl_video_format_copy(&s->output_format, &ctx->output_format);
+
+    if(i < nt - 1)
+      s->input_format.image_height = delta;
+    else
+      s->input_format.image_height = height - (nt - 1) * delta;
+
+    s->input_format.frame_height = s->input_format.image_height;
+    s->output_format.image_height = s->input_format.image_height;
+    s->output_format.frame_height = s->input_format.image_height;
+    
+    s->input_subframe = gavl_video_frame_create(NULL);
+    s->input_frame = s->input_subframe;
+    s->output_frame = gavl_video_frame_create(NULL);
+    }
+  ctx->func = csp_func_mt;
+  }
+
 static int add_context_csp(gavl_video_converter_t * cnv,
                      const gavl_video_format_t * input_format,
                      const gavl_video_format_t * output_format)
   {
   gavl_video_convert_context_t * ctx;
-  ctx = add_context(cnv, input_format, output_format);
+  gavl_video_format_t planar_format;
+  gavl_video_func_t func;
+  
+  func = gavl_find_pixelformat_converter(&cnv->options,
+                                         input_format->pixelformat,
+                                         output_format->pixelformat,
+                                         input_format->frame_width,
+                                         input_format->frame_height);
+
+  /* Semiplanar formats, for which no direct conversion exists,
+     are converted through their planar counterparts */
+  
+  if(!func &&
+     (gavl_pixelformat_is_semiplanar(input_format->pixelformat) ||
+      gavl_pixelformat_is_semiplanar(output_format->pixelformat)))
+    {
+    if(gavl_pixelformat_is_semiplanar(input_format->pixelformat))
+      {
+      gavl_video_format_copy(&planar_format, input_format);
+      planar_format.pixelformat =
+        gavl_pixelformat_get_planar(input_format->pixelformat);
+      }
+    else
+      {
+      gavl_video_format_copy(&planar_format, output_format);
+      planar_format.pixelformat =
+        gavl_pixelformat_get_planar(output_format->pixelformat);
+      }
+
+    /* No shuffle function for the enabled accel flags */
+    if((planar_format.pixelformat == input_format->pixelformat) ||
+       (planar_format.pixelformat == output_format->pixelformat))
+      return 0;
+    
+    return add_context_csp(cnv, input_format, &planar_format) &&
+      add_context_csp(cnv, &planar_format, output_format);
+    }
+
+  /* 16 bit 4:2:0 is converted through 8 bit 4:2:0 or 16 bit 4:2:2,
+     depending on the precision of the other format */
+
+  if(!func &&
+     ((input_format->pixelformat == GAVL_YUV_420_P_16) ||
+      (output_format->pixelformat == GAVL_YUV_420_P_16)))
+    {
+    gavl_pixelformat_t other;
+
+    if(input_format->pixelformat == GAVL_YUV_420_P_16)
+      other = output_format->pixelformat;
+    else
+      other = input_format->pixelformat;
 
-  ctx->func = gavl_find_pixelformat_converter(&cnv->options,
-                                             input_format->pixelformat,
-                                             output_format->pixelformat,
-                                             input_format->frame_width,
-                                             input_format->frame_height);
+    if((other == GAVL_YUV_420_P) || (other == GAVL_YUV_422_P_16))
+      return 0;
 
+    gavl_video_format_copy(&planar_format, input_format);
+
+    if(gavl_pixelformat_conversion_penalty(other, GAVL_YUV_420_P) <
+       gavl_pixelformat_conversion_penalty(other, GAVL_YUV_422_P_16))
+      planar_format.pixelformat = GAVL_YUV_420_P;
+    else
+      planar_format.pixelformat = GAVL_YUV_422_P_16;
+
+    return add_context_csp(cnv, input_format, &planar_format) &&
+      add_context_csp(cnv, &planar_format, output_format);
+    }
+
+  ctx = add_context(cnv, input_format, output_format);
+  ctx->func = func;
+  
   if(!ctx->func)
     {
 #if 0
@@ -148,6 +417,158 @@ static int add_context_csp(gavl_video_converter_t * cnv,
   return 1;
   }
 
+static int is_csp_context(gavl_video_convert_context_t * ctx)
+  {
+  return !ctx->scaler && !ctx->deinterlacer;
+  }
+
+/* Scale and convert every num_strips'th strip starting with the
+   index of s */
+
+static void convert_strips(gavl_video_convert_strip_t * s, int start, int num)
+  {
+  int i;
+  gavl_rectangle_i_t rect;
+  gavl_video_converter_t * cnv = s->cnv;
+  int height = cnv->pipeline_ctx->output_format.image_height;
+  
+  rect.x = 0;
+  rect.w = s->csp.output_format.image_width;
+  
+  for(i = start; i < num; i += cnv->num_strips)
+    {
+    rect.y = i * cnv->strip_height;
+    rect.h = cnv->strip_height;
+    if(rect.y + rect.h > height)
+      rect.h = height - rect.y;
+
+    gavl_video_scaler_scale_rows(cnv->pipeline_ctx->scaler,
+                                 s->strip, rect.y, rect.y + rect.h);
+
+    gavl_video_frame_get_subframe(s->csp.output_format.pixelformat,
+                                  s->dst_frame, s->dst, &rect);
+    
+    s->csp.input_format.image_height = rect.h;
+    s->csp.input_format.frame_height = rect.h;
+    s->csp.output_format.image_height = rect.h;
+    s->csp.output_format.frame_height = rect.h;
+    s->csp.func(&s->csp);
+    }
+  }
+
+static int get_num_strip_rows(gavl_video_converter_t * cnv)
+  {
+  return (cnv->pipeline_ctx->output_format.image_height + cnv->strip_height - 1) /
+    cnv->strip_height;
+  }
+
+static void strip_func(void * data, int start, int end)
+  {
+  int i;
+  gavl_video_converter_t * cnv = data;
+  int num = get_num_strip_rows(cnv);
+  
+  for(i = start; i < end; i++)
+    convert_strips(&cnv->strips[i], i, num);
+  }
+
+static void convert_pipeline(gavl_video_converter_t * cnv,
+                             const gavl_video_frame_t * input_frame,
+                             gavl_video_frame_t * output_frame)
+  {
+  int i;
+  
+  gavl_video_scaler_scale_prepare(cnv->pipeline_ctx->scaler, input_frame);
+
+  for(i = 0; i < cnv->num_strips; i++)
+    cnv->strips[i].dst_frame = output_frame;
+  
+  if(cnv->num_strips == 1)
+    {
+    convert_strips(&cnv->strips[0], 0, get_num_strip_rows(cnv));
+    return;
+    }
+  gavl_thread_pool_parallel_for(cnv->options.tp, strip_func, cnv,
+                                0, cnv->num_strips, 1);
+  }
+
+/* Check if a scale context followed by a csp context can run on strips */
+
+static void init_pipeline(gavl_video_converter_t * cnv)
+  {
+  int i;
+  int height;
+  int num;
+  int sub_h, sub_v, sub_v_out;
+  gavl_video_format_t strip_format;
+  gavl_video_convert_context_t * ctx = cnv->first_context;
+  gavl_video_convert_strip_t * s;
+  
+  while(ctx)
+    {
+    if(ctx->scaler && ctx->next && is_csp_context(ctx->next) &&
+       gavl_video_scaler_can_scale_rows(ctx->scaler))
+      break;
+    ctx = ctx->next;
+    }
+  if(!ctx)
+    return;
+
+  height = ctx->output_format.image_height;
+
+  /* Strips must start at chroma lines of both formats */
+  gavl_pixelformat_chroma_sub(ctx->output_format.pixelformat, &sub_h, &sub_v);
+  gavl_pixelformat_chroma_sub(ctx->next->output_format.pixelformat, &sub_h, &sub_v_out);
+  if(sub_v < sub_v_out)
+    sub_v = sub_v_out;
+  
+  cnv->strip_height = PIPELINE_STRIP_BYTES /
+    (gavl_video_format_get_image_size(&ctx->output_format) / ctx->output_format.frame_height);
+  cnv->strip_height = (cnv->strip_height / sub_v) * sub_v;
+  if(cnv->strip_height < sub_v)
+    cnv->strip_height = sub_v;
+  
+  /* Nothing to gain */
+  if(cnv->strip_height >= height)
+    return;
+  
+  num = (height + cnv->strip_height - 1) / cnv->strip_height;
+
+  if(cnv->options.tp)
+    {
+    cnv->num_strips = gavl_thread_pool_get_num_threads(cnv->options.tp);
+    if(cnv->num_strips > num)
+      cnv->num_strips = num;
+    }
+  else
+    cnv->num_strips = 1;
+
+  gavl_video_format_copy(&strip_format, &ctx->output_format);
+  strip_format.image_height = cnv->strip_height;
+  strip_format.frame_height = cnv->strip_height;
+  
+  cnv->strips = calloc(cnv->num_strips, sizeof(*cnv->strips));
+  
+  for(i = 0; i < cnv->num_strips; i++)
+    {
+    s = &cnv->strips[i];
+    memcpy(&s->csp, ctx->next, sizeof(s->csp));
+    s->csp.next = NULL;
+    
+    s->strip = gavl_video_frame_create(&strip_format);
+    gavl_video_frame_clear(s->strip, &strip_format);
+    s->dst = gavl_video_frame_create(NULL);
+    
+    s->csp.input_frame = s->strip;
+    s->csp.output_frame = s->dst;
+    s->cnv = cnv;
+    }
+  
+  cnv->pipeline_ctx = ctx;
+  gavl_log(GAVL_LOG_DEBUG, LOG_DOMAIN, "Scaling and pixelformat conversion in strips of %d scanlines",
+           cnv->strip_height);
+  }
+
 static void scale_func(gavl_video_convert_context_t * ctx)
   {
   gavl_video_scaler_scale(ctx->scaler,
@@ -242,6 +663,8 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
 
   gavl_video_format_t tmp_format;
   gavl_video_format_t tmp_format1;
+  gavl_video_format_t planar_output_format;
+  gavl_pixelformat_t input_pixelformat;
 
   gavl_video_format_t * input_format;
   gavl_video_format_t * output_format;
@@ -249,13 +672,6 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
   input_format = &cnv->input_format;
   output_format = &cnv->output_format;
 
-  if(cnv->tp_priv)
-    {
-    gavl_thread_pool_destroy(cnv->tp_priv);
-    cnv->tp_priv = NULL;
-    cnv->options.tp = NULL;
-    }
-  
   // #ifdef DEBUG
 #if 0
   fprintf(stderr, "Initializing video converter, quality: %d, Flags: 0x%08x\n",
@@ -274,6 +690,18 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
      (tmp_format.pixelformat == GAVL_RGBA_32) &&
      (output_format->pixelformat == GAVL_RGB_32))
     tmp_format.pixelformat = GAVL_RGB_32;
+
+  /* Semiplanar formats can only be converted directly. All other
+     operations are planned for the planar counterparts, which are
+     converted from and to the semiplanar formats at the ends of the chain */
+
+  input_pixelformat = tmp_format.pixelformat;
+  tmp_format.pixelformat = gavl_pixelformat_get_planar(input_pixelformat);
+
+  gavl_video_format_copy(&planar_output_format, output_format);
+  planar_output_format.pixelformat =
+    gavl_pixelformat_get_planar(output_format->pixelformat);
+  output_format = &planar_output_format;
   
   /* Check for pixelformat conversion */
 
@@ -346,14 +774,27 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
       do_deinterlace = 1;
     }
 
+  if(!do_scale && !do_deinterlace)
+    {
+    tmp_format.pixelformat = input_pixelformat;
+    output_format = &cnv->output_format;
+    do_csp = (tmp_format.pixelformat != output_format->pixelformat);
+    }
+  
   /* Now we know which operations to perform. */
 
-  if(!cnv->options.tp && do_scale)
+  if(do_scale || do_csp || do_deinterlace)
+    get_thread_pool(cnv);
+ 
+  
+  if(input_pixelformat != tmp_format.pixelformat)
     {
-    cnv->tp_priv = gavl_thread_pool_create(-1);
-    cnv->options.tp = cnv->tp_priv;
+    gavl_video_format_copy(&tmp_format1, &tmp_format);
+    tmp_format.pixelformat = input_pixelformat;
+    if(!add_context_csp(cnv, &tmp_format, &tmp_format1))
+      return -1;
+    gavl_video_format_copy(&tmp_format, &tmp_format1);
     }
- 
   
   /* Deinterlacing must always be the first step */
 
@@ -386,7 +827,8 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
       }
     else
       {
-      if(!gavl_pixelformat_can_scale(input_format->pixelformat, tmp_csp))
+      if(!gavl_pixelformat_can_scale(gavl_pixelformat_get_planar(input_format->pixelformat),
+                                     tmp_csp))
         csp_then_scale = 1;
 #if 0
       fprintf(stderr, "converting %s -> %s -> %s (%d, %d)\n",
@@ -494,6 +936,30 @@ int gavl_video_converter_reinit(gavl_video_converter_t * cnv)
       return -1;
     }
 
+  if(output_format->pixelformat != cnv->output_format.pixelformat)
+    {
+    if(!add_context_csp(cnv, output_format, &cnv->output_format))
+      return -1;
+    }
+
+  /* Check if scaling and pixelformat conversion can run on strips */
+
+  init_pipeline(cnv);
+
+  /* Split the remaining pixelformat conversions among the threads */
+
+  if(cnv->options.tp)
+    {
+    gavl_video_convert_context_t * ctx = cnv->first_context;
+    while(ctx)
+      {
+      if(is_csp_context(ctx) &&
+         (!cnv->pipeline_ctx || (ctx != cnv->pipeline_ctx->next)))
+        init_slices(ctx);
+      ctx = ctx->next;
+      }
+    }
+  
   /* Now, create temporary frames for the contexts */
 
   cnv->have_frames = 0;
@@ -511,11 +977,15 @@ static void alloc_frames(gavl_video_converter_t * cnv)
   tmp_ctx = cnv->first_context;
   while(tmp_ctx && tmp_ctx->next)
     {
-    tmp_ctx->output_frame =
-      gavl_video_frame_create(&tmp_ctx->output_format);
-    gavl_video_frame_clear(tmp_ctx->output_frame, &tmp_ctx->output_format);
+    /* No full frame intermediate in pipeline mode */
+    if(tmp_ctx != cnv->pipeline_ctx)
+      {
+      tmp_ctx->output_frame =
+        gavl_video_frame_create(&tmp_ctx->output_format);
+      gavl_video_frame_clear(tmp_ctx->output_frame, &tmp_ctx->output_format);
     
-    tmp_ctx->next->input_frame = tmp_ctx->output_frame;
+      tmp_ctx->next->input_frame = tmp_ctx->output_frame;
+      }
     tmp_ctx = tmp_ctx->next;
     }
 
@@ -538,6 +1008,35 @@ gavl_video_converter_get_options(gavl_video_converter_t * cnv)
   return &cnv->options;
   }
 
+static void reset_contexts(gavl_video_converter_t * cnv)
+  {
+  gavl_video_convert_context_t * ctx;
+
+  ctx = cnv->first_context;
+  while(ctx)
+    {
+    if(ctx->deinterlacer)
+      gavl_video_deinterlacer_reset(ctx->deinterlacer);
+    ctx = ctx->next;
+    }
+  }
+
+void gavl_video_converter_reset(gavl_video_converter_t * cnv)
+  {
+  int i;
+
+  reset_contexts(cnv);
+
+  if(cnv->async)
+    {
+    for(i = 0; i < cnv->num_async; i++)
+      {
+      if(cnv->async[i].cnv)
+        reset_contexts(cnv->async[i].cnv);
+      }
+    }
+  }
+
 /***************************************************
  * Convert a frame
  ***************************************************/
@@ -557,6 +1056,16 @@ void gavl_video_convert(gavl_video_converter_t * cnv,
   
   while(tmp_ctx)
     {
+    if(tmp_ctx == cnv->pipeline_ctx)
+      {
+      /* Scale and pixelformat conversion in one go */
+      gavl_video_frame_copy_metadata(tmp_ctx->next->output_frame,
+                                     tmp_ctx->input_frame);
+      convert_pipeline(cnv, tmp_ctx->input_frame, tmp_ctx->next->output_frame);
+      tmp_ctx = tmp_ctx->next->next;
+      continue;
+      }
+    
     gavl_video_frame_copy_metadata(tmp_ctx->output_frame,
                                    tmp_ctx->input_frame);
     tmp_ctx->func(tmp_ctx);
@@ -565,3 +1074,155 @@ void gavl_video_convert(gavl_video_converter_t * cnv,
 
   }
 
+/***************************************************
+ * Asynchronous conversion
+ ***************************************************/
+
+static void async_func(void * data, int start, int end)
+  {
+  gavl_video_convert_async_t * a = data;
+  gavl_video_converter_t * cnv = a->parent;
+
+  /* Synchronous fallback: Use the parent converter */
+  gavl_video_converter_t * c = a->cnv ? a->cnv : cnv;
+  
+  if(c->num_contexts)
+    gavl_video_convert(c, a->input_frame, a->output_frame);
+  else
+    {
+    gavl_video_frame_copy(&cnv->output_format,
+                          a->output_frame, a->input_frame);
+    gavl_video_frame_copy_metadata(a->output_frame, a->input_frame);
+    }
+  
+  pthread_mutex_lock(&cnv->async_mutex);
+  a->busy = 0;
+  pthread_cond_broadcast(&cnv->async_cond);
+  pthread_mutex_unlock(&cnv->async_mutex);
+  }
+
+static void init_async_sync(gavl_video_converter_t * cnv)
+  {
+  int i;
+
+  /* One frame in flight and the one in use by the caller */
+  cnv->num_async = 2;
+  cnv->async = calloc(cnv->num_async, sizeof(*cnv->async));
+  cnv->async_sync = 1;
+  
+  for(i = 0; i < cnv->num_async; i++)
+    {
+    cnv->async[i].parent = cnv;
+    cnv->async[i].output_frame = gavl_video_frame_create(&cnv->output_format);
+    }
+  }
+
+/* The adaptive deinterlacer needs the previous frame, so the frames
+   must be converted in order by one converter */
+
+static int needs_prev_frame(gavl_video_converter_t * cnv)
+  {
+  gavl_video_convert_context_t * ctx;
+
+  if(cnv->options.deinterlace_mode != GAVL_DEINTERLACE_ADAPTIVE)
+    return 0;
+  
+  ctx = cnv->first_context;
+  while(ctx)
+    {
+    if(ctx->deinterlacer)
+      return 1;
+    ctx = ctx->next;
+    }
+  return 0;
+  }
+
+static void init_async(gavl_video_converter_t * cnv)
+  {
+  int i;
+  gavl_video_convert_async_t * a;
+  
+  get_thread_pool(cnv);
+
+  if(needs_prev_frame(cnv))
+    {
+    init_async_sync(cnv);
+    return;
+    }
+  
+  cnv->num_async = cnv->options.async_frames;
+  if(cnv->num_async < 1)
+    cnv->num_async = gavl_thread_pool_get_num_threads(cnv->options.tp);
+
+  /* Plus the one, which is in use by the caller */
+  cnv->num_async++;
+
+  cnv->async = calloc(cnv->num_async, sizeof(*cnv->async));
+  
+  for(i = 0; i < cnv->num_async; i++)
+    {
+    a = &cnv->async[i];
+    a->parent = cnv;
+    a->cnv = gavl_video_converter_create();
+    gavl_video_options_copy(&a->cnv->options, &cnv->options);
+    a->output_frame = gavl_video_frame_create(&cnv->output_format);
+    
+    if(gavl_video_converter_init(a->cnv, &cnv->input_format,
+                                 &cnv->output_format) < 0)
+      {
+      gavl_log(GAVL_LOG_WARNING, LOG_DOMAIN,
+               "Initializing asynchronous converter failed, converting synchronously");
+      destroy_async(cnv);
+      init_async_sync(cnv);
+      return;
+      }
+    }
+  }
+
+int gavl_video_converter_submit(gavl_video_converter_t * cnv,
+                                const gavl_video_frame_t * input_frame)
+  {
+  gavl_video_convert_async_t * a;
+
+  if(!cnv->async)
+    init_async(cnv);
+  
+  if(cnv->async_count + cnv->async_delivered >= cnv->num_async)
+    return 0;
+
+  a = &cnv->async[(cnv->async_first + cnv->async_count) % cnv->num_async];
+  a->input_frame = input_frame;
+
+  pthread_mutex_lock(&cnv->async_mutex);
+  a->busy = 1;
+  pthread_mutex_unlock(&cnv->async_mutex);
+  
+  cnv->async_count++;
+
+  if(cnv->async_sync)
+    async_func(a, 0, 0);
+  else
+    gavl_thread_pool_submit(cnv->options.tp, async_func, a, 0, 0);
+  return 1;
+  }
+
+gavl_video_frame_t * gavl_video_converter_complete(gavl_video_converter_t * cnv,
+                                                   int wait)
+  {
+  gavl_video_convert_async_t * a;
+
+  cnv->async_delivered = 0;
+  
+  if(!cnv->async_count)
+    return NULL;
+
+  a = &cnv->async[cnv->async_first];
+  
+  if(!wait_async(cnv, a, wait))
+    return NULL;
+
+  cnv->async_first = (cnv->async_first + 1) % cnv->num_async;
+  cnv->async_count--;
+  cnv->async_delivered = 1;
+  return a->output_frame;
+  }
@@ -422,6 +422,9 @@ int gavl_video_format_get_image_size(const gavl_video_format_t * format)
       {
       bytes_per_line /= sub_h;
       height /= sub_v;
+      /* Interleaved chroma */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       }
     }
   return ret;
@@ -473,6 +476,12 @@ void gavl_video_format_get_frame_layout(const gavl_video_format_t * format,
       {
       bytes_per_line /= sub_h;
       size /= (sub_h*sub_v);
+      /* Interleaved chroma */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        {
+        bytes_per_line *= 2;
+        size *= 2;
+        }
       }
     
     }
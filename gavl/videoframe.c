@@ -67,6 +67,13 @@ static void video_frame_alloc(gavl_video_frame_t * ret,
       ret->strides[0] = bpc * format->frame_width;
       ret->strides[1] = bpc * ((format->frame_width + sub_h - 1) / sub_h);
       ret->strides[2] = ret->strides[1];
+
+      /* Chroma samples are interleaved in one plane */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        {
+        ret->strides[1] *= 2;
+        ret->strides[2] = 0;
+        }
       
       if(align)
         {
@@ -81,7 +88,8 @@ static void video_frame_alloc(gavl_video_frame_t * ret,
                               ret->strides[1]*((format->frame_height+sub_v-1)/sub_v)+
                               ret->strides[2]*((format->frame_height+sub_v-1)/sub_v));
     ret->planes[1] = ret->planes[0] + ret->strides[0]*format->frame_height;
-    ret->planes[2] = ret->planes[1] + ret->strides[1]*((format->frame_height+sub_v-1)/sub_v);
+    if(ret->strides[2])
+      ret->planes[2] = ret->planes[1] + ret->strides[1]*((format->frame_height+sub_v-1)/sub_v);
     }
   else // Packed
     {
@@ -391,6 +399,43 @@ void gavl_video_frame_clear_mask(gavl_video_frame_t * frame,
         ptr_16_u = (uint16_t*)line_start_u;
         ptr_16_v = (uint16_t*)line_start_v;
 
+        if(mask & CLEAR_MASK_PLANE_1)
+          {
+          for(j = 0; j < format->frame_width/2; j++)
+            {
+            *(ptr_16_u++) = 0x8000;
+            }
+          }
+        if(mask & CLEAR_MASK_PLANE_2)
+          {
+          for(j = 0; j < format->frame_width/2; j++)
+            {
+            *(ptr_16_v++) = 0x8000;
+            }
+          }
+        
+        line_start_u += frame->strides[1];
+        line_start_v += frame->strides[2];
+        }
+      break;
+    case GAVL_YUV_420_P_16:
+      if(mask & CLEAR_MASK_PLANE_0)
+        {
+        bytes = format->frame_width * 2;
+        for(i = 0; i < format->frame_height; i++)
+          memset(frame->planes[0] + i * frame->strides[0], 0x00, bytes);
+        }
+      
+      if(!(mask & (CLEAR_MASK_PLANE_1 | CLEAR_MASK_PLANE_2)))
+        break;
+      
+      line_start_u = frame->planes[1];
+      line_start_v = frame->planes[2];
+      for(i = 0; i < format->frame_height / 2; i++)
+        {
+        ptr_16_u = (uint16_t*)line_start_u;
+        ptr_16_v = (uint16_t*)line_start_v;
+
         if(mask & CLEAR_MASK_PLANE_1)
           {
           for(j = 0; j < format->frame_width/2; j++)
@@ -513,6 +558,43 @@ void gavl_video_frame_clear_mask(gavl_video_frame_t * frame,
           memset(frame->planes[2] + i * frame->strides[2], 0x80, bytes);
         }
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
+      if(mask & CLEAR_MASK_PLANE_0)
+        {
+        bytes = format->frame_width;
+        for(i = 0; i < format->frame_height; i++)
+          memset(frame->planes[0] + i * frame->strides[0], 0x00, bytes);
+        }
+      /* U and V share one plane */
+      if(mask & (CLEAR_MASK_PLANE_1|CLEAR_MASK_PLANE_2))
+        {
+        int sub_h, sub_v;
+        gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
+        bytes = (format->frame_width / 2) * 2;
+        for(i = 0; i < format->frame_height / sub_v; i++)
+          memset(frame->planes[1] + i * frame->strides[1], 0x80, bytes);
+        }
+      break;
+    case GAVL_P016:
+      if(mask & CLEAR_MASK_PLANE_0)
+        {
+        bytes = format->frame_width * 2;
+        for(i = 0; i < format->frame_height; i++)
+          memset(frame->planes[0] + i * frame->strides[0], 0x00, bytes);
+        }
+      /* U and V share one plane */
+      if(mask & (CLEAR_MASK_PLANE_1|CLEAR_MASK_PLANE_2))
+        {
+        for(i = 0; i < format->frame_height / 2; i++)
+          {
+          ptr_16_u = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+          for(j = 0; j < (format->frame_width / 2) * 2; j++)
+            *(ptr_16_u++) = 0x8000;
+          }
+        }
+      break;
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -587,6 +669,8 @@ void gavl_video_frame_copy_plane(const gavl_video_format_t * format,
     gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
     bytes_per_line /= sub_h;
     height /= sub_v;
+    if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+      bytes_per_line *= 2;
     }
   copy_plane(dst, src, plane, bytes_per_line, height);
   }
@@ -647,6 +731,8 @@ void gavl_video_frame_copy(const gavl_video_format_t * format,
       gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
       bytes_per_line /= sub_h;
       height /= sub_v;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       }
     copy_plane(dst, src, i, bytes_per_line, height);
     }
@@ -841,6 +927,8 @@ static flip_scanline_func find_flip_scanline_func(gavl_pixelformat_t csp)
     case GAVL_BGR_16:
     case GAVL_YUV_444_P_16:
     case GAVL_YUV_422_P_16:
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
     case GAVL_GRAYA_16:
     case GAVL_GRAY_16:
       return flip_scanline_2;
@@ -882,6 +970,9 @@ static flip_scanline_func find_flip_scanline_func(gavl_pixelformat_t csp)
     case GAVL_YUVJ_422_P:
     case GAVL_YUVJ_444_P:
     case GAVL_GRAY_8:
+    case GAVL_NV12:
+    case GAVL_NV21:
+    case GAVL_NV16:
       return flip_scanline_1;
       break;
     case GAVL_YUY2:
@@ -935,6 +1026,11 @@ void gavl_video_frame_copy_flip_x(const gavl_video_format_t * format,
       {
       jmax /= sub_v;
       width /= sub_h;
+
+      /* Flip interleaved chroma pairs */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        func = (gavl_pixelformat_bytes_per_component(format->pixelformat) == 2) ?
+          flip_scanline_4 : flip_scanline_2;
       }
     }
   
@@ -1003,8 +1099,15 @@ void gavl_video_frame_copy_flip_xy(const gavl_video_format_t * format,
   for(i = 0; i < planes; i++)
     {
     if(i)
+      {
       gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
 
+      /* Flip interleaved chroma pairs */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        func = (gavl_pixelformat_bytes_per_component(format->pixelformat) == 2) ?
+          flip_scanline_4 : flip_scanline_2;
+      }
+    
     src_ptr = src->planes[i] +
       ((format->image_height / sub_v) - 1) * src->strides[i];
 
@@ -1055,8 +1158,13 @@ void gavl_video_frame_dump(gavl_video_frame_t * frame,
     output = fopen(filename, "wb");
 
     if(i == 1)
+      {
       gavl_pixelformat_chroma_sub(format->pixelformat,
                           &sub_h, &sub_v);
+      /* Interleaved chroma has 2 bytes per sample */
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        sub_h /= 2;
+      }
     
     for(j = 0; j < format->image_height / sub_v; j++)
       {
@@ -1088,6 +1196,10 @@ void gavl_video_frame_get_subframe(gavl_pixelformat_t pixelformat,
     bytes = gavl_pixelformat_bytes_per_component(pixelformat);
     dst->planes[0] = src->planes[0] + src_rect->y * src->strides[0] + src_rect->x * bytes;
 
+    /* Interleaved chroma has 2 components per sample */
+    if(gavl_pixelformat_is_semiplanar(pixelformat))
+      bytes *= 2;
+    
     for(i = 1; i < num_planes; i++)
       {
       dst->planes[i] = src->planes[i] +
@@ -1306,6 +1418,78 @@ static void fill_planar_8(gavl_video_frame_t * frame,
     }
   }
 
+/* color[1] and color[2] are the chroma bytes in memory order */
+
+static void fill_semiplanar_8(gavl_video_frame_t * frame,
+                              const gavl_video_format_t * format,
+                              uint8_t * color)
+  {
+  int i, j, imax, jmax;
+  int sub_h, sub_v;
+
+  uint8_t * dst;
+  
+  gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
+  
+  /* Luminance */
+  dst = frame->planes[0];
+  for(i = 0; i < format->image_height; i++)
+    {
+    memset(dst, color[0], format->image_width);
+    dst += frame->strides[0];
+    }
+  /* Chrominance */
+
+  imax = format->image_height / sub_v;
+  jmax = format->image_width  / sub_h;
+  
+  for(i = 0; i < imax; i++)
+    {
+    dst = frame->planes[1] + i * frame->strides[1];
+    for(j = 0; j < jmax; j++)
+      {
+      dst[0] = color[1];
+      dst[1] = color[2];
+      dst += 2;
+      }
+    }
+  }
+
+static void fill_semiplanar_16(gavl_video_frame_t * frame,
+                               const gavl_video_format_t * format,
+                               uint16_t * color)
+  {
+  int i, j, imax, jmax;
+  int sub_h, sub_v;
+
+  uint16_t * dst;
+  
+  gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
+  
+  /* Luminance */
+  for(i = 0; i < format->image_height; i++)
+    {
+    dst = (uint16_t*)(frame->planes[0] + i * frame->strides[0]);
+    for(j = 0; j < format->image_width; j++)
+      *(dst++) = color[0];
+    }
+  /* Chrominance */
+
+  imax = format->image_height / sub_v;
+  jmax = format->image_width  / sub_h;
+  
+  for(i = 0; i < imax; i++)
+    {
+    dst = (uint16_t*)(frame->planes[1] + i * frame->strides[1]);
+    for(j = 0; j < jmax; j++)
+      {
+      dst[0] = color[1];
+      dst[1] = color[2];
+      dst += 2;
+      }
+    }
+  }
+
 static void fill_planar_16(gavl_video_frame_t * frame,
                            const gavl_video_format_t * format,
                            uint16_t * color)
@@ -1555,10 +1739,27 @@ void gavl_video_frame_fill(gavl_video_frame_t * frame,
       break;
     case GAVL_YUV_422_P_16:
     case GAVL_YUV_444_P_16:
+    case GAVL_YUV_420_P_16:
       RGB_FLOAT_TO_YUV_16(color[0], color[1], color[2], packed_64[0],
                           packed_64[1], packed_64[2]);
       fill_planar_16(frame, format, packed_64);
       break;
+    case GAVL_P016:
+      RGB_FLOAT_TO_YUV_16(color[0], color[1], color[2], packed_64[0],
+                          packed_64[1], packed_64[2]);
+      fill_semiplanar_16(frame, format, packed_64);
+      break;
+    case GAVL_NV12:
+    case GAVL_NV16:
+      RGB_FLOAT_TO_YUV_8(color[0], color[1], color[2], packed_32[0],
+                         packed_32[1], packed_32[2]);
+      fill_semiplanar_8(frame, format, packed_32);
+      break;
+    case GAVL_NV21:
+      RGB_FLOAT_TO_YUV_8(color[0], color[1], color[2], packed_32[0],
+                         packed_32[2], packed_32[1]);
+      fill_semiplanar_8(frame, format, packed_32);
+      break;
     case GAVL_PIXELFORMAT_NONE:
       fprintf(stderr, "Pixelformat not specified for video frame\n");
       return;
@@ -1649,6 +1850,8 @@ int gavl_video_frames_equal(const gavl_video_format_t * format,
       gavl_pixelformat_chroma_sub(format->pixelformat, &sub_h, &sub_v);
       bytes_per_line /= sub_h;
       height /= sub_v;
+      if(gavl_pixelformat_is_semiplanar(format->pixelformat))
+        bytes_per_line *= 2;
       }
 
     for(j = 0; j < height; j++)
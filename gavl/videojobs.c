@@ -0,0 +1,104 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#include <stdlib.h>
+
+#include <config.h>
+
+#include <gavl/gavl.h>
+#include <video.h>
+
+/* Scanlines of several planes and fields in one parallel loop */
+
+void gavl_video_jobs_reset(gavl_video_jobs_t * j)
+  {
+  j->num_jobs = 0;
+  j->num_rows = 0;
+  }
+
+void gavl_video_jobs_add(gavl_video_jobs_t * j,
+                         void (*func)(void * data, int start, int end),
+                         void * data, int num_rows)
+  {
+  if(num_rows <= 0)
+    return;
+  
+  if(j->num_jobs == j->jobs_alloc)
+    {
+    j->jobs_alloc += 8;
+    j->jobs = realloc(j->jobs, j->jobs_alloc * sizeof(*j->jobs));
+    }
+
+  j->jobs[j->num_jobs].func  = func;
+  j->jobs[j->num_jobs].data  = data;
+  j->jobs[j->num_jobs].start = j->num_rows;
+  j->num_rows += num_rows;
+  j->jobs[j->num_jobs].end   = j->num_rows;
+  j->num_jobs++;
+  }
+
+/* Split a chunk of the loop among the jobs it covers */
+
+static void do_jobs(void * data, int start, int end)
+  {
+  int i;
+  gavl_video_job_t * job;
+  gavl_video_jobs_t * j = data;
+
+  for(i = 0; i < j->num_jobs; i++)
+    {
+    job = &j->jobs[i];
+    
+    if(start >= job->end)
+      continue;
+    if(end <= job->start)
+      break;
+
+    job->func(job->data,
+              ((start > job->start) ? start : job->start) - job->start,
+              ((end < job->end) ? end : job->end) - job->start);
+    }
+  }
+
+void gavl_video_jobs_run(gavl_video_jobs_t * j, gavl_thread_pool_t * tp)
+  {
+  int i;
+
+  if(!j->num_rows)
+    return;
+  
+  if(tp && (j->num_rows > 1))
+    gavl_thread_pool_parallel_for(tp, do_jobs, j, 0, j->num_rows, 0);
+  else
+    {
+    for(i = 0; i < j->num_jobs; i++)
+      j->jobs[i].func(j->jobs[i].data, 0, j->jobs[i].end - j->jobs[i].start);
+    }
+  }
+
+void gavl_video_jobs_free(gavl_video_jobs_t * j)
+  {
+  if(j->jobs)
+    free(j->jobs);
+  j->jobs = NULL;
+  j->jobs_alloc = 0;
+  j->num_jobs = 0;
+  j->num_rows = 0;
+  }
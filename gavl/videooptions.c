@@ -268,3 +268,13 @@ gavl_thread_pool_t * gavl_video_options_get_thread_pool(const gavl_video_options
   {
   return opt->tp;
   }
+
+void gavl_video_options_set_async_frames(gavl_video_options_t * opt, int num)
+  {
+  opt->async_frames = num;
+  }
+
+int gavl_video_options_get_async_frames(const gavl_video_options_t * opt)
+  {
+  return opt->async_frames;
+  }
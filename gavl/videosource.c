@@ -92,6 +92,14 @@ struct gavl_video_source_s
   gavl_connector_free_func_t free_func;
 
   int64_t pts_offset;
+
+  /* Asynchronous conversion */
+  gavl_video_frame_t ** async_in_frames; /* Input frames of the frames in flight */
+  int num_async_in_frames;
+  int async_next;                        /* Next input frame to read into */
+  int async_count;                       /* Frames in flight */
+  gavl_video_frame_t * async_pending;    /* Frame read but not yet submitted */
+  gavl_source_status_t async_status;     /* Status, which stopped reading ahead */
   };
 
 static void resync_importer(gavl_video_source_t * src);
@@ -210,9 +218,43 @@ gavl_video_options_t * gavl_video_source_get_options(gavl_video_source_t * s)
   return gavl_video_converter_get_options(s->cnv);
   }
 
+/* Discard the frames in flight */
+
+static void flush_async(gavl_video_source_t * s)
+  {
+  while(s->async_count)
+    {
+    gavl_video_converter_complete(s->cnv, 1);
+    s->async_count--;
+    }
+  s->async_pending = NULL;
+  s->async_status = GAVL_SOURCE_OK;
+  }
+
+static void free_async(gavl_video_source_t * s)
+  {
+  int i;
+  
+  flush_async(s);
+  
+  for(i = 0; i < s->num_async_in_frames; i++)
+    {
+    if(s->async_in_frames[i])
+      gavl_video_frame_destroy(s->async_in_frames[i]);
+    }
+  if(s->async_in_frames)
+    free(s->async_in_frames);
+  s->async_in_frames = NULL;
+  s->num_async_in_frames = 0;
+  s->async_next = 0;
+  }
+
 GAVL_PUBLIC
 void gavl_video_source_reset(gavl_video_source_t * s)
   {
+  flush_async(s);
+  gavl_video_converter_reset(s->cnv);
+  
   s->pts = GAVL_TIME_UNDEFINED;
 
   if(s->in_frame)
@@ -242,7 +284,8 @@ void gavl_video_source_destroy(gavl_video_source_t * s)
 
   if(s->out_frame)
     gavl_video_frame_destroy(s->out_frame);
-  
+
+  free_async(s);
   gavl_video_converter_destroy(s->cnv);
 
   if(s->priv && s->free_func)
@@ -425,6 +468,90 @@ read_video_cnv(gavl_video_source_t * s,
   return GAVL_SOURCE_OK;
   }
 
+/*
+ *  Asynchronous conversion: Read ahead and keep up to
+ *  num_async_in_frames in the converter. The input frames are
+ *  used in the same order in which the converter completes them.
+ */
+
+static gavl_source_status_t
+read_video_cnv_async(gavl_video_source_t * s,
+                     gavl_video_frame_t ** frame)
+  {
+  gavl_source_status_t st;
+  gavl_video_frame_t * in_frame;
+  gavl_video_frame_t * out_frame;
+  
+  while((s->async_pending || (s->async_status == GAVL_SOURCE_OK)) &&
+        (s->async_count < s->num_async_in_frames))
+    {
+    /* The converter was full with the last call */
+    if(s->async_pending)
+      {
+      if(!gavl_video_converter_submit(s->cnv, s->async_pending))
+        break;
+      s->async_pending = NULL;
+      s->async_count++;
+      s->async_next = (s->async_next + 1) % s->num_async_in_frames;
+      continue;
+      }
+    
+    if(!s->async_in_frames[s->async_next])
+      s->async_in_frames[s->async_next] = create_in_frame(s);
+    
+    if(!(s->src_flags & GAVL_SOURCE_SRC_ALLOC))
+      in_frame = s->async_in_frames[s->async_next];
+    else
+      in_frame = NULL;
+    
+    if((st = s->read_frame(s, &in_frame)) != GAVL_SOURCE_OK)
+      {
+      /* Try again with the next call */
+      if(st != GAVL_SOURCE_AGAIN)
+        s->async_status = st;
+      break;
+      }
+    
+    /* Frames of the source are only valid until the next read */
+    if(s->src_flags & GAVL_SOURCE_SRC_ALLOC)
+      {
+      gavl_video_frame_copy(&s->src_format, s->async_in_frames[s->async_next], in_frame);
+      gavl_video_frame_copy_metadata(s->async_in_frames[s->async_next], in_frame);
+      in_frame = s->async_in_frames[s->async_next];
+      }
+    
+    /* Converter full: Complete a frame and submit this one later */
+    if(!gavl_video_converter_submit(s->cnv, in_frame))
+      {
+      s->async_pending = in_frame;
+      break;
+      }
+    s->async_count++;
+    s->async_next = (s->async_next + 1) % s->num_async_in_frames;
+    }
+  
+  if(!s->async_count)
+    {
+    if(s->async_status != GAVL_SOURCE_OK)
+      return s->async_status;
+    return GAVL_SOURCE_AGAIN;
+    }
+  
+  out_frame = gavl_video_converter_complete(s->cnv, 1);
+  s->async_count--;
+  
+  if(*frame)
+    {
+    gavl_video_frame_copy(&s->dst_format, *frame, out_frame);
+    gavl_video_frame_copy_metadata(*frame, out_frame);
+    }
+  else
+    *frame = out_frame;
+  
+  scale_pts(s, *frame);
+  return GAVL_SOURCE_OK;
+  }
+
 static void next_in_frame_fps(gavl_video_source_t * s)
   {
   gavl_video_frame_t * sav = s->in_frame;
@@ -540,6 +667,8 @@ void gavl_video_source_set_dst(gavl_video_source_t * s, int dst_flags,
   dst_fmt.timescale      = s->src_format.timescale;
   dst_fmt.frame_duration = s->src_format.frame_duration;
     
+  free_async(s);
+  
   if(gavl_video_converter_init(s->cnv, &s->src_format, &dst_fmt))
     s->flags |= FLAG_DO_CONVERT;
   else
@@ -579,6 +708,14 @@ void gavl_video_source_set_dst(gavl_video_source_t * s, int dst_flags,
   
   if(convert_fps)
     s->read_video = read_video_fps;
+  else if((s->flags & FLAG_DO_CONVERT) &&
+          gavl_video_options_get_async_frames(gavl_video_converter_get_options(s->cnv)))
+    {
+    s->num_async_in_frames =
+      gavl_video_options_get_async_frames(gavl_video_converter_get_options(s->cnv));
+    s->async_in_frames = calloc(s->num_async_in_frames, sizeof(*s->async_in_frames));
+    s->read_video = read_video_cnv_async;
+    }
   else if(s->flags & FLAG_DO_CONVERT)
     s->read_video = read_video_cnv;
   else
@@ -605,7 +742,14 @@ gavl_video_source_read_frame(void * sp, gavl_video_frame_t ** frame)
   if(!(s->flags & FLAG_DST_SET))
     gavl_video_source_set_dst(s, 0, NULL);
   
-  if(!frame)
+  if(!frame && s->async_count)
+    {
+    /* Skip a frame, which was read ahead */
+    gavl_video_converter_complete(s->cnv, 1);
+    s->async_count--;
+    return GAVL_SOURCE_OK;
+    }
+  else if(!frame)
     {
     /* Forget our status */
     gavl_video_source_reset(s);
@@ -26,9 +26,11 @@
 
 #include <gavl/connectors.h>
 
-typedef void (*gavl_blend_func_t)(gavl_overlay_blend_context_t * ctx,
-                                  gavl_video_frame_t * frame,
-                                  gavl_video_frame_t * overlay);
+/* Blend a width x height overlay onto the frame */
+
+typedef void (*gavl_blend_func_t)(gavl_video_frame_t * frame,
+                                  gavl_video_frame_t * overlay,
+                                  int width, int height);
 
 struct gavl_overlay_blend_context_s
   {
@@ -49,6 +51,62 @@ struct gavl_overlay_blend_context_s
   int dst_sub_h, dst_sub_v;
   
   gavl_video_sink_t * sink;
+
+  /* Large overlays are blended in horizontal bands */
+  gavl_video_jobs_t jobs;
+  gavl_thread_pool_t * tp_priv;
+  };
+
+/* Overlay compositor */
+
+typedef struct
+  {
+  gavl_overlay_blend_context_t * ctx;
+  gavl_video_sink_t * sink;
+  gavl_overlay_compositor_t * c;
+  int z;
+  int changed; /* Overlay was set since the last blend call */
+  } gavl_overlay_layer_t;
+
+/* Overlapping layers are merged into one cluster */
+
+typedef struct
+  {
+  gavl_rectangle_i_t rect;
+
+  int * layers; /* Sorted by z-order */
+  int num_layers;
+  int layers_alloc;
+  
+  /* Composite of all layers, NULL for clusters with one layer */
+  gavl_overlay_t * ovl;
+  } gavl_overlay_cluster_t;
+
+struct gavl_overlay_compositor_s
+  {
+  gavl_video_format_t dst_format;
+  gavl_video_format_t ovl_format; /* Format of the composited overlays */
+  
+  gavl_overlay_layer_t ** layers;
+  int num_layers;
+  int layers_alloc;
+
+  gavl_overlay_cluster_t * clusters;
+  int num_clusters;
+  gavl_overlay_cluster_t * old_clusters;
+  int num_old_clusters;
+  int clusters_alloc;
+
+  int changed;
+  
+  /* Blends overlays into a composite */
+  gavl_overlay_blend_context_t * comp_ctx;
+  /* Blends composites onto the frame */
+  gavl_overlay_blend_context_t * dst_ctx;
+  
+  gavl_video_frame_t * comp_win;
+  
+  gavl_video_options_t opt;
   };
 
 gavl_blend_func_t
@@ -56,5 +114,30 @@ gavl_find_blend_func_c(gavl_overlay_blend_context_t * ctx,
                        gavl_pixelformat_t frame_format,
                        gavl_pixelformat_t * overlay_format);
 
+/* SIMD versions for some formats. They return NULL if the frame format
+   is not supported, overlay_format must be the one set by the
+   C version */
+
+#ifdef HAVE_SSE2
+gavl_blend_func_t
+gavl_find_blend_func_sse2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format,
+                          gavl_pixelformat_t overlay_format);
+#endif
+
+#ifdef HAVE_SSSE3
+gavl_blend_func_t
+gavl_find_blend_func_ssse3(gavl_overlay_blend_context_t * ctx,
+                           gavl_pixelformat_t frame_format,
+                           gavl_pixelformat_t overlay_format);
+#endif
+
+#ifdef HAVE_AVX2
+gavl_blend_func_t
+gavl_find_blend_func_avx2(gavl_overlay_blend_context_t * ctx,
+                          gavl_pixelformat_t frame_format,
+                          gavl_pixelformat_t overlay_format);
+#endif
+
                        
 #endif // BLEND_H_INCLUDED
@@ -1217,7 +1217,80 @@ typedef struct
 
   gavl_video_func_t graya_float_to_gray_float;
   gavl_video_func_t gray_float_to_graya_float;
-  
+
+  /* Semiplanar formats */
+
+  gavl_video_func_t nv12_to_yuv_420_p;
+  gavl_video_func_t nv21_to_yuv_420_p;
+  gavl_video_func_t nv16_to_yuv_422_p;
+
+  gavl_video_func_t yuv_420_p_to_nv12;
+  gavl_video_func_t yuv_420_p_to_nv21;
+  gavl_video_func_t yuv_422_p_to_nv16;
+
+  gavl_video_func_t nv12_to_rgb_24;
+  gavl_video_func_t nv12_to_bgr_24;
+  gavl_video_func_t nv12_to_rgb_32;
+  gavl_video_func_t nv12_to_bgr_32;
+  gavl_video_func_t nv12_to_rgba_32;
+  gavl_video_func_t nv12_to_rgb_float;
+  gavl_video_func_t nv12_to_rgba_float;
+
+  gavl_video_func_t nv21_to_rgb_24;
+  gavl_video_func_t nv21_to_bgr_24;
+  gavl_video_func_t nv21_to_rgb_32;
+  gavl_video_func_t nv21_to_bgr_32;
+  gavl_video_func_t nv21_to_rgba_32;
+  gavl_video_func_t nv21_to_rgb_float;
+  gavl_video_func_t nv21_to_rgba_float;
+
+  gavl_video_func_t nv16_to_rgb_24;
+  gavl_video_func_t nv16_to_bgr_24;
+  gavl_video_func_t nv16_to_rgb_32;
+  gavl_video_func_t nv16_to_bgr_32;
+  gavl_video_func_t nv16_to_rgba_32;
+  gavl_video_func_t nv16_to_rgb_float;
+  gavl_video_func_t nv16_to_rgba_float;
+
+  gavl_video_func_t rgb_24_to_nv12;
+  gavl_video_func_t bgr_24_to_nv12;
+  gavl_video_func_t rgb_32_to_nv12;
+  gavl_video_func_t bgr_32_to_nv12;
+
+  gavl_video_func_t rgb_24_to_nv21;
+  gavl_video_func_t bgr_24_to_nv21;
+  gavl_video_func_t rgb_32_to_nv21;
+  gavl_video_func_t bgr_32_to_nv21;
+
+  gavl_video_func_t rgb_24_to_nv16;
+  gavl_video_func_t bgr_24_to_nv16;
+  gavl_video_func_t rgb_32_to_nv16;
+  gavl_video_func_t bgr_32_to_nv16;
+
+  /* 16 bit 4:2:0 formats */
+
+  gavl_video_func_t yuv_420_p_16_to_yuv_420_p;
+  gavl_video_func_t yuv_420_p_to_yuv_420_p_16;
+  gavl_video_func_t yuv_420_p_16_to_yuv_422_p_16;
+  gavl_video_func_t yuv_422_p_16_to_yuv_420_p_16;
+
+  gavl_video_func_t yuv_420_p_16_to_rgb_48;
+  gavl_video_func_t yuv_420_p_16_to_rgba_64;
+  gavl_video_func_t rgb_48_to_yuv_420_p_16;
+  gavl_video_func_t rgba_64_to_yuv_420_p_16;
+
+  gavl_video_func_t p016_to_yuv_420_p_16;
+  gavl_video_func_t yuv_420_p_16_to_p016;
+  gavl_video_func_t p016_to_yuv_420_p;
+  gavl_video_func_t yuv_420_p_to_p016;
+  gavl_video_func_t p016_to_nv12;
+  gavl_video_func_t nv12_to_p016;
+
+  gavl_video_func_t p016_to_rgb_48;
+  gavl_video_func_t p016_to_rgba_64;
+  gavl_video_func_t rgb_48_to_p016;
+  gavl_video_func_t rgba_64_to_p016;
+
   } gavl_pixelformat_function_table_t;
 
 void gavl_init_rgb_rgb_funcs_c(gavl_pixelformat_function_table_t *, const gavl_video_options_t * opt);
@@ -1274,9 +1347,36 @@ gavl_init_yuv_rgb_funcs_mmxext(gavl_pixelformat_function_table_t *,
 
 #endif
 
+#ifdef HAVE_SSE2
+void gavl_init_yuv_yuv_funcs_sse2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+#endif
+
 #ifdef HAVE_SSE3
 void gavl_init_rgb_yuv_funcs_sse3(gavl_pixelformat_function_table_t *,
                                   const gavl_video_options_t * opt);
 #endif
 
+#ifdef HAVE_SSSE3
+void gavl_init_rgb_rgb_funcs_ssse3(gavl_pixelformat_function_table_t *,
+                                   int width, const gavl_video_options_t * opt);
+
+void gavl_init_rgb_yuv_funcs_ssse3(gavl_pixelformat_function_table_t *,
+                                   int width, const gavl_video_options_t * opt);
+
+void gavl_init_yuv_rgb_funcs_ssse3(gavl_pixelformat_function_table_t *,
+                                   int width, const gavl_video_options_t * opt);
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_init_rgb_yuv_funcs_avx2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+
+void gavl_init_yuv_rgb_funcs_avx2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+
+void gavl_init_yuv_yuv_funcs_avx2(gavl_pixelformat_function_table_t *,
+                                  int width, const gavl_video_options_t * opt);
+#endif
+
 #endif // COLORSPACE_H_INCLUDED
@@ -46,6 +46,41 @@ typedef struct
   gavl_video_deinterlace_blend_func func_float;
   } gavl_video_deinterlace_blend_func_table_t;
 
+/*
+ *  Motion adaptive deinterlacing of one scanline y. prev and cur contain
+ *  the lines y-2 .. y+2 of the previous and current frame. Samples
+ *  [start, end[ of line y are interpolated into dst, num is the number
+ *  of samples per line and advance the distance between horizontally
+ *  neighboring pixels in samples (of the luma samples for packed 4:2:2).
+ *  prev is NULL if there is no previous frame.
+ */
+
+typedef void (*gavl_video_deinterlace_adaptive_func)(const uint8_t * const * prev,
+                                                     const uint8_t * const * cur,
+                                                     uint8_t * dst,
+                                                     int start, int end,
+                                                     int num, int advance);
+
+typedef struct
+  {
+  gavl_video_deinterlace_adaptive_func func_8;
+  gavl_video_deinterlace_adaptive_func func_yuy2; /* Packed 4:2:2 */
+  gavl_video_deinterlace_adaptive_func func_uyvy;
+  gavl_video_deinterlace_adaptive_func func_16;
+  gavl_video_deinterlace_adaptive_func func_float;
+  } gavl_video_deinterlace_adaptive_func_table_t;
+
+/* One plane for the adaptive deinterlacer */
+
+typedef struct
+  {
+  gavl_video_deinterlacer_t * d;
+  int plane;
+  int height;
+  int num;   /* Samples per line */
+  int bytes; /* Bytes per line */
+  } gavl_video_deinterlace_plane_t;
+
 struct gavl_video_deinterlacer_s
   {
   gavl_video_options_t opt;
@@ -71,6 +106,23 @@ struct gavl_video_deinterlacer_s
   int sub_v;
   
   int mixed;
+
+  /* Motion adaptive */
+  gavl_video_deinterlace_adaptive_func adaptive_func;
+  gavl_video_deinterlace_plane_t planes[GAVL_MAX_PLANES];
+  int advance;
+  
+  gavl_video_frame_t * prev_frame; /* Previous input frame */
+  gavl_video_frame_t * save_frame; /* Receives the current input frame */
+  int have_prev;
+
+  /* Set while deinterlacing */
+  const gavl_video_frame_t * input_frame;
+  gavl_video_frame_t * output_frame;
+  int field; /* Field, which is kept */
+
+  gavl_video_jobs_t jobs;
+  gavl_thread_pool_t * tp_priv;
   };
 
 /* Find conversion function */
@@ -82,6 +134,8 @@ int gavl_deinterlacer_init_blend(gavl_video_deinterlacer_t * d);
 
 int gavl_deinterlacer_init_copy(gavl_video_deinterlacer_t * d);
 
+int gavl_deinterlacer_init_adaptive(gavl_video_deinterlacer_t * d);
+
 void
 gavl_find_deinterlacer_blend_funcs_c(gavl_video_deinterlace_blend_func_table_t * tab,
                                      const gavl_video_options_t * opt,
@@ -99,6 +153,38 @@ gavl_find_deinterlacer_blend_funcs_mmxext(gavl_video_deinterlace_blend_func_tabl
                                           const gavl_video_format_t * format);
 #endif
 
+void
+gavl_find_deinterlacer_adaptive_funcs_c(gavl_video_deinterlace_adaptive_func_table_t * tab,
+                                        const gavl_video_options_t * opt,
+                                        const gavl_video_format_t * format);
+
+/* Used by the SIMD versions for the line borders */
+
+void gavl_deinterlace_adaptive_8_c(const uint8_t * const * prev,
+                                   const uint8_t * const * cur,
+                                   uint8_t * dst,
+                                   int start, int end,
+                                   int num, int advance);
+
+void gavl_deinterlace_adaptive_yuy2_c(const uint8_t * const * prev,
+                                      const uint8_t * const * cur,
+                                      uint8_t * dst,
+                                      int start, int end,
+                                      int num, int advance);
+
+void gavl_deinterlace_adaptive_uyvy_c(const uint8_t * const * prev,
+                                      const uint8_t * const * cur,
+                                      uint8_t * dst,
+                                      int start, int end,
+                                      int num, int advance);
+
+#ifdef HAVE_SSE2
+void
+gavl_find_deinterlacer_adaptive_funcs_sse2(gavl_video_deinterlace_adaptive_func_table_t * tab,
+                                           const gavl_video_options_t * opt,
+                                           const gavl_video_format_t * format);
+#endif
+
 #ifdef HAVE_3DNOW
 void
 gavl_find_deinterlacer_blend_funcs_3dnow(gavl_video_deinterlace_blend_func_table_t * tab,
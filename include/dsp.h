@@ -45,5 +45,15 @@ void gavl_dsp_init_sse(gavl_dsp_funcs_t * funcs,
                        int quality);
 #endif
 
+#ifdef HAVE_SSE2
+void gavl_dsp_init_sse2(gavl_dsp_funcs_t * funcs, 
+                        int quality);
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_dsp_init_avx2(gavl_dsp_funcs_t * funcs, 
+                        int quality);
+#endif
+
 
 #endif // DSP_H_INCLUDED
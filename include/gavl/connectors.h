@@ -311,6 +311,13 @@ gavl_video_source_get_dst_format(gavl_video_source_t * s);
  *  the frames will converted. For this, we have a
  *  \ref gavl_video_converter_t and also do simple framerate conversion
  *  which repeats/drops frames.
+ *
+ *  If the converter options (see \ref gavl_video_source_get_options)
+ *  have a nonzero number of asynchronous frames
+ *  (\ref gavl_video_options_set_async_frames) and no framerate
+ *  conversion is needed, the source reads ahead and converts that many
+ *  frames in the background. Frames returned in the internal buffer stay
+ *  valid until the next read.
  */
   
 GAVL_PUBLIC
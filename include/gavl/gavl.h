@@ -103,6 +103,14 @@ typedef struct gavl_video_format_s gavl_video_format_t;
 
 typedef struct gavl_video_frame_s gavl_video_frame_t;
 
+/** \ingroup video_options
+ * Opaque container for video conversion options
+ *
+ * You don't want to know what's inside.
+ */
+
+typedef struct gavl_video_options_s gavl_video_options_t;
+
 /* Global handle for accessing a piece of hardware */
 typedef struct gavl_hw_context_s gavl_hw_context_t;
 
@@ -1811,6 +1819,11 @@ void gavl_rectangle_f_dump(const gavl_rectangle_f_t * r);
  * Flag for grayscale pixelformats
  */
 #define GAVL_PIXFMT_GRAY   (1<<13)
+
+/** \ingroup video_format
+ * Flag for semiplanar pixelformats (luma plane + interleaved chroma plane)
+ */
+#define GAVL_PIXFMT_SEMIPLANAR (1<<14)
   
 /*! \ingroup video_format
  * \brief Pixelformat definition
@@ -1945,7 +1958,30 @@ enum gavl_pixelformat_e
     /*! 16 bit Planar YCbCr 4:2:2. Each component is an uint16_t in native byte order.
      */
     GAVL_YUV_422_P_16 = 10 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV,
-    
+
+    /*! Semiplanar YCbCr 4:2:0. Luma plane followed by a plane with interleaved Cb and Cr (CbCrCbCr...).
+     *  Each component is an uint8_t. Also known as NV12.
+     */
+    GAVL_NV12 = 11 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_SEMIPLANAR | GAVL_PIXFMT_YUV,
+    /*! Semiplanar YCbCr 4:2:0. Luma plane followed by a plane with interleaved Cr and Cb (CrCbCrCb...).
+     *  Each component is an uint8_t. Also known as NV21.
+     */
+    GAVL_NV21 = 12 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_SEMIPLANAR | GAVL_PIXFMT_YUV,
+    /*! Semiplanar YCbCr 4:2:2. Luma plane followed by a plane with interleaved Cb and Cr (CbCrCbCr...).
+     *  Each component is an uint8_t. Also known as NV16.
+     */
+    GAVL_NV16 = 13 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_SEMIPLANAR | GAVL_PIXFMT_YUV,
+
+    /*! 16 bit Planar YCbCr 4:2:0. Each component is an uint16_t in native byte order.
+     *  10 and 12 bit content is stored MSB aligned (i.e. the lowest bits are zero).
+     */
+    GAVL_YUV_420_P_16 = 14 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_YUV,
+    /*! 16 bit Semiplanar YCbCr 4:2:0. Luma plane followed by a plane with interleaved Cb and Cr (CbCrCbCr...).
+     *  Each component is an uint16_t in native byte order. Also known as P016. Since the
+     *  samples are MSB aligned, P010 and P012 frames can be used as P016 frames.
+     */
+    GAVL_P016 = 15 | GAVL_PIXFMT_PLANAR | GAVL_PIXFMT_SEMIPLANAR | GAVL_PIXFMT_YUV,
+
   };
 
 /*! \ingroup video_format
@@ -2064,6 +2100,28 @@ typedef enum
 
 #define  gavl_pixelformat_is_planar(fmt) ((fmt) & GAVL_PIXFMT_PLANAR)
 
+/*! \ingroup video_format
+ * \brief Check if a pixelformat is semiplanar
+ * \param fmt A pixelformat
+ * \returns 1 if the pixelformat is semiplanar, 0 else
+ *
+ * Semiplanar formats are also planar. They have 2 planes, the second one
+ * contains both chroma components interleaved.
+ */
+
+#define  gavl_pixelformat_is_semiplanar(fmt) ((fmt) & GAVL_PIXFMT_SEMIPLANAR)
+
+/*! \ingroup video_format
+ * \brief Get the planar counterpart of a semiplanar pixelformat
+ * \param pixelformat A pixelformat
+ * \returns The planar pixelformat with the same chroma subsampling
+ *
+ * For all other pixelformats, the argument is returned.
+ */
+
+GAVL_PUBLIC
+gavl_pixelformat_t gavl_pixelformat_get_planar(gavl_pixelformat_t pixelformat);
+
 
 /*! \ingroup video_format
  * \brief Get the number of channels
@@ -2168,6 +2226,26 @@ GAVL_PUBLIC gavl_pixelformat_t
 gavl_pixelformat_get_best(gavl_pixelformat_t src,
                           const gavl_pixelformat_t * dst_supported,
                           int * penalty);
+
+/*! \ingroup video_format
+ *  \brief Measure the speed of pixelformat conversions
+ *  \param cache_file File for storing the results or NULL
+ *  \returns 1 on success, 0 else
+ *
+ *  This times the conversion functions available on this CPU and
+ *  lets \ref gavl_pixelformat_conversion_penalty and \ref gavl_pixelformat_get_best
+ *  prefer the faster of otherwise equivalent conversions. The results are
+ *  loaded from the cache file, if it was written by the same gavl version
+ *  on a CPU with the same features. Otherwise the measurement is done
+ *  (which takes about a second) and the file is written. If cache_file is NULL,
+ *  a file in the user's cache directory is used.
+ *
+ *  Alternatively, set the environment variable GAVL_PIXELFORMAT_COSTS
+ *  to the cache file (or to an empty string for the default location).
+ */
+
+GAVL_PUBLIC
+int gavl_pixelformat_calibrate(const char * cache_file);
   
 
 
@@ -2788,11 +2866,12 @@ void gavl_video_frame_psnr(double * psnr,
   \returns 1 if the SSIM could be computed, 0 else
 
   This calculates the SSIM indices of each pixel for 2 source frames and
-  stores them into dst. The source frames must have the pixelformat
-  \ref GAVL_GRAY_FLOAT implying that only the luminance component is
-  considered. The destination also has the pixelformat \ref GAVL_GRAY_FLOAT.
-  If other pixelformats are passed to this function it will return 0 and
-  nothing is done.
+  stores them into dst. The source frames must have one of the
+  pixelformats \ref GAVL_GRAY_8, \ref GAVL_GRAY_16, \ref GAVL_GRAY_FLOAT
+  or a planar 8 or 16 bit YUV format. Only the luminance component is
+  considered. The destination has the pixelformat \ref GAVL_GRAY_FLOAT
+  and the image size of the source frames. If other pixelformats are passed
+  to this function it will return 0 and nothing is done.
 
   The SSIM algorithm is taken from the paper "Image Quality Assessment:
   From Error Visibility to Structural Similarity" by Z. Want et. al.
@@ -2810,6 +2889,29 @@ int gavl_video_frame_ssim(const gavl_video_frame_t * src1,
                           gavl_video_frame_t * dst,
                           const gavl_video_format_t * format);
 
+/*!
+  \ingroup video_frame
+  \brief Calculate the mean SSIM of 2 source frames
+  \param ssim Returns the mean SSIM for all planes (maximum 3)
+  \param src1 First source frame
+  \param src2 Second source frame
+  \param format Format of the data in the frame
+  \param opt Options or NULL
+  \returns The number of planes or 0 if the SSIM could not be computed
+
+  Like \ref gavl_video_frame_ssim but no per pixel indices are stored.
+  For YUV formats, the SSIM of the chroma planes is returned as well.
+  The calculation is done in the thread pool of the options. If opt is NULL
+  or has no thread pool, the shared pool is used.
+*/
+
+GAVL_PUBLIC
+int gavl_video_frame_ssim_mean(double * ssim,
+                               const gavl_video_frame_t * src1,
+                               const gavl_video_frame_t * src2,
+                               const gavl_video_format_t * format,
+                               const gavl_video_options_t * opt);
+
 /*!
   \ingroup video_frame
   \brief Copy one video frame to another
@@ -3159,6 +3261,16 @@ void gavl_video_frame_set_from_packet(gavl_video_frame_t * frame,
  */
 
 #define GAVL_FORCE_SW          (1<<4)
+
+/** \ingroup video_conversion_flags
+ * \brief Cascaded scaling in the ladder scaler
+ *
+ * Scale each output of a \ref gavl_video_ladder_scaler_t from the next larger
+ * output instead of the input frame. This is faster for many outputs
+ * at the cost of some quality.
+ */
+
+#define GAVL_SCALE_CASCADE     (1<<5)
   
 /** \ingroup video_options
  * Alpha handling mode
@@ -3184,7 +3296,8 @@ typedef enum
     GAVL_DEINTERLACE_NONE      = 0, /*!< Don't care about interlacing                */
     GAVL_DEINTERLACE_COPY      = 1, /*!< Take one field and copy it to the other     */
     GAVL_DEINTERLACE_SCALE     = 2, /*!< Take one field and scale it vertically by 2 */
-    GAVL_DEINTERLACE_BLEND     = 3  /*!< Linear blend fields together */
+    GAVL_DEINTERLACE_BLEND     = 3, /*!< Linear blend fields together */
+    GAVL_DEINTERLACE_ADAPTIVE  = 4  /*!< Motion adaptive, uses the previous frame  */
   } gavl_deinterlace_mode_t;
 
 /** \ingroup video_options
@@ -3231,16 +3344,9 @@ typedef enum
     GAVL_DOWNSCALE_FILTER_NONE, //!< Fastest method, might produce heavy aliasing artifacts
     GAVL_DOWNSCALE_FILTER_WIDE, //!< Widen the filter curve according to the scaling ratio. 
     GAVL_DOWNSCALE_FILTER_GAUSS, //!< Do a Gaussian preblur
+    GAVL_DOWNSCALE_FILTER_BOX, //!< Average the covered source pixels. Integer ratios use dedicated kernels
   } gavl_downscale_filter_t;
   
-/** \ingroup video_options
- * Opaque container for video conversion options
- *
- * You don't want to know what's inside.
- */
-
-typedef struct gavl_video_options_s gavl_video_options_t;
-
 /* Default Options */
 
 /*! \ingroup video_options
@@ -3525,15 +3631,40 @@ void gavl_video_options_set_downscale_blur(gavl_video_options_t * opt,
 GAVL_PUBLIC
 float gavl_video_options_get_downscale_blur(const gavl_video_options_t * opt);
 
-/* Set an externally created thread pool. If this is not called, a private thread pool will be created if needed.
-   This function has the advantage that one thread pool can be shared among different elements of a video
-   pipeline, which will reduce the overhead */
+/* Set an externally created thread pool. If this is not called, the process wide pool
+   (see gavl_thread_pool_get_shared()) is used if needed. Setting a pool has the advantage that
+   the number of threads can be chosen and that elements of a video pipeline don't have to wait
+   for other users of the shared pool */
   
 GAVL_PUBLIC
 void gavl_video_options_set_thread_pool(gavl_video_options_t * opt, gavl_thread_pool_t * tp);
 
 GAVL_PUBLIC
 gavl_thread_pool_t * gavl_video_options_get_thread_pool(const gavl_video_options_t * opt);
+
+/*! \ingroup video_options
+ *  \brief Set the number of frames for asynchronous conversion
+ *  \param opt Video options
+ *  \param num Maximum number of frames in flight
+ *
+ *  This limits the number of frames, which can be submitted to
+ *  \ref gavl_video_converter_submit before one is completed. 0 (the default)
+ *  means one frame per thread of the pool. For video sources,
+ *  a nonzero value enables asynchronous conversion (see
+ *  \ref gavl_video_source_set_dst).
+ */
+
+GAVL_PUBLIC
+void gavl_video_options_set_async_frames(gavl_video_options_t * opt, int num);
+
+/*! \ingroup video_options
+ *  \brief Get the number of frames for asynchronous conversion
+ *  \param opt Video options
+ *  \returns Maximum number of frames in flight
+ */
+
+GAVL_PUBLIC
+int gavl_video_options_get_async_frames(const gavl_video_options_t * opt);
   
 /***************************************************
  * Create and destroy video converters
@@ -3638,6 +3769,17 @@ int gavl_video_converter_init(gavl_video_converter_t* cnv,
   
 GAVL_PUBLIC
 int gavl_video_converter_reinit(gavl_video_converter_t* cnv);
+
+/*! \ingroup video_converter
+ *  \brief Forget the previous frames
+ *  \param cnv A video converter
+ *
+ * Call this after seeking. It resets the internal deinterlacers, which use
+ * the previous frame (see \ref GAVL_DEINTERLACE_ADAPTIVE).
+ */
+
+GAVL_PUBLIC
+void gavl_video_converter_reset(gavl_video_converter_t* cnv);
  
   
 /***************************************************
@@ -3656,6 +3798,43 @@ void gavl_video_convert(gavl_video_converter_t * cnv,
                         const gavl_video_frame_t * input_frame,
                         gavl_video_frame_t * output_frame);
 
+/*! \ingroup video_converter
+ *  \brief Start converting a frame asynchronously
+ *  \param cnv A video converter
+ *  \param input_frame Input frame
+ *  \returns 1 if the frame was submitted, 0 if too many frames are in flight
+ *
+ *  The frame is converted by the thread pool while the caller continues.
+ *  The input frame must stay valid until the converted frame was returned by
+ *  \ref gavl_video_converter_complete. If 0 is returned, complete a frame and
+ *  try again (see \ref gavl_video_options_set_async_frames).
+ *
+ *  Reinitializing the converter waits for all frames in flight and discards them.
+ *
+ *  With \ref GAVL_DEINTERLACE_ADAPTIVE, each frame depends on the previous one.
+ *  In this case, the frame is converted before this function returns.
+ */
+
+GAVL_PUBLIC
+int gavl_video_converter_submit(gavl_video_converter_t * cnv,
+                                const gavl_video_frame_t * input_frame);
+
+/*! \ingroup video_converter
+ *  \brief Get the next asynchronously converted frame
+ *  \param cnv A video converter
+ *  \param wait If nonzero, wait until the frame is finished
+ *  \returns The converted frame or NULL
+ *
+ *  Frames are returned in the order they were submitted, so timestamps
+ *  stay in order. NULL is returned if no frames are in flight or if wait is
+ *  zero and the next frame is not finished yet. The returned frame is owned by
+ *  the converter and stays valid until the next call of this function.
+ */
+
+GAVL_PUBLIC
+gavl_video_frame_t * gavl_video_converter_complete(gavl_video_converter_t * cnv,
+                                                   int wait);
+
 
 /*! \defgroup video_scaler Scaler
  *  \ingroup video
@@ -3773,6 +3952,77 @@ void gavl_video_scaler_scale(gavl_video_scaler_t * scaler,
                              const gavl_video_frame_t * input_frame,
                              gavl_video_frame_t * output_frame);
 
+/*! \ingroup video_scaler
+ *  \brief Opaque ladder scaler structure.
+ *
+ *  A ladder scaler scales one input frame to several output sizes at once
+ *  (e.g. for adaptive bitrate streaming). It is faster than several
+ *  \ref gavl_video_scaler_t instances because the first scaling pass is shared between
+ *  outputs of the same width and all outputs are scheduled together on the
+ *  thread pool.
+ */
+  
+typedef struct gavl_video_ladder_scaler_s gavl_video_ladder_scaler_t;
+
+/*! \ingroup video_scaler
+ *  \brief Create a ladder scaler
+ *  \returns A newly allocated ladder scaler
+ */
+
+GAVL_PUBLIC
+gavl_video_ladder_scaler_t * gavl_video_ladder_scaler_create(void);
+
+/*! \ingroup video_scaler
+ *  \brief Destroy a ladder scaler
+ *  \param scaler A ladder scaler
+ */
+
+GAVL_PUBLIC
+void gavl_video_ladder_scaler_destroy(gavl_video_ladder_scaler_t * scaler);
+
+/*! \ingroup video_scaler
+ *  \brief gets options of a ladder scaler
+ *  \param scaler A ladder scaler
+ *
+ * The options are used for all outputs. Rectangles are ignored, the
+ * whole input frame is always scaled into the whole output frames.
+ * Set \ref GAVL_SCALE_CASCADE in the conversion flags for cascaded scaling.
+ * Options will become valid with the next call to \ref gavl_video_ladder_scaler_init
+ */
+  
+GAVL_PUBLIC gavl_video_options_t *
+gavl_video_ladder_scaler_get_options(gavl_video_ladder_scaler_t * scaler);
+
+/*! \ingroup video_scaler
+ *  \brief Initialize a ladder scaler
+ *  \param scaler A ladder scaler
+ *  \param src_format Input format
+ *  \param dst_formats Output formats
+ *  \param num_outputs Number of output formats
+ *  \returns 1 on success, 0 on error
+ *
+ * The same restrictions as for \ref gavl_video_scaler_init apply
+ * to each output format.
+ */
+
+GAVL_PUBLIC
+int gavl_video_ladder_scaler_init(gavl_video_ladder_scaler_t * scaler,
+                                  const gavl_video_format_t * src_format,
+                                  const gavl_video_format_t * dst_formats,
+                                  int num_outputs);
+
+/*! \ingroup video_scaler
+ *  \brief Scale a frame to all outputs
+ *  \param scaler A ladder scaler
+ *  \param input_frame Input frame
+ *  \param output_frames Output frames (one for each output format)
+ */
+  
+GAVL_PUBLIC
+void gavl_video_ladder_scaler_scale(gavl_video_ladder_scaler_t * scaler,
+                                    const gavl_video_frame_t * input_frame,
+                                    gavl_video_frame_t ** output_frames);
+
 /*! \defgroup video_deinterlacer Deinterlacer
  *  \ingroup video
  *  \brief Deinterlacer
@@ -3844,6 +4094,16 @@ void gavl_video_deinterlacer_deinterlace(gavl_video_deinterlacer_t * deinterlace
                                          const gavl_video_frame_t * input_frame,
                                          gavl_video_frame_t * output_frame);
 
+/*! \ingroup video_deinterlacer
+ *  \brief Forget the previous frame
+ *  \param deinterlacer A video deinterlacer
+ *
+ * \ref GAVL_DEINTERLACE_ADAPTIVE uses the previous input frame, so frames
+ * must be passed in display order. Call this after seeking.
+ */
+  
+GAVL_PUBLIC
+void gavl_video_deinterlacer_reset(gavl_video_deinterlacer_t * deinterlacer);
   
   
 /**************************************************
@@ -3965,7 +4225,305 @@ void gavl_overlay_blend(gavl_overlay_blend_context_t * ctx,
 
 GAVL_PUBLIC gavl_video_sink_t *
 gavl_overlay_blend_context_get_sink(gavl_overlay_blend_context_t * ctx);
+
+/*! \ingroup video_blend
+ *  \brief Opaque overlay compositor
+ *
+ *  A compositor blends several overlays (e.g. subtitles, logo
+ *  and clock) onto the same frame. Each overlay lives in a layer
+ *  with a z-order. Overlays with overlapping rectangles are
+ *  blended together first, so each area of the frame is
+ *  blended only once. The result is reused as long as none of
+ *  the overlays changes.
+ */
+  
+typedef struct gavl_overlay_compositor_s gavl_overlay_compositor_t;
+
+/*! \ingroup video_blend
+ *  \brief Create an overlay compositor
+ *  \returns A newly allocated compositor.
+ */
   
+GAVL_PUBLIC
+gavl_overlay_compositor_t * gavl_overlay_compositor_create(void);
+
+/*! \ingroup video_blend
+ *  \brief Destroy an overlay compositor and free all associated memory
+ *  \param c An overlay compositor
+ */
+
+GAVL_PUBLIC
+void gavl_overlay_compositor_destroy(gavl_overlay_compositor_t * c);
+
+/*! \ingroup video_blend
+ *  \brief Get options from an overlay compositor
+ *  \param c An overlay compositor
+ *  \returns Options (See \ref video_options)
+ */
+  
+GAVL_PUBLIC gavl_video_options_t *
+gavl_overlay_compositor_get_options(gavl_overlay_compositor_t * c);
+
+/*! \ingroup video_blend
+ *  \brief Initialize an overlay compositor
+ *  \param c An overlay compositor
+ *  \param frame_format The format of the destination frames
+ *  \returns 1 on success, 0 if the format is not supported
+ *
+ *  This removes all layers.
+ */
+
+GAVL_PUBLIC
+int gavl_overlay_compositor_init(gavl_overlay_compositor_t * c,
+                                 const gavl_video_format_t * frame_format);
+
+/*! \ingroup video_blend
+ *  \brief Add a layer to an overlay compositor
+ *  \param c An overlay compositor
+ *  \param overlay_format The format of the overlays
+ *  \param z_order Layers with higher values are blended on top
+ *  \returns The index of the layer or -1
+ *
+ *  The overlay_format is handled like in \ref gavl_overlay_blend_context_init.
+ *  Layers with the same z_order are stacked in the order they were added.
+ */
+
+GAVL_PUBLIC
+int gavl_overlay_compositor_add_layer(gavl_overlay_compositor_t * c,
+                                      gavl_video_format_t * overlay_format,
+                                      int z_order);
+
+/*! \ingroup video_blend
+ *  \brief Set a new overlay for a layer
+ *  \param c An overlay compositor
+ *  \param layer Index of the layer
+ *  \param ovl An overlay or NULL to hide the layer
+ *
+ *  The layer is marked as changed. If you modify the pixels of
+ *  an overlay, you must pass it here again.
+ */
+  
+GAVL_PUBLIC
+void gavl_overlay_compositor_set_overlay(gavl_overlay_compositor_t * c,
+                                         int layer, gavl_overlay_t * ovl);
+
+/*! \ingroup video_blend
+ *  \brief Get the sink for overlays of a layer
+ *  \param c An overlay compositor
+ *  \param layer Index of the layer
+ *  \return A video sink
+ */
+
+GAVL_PUBLIC gavl_video_sink_t *
+gavl_overlay_compositor_get_sink(gavl_overlay_compositor_t * c, int layer);
+
+/*! \ingroup video_blend
+ *  \brief Blend all layers onto a video frame
+ *  \param c An overlay compositor
+ *  \param dst_frame Destination frame
+ */
+  
+GAVL_PUBLIC
+void gavl_overlay_compositor_blend(gavl_overlay_compositor_t * c,
+                                   gavl_video_frame_t * dst_frame);
+  
+/*! \defgroup video_metrics Quality metrics
+ * \ingroup video
+ *
+ *  A metrics object compares a distorted video stream (e.g. the output
+ *  of an encoder) with the reference stream. Frames are passed to
+ *  2 video sinks and paired by their timestamps. For each pair, the
+ *  PSNR, SSIM and MS-SSIM of each plane are calculated. The results are
+ *  available for each frame and as statistics of the whole sequence.
+ *
+ *  Frames in formats other than gray or planar YUV are converted first.
+ *
+ * @{
+ */
+
+/** \brief Quality metrics
+ */
+
+typedef enum
+  {
+    GAVL_METRIC_PSNR    = 0, /*!< Peak signal to noise ratio in dB */
+    GAVL_METRIC_SSIM    = 1, /*!< Structural similarity */
+    GAVL_METRIC_MS_SSIM = 2, /*!< Multi scale structural similarity */
+  } gavl_metric_t;
+
+#define GAVL_METRIC_NUM 3 /*!< Number of metrics */
+
+#define GAVL_METRICS_PSNR    (1<<GAVL_METRIC_PSNR)    /*!< Calculate the PSNR */
+#define GAVL_METRICS_SSIM    (1<<GAVL_METRIC_SSIM)    /*!< Calculate the SSIM */
+#define GAVL_METRICS_MS_SSIM (1<<GAVL_METRIC_MS_SSIM) /*!< Calculate the MS-SSIM */
+
+#define GAVL_METRICS_MAX_PLANES 3 /*!< Maximum number of planes */
+
+#define GAVL_METRICS_PSNR_MAX 100.0 /*!< PSNR of identical planes */
+
+#define GAVL_METRICS_MAX_FRAMES 65536 /*!< Maximum number of frames, whose metrics are kept */
+
+/** \brief Metrics of one frame
+ */
+
+typedef struct
+  {
+  int64_t pts; /*!< Timestamp of the frame */
+  double values[GAVL_METRIC_NUM][GAVL_METRICS_MAX_PLANES]; /*!< Value of each metric and plane */
+  } gavl_video_metrics_frame_t;
+
+/** \brief Statistics of one metric over all frames
+ */
+
+typedef struct
+  {
+  int num_frames; /*!< Number of frame pairs */
+  double mean;    /*!< Mean value */
+  double min;     /*!< Minimum value */
+  double max;     /*!< Maximum value */
+  } gavl_video_metrics_stats_t;
+
+/** \brief Opaque metrics structure
+ *
+ * You don't want to know what's inside.
+ */
+
+typedef struct gavl_video_metrics_s gavl_video_metrics_t;
+
+/** \brief Callback for the metrics of each frame
+ */
+
+typedef void (*gavl_video_metrics_callback)(void * data,
+                                            const gavl_video_metrics_frame_t * frame);
+
+/** \brief Create a metrics object
+ *  \returns A newly allocated metrics object
+ */
+
+GAVL_PUBLIC
+gavl_video_metrics_t * gavl_video_metrics_create(void);
+
+/** \brief Destroy a metrics object
+ *  \param m A metrics object
+ */
+
+GAVL_PUBLIC
+void gavl_video_metrics_destroy(gavl_video_metrics_t * m);
+
+/** \brief Get the options of a metrics object
+ *  \param m A metrics object
+ *  \returns Options (See \ref video_options)
+ *
+ *  The options are used for the format conversion. If a thread
+ *  pool is set, it is used for the calculation as well.
+ */
+
+GAVL_PUBLIC gavl_video_options_t *
+gavl_video_metrics_get_options(gavl_video_metrics_t * m);
+
+/** \brief Initialize a metrics object
+ *  \param m A metrics object
+ *  \param format Format of both video streams
+ *  \param flags ORed combination of GAVL_METRICS_* flags
+ *  \returns The number of planes, which are compared or 0 on error
+ *
+ *  This also clears the results of the previous sequence.
+ */
+
+GAVL_PUBLIC
+int gavl_video_metrics_init(gavl_video_metrics_t * m,
+                            const gavl_video_format_t * format,
+                            int flags);
+
+/** \brief Set a callback for the metrics of each frame
+ *  \param m A metrics object
+ *  \param cb Callback, which is called after a frame pair is done
+ *  \param data Data passed to the callback
+ */
+
+GAVL_PUBLIC
+void gavl_video_metrics_set_callback(gavl_video_metrics_t * m,
+                                     gavl_video_metrics_callback cb,
+                                     void * data);
+
+/** \brief Get the sink for the reference frames
+ *  \param m A metrics object
+ *  \returns A video sink
+ */
+
+GAVL_PUBLIC gavl_video_sink_t *
+gavl_video_metrics_get_reference_sink(gavl_video_metrics_t * m);
+
+/** \brief Get the sink for the distorted frames
+ *  \param m A metrics object
+ *  \returns A video sink
+ *
+ *  The sinks can be used from different threads. Frames, which
+ *  don't get a partner with the same timestamp, are ignored.
+ */
+
+GAVL_PUBLIC gavl_video_sink_t *
+gavl_video_metrics_get_distorted_sink(gavl_video_metrics_t * m);
+
+/** \brief Get the number of compared frames
+ *  \param m A metrics object
+ *  \returns The number of frame pairs, whose metrics are kept
+ *
+ *  The metrics of at most \ref GAVL_METRICS_MAX_FRAMES frame pairs are
+ *  kept. After that, the oldest ones are dropped. The statistics
+ *  (see \ref gavl_video_metrics_get_stats) include all frame pairs.
+ */
+
+GAVL_PUBLIC
+int gavl_video_metrics_get_num_frames(gavl_video_metrics_t * m);
+
+/** \brief Get the metrics of a frame
+ *  \param m A metrics object
+ *  \param index Index of the frame pair (0 is the oldest kept one)
+ *  \returns The metrics or NULL
+ *
+ *  Values of metrics, which were not enabled, are undefined. The
+ *  returned data can be overwritten when more frames are compared.
+ */
+
+GAVL_PUBLIC const gavl_video_metrics_frame_t *
+gavl_video_metrics_get_frame(gavl_video_metrics_t * m, int index);
+
+/** \brief Get the statistics of a metric
+ *  \param m A metrics object
+ *  \param metric A metric
+ *  \param plane A plane
+ *  \param ret Returns the statistics
+ *  \returns 1 on success, 0 if the metric isn't available
+ */
+
+GAVL_PUBLIC
+int gavl_video_metrics_get_stats(gavl_video_metrics_t * m,
+                                 gavl_metric_t metric, int plane,
+                                 gavl_video_metrics_stats_t * ret);
+
+/** \brief Get a percentile of a metric
+ *  \param m A metrics object
+ *  \param metric A metric
+ *  \param plane A plane
+ *  \param percent Percentage (0.0 .. 100.0)
+ *  \param ret Returns the value
+ *  \returns 1 on success, 0 if the metric isn't available
+ *
+ *  The value is interpolated between the closest frames. Small
+ *  percentages give the quality of the worst frames. Only the kept
+ *  frames (see \ref gavl_video_metrics_get_num_frames) are considered.
+ */
+
+GAVL_PUBLIC
+int gavl_video_metrics_get_percentile(gavl_video_metrics_t * m,
+                                      gavl_metric_t metric, int plane,
+                                      double percent, double * ret);
+
+/**
+ * @}
+ */
+
 /*! \defgroup video_transform Image transformation
  * \ingroup video
  *
@@ -4049,6 +4607,41 @@ int gavl_image_transform_init(gavl_image_transform_t * t,
                               gavl_video_format_t * format,
                               gavl_image_transform_func func, void * priv);
 
+/** \brief Initialize a transformation engine with a projective matrix
+ *  \param t A transformation engine
+ *  \param format Format (can be changed)
+ *  \param matrix Coordinate transform matrix
+ *  \returns 1 if the transform was successfully initialized, 0 else.
+ *
+ * The matrix maps the destination coordinates (xdst, ydst, 1) to the
+ * homogeneous source coordinates (xsrc * w, ysrc * w, w). Coordinates
+ * are the same as for \ref gavl_image_transform_func. For affine
+ * transforms, the last row is 0, 0, 1.
+ *
+ * The source coordinates are calculated on the fly while transforming,
+ * so no coordinate table is built. This makes initialization much faster
+ * and allows to change the matrix for each frame with
+ * \ref gavl_image_transform_set_matrix.
+ */
+
+GAVL_PUBLIC
+int gavl_image_transform_init_matrix(gavl_image_transform_t * t,
+                                     gavl_video_format_t * format,
+                                     const double matrix[3][3]);
+
+/** \brief Change the matrix of a transformation engine
+ *  \param t A transformation engine
+ *  \param matrix Coordinate transform matrix
+ *
+ * The engine must be initialized with
+ * \ref gavl_image_transform_init_matrix. The new matrix is used
+ * starting with the next call to \ref gavl_image_transform_transform.
+ */
+
+GAVL_PUBLIC
+void gavl_image_transform_set_matrix(gavl_image_transform_t * t,
+                                     const double matrix[3][3]);
+
 /** \brief Transform an image
  *  \param t A transformation engine
  *  \param in_frame Input frame
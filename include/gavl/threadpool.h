@@ -30,8 +30,21 @@
 typedef struct gavl_thread_pool_s gavl_thread_pool_t;
 
 GAVL_PUBLIC gavl_thread_pool_t * gavl_thread_pool_create(int num_threads);
+
+/* Thread pools are reference counted. gavl_thread_pool_create() returns a pool with
+   one reference, gavl_thread_pool_destroy() releases one and stops the threads
+   after the last one is gone */
+
+GAVL_PUBLIC gavl_thread_pool_t * gavl_thread_pool_ref(gavl_thread_pool_t *);
 GAVL_PUBLIC void gavl_thread_pool_destroy(gavl_thread_pool_t *);
 
+/* Get a reference to the process wide pool with one thread per CPU. It is created
+   on the first call and never stopped. Converters, scalers and image transforms use
+   it if no pool was set in the options. Release the reference with
+   gavl_thread_pool_destroy(). */
+
+GAVL_PUBLIC gavl_thread_pool_t * gavl_thread_pool_get_shared(void);
+
 GAVL_PUBLIC int gavl_thread_pool_get_num_threads(gavl_thread_pool_t *);
 
 GAVL_PUBLIC void gavl_thread_pool_run(void (*func)(void*,int start, int len),
@@ -41,4 +54,30 @@ GAVL_PUBLIC void gavl_thread_pool_run(void (*func)(void*,int start, int len),
 
 GAVL_PUBLIC void gavl_thread_pool_stop(void * client_data, int thread);
 
+/* Call func(data, chunk_start, chunk_end) for consecutive chunks of
+   [start, end[ and return after all chunks are done. The chunks are
+   distributed over the threads by work stealing, and the calling thread
+   works on them as well. If chunk is < 1, a chunk size giving several
+   chunks per thread is chosen. Unlike gavl_thread_pool_run(), this can
+   be called from several threads at once. */
+
+GAVL_PUBLIC void gavl_thread_pool_parallel_for(gavl_thread_pool_t * p,
+                                               void (*func)(void*, int start, int end),
+                                               void * data,
+                                               int start, int end, int chunk);
+
+/* Queue func(data, start, end) and return immediately. The caller must
+   find out by itself, when the function is finished. */
+
+GAVL_PUBLIC void gavl_thread_pool_submit(gavl_thread_pool_t * p,
+                                         void (*func)(void*, int start, int end),
+                                         void * data, int start, int end);
+
+/* Run one queued task in the calling thread. Returns 1 if a task was run,
+   0 if the queues are empty. Call this while waiting for submitted tasks,
+   so the waiting thread helps instead of sleeping. If it returns 0, all
+   submitted tasks are running in other threads already. */
+
+GAVL_PUBLIC int gavl_thread_pool_help(gavl_thread_pool_t * p);
+
 #endif // GAVL_THREADPOOL_H_INCLUDED
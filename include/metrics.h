@@ -0,0 +1,146 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#ifndef METRICS_H_INCLUDED
+#define METRICS_H_INCLUDED
+
+/* Private structures for the quality metrics */
+
+#include "config.h"
+
+#include <pthread.h>
+
+#include <ssim.h>
+
+/* Frames kept for each stream until the partner arrives */
+
+#define GAVL_METRICS_QUEUE 16
+
+/* Scales for the MS-SSIM */
+
+#define GAVL_METRICS_SCALES 5
+
+/* Sums of squared differences for the PSNR */
+
+typedef struct
+  {
+  uint64_t (*sse_8)(const uint8_t * src1, const uint8_t * src2, int num);
+  uint64_t (*sse_16)(const uint16_t * src1, const uint16_t * src2, int num);
+  double (*sse_float)(const float * src1, const float * src2, int num);
+  } gavl_metrics_funcs_t;
+
+void gavl_init_metrics_funcs_c(gavl_metrics_funcs_t * funcs);
+
+#ifdef HAVE_SSE2
+void gavl_init_metrics_funcs_sse2(gavl_metrics_funcs_t * funcs);
+#endif
+
+/* One of the 2 input streams */
+
+typedef struct
+  {
+  gavl_video_metrics_t * m;
+  gavl_video_sink_t * sink;
+  gavl_video_converter_t * cnv;
+
+  gavl_video_frame_t * queue[GAVL_METRICS_QUEUE];
+  int num_queued;
+  } gavl_metrics_stream_t;
+
+/* One plane of a frame pair */
+
+typedef struct
+  {
+  gavl_video_metrics_t * m;
+  
+  int width;
+  int height;
+  int bytes;
+  
+  const uint8_t * src[2];
+  int strides[2];
+  double * row_sums;
+
+  /* Downscaled planes of both frames for the MS-SSIM */
+  int num_scales;
+  float * scaled[2][GAVL_METRICS_SCALES];
+  int scaled_width[GAVL_METRICS_SCALES];
+  int scaled_height[GAVL_METRICS_SCALES];
+  
+  gavl_ssim_plane_t ssim[GAVL_METRICS_SCALES];
+  } gavl_metrics_plane_t;
+
+/* Downscaling of one scale of a plane */
+
+typedef struct
+  {
+  gavl_metrics_plane_t * p;
+  int stream;
+  int scale;
+  } gavl_metrics_scale_job_t;
+
+struct gavl_video_metrics_s
+  {
+  gavl_video_options_t opt;
+  gavl_video_format_t format;
+
+  /* Format, in which the metrics are calculated */
+  gavl_video_format_t metrics_format;
+  int do_convert;
+  
+  int flags;
+  int num_planes;
+  
+  gavl_metrics_stream_t streams[2];
+  gavl_metrics_plane_t planes[GAVL_METRICS_MAX_PLANES];
+  gavl_metrics_scale_job_t
+    scale_jobs[2 * GAVL_METRICS_MAX_PLANES * GAVL_METRICS_SCALES];
+  
+  /* Unused frames. Besides the queues, each stream can hold the frame it
+     converts and a pair it compares */
+  gavl_video_frame_t * pool[2 * GAVL_METRICS_QUEUE + 4];
+  int pool_size;
+  
+  gavl_ssim_funcs_t ssim_funcs;
+  gavl_metrics_funcs_t funcs;
+
+  gavl_video_jobs_t jobs;
+  gavl_thread_pool_t * tp_priv;
+
+  /* Results of the last GAVL_METRICS_MAX_FRAMES frame pairs */
+  gavl_video_metrics_frame_t * frames;
+  int num_frames;
+  int frames_alloc;
+  int frames_start;
+
+  gavl_video_metrics_stats_t stats[GAVL_METRIC_NUM][GAVL_METRICS_MAX_PLANES];
+  
+  gavl_video_metrics_callback cb;
+  void * cb_data;
+  
+  /* Protects the queues, the frame pool and the results */
+  pthread_mutex_t mutex;
+
+  /* Serializes the calculation, which uses the planes and jobs above,
+     and the callback. Locked before the mutex */
+  pthread_mutex_t compare_mutex;
+  };
+
+#endif // METRICS_H_INCLUDED
@@ -49,6 +49,9 @@ typedef struct
   int factors_per_pixel;
   int do_clip; /* Use routines with clipping */
   int normalized;
+
+  /* Cached table, whose factors we share (read only). NULL if we own them */
+  struct gavl_video_scale_table_entry_s * entry;
   } gavl_video_scale_table_t;
 
 typedef void
@@ -115,6 +118,14 @@ void gavl_init_scale_funcs_bicubic_noclip_c(gavl_scale_funcs_t * tab);
 void gavl_init_scale_funcs_generic_c(gavl_scale_funcs_t * tab);
 void gavl_init_scale_funcs_generic_noclip_c(gavl_scale_funcs_t * tab);
 
+/* Box filter for integer ratios, x and y at once */
+
+void gavl_init_scale_funcs_box_c(gavl_scale_funcs_t * tab);
+
+/* Sliding window for box convolution in x-direction */
+
+void gavl_init_scale_funcs_slide_x_c(gavl_scale_funcs_t * tab);
+
 
 #ifdef HAVE_MMX
 void gavl_init_scale_funcs_bicubic_y_mmx(gavl_scale_funcs_t * tab,
@@ -256,6 +267,19 @@ void gavl_init_scale_funcs_generic_x_sse3(gavl_scale_funcs_t * tab);
 
 #endif
 
+#ifdef HAVE_SSSE3
+void gavl_init_scale_funcs_box_ssse3(gavl_scale_funcs_t * tab,
+                                     int num_h, int num_v,
+                                     int src_advance, int dst_advance);
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_init_scale_funcs_x_avx2(gavl_scale_funcs_t * tab);
+
+void gavl_init_scale_funcs_y_avx2(gavl_scale_funcs_t * tab,
+                                  int src_advance, int dst_advance);
+#endif
+
 void gavl_init_scale_funcs(gavl_scale_funcs_t * tab,
                            gavl_video_options_t * opt,
                            int src_advance,
@@ -279,6 +303,10 @@ gavl_video_scale_table_init_convolve(gavl_video_scale_table_t * tab,
 void gavl_video_scale_table_init_int(gavl_video_scale_table_t * tab,
                                      int bits);
 
+int gavl_video_scale_table_get_box(const gavl_video_scale_table_t * tab);
+
+int gavl_video_scale_table_is_box_convolve(const gavl_video_scale_table_t * tab);
+
 void gavl_video_scale_table_get_src_indices(gavl_video_scale_table_t * tab,
                                             int * start, int * size);
 
@@ -302,6 +330,27 @@ typedef struct
   int src_offset,  dst_offset;
   } gavl_video_scale_offsets_t;
 
+/*
+ *  Per thread state for 2 pass scaling in bands: A private copy of the
+ *  context (src and offset differ between the threads) and the ring for
+ *  the intermediate scanlines. There is one slot for each thread of the
+ *  pool and one for the calling thread. They are allocated at init and
+ *  taken from the free list for each chunk of output scanlines.
+ */
+
+typedef struct
+  {
+  pthread_mutex_t mutex;
+
+  int num_slots;
+  int num_free;
+  int * free;         /* Indices of the free slots */
+
+  gavl_video_scale_context_t * ctx;
+  uint8_t * rings;
+  int ring_size;      /* Bytes per ring */
+  } gavl_video_scale_bands_t;
+
 /*
  *  Scale context is for one plane of one field.
  *  This means, that depending on the video format, we have 1 - 6 scale contexts.
@@ -344,6 +393,21 @@ struct gavl_video_scale_context_s
 
   int num_directions;
 
+  /* 2 pass scaling: The first pass is the x-direction */
+  int x_first;
+
+  /* 2 pass scaling: Take the result of the first pass from another context
+     (starting first_pass_offset bytes into its buffer) */
+  const gavl_video_scale_context_t * first_pass;
+  int first_pass_offset;
+
+  /* 2 pass scaling in bands: band_rows output scanlines are produced from
+     a window of at most ring_lines intermediate scanlines. 0 if the full
+     buffer must be used */
+  int band_rows;
+  int ring_lines;
+  gavl_video_scale_bands_t * bands;
+
   /* Minimum and maximum values for clipping.
      Values can be different for different components */
   
@@ -399,6 +463,48 @@ void gavl_video_scale_context_scale(gavl_video_scale_context_t * ctx,
                                     const gavl_video_frame_t * src,
                                     gavl_video_frame_t * dst);
 
+/* Add the scanlines of a full frame to a job set. The frames must stay
+   valid until the jobs are run */
+
+void gavl_video_scale_context_add_jobs(gavl_video_scale_context_t * ctx,
+                                       gavl_video_jobs_t * jobs,
+                                       const gavl_video_frame_t * src,
+                                       gavl_video_frame_t * dst);
+
+/* Strip based scaling */
+
+void gavl_video_scale_context_scale_prepare(gavl_video_scale_context_t * ctx,
+                                            const gavl_video_frame_t * src);
+
+void gavl_video_scale_context_scale_rows(gavl_video_scale_context_t * ctx,
+                                         uint8_t * dst, int dst_stride,
+                                         int start, int end);
+
+/*
+ *  Pass based scaling: Pass 0 is the only pass of 1 pass scaling or
+ *  the first pass of 2 pass scaling, which writes the temporary buffer.
+ *  Pass 1 is the second pass. The scanlines of one pass can be processed
+ *  in any order (also from several threads), but all scanlines of pass 0
+ *  must be done before pass 1 is prepared.
+ */
+
+/* Number of scanlines (0 if there is nothing to do) */
+int gavl_video_scale_context_pass_height(const gavl_video_scale_context_t * ctx,
+                                         int pass);
+
+void gavl_video_scale_context_pass_prepare(gavl_video_scale_context_t * ctx,
+                                           int pass,
+                                           const gavl_video_frame_t * src,
+                                           gavl_video_frame_t * dst);
+
+void gavl_video_scale_context_pass_rows(gavl_video_scale_context_t * ctx,
+                                        int pass, int start, int end);
+
+/* Take the first pass from src_ctx if it's exactly the same. Returns 1 on success */
+
+int gavl_video_scale_context_share_first_pass(gavl_video_scale_context_t * ctx,
+                                              const gavl_video_scale_context_t * src_ctx);
+
 struct gavl_video_scaler_s
   {
   gavl_video_options_t opt;
@@ -419,8 +525,12 @@ struct gavl_video_scaler_s
   gavl_video_frame_t * src;
   gavl_video_frame_t * dst;
 
-  gavl_video_frame_t * src_field;
-  gavl_video_frame_t * dst_field;
+  /* One per field, since both fields are scaled at once */
+  gavl_video_frame_t * src_field[2];
+  gavl_video_frame_t * dst_field[2];
+
+  /* All planes and fields of a frame */
+  gavl_video_jobs_t jobs;
   
   gavl_video_format_t src_format;
   gavl_video_format_t dst_format;
@@ -428,7 +538,25 @@ struct gavl_video_scaler_s
   gavl_rectangle_i_t dst_rect;
   //  gavl_rectangle_f_t src_rect;
 
+  /* Shared pool, used if none was set in the options */
+  gavl_thread_pool_t * tp_priv;
   };
 
+/*
+ *  Strip based scaling for the video converter. This works only for
+ *  progressive scaling into the whole destination frame.
+ *  gavl_video_scaler_scale_rows() produces the scanlines start..end-1 of
+ *  the destination frame into dst, which holds only these scanlines.
+ */
+
+int gavl_video_scaler_can_scale_rows(const gavl_video_scaler_t * s);
+
+void gavl_video_scaler_scale_prepare(gavl_video_scaler_t * s,
+                                     const gavl_video_frame_t * src);
+
+void gavl_video_scaler_scale_rows(gavl_video_scaler_t * s,
+                                  gavl_video_frame_t * dst,
+                                  int start, int end);
+
 
 #endif // SCALE_H_INCLUDED
@@ -0,0 +1,112 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+#ifndef SSIM_H_INCLUDED
+#define SSIM_H_INCLUDED
+
+/* Private structures for the SSIM calculation */
+
+#include "config.h"
+
+/*
+ *  The SSIM is calculated from 5 moments (x, y, x*x, y*y and x*y),
+ *  which are filtered with a separable gaussian window. The samples
+ *  are normalized to 0.0 .. 1.0 and shifted by -0.5.
+ */
+
+#define GAVL_SSIM_MOMENTS 5
+
+/* Minimum width and height of a plane (size of the gaussian window) */
+
+#define GAVL_SSIM_MIN_SIZE 11
+
+/* Maximum number of planes */
+
+#define GAVL_SSIM_MAX_PLANES 3
+
+typedef struct
+  {
+  /* dst[i] = sum(coeffs[t] * src[i + t]) for t = 0 .. taps-1 */
+  void (*filter_h)(const float * src, float * dst,
+                   const float * coeffs, int taps, int num);
+
+  /* dst[i] = sum(coeffs[t] * src[t][i]) for t = 0 .. taps-1 */
+  void (*filter_v)(const float * const * src, float * dst,
+                   const float * coeffs, int taps, int num);
+
+  /* SSIM indices from the filtered moments. Returns their sum,
+     map can be NULL. If cs is non NULL, the sum of the contrast
+     structure terms (the SSIM without the luminance term) is
+     returned there. */
+  double (*ssim)(const float * const * mom, float * map, int num,
+                 float c1, float c2, double * cs);
+  } gavl_ssim_funcs_t;
+
+void gavl_ssim_funcs_init(gavl_ssim_funcs_t * funcs, int accel_flags);
+
+void gavl_init_ssim_funcs_c(gavl_ssim_funcs_t * funcs);
+
+#ifdef HAVE_SSE2
+void gavl_init_ssim_funcs_sse2(gavl_ssim_funcs_t * funcs);
+#endif
+
+/* One plane of the source frames */
+
+typedef struct
+  {
+  const uint8_t * src1;
+  const uint8_t * src2;
+  int stride1;
+  int stride2;
+
+  int width;
+  int height;
+  int bytes;   /* Bytes per sample: 1, 2 or 4 (float) */
+
+  float * map; /* Per pixel SSIM or NULL */
+  int map_stride;
+
+  int cs;      /* Calculate the contrast structure term as well */
+  
+  double * row_sums;
+  double * cs_sums;
+  const gavl_ssim_funcs_t * funcs;
+  } gavl_ssim_plane_t;
+
+/* Set up the planes of 2 frames. Returns the number of planes or 0 if
+   the format is not supported */
+
+int gavl_ssim_init_planes(gavl_ssim_plane_t * planes,
+                          const gavl_video_frame_t * src1,
+                          const gavl_video_frame_t * src2,
+                          const gavl_video_format_t * format,
+                          const gavl_ssim_funcs_t * funcs);
+
+/* Add the scanlines of a plane to a parallel loop */
+
+void gavl_ssim_add_jobs(gavl_ssim_plane_t * plane, gavl_video_jobs_t * jobs);
+
+/* Get the mean SSIM (and contrast structure term) of a plane after
+   the loop was run. cs can be NULL */
+
+void gavl_ssim_get_result(gavl_ssim_plane_t * plane, double * ssim,
+                          double * cs);
+
+#endif // SSIM_H_INCLUDED
@@ -25,6 +25,9 @@
 
 #define MAX_TRANSFORM_FILTER 4
 
+/* Pixel as seen by the scanline functions. These are expanded from the
+   compact table entries for a few pixels at a time */
+
 typedef struct 
   {
   int index_x;
@@ -35,13 +38,42 @@ typedef struct
   int   factors_i[MAX_TRANSFORM_FILTER][MAX_TRANSFORM_FILTER];
   } gavl_transform_pixel_t;
 
+/* Number of pixels expanded at once */
+
+#define TRANSFORM_CHUNK_SIZE 64
+
 typedef struct gavl_transform_context_s gavl_transform_context_t;
 
 typedef void
 (*gavl_transform_scanline_func)(gavl_transform_context_t * ctx,
                                 gavl_transform_pixel_t * pixels,
+                                int num_pixels,
                                 uint8_t * dest_start);
 
+/*
+ *  Source position of the first pixel of a scanline and the increment
+ *  per pixel for affine matrices. The positions are in 1/TRANSFORM_PHASES
+ *  pixels with TRANSFORM_FIXED_BITS additional fractional bits.
+ */
+
+#define TRANSFORM_FIXED_BITS 16
+
+typedef struct
+  {
+  int64_t x;
+  int64_t y;
+  int64_t step_x;
+  int64_t step_y;
+  } gavl_transform_affine_t;
+
+/* Transform a whole scanline of an affine matrix transform.
+   The source positions are calculated on the fly */
+
+typedef void
+(*gavl_transform_affine_func)(gavl_transform_context_t * ctx,
+                              const gavl_transform_affine_t * pos,
+                              int y, uint8_t * dest_start);
+
 typedef struct
   {
   gavl_transform_scanline_func transform_rgb_15;
@@ -60,6 +92,10 @@ typedef struct
   gavl_transform_scanline_func transform_float_x_3;
   gavl_transform_scanline_func transform_float_x_4;
 
+  /* Affine matrix kernels (bilinear only) */
+  gavl_transform_affine_func affine_uint8_x_1;
+  gavl_transform_affine_func affine_uint8_x_4;
+  
   /* Bits needed for the integer scaling coefficient */
   int bits_rgb_15;
   int bits_rgb_16;
@@ -98,22 +134,106 @@ void gavl_init_transform_funcs_bicubic_mmxext(gavl_transform_funcs_t * tab,
 
 #endif
 
+#ifdef HAVE_SSE2
+void gavl_init_transform_funcs_bilinear_sse2(gavl_transform_funcs_t * tab,
+                                             int advance);
+#endif
+
+#ifdef HAVE_AVX2
+void gavl_init_transform_funcs_bilinear_avx2(gavl_transform_funcs_t * tab,
+                                             int advance);
+#endif
+
+/*
+ *  Compact table entry. The source position is stored relative to the
+ *  destination pixel. The factors are the product of an x- and a y-weight
+ *  vector. Since the weights only depend on the subpixel phase and the
+ *  border handling, there are only a few of them shared by all pixels.
+ */
+
+#define TRANSFORM_OUTSIDE    INT16_MIN
+#define TRANSFORM_PHASE_BITS 10
+#define TRANSFORM_PHASES     (1 << TRANSFORM_PHASE_BITS)
 
+typedef struct
+  {
+  int16_t dx;
+  int16_t dy;
+  uint16_t wx;
+  uint16_t wy;
+  } gavl_transform_entry_t;
+
+/*
+ *  Entry of a full precision table, used for 16 bit and float formats.
+ *  The phases of the compact entries are too coarse for these, so the
+ *  fractional part of the source position is kept.
+ */
+
+typedef struct
+  {
+  int16_t dx;  /* Integer part relative to the destination pixel */
+  int16_t dy;
+  uint32_t fx; /* Fractional part in 1/2^32 pixels */
+  uint32_t fy;
+  } gavl_transform_entry_precise_t;
 
 typedef struct 
   {
-  gavl_transform_pixel_t ** pixels;
+  gavl_transform_entry_t * entries; /* width * height, NULL for a matrix */
+  int width;
+  int height;
   int factors_per_pixel; /* Per dimension */
+
+  /* Full precision: entries_precise instead of entries. The weights
+     are interpolated between the phases. Used by 16 bit and float formats */
+  int precise;
+  gavl_transform_entry_precise_t * entries_precise;
+
+  /* Weight vectors, factors_per_pixel per vector */
+  float * weights_f;
+  int   * weights_i; /* 15 bit fixed point */
+  int   * weights_max; /* Index of the largest weight */
+  int num_weights;
+  int bits;
+
+  /* Maps plane coordinates of the destination to the source,
+     used if there are no entries */
+  double matrix[3][3];
   } gavl_transform_table_t;
 
 void gavl_transform_table_init(gavl_transform_table_t * t,
                                gavl_video_options_t * opt,
                                gavl_image_transform_func func, void * priv,
                                float off_x, float off_y, float scale_x,
-                               float scale_y, int width, int height);
+                               float scale_y, int width, int height,
+                               int precise);
+
+/* Matrix transform: Only the weights are created here */
+
+void gavl_transform_table_init_matrix(gavl_transform_table_t * tab,
+                                      gavl_video_options_t * opt,
+                                      int width, int height, int precise);
+
+void gavl_transform_table_set_matrix(gavl_transform_table_t * tab,
+                                     const double matrix[3][3],
+                                     float off_x, float off_y,
+                                     float scale_x, float scale_y);
 
 void gavl_transform_table_init_int(gavl_transform_table_t * tab,
-                                   int bits, int width, int height);
+                                   int bits);
+
+/* Get the source position of the first pixel of scanline y.
+   Returns 0 if the matrix is not affine or the positions of the
+   scanline don't fit into the fixed point range */
+
+int gavl_transform_table_get_affine(const gavl_transform_table_t * tab,
+                                    int y, gavl_transform_affine_t * ret);
+
+/* Expand num pixels of a scanline starting at x */
+
+void gavl_transform_table_get_pixels(const gavl_transform_table_t * tab,
+                                     int y, int x, int num,
+                                     gavl_transform_pixel_t * ret);
 
 
 void
@@ -125,6 +245,7 @@ gavl_transform_table_free(gavl_transform_table_t * tab);
 struct gavl_transform_context_s
   {
   gavl_transform_scanline_func func;
+  gavl_transform_affine_func affine_func;
   gavl_transform_table_t tab;
   int offset;
   int advance;
@@ -133,6 +254,12 @@ struct gavl_transform_context_s
   int num_fields;
   int dst_width;
   int dst_height;
+
+  /* Plane to frame coordinates */
+  float off_x;
+  float off_y;
+  float scale_x;
+  float scale_y;
   
   /* Things set while transforming */
   uint8_t * src; /* Beginning of plane */
@@ -150,12 +277,24 @@ int
 gavl_transform_context_init(gavl_image_transform_t * t,
                             gavl_video_options_t * opt,
                             int field_index, int plane_index,
-                            gavl_image_transform_func func, void * priv);
+                            gavl_image_transform_func func, void * priv,
+                            const double matrix[3][3]);
+
+void gavl_transform_context_set_matrix(gavl_transform_context_t * ctx,
+                                       const double matrix[3][3]);
+
+/* Transform num pixels of scanline y starting at x with the
+   generic scanline function */
+
+void gavl_transform_context_scanline(gavl_transform_context_t * ctx,
+                                     int y, int x, int num,
+                                     uint8_t * dest_start);
 
 void
-gavl_transform_context_transform(gavl_transform_context_t * ctx,
-                                 const gavl_video_frame_t * src,
-                                 gavl_video_frame_t * dst);
+gavl_transform_context_add_jobs(gavl_transform_context_t * ctx,
+                                gavl_video_jobs_t * jobs,
+                                const gavl_video_frame_t * src,
+                                gavl_video_frame_t * dst);
 
 void
 gavl_transform_context_free(gavl_transform_context_t * ctx);
@@ -176,7 +315,9 @@ struct gavl_image_transform_s
   
   int num_planes;
   int num_fields;
-  
+
+  /* All planes and fields of a frame */
+  gavl_video_jobs_t jobs;
   };
 
 
@@ -23,6 +23,8 @@
 #ifndef VIDEO_H_INCLUDED
 #define VIDEO_H_INCLUDED
 
+#include <pthread.h>
+
 #include <hw.h>
 
 /* Private structures for the video converter */
@@ -70,7 +72,9 @@ struct gavl_video_options_s
   float downscale_blur;
 
   gavl_thread_pool_t * tp;
-  
+
+  /* Maximum number of frames in flight for asynchronous conversion */
+  int async_frames;
   };
 
 typedef struct gavl_video_convert_context_s gavl_video_convert_context_t;
@@ -91,8 +95,36 @@ struct gavl_video_convert_context_s
   
   struct gavl_video_convert_context_s * next;
   gavl_video_func_t func;
+
+  /* Multithreaded pixelformat conversion: Each slice converts
+     a horizontal band of the image */
+  struct gavl_video_convert_context_s * slices;
+  int num_slices;
+  gavl_video_frame_t * input_subframe;
   };
 
+/* One strip of the video converter pipeline */
+
+typedef struct
+  {
+  gavl_video_convert_context_t csp;  /* Pixelformat conversion of the strip */
+  gavl_video_frame_t * strip;        /* Scaled scanlines */
+  gavl_video_frame_t * dst;          /* Subframe of the output frame */
+  gavl_video_frame_t * dst_frame;    /* Output frame */
+  gavl_video_converter_t * cnv;
+  } gavl_video_convert_strip_t;
+
+/* One frame of the asynchronous conversion */
+
+typedef struct
+  {
+  gavl_video_converter_t * cnv;    /* Private converter for this frame */
+  gavl_video_converter_t * parent;
+  const gavl_video_frame_t * input_frame;
+  gavl_video_frame_t * output_frame;
+  int busy;                        /* Protected by the async mutex of the parent */
+  } gavl_video_convert_async_t;
+
 struct gavl_video_converter_s
   {
   gavl_video_format_t input_format;
@@ -104,8 +136,32 @@ struct gavl_video_converter_s
   gavl_video_convert_context_t * last_context;
   int num_contexts;
   int have_frames;
+
+  /*
+   *  Pipeline mode: The scale context and the following
+   *  csp context run on horizontal strips, which stay in the cache.
+   *  Each thread carries its strips through both stages.
+   */
+  gavl_video_convert_context_t * pipeline_ctx;
+  gavl_video_convert_strip_t * strips;
+  int num_strips;
+  int strip_height;
   
   gavl_thread_pool_t * tp_priv;
+
+  /*
+   *  Asynchronous conversion: Each frame in flight has its own
+   *  converter and output frame. They are kept in a ring and
+   *  completed in the order they were submitted.
+   */
+  gavl_video_convert_async_t * async;
+  int num_async;
+  int async_first;     /* Oldest frame not yet completed */
+  int async_count;     /* Frames submitted and not yet completed */
+  int async_delivered; /* The frame before async_first is still in use */
+  int async_sync;      /* Convert in submit (init failed or adaptive deinterlacing) */
+  pthread_mutex_t async_mutex;
+  pthread_cond_t async_cond;
   
   /* Hardware accelerated converter (unused for now) */
   //  gavl_video_source_t * src;
@@ -136,6 +192,62 @@ int gavl_pixelformat_can_scale(gavl_pixelformat_t in_csp, gavl_pixelformat_t out
 gavl_pixelformat_t gavl_pixelformat_get_intermediate(gavl_pixelformat_t in_csp,
                                                    gavl_pixelformat_t out_csp);
 
+/*
+ *  Measured cost of converting one pixel (see gavl_pixelformat_calibrate()).
+ *  Returns < 0 if the conversions weren't calibrated.
+ */
+
+float gavl_pixelformat_get_cost(gavl_pixelformat_t src,
+                                gavl_pixelformat_t dst);
+
+/* Measured cost mapped to 1..255 for the conversion penalty */
+
+int gavl_pixelformat_get_cost_rank(gavl_pixelformat_t src,
+                                   gavl_pixelformat_t dst);
+
+/*
+ *  Check if fmt can carry everything from sub, i.e. if converting
+ *  through fmt instead of directly to sub loses nothing
+ */
+
+int gavl_pixelformat_covers(gavl_pixelformat_t fmt,
+                            gavl_pixelformat_t sub);
+
+/*
+ *  Job sets: The scanlines of several planes, fields or images are
+ *  processed in one parallel loop, so the threads are synchronized only
+ *  once per frame. Each job gets its own range of loop indices, func is
+ *  called with scanline indices relative to the job.
+ */
+
+typedef struct
+  {
+  void (*func)(void * data, int start, int end);
+  void * data;
+  int start; /* Range inside the parallel loop */
+  int end;
+  } gavl_video_job_t;
+
+typedef struct
+  {
+  gavl_video_job_t * jobs;
+  int num_jobs;
+  int jobs_alloc;
+  int num_rows;
+  } gavl_video_jobs_t;
+
+void gavl_video_jobs_reset(gavl_video_jobs_t * j);
+
+void gavl_video_jobs_add(gavl_video_jobs_t * j,
+                         void (*func)(void * data, int start, int end),
+                         void * data, int num_rows);
+
+/* tp can be NULL, then the jobs are done one after another */
+
+void gavl_video_jobs_run(gavl_video_jobs_t * j, gavl_thread_pool_t * tp);
+
+void gavl_video_jobs_free(gavl_video_jobs_t * j);
+
 #define CLEAR_MASK_PLANE_0 (1<<0)
 #define CLEAR_MASK_PLANE_1 (1<<1)
 #define CLEAR_MASK_PLANE_2 (1<<2)
@@ -8,6 +8,9 @@ dnl variable HAVE_feature is set to "true". The following features are
 dnl Supported:
 dnl MMX: Compiler can compile inline MMX assembly
 dnl SSE: Compiler can compile inline SSE assembly
+dnl SSE2_INT: Compiler can compile SSE2 intrinsics (with SSE2_CFLAGS)
+dnl SSSE3_INT: Compiler can compile SSSE3 intrinsics (with SSSE3_CFLAGS)
+dnl AVX2_INT: Compiler can compile AVX2 intrinsics (with AVX2_CFLAGS)
 AC_DEFUN([GAVL_CHECK_SIMD_INTERNAL],[
 AC_MSG_CHECKING([Architecture])
 case $1 in
@@ -149,6 +152,7 @@ dnl Check for SSE2 intrinsics
 dnl
 
   AC_MSG_CHECKING([if C compiler accepts SSE2 intrinsics])
+  CFLAGS="$2 -msse2"
   AC_LINK_IFELSE([AC_LANG_SOURCE([[#include <emmintrin.h>
 		  int main()
 		  {
@@ -158,7 +162,59 @@ dnl
 		  }
 		 ]])],
 	      HAVE_SSE2_INT=true)
+  CFLAGS=$2
   if test "$HAVE_SSE2_INT" = true; then
+    SSE2_CFLAGS="-msse2"
+    AC_MSG_RESULT(yes)
+  else
+    AC_MSG_RESULT(no)
+  fi
+
+dnl
+dnl Check for SSSE3 intrinsics. Like AVX2, these are only enabled
+dnl for the files, which need them
+dnl
+
+  AC_MSG_CHECKING([if C compiler accepts SSSE3 intrinsics])
+  CFLAGS="$2 -mssse3"
+  AC_LINK_IFELSE([AC_LANG_SOURCE([[#include <tmmintrin.h>
+		  int main()
+		  {
+		  __m128i m1;
+		  m1 = _mm_set1_epi16(1);
+		  m1 = _mm_mulhrs_epi16(m1, m1);
+		  return _mm_extract_epi16(_mm_shuffle_epi8(m1, m1), 0);
+		  }
+		 ]])],
+	      HAVE_SSSE3_INT=true)
+  CFLAGS=$2
+  if test "$HAVE_SSSE3_INT" = true; then
+    SSSE3_CFLAGS="-mssse3"
+    AC_MSG_RESULT(yes)
+  else
+    AC_MSG_RESULT(no)
+  fi
+
+dnl
+dnl Check for AVX2 intrinsics. These need special compiler flags,
+dnl which are only passed to the files in gavl/avx2
+dnl
+
+  AC_MSG_CHECKING([if C compiler accepts AVX2 intrinsics])
+  CFLAGS="$2 -mavx2 -mfma"
+  AC_LINK_IFELSE([AC_LANG_SOURCE([[#include <immintrin.h>
+		  int main()
+		  {
+		  __m256i m1;
+		  m1 = _mm256_set1_epi16(1);
+		  m1 = _mm256_mulhrs_epi16(m1, m1);
+		  return _mm256_extract_epi16(m1, 0);
+		  }
+		 ]])],
+	      HAVE_AVX2_INT=true)
+  CFLAGS=$2
+  if test "$HAVE_AVX2_INT" = true; then
+    AVX2_CFLAGS="-mavx2 -mfma"
     AC_MSG_RESULT(yes)
   else
     AC_MSG_RESULT(no)
@@ -223,9 +279,22 @@ AH_TEMPLATE([HAVE_SSE3],   [SSE3 Supported])
 AH_TEMPLATE([HAVE_SSSE3],   [SSSE3 Supported])
 AH_TEMPLATE([HAVE_NEON],   [Neon Supported])
 AH_TEMPLATE([HAVE_AVX],    [AVX Supported])
+AH_TEMPLATE([HAVE_AVX2],   [AVX2 Supported])
 
 GAVL_CHECK_SIMD_INTERNAL($1, $2)
 
+dnl
+dnl The MMX code can be left out on CPUs, which have the SSE2 and
+dnl SSSE3 replacements anyway
+dnl
+
+AC_ARG_ENABLE(mmx,
+[AS_HELP_STRING([--disable-mmx],[Don't build the MMX routines])],
+[case "${enableval}" in
+   yes) ;;
+   no)  HAVE_MMX=false ;;
+esac])
+
 if test x"$HAVE_MMX" = "xtrue"; then
 AC_DEFINE(HAVE_MMX)
 fi
@@ -240,16 +309,24 @@ if test x"$HAVE_SSE2" = "xtrue"; then
 AC_DEFINE(HAVE_SSE2)
 fi
 AM_CONDITIONAL(HAVE_SSE2, test "x$HAVE_SSE2" = "xtrue")
+AC_SUBST(SSE2_CFLAGS)
 
 if test x"$HAVE_SSE3" = "xtrue"; then
 AC_DEFINE(HAVE_SSE3)
 fi
 AM_CONDITIONAL(HAVE_SSE3, test "x$HAVE_SSE3" = "xtrue")
 
-if test x"$HAVE_SSSE3" = "xtrue"; then
+if test x"$HAVE_SSSE3_INT" = "xtrue"; then
 AC_DEFINE(HAVE_SSSE3)
 fi
-AM_CONDITIONAL(HAVE_SSSE3, test "x$HAVE_SSSE3" = "xtrue")
+AM_CONDITIONAL(HAVE_SSSE3, test "x$HAVE_SSSE3_INT" = "xtrue")
+AC_SUBST(SSSE3_CFLAGS)
+
+if test x"$HAVE_AVX2_INT" = "xtrue"; then
+AC_DEFINE(HAVE_AVX2)
+fi
+AM_CONDITIONAL(HAVE_AVX2, test "x$HAVE_AVX2_INT" = "xtrue")
+AC_SUBST(AVX2_CFLAGS)
 
 if test x"$ARCH_X86" = "xtrue"; then
 AC_DEFINE(ARCH_X86)
@@ -28,6 +28,7 @@
 
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -911,6 +912,10 @@ static void benchmark_pixelformat()
       gavl_video_options_set_accel_flags(ctx.opt, GAVL_ACCEL_SSE3);
       do_pixelformat(&ctx, &b, in_format, out_format, "SSE3");
       fflush(stdout);
+
+      gavl_video_options_set_accel_flags(ctx.opt, GAVL_ACCEL_AVX2);
+      do_pixelformat(&ctx, &b, in_format, out_format, "AVX2");
+      fflush(stdout);
       
       }
     }
@@ -1145,6 +1150,7 @@ deinterlace_modes[] =
     { "Scanline doubler", GAVL_DEINTERLACE_COPY },
     { "Upscale",          GAVL_DEINTERLACE_SCALE },
     { "Blend",            GAVL_DEINTERLACE_BLEND },
+    { "Adaptive",         GAVL_DEINTERLACE_ADAPTIVE },
     { /* End */ }
   };
 
@@ -1514,6 +1520,287 @@ static void benchmark_dsp_interpolate()
   
   }
 
+/* Single DSP functions */
+
+#define DSP_WIDTH  720
+#define DSP_HEIGHT 576
+#define DSP_NUM    (DSP_WIDTH * DSP_HEIGHT)
+
+typedef struct
+  {
+  gavl_dsp_funcs_t * funcs;
+
+  uint8_t * src_1;
+  uint8_t * src_2;
+  uint8_t * dst;
+
+  int indices[4];
+  } dsp_funcs_context_t;
+
+#define DSP_SAD(name, bytes) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->src_1, ctx->src_2, \
+                   DSP_WIDTH * bytes, DSP_WIDTH * bytes, \
+                   DSP_WIDTH, DSP_HEIGHT); \
+  }
+
+#define DSP_2_SRC(name) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->src_1, ctx->src_2, ctx->dst, DSP_NUM); \
+  }
+
+#define DSP_INTERPOLATE(name) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->src_1, ctx->src_2, ctx->dst, DSP_NUM, 0.3); \
+  }
+
+#define DSP_BSWAP(name) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->dst, DSP_NUM); \
+  }
+
+#define DSP_SHIFT(name) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->dst, DSP_NUM, 4); \
+  }
+
+#define DSP_SHIFT_COPY(name) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->dst, ctx->src_1, DSP_NUM, 4); \
+  }
+
+#define DSP_SHUFFLE(name) \
+static void dsp_##name(void * data) \
+  { \
+  dsp_funcs_context_t * ctx = data; \
+  ctx->funcs->name(ctx->dst, ctx->src_1, DSP_NUM, ctx->indices); \
+  }
+
+DSP_SAD(sad_rgb15, 2)
+DSP_SAD(sad_rgb16, 2)
+DSP_SAD(sad_8, 1)
+DSP_SAD(sad_16, 2)
+DSP_SAD(sad_f, 4)
+
+DSP_2_SRC(average_rgb15)
+DSP_2_SRC(average_rgb16)
+DSP_2_SRC(average_8)
+DSP_2_SRC(average_16)
+DSP_2_SRC(average_f)
+
+DSP_INTERPOLATE(interpolate_rgb15)
+DSP_INTERPOLATE(interpolate_rgb16)
+DSP_INTERPOLATE(interpolate_8)
+DSP_INTERPOLATE(interpolate_16)
+DSP_INTERPOLATE(interpolate_f)
+
+DSP_BSWAP(bswap_16)
+DSP_BSWAP(bswap_32)
+DSP_BSWAP(bswap_64)
+
+DSP_2_SRC(add_u8)
+DSP_2_SRC(add_u8_s)
+DSP_2_SRC(add_s8)
+DSP_2_SRC(add_u16)
+DSP_2_SRC(add_u16_s)
+DSP_2_SRC(add_s16)
+DSP_2_SRC(add_s32)
+DSP_2_SRC(add_float)
+DSP_2_SRC(add_double)
+
+DSP_2_SRC(sub_u8)
+DSP_2_SRC(sub_u8_s)
+DSP_2_SRC(sub_s8)
+DSP_2_SRC(sub_u16)
+DSP_2_SRC(sub_u16_s)
+DSP_2_SRC(sub_s16)
+DSP_2_SRC(sub_s32)
+DSP_2_SRC(sub_float)
+DSP_2_SRC(sub_double)
+
+DSP_SHIFT(shift_up_16)
+DSP_SHIFT(shift_down_16)
+DSP_SHIFT_COPY(shift_up_copy_16)
+DSP_SHIFT_COPY(shift_down_copy_16)
+
+DSP_SHUFFLE(shuffle_8_4)
+DSP_SHUFFLE(shuffle_16_4)
+
+#define DSP_FUNC(name) { #name, offsetof(gavl_dsp_funcs_t, name), dsp_##name }
+
+static const struct
+  {
+  const char * name;
+  size_t offset; /* Offset of the function pointer in gavl_dsp_funcs_t */
+  void (*func)(void*);
+  }
+dsp_funcs[] =
+  {
+    DSP_FUNC(sad_rgb15),
+    DSP_FUNC(sad_rgb16),
+    DSP_FUNC(sad_8),
+    DSP_FUNC(sad_16),
+    DSP_FUNC(sad_f),
+    DSP_FUNC(average_rgb15),
+    DSP_FUNC(average_rgb16),
+    DSP_FUNC(average_8),
+    DSP_FUNC(average_16),
+    DSP_FUNC(average_f),
+    DSP_FUNC(interpolate_rgb15),
+    DSP_FUNC(interpolate_rgb16),
+    DSP_FUNC(interpolate_8),
+    DSP_FUNC(interpolate_16),
+    DSP_FUNC(interpolate_f),
+    DSP_FUNC(bswap_16),
+    DSP_FUNC(bswap_32),
+    DSP_FUNC(bswap_64),
+    DSP_FUNC(add_u8),
+    DSP_FUNC(add_u8_s),
+    DSP_FUNC(add_s8),
+    DSP_FUNC(add_u16),
+    DSP_FUNC(add_u16_s),
+    DSP_FUNC(add_s16),
+    DSP_FUNC(add_s32),
+    DSP_FUNC(add_float),
+    DSP_FUNC(add_double),
+    DSP_FUNC(sub_u8),
+    DSP_FUNC(sub_u8_s),
+    DSP_FUNC(sub_s8),
+    DSP_FUNC(sub_u16),
+    DSP_FUNC(sub_u16_s),
+    DSP_FUNC(sub_s16),
+    DSP_FUNC(sub_s32),
+    DSP_FUNC(sub_float),
+    DSP_FUNC(sub_double),
+    DSP_FUNC(shift_up_16),
+    DSP_FUNC(shift_down_16),
+    DSP_FUNC(shift_up_copy_16),
+    DSP_FUNC(shift_down_copy_16),
+    DSP_FUNC(shuffle_8_4),
+    DSP_FUNC(shuffle_16_4),
+  };
+
+static const struct
+  {
+  const char * name;
+  int flag;
+  }
+dsp_flavours[] =
+  {
+    { "C",      GAVL_ACCEL_C },
+    { "MMX",    GAVL_ACCEL_MMX },
+    { "MMXEXT", GAVL_ACCEL_MMXEXT },
+    { "SSE",    GAVL_ACCEL_SSE },
+    { "SSE2",   GAVL_ACCEL_SSE2 },
+    { "AVX2",   GAVL_ACCEL_AVX2 },
+  };
+
+static void benchmark_dsp_funcs()
+  {
+  dsp_funcs_context_t ctx;
+  gavl_dsp_context_t * dsp;
+  gavl_benchmark_t b;
+  int i, j;
+  int supported;
+  int len = DSP_NUM * 8;
+
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&b, 0, sizeof(b));
+
+  b.data = &ctx;
+
+  /* Largest element is 8 bytes (double and 64 bit swapping) */
+  ctx.src_1 = malloc(len);
+  ctx.src_2 = malloc(len);
+  ctx.dst   = malloc(len);
+
+  /* Random floats, so the float functions don't see NaNs or denormals */
+  for(i = 0; i < len / 4; i++)
+    {
+    ((float*)ctx.src_1)[i] = (float)rand() / RAND_MAX;
+    ((float*)ctx.src_2)[i] = (float)rand() / RAND_MAX;
+    }
+  memset(ctx.dst, 0, len);
+
+  ctx.indices[0] = 2;
+  ctx.indices[1] = 1;
+  ctx.indices[2] = 0;
+  ctx.indices[3] = 3;
+
+  printf("Samples: %d\n", DSP_NUM);
+
+  if(do_html)
+    {
+    printf("<p><table border=\"1\" width=\"100%%\"><tr><td>Function</td><td>Flavour</td>");
+    gavl_benchmark_print_header(&b);
+    printf("</tr>\n");
+    }
+  else
+    {
+    printf("Function            Flavour ");
+    gavl_benchmark_print_header(&b);
+    printf("\n");
+    }
+
+  dsp = gavl_dsp_context_create();
+
+  /* Disable autoselection */
+  gavl_dsp_context_set_quality(dsp, 0);
+  ctx.funcs = gavl_dsp_context_get_funcs(dsp);
+
+  supported = gavl_accel_supported() | GAVL_ACCEL_C;
+
+  for(i = 0; i < sizeof(dsp_funcs)/sizeof(dsp_funcs[0]); i++)
+    {
+    b.func = dsp_funcs[i].func;
+
+    for(j = 0; j < sizeof(dsp_flavours)/sizeof(dsp_flavours[0]); j++)
+      {
+      if(!(supported & dsp_flavours[j].flag))
+        continue;
+
+      gavl_dsp_context_set_accel_flags(dsp, dsp_flavours[j].flag);
+
+      /* Function not available in this flavour */
+      if(!(*(void**)((uint8_t*)ctx.funcs + dsp_funcs[i].offset)))
+        continue;
+
+      if(do_html)
+        printf("<tr><td>%s</td><td>%s</td>",
+               dsp_funcs[i].name, dsp_flavours[j].name);
+      else
+        printf("%-19s %-7s ", dsp_funcs[i].name, dsp_flavours[j].name);
+
+      gavl_benchmark_run(&b);
+      gavl_benchmark_print_results(&b);
+      if(do_html)
+        printf("</tr>");
+      printf("\n");
+      fflush(stdout);
+      }
+    }
+
+  gavl_dsp_context_destroy(dsp);
+  free(ctx.src_1);
+  free(ctx.src_2);
+  free(ctx.dst);
+
+  if(do_html)
+    printf("</table>\n");
+  }
+
 /* Image transformation */
 
 static const struct
@@ -1760,6 +2047,7 @@ static void benchmark_image_transform()
 #define BENCHMARK_INTERPOLATE  (1<<9)
 #define BENCHMARK_SAD          (1<<10)
 #define BENCHMARK_TRANSFORM    (1<<11)
+#define BENCHMARK_DSP          (1<<12)
 
 static const struct
   {
@@ -1780,6 +2068,7 @@ benchmark_flags[] =
     { "-deint", "Deinterlacing",           BENCHMARK_DEINTERLACE},
     { "-ip", "Video frame interpolation",  BENCHMARK_INTERPOLATE},
     { "-it", "Image transformation",  BENCHMARK_TRANSFORM},
+    { "-dsp", "DSP functions",             BENCHMARK_DSP},
     //    { "-sad", "SAD routines",              BENCHMARK_SAD},
   };
 
@@ -1932,6 +2221,8 @@ int main(int argc, char ** argv)
       printf("<a href=\"#ip\">Video frame interpolation</a><br>\n");
     if(flags & BENCHMARK_TRANSFORM)
       printf("<a href=\"#it\">Video image transformation</a><br>\n");
+    if(flags & BENCHMARK_DSP)
+      printf("<a href=\"#dsp\">DSP functions</a><br>\n");
     }
   else
     printf("Times are %s\n", gavl_benchmark_get_desc(gavl_accel_supported()));
@@ -2010,6 +2301,15 @@ int main(int argc, char ** argv)
     print_header("Video image transformation");
     benchmark_image_transform();
     }
+  if(flags & BENCHMARK_DSP)
+    {
+    if(do_html)
+      {
+      printf("<a name=\"dsp\"></a>");
+      }
+    print_header("DSP functions");
+    benchmark_dsp_funcs();
+    }
   
   if(do_html)
     {
@@ -1309,6 +1309,120 @@ static void convert_UYVY_to_RGB24(gavl_video_frame_t * in_frame,
     }
   }
 
+/* Semiplanar formats (NV12, NV21, NV16): u_offset is the position of U
+   in the interleaved chroma plane, sub_v the vertical chroma subsampling */
+
+static void convert_NV_to_RGB24(gavl_video_frame_t * in_frame,
+                                gavl_video_frame_t * out_frame,
+                                int width, int height,
+                                int sub_v, int u_offset)
+  {
+  int i, j, i_tmp;
+
+  uint8_t * in_y;
+  uint8_t * in_uv;
+
+  uint8_t * out_pixel;
+
+  uint8_t * out_pixel_save = out_frame->planes[0];
+  uint8_t * in_y_save = in_frame->planes[0];
+
+  for(i = 0; i < height; i++)
+    {
+    in_y = in_y_save;
+    in_uv = in_frame->planes[1] + (i / sub_v) * in_frame->strides[1];
+    out_pixel = out_pixel_save;
+    for(j = 0; j < width/2; j++)
+      {
+      YUV_2_RGB(in_y[0], in_uv[u_offset], in_uv[1-u_offset],
+                out_pixel[0], out_pixel[1], out_pixel[2]);
+      out_pixel += 3;
+      YUV_2_RGB(in_y[1], in_uv[u_offset], in_uv[1-u_offset],
+                out_pixel[0], out_pixel[1], out_pixel[2]);
+      out_pixel += 3;
+      in_y += 2;
+      in_uv += 2;
+      }
+    out_pixel_save += out_frame->strides[0];
+    in_y_save += in_frame->strides[0];
+    }
+  }
+
+static void convert_YUV_420_P_16_to_RGB24(gavl_video_frame_t * in_frame,
+                                          gavl_video_frame_t * out_frame,
+                                          int width, int height)
+  {
+  int i, j, i_tmp;
+
+  uint16_t * in_y;
+  uint16_t * in_u;
+  uint16_t * in_v;
+
+  uint8_t * out_pixel;
+
+  uint8_t * out_pixel_save = out_frame->planes[0];
+  uint8_t * in_y_save = in_frame->planes[0];
+
+  for(i = 0; i < height; i++)
+    {
+    in_y = (uint16_t*)in_y_save;
+    in_u = (uint16_t*)(in_frame->planes[1] + (i / 2) * in_frame->strides[1]);
+    in_v = (uint16_t*)(in_frame->planes[2] + (i / 2) * in_frame->strides[2]);
+    out_pixel = out_pixel_save;
+    for(j = 0; j < width/2; j++)
+      {
+      YUV_2_RGB(((*in_y)>>8), ((*in_u)>>8), ((*in_v)>>8),
+                out_pixel[0], out_pixel[1], out_pixel[2]);
+      in_y++;
+      out_pixel += 3;
+      
+      YUV_2_RGB(((*in_y)>>8), ((*in_u)>>8), ((*in_v)>>8),
+                out_pixel[0], out_pixel[1], out_pixel[2]);
+      in_y++;
+      in_u++;
+      in_v++;
+      out_pixel += 3;
+      }
+    out_pixel_save += out_frame->strides[0];
+    in_y_save += in_frame->strides[0];
+    }
+  }
+
+static void convert_P016_to_RGB24(gavl_video_frame_t * in_frame,
+                                  gavl_video_frame_t * out_frame,
+                                  int width, int height)
+  {
+  int i, j, i_tmp;
+
+  uint16_t * in_y;
+  uint16_t * in_uv;
+
+  uint8_t * out_pixel;
+
+  uint8_t * out_pixel_save = out_frame->planes[0];
+  uint8_t * in_y_save = in_frame->planes[0];
+
+  for(i = 0; i < height; i++)
+    {
+    in_y = (uint16_t*)in_y_save;
+    in_uv = (uint16_t*)(in_frame->planes[1] + (i / 2) * in_frame->strides[1]);
+    out_pixel = out_pixel_save;
+    for(j = 0; j < width/2; j++)
+      {
+      YUV_2_RGB((in_y[0]>>8), (in_uv[0]>>8), (in_uv[1]>>8),
+                out_pixel[0], out_pixel[1], out_pixel[2]);
+      out_pixel += 3;
+      YUV_2_RGB((in_y[1]>>8), (in_uv[0]>>8), (in_uv[1]>>8),
+                out_pixel[0], out_pixel[1], out_pixel[2]);
+      out_pixel += 3;
+      in_y += 2;
+      in_uv += 2;
+      }
+    out_pixel_save += out_frame->strides[0];
+    in_y_save += in_frame->strides[0];
+    }
+  }
+
 /*
  *  This function writes a png file of the video frame in the given format
  *  The format can have all supported colorspaces, so we'll convert them
@@ -1568,6 +1682,36 @@ static int write_file(const char * name,
                                  format->image_height);
       out_frame = tmp_frame;
       break;
+    case GAVL_NV12:
+      tmp_frame = gavl_video_frame_create(&tmp_format);
+      convert_NV_to_RGB24(frame, tmp_frame, format->image_width,
+                          format->image_height, 2, 0);
+      out_frame = tmp_frame;
+      break;
+    case GAVL_NV21:
+      tmp_frame = gavl_video_frame_create(&tmp_format);
+      convert_NV_to_RGB24(frame, tmp_frame, format->image_width,
+                          format->image_height, 2, 1);
+      out_frame = tmp_frame;
+      break;
+    case GAVL_NV16:
+      tmp_frame = gavl_video_frame_create(&tmp_format);
+      convert_NV_to_RGB24(frame, tmp_frame, format->image_width,
+                          format->image_height, 1, 0);
+      out_frame = tmp_frame;
+      break;
+    case GAVL_YUV_420_P_16:
+      tmp_frame = gavl_video_frame_create(&tmp_format);
+      convert_YUV_420_P_16_to_RGB24(frame, tmp_frame, format->image_width,
+                                    format->image_height);
+      out_frame = tmp_frame;
+      break;
+    case GAVL_P016:
+      tmp_frame = gavl_video_frame_create(&tmp_format);
+      convert_P016_to_RGB24(frame, tmp_frame, format->image_width,
+                            format->image_height);
+      out_frame = tmp_frame;
+      break;
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -2649,6 +2793,143 @@ static gavl_video_frame_t * create_picture(gavl_pixelformat_t pixelformat,
           }
         }
       break;
+    case GAVL_NV12:
+    case GAVL_NV21:
+      for(row = 0; row < TEST_PICTURE_HEIGHT/2; row++)
+        {
+        y = ret->planes[0] + 2 * row * ret->strides[0];
+        u = ret->planes[1] + row * ret->strides[1];
+        if(pixelformat == GAVL_NV21)
+          {
+          v = u;
+          u = v + 1;
+          }
+        else
+          v = u + 1;
+        
+        for(col = 0; col < TEST_PICTURE_WIDTH/2; col++)
+          {
+          get_pixel(2*col, 2*row, tmp_f);
+
+          RGB_TO_YUV();
+          Y_TO_8(*y);
+          U_TO_8(*u);
+          V_TO_8(*v);
+
+          y++;
+          
+          get_pixel(2*col+1, 2*row, tmp_f);
+          RGB_TO_Y();
+          Y_TO_8(*y);
+          
+          y++;
+          u += 2;
+          v += 2;
+          }
+
+        y = ret->planes[0] + (2 * row + 1) * ret->strides[0];
+
+        for(col = 0; col < TEST_PICTURE_WIDTH/2; col++)
+          {
+          get_pixel(2*col, 2*row+1, tmp_f);
+          RGB_TO_Y();
+          Y_TO_8(*y);
+
+          y++;
+          
+          get_pixel(2*col+1, 2*row+1, tmp_f);
+          RGB_TO_Y();
+          Y_TO_8(*y);
+          
+          y++;
+          }
+        }
+      break;
+    case GAVL_NV16:
+      for(row = 0; row < TEST_PICTURE_HEIGHT; row++)
+        {
+        y = ret->planes[0] + row * ret->strides[0];
+        u = ret->planes[1] + row * ret->strides[1];
+        v = u + 1;
+
+        for(col = 0; col < TEST_PICTURE_WIDTH/2; col++)
+          {
+          get_pixel(2*col, row, tmp_f);
+
+          RGB_TO_YUV();
+          Y_TO_8(*y);
+          U_TO_8(*u);
+          V_TO_8(*v);
+
+          y++;
+          
+          get_pixel(2*col+1, row, tmp_f);
+          RGB_TO_Y();
+          Y_TO_8(*y);
+          
+          y++;
+          u += 2;
+          v += 2;
+          }
+        }
+      break;
+    case GAVL_YUV_420_P_16:
+    case GAVL_P016:
+      for(row = 0; row < TEST_PICTURE_HEIGHT/2; row++)
+        {
+        y_16 = (uint16_t*)(ret->planes[0] + 2 * row * ret->strides[0]);
+        u_16 = (uint16_t*)(ret->planes[1] + row * ret->strides[1]);
+        if(pixelformat == GAVL_P016)
+          v_16 = u_16 + 1;
+        else
+          v_16 = (uint16_t*)(ret->planes[2] + row * ret->strides[2]);
+        
+        for(col = 0; col < TEST_PICTURE_WIDTH/2; col++)
+          {
+          get_pixel(2*col, 2*row, tmp_f);
+
+          RGB_TO_YUV();
+          Y_TO_16(*y_16);
+          U_TO_16(*u_16);
+          V_TO_16(*v_16);
+
+          y_16++;
+          
+          get_pixel(2*col+1, 2*row, tmp_f);
+          RGB_TO_Y();
+          Y_TO_16(*y_16);
+          
+          y_16++;
+          if(pixelformat == GAVL_P016)
+            {
+            u_16 += 2;
+            v_16 += 2;
+            }
+          else
+            {
+            u_16++;
+            v_16++;
+            }
+          }
+
+        y_16 = (uint16_t*)(ret->planes[0] + (2 * row + 1) * ret->strides[0]);
+
+        for(col = 0; col < TEST_PICTURE_WIDTH/2; col++)
+          {
+          get_pixel(2*col, 2*row+1, tmp_f);
+          RGB_TO_Y();
+          Y_TO_16(*y_16);
+
+          y_16++;
+          
+          get_pixel(2*col+1, 2*row+1, tmp_f);
+          RGB_TO_Y();
+          Y_TO_16(*y_16);
+          
+          y_16++;
+          }
+        }
+      break;
     case GAVL_PIXELFORMAT_NONE:
       break;
     }
@@ -2842,6 +3123,20 @@ int main(int argc, char ** argv)
                    output_frame, &output_format);
         fprintf(stderr, "Wrote %s\n", filename_buffer);
         }
+
+      gavl_video_options_set_accel_flags(opt, GAVL_ACCEL_AVX2);
+      gavl_video_frame_clear(output_frame, &output_format);
+      sprintf(filename_buffer, "%s_to_%s_avx2.png", tmp1, tmp2);
+      if(gavl_video_converter_init(cnv, &input_format, &output_format) <= 0)
+        fprintf(stderr, "No AVX2 Conversion defined yet\n");
+      else
+        {
+        fprintf(stderr, "AVX2 Version:    ");
+        gavl_video_convert(cnv, input_frame, output_frame);
+        write_file(filename_buffer,
+                   output_frame, &output_format);
+        fprintf(stderr, "Wrote %s\n", filename_buffer);
+        }
 #endif
       
       gavl_video_frame_destroy(output_frame);
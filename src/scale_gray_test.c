@@ -0,0 +1,173 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Regression test for scaling planar YUV to gray: The output must be
+   identical on repeated runs and equal to the scaled Y plane */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gavl/gavl.h>
+
+#define SRC_WIDTH   640
+#define SRC_HEIGHT  480
+#define DST_WIDTH  1280
+#define DST_HEIGHT  720
+
+#define NUM_RUNS      5
+
+static const gavl_pixelformat_t pixelformats[] =
+  {
+    GAVL_YUV_420_P,
+    GAVL_YUV_422_P,
+    GAVL_YUV_410_P,
+  };
+
+static void init_format(gavl_video_format_t * fmt,
+                        int width, int height,
+                        gavl_pixelformat_t pixelformat)
+  {
+  memset(fmt, 0, sizeof(*fmt));
+  fmt->image_width  = width;
+  fmt->image_height = height;
+  fmt->frame_width  = width;
+  fmt->frame_height = height;
+  fmt->pixel_width  = 1;
+  fmt->pixel_height = 1;
+  fmt->pixelformat  = pixelformat;
+  }
+
+static void fill_frame(gavl_video_frame_t * frame,
+                       const gavl_video_format_t * fmt)
+  {
+  int i, j, plane;
+  int sub_h, sub_v;
+  int width, height;
+  
+  gavl_pixelformat_chroma_sub(fmt->pixelformat, &sub_h, &sub_v);
+  
+  srand(1);
+  
+  for(plane = 0; plane < 3; plane++)
+    {
+    width  = plane ? fmt->image_width  / sub_h : fmt->image_width;
+    height = plane ? fmt->image_height / sub_v : fmt->image_height;
+    
+    for(i = 0; i < height; i++)
+      {
+      for(j = 0; j < width; j++)
+        frame->planes[plane][i * frame->strides[plane] + j] = rand() & 0xff;
+      }
+    }
+  }
+
+static void convert(const gavl_video_format_t * in_format,
+                    const gavl_video_format_t * out_format,
+                    gavl_video_frame_t * in_frame,
+                    gavl_video_frame_t * out_frame)
+  {
+  gavl_video_converter_t * cnv;
+  
+  cnv = gavl_video_converter_create();
+  gavl_video_converter_init(cnv, in_format, out_format);
+  gavl_video_convert(cnv, in_frame, out_frame);
+  gavl_video_converter_destroy(cnv);
+  }
+
+static int compare_plane(const gavl_video_frame_t * f1,
+                         const gavl_video_frame_t * f2,
+                         int width, int height)
+  {
+  int i;
+  for(i = 0; i < height; i++)
+    {
+    if(memcmp(f1->planes[0] + i * f1->strides[0],
+              f2->planes[0] + i * f2->strides[0], width))
+      return 0;
+    }
+  return 1;
+  }
+
+int main(int argc, char ** argv)
+  {
+  int i, run;
+  int ret = 0;
+  gavl_video_format_t in_format;
+  gavl_video_format_t gray_format;
+  gavl_video_format_t yuv_format;
+
+  gavl_video_frame_t * in_frame;
+  gavl_video_frame_t * gray_frame;
+  gavl_video_frame_t * yuv_frame;
+  gavl_video_frame_t * ref_frame;
+  
+  for(i = 0; i < sizeof(pixelformats) / sizeof(pixelformats[0]); i++)
+    {
+    init_format(&in_format, SRC_WIDTH, SRC_HEIGHT, pixelformats[i]);
+    init_format(&gray_format, DST_WIDTH, DST_HEIGHT, GAVL_GRAY_8);
+    init_format(&yuv_format, DST_WIDTH, DST_HEIGHT, pixelformats[i]);
+    
+    in_frame   = gavl_video_frame_create(&in_format);
+    gray_frame = gavl_video_frame_create(&gray_format);
+    yuv_frame  = gavl_video_frame_create(&yuv_format);
+    ref_frame  = gavl_video_frame_create(&gray_format);
+    
+    fill_frame(in_frame, &in_format);
+
+    /* Reference: Y plane of the scaled YUV image */
+    convert(&in_format, &yuv_format, in_frame, yuv_frame);
+    
+    for(run = 0; run < NUM_RUNS; run++)
+      {
+      gavl_video_frame_clear(gray_frame, &gray_format);
+      convert(&in_format, &gray_format, in_frame, gray_frame);
+      
+      if(!run)
+        gavl_video_frame_copy(&gray_format, ref_frame, gray_frame);
+      else if(!compare_plane(gray_frame, ref_frame, DST_WIDTH, DST_HEIGHT))
+        {
+        fprintf(stderr, "%s -> %s: Run %d differs from run 0\n",
+                gavl_pixelformat_to_string(pixelformats[i]),
+                gavl_pixelformat_to_string(GAVL_GRAY_8), run);
+        ret = 1;
+        }
+      }
+
+    if(!compare_plane(ref_frame, yuv_frame, DST_WIDTH, DST_HEIGHT))
+      {
+      fprintf(stderr, "%s -> %s: Output differs from scaled Y plane\n",
+              gavl_pixelformat_to_string(pixelformats[i]),
+              gavl_pixelformat_to_string(GAVL_GRAY_8));
+      ret = 1;
+      }
+    else
+      fprintf(stderr, "%s -> %s: OK\n",
+              gavl_pixelformat_to_string(pixelformats[i]),
+              gavl_pixelformat_to_string(GAVL_GRAY_8));
+    
+    gavl_video_frame_destroy(in_frame);
+    gavl_video_frame_destroy(gray_frame);
+    gavl_video_frame_destroy(yuv_frame);
+    gavl_video_frame_destroy(ref_frame);
+    }
+  
+  return ret;
+  }
@@ -0,0 +1,236 @@
+/*****************************************************************
+ * gavl - a general purpose audio/video processing library
+ *
+ * Copyright (c) 2001 - 2024 Members of the Gmerlin project
+ * http://github.com/bplaum
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * *****************************************************************/
+
+/* Regression test for the ladder scaler: Each output must be
+   identical to a standalone scaler working on its source. Without
+   cascading, the source is the input frame. With cascading, it's the
+   next larger output, which also checks the source index chosen for
+   each output. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gavl/gavl.h>
+
+#define SRC_WIDTH  1280
+#define SRC_HEIGHT  720
+
+typedef struct
+  {
+  int width;
+  int height;
+  } frame_size_t;
+
+/* Sorted by size, so each output is the cascade source of the next one */
+
+static const frame_size_t cascade_sizes[] =
+  {
+    { 960, 540 },
+    { 640, 360 },
+    { 480, 270 },
+    { 320, 180 },
+  };
+
+/* Outputs of the same width, which scale in different directions first */
+
+static const frame_size_t shared_sizes[] =
+  {
+    { 960, 540 },
+    { 960, 400 },
+    { 640, 360 },
+    { 640, 480 },
+  };
+
+#define MAX_OUTPUTS 4
+
+static const gavl_pixelformat_t pixelformats[] =
+  {
+    GAVL_YUV_420_P,
+    GAVL_RGB_24,
+    GAVL_YUY2,
+  };
+
+static void init_format(gavl_video_format_t * fmt,
+                        int width, int height,
+                        gavl_pixelformat_t pixelformat)
+  {
+  memset(fmt, 0, sizeof(*fmt));
+  fmt->image_width  = width;
+  fmt->image_height = height;
+  fmt->frame_width  = width;
+  fmt->frame_height = height;
+  fmt->pixel_width  = 1;
+  fmt->pixel_height = 1;
+  fmt->pixelformat  = pixelformat;
+  }
+
+static void fill_frame(gavl_video_frame_t * frame,
+                       const gavl_video_format_t * fmt)
+  {
+  int i, j, plane;
+  int sub_h, sub_v;
+  int width, height;
+  int num_planes;
+
+  gavl_pixelformat_chroma_sub(fmt->pixelformat, &sub_h, &sub_v);
+  num_planes = gavl_pixelformat_num_planes(fmt->pixelformat);
+
+  srand(1);
+
+  for(plane = 0; plane < num_planes; plane++)
+    {
+    width  = plane ? fmt->image_width  / sub_h : fmt->image_width;
+    height = plane ? fmt->image_height / sub_v : fmt->image_height;
+
+    if(num_planes > 1)
+      width *= gavl_pixelformat_bytes_per_component(fmt->pixelformat);
+    else
+      width *= gavl_pixelformat_bytes_per_pixel(fmt->pixelformat);
+
+    /* Smooth content, so cascaded and direct scaling differ
+       only slightly but noticeably */
+    for(i = 0; i < height; i++)
+      {
+      for(j = 0; j < width; j++)
+        frame->planes[plane][i * frame->strides[plane] + j] =
+          (i * 3 + j * 5 + (rand() & 0x0f)) & 0xff;
+      }
+    }
+  }
+
+static void scale(const gavl_video_format_t * in_format,
+                  const gavl_video_format_t * out_format,
+                  const gavl_video_frame_t * in_frame,
+                  gavl_video_frame_t * out_frame)
+  {
+  gavl_video_scaler_t * scaler;
+
+  scaler = gavl_video_scaler_create();
+  gavl_video_scaler_init(scaler, in_format, out_format);
+  gavl_video_scaler_scale(scaler, in_frame, out_frame);
+  gavl_video_scaler_destroy(scaler);
+  }
+
+static int test_ladder(gavl_pixelformat_t pixelformat,
+                       const frame_size_t * sizes, int num_outputs,
+                       int cascade)
+  {
+  int k;
+  int ret = 0;
+  gavl_video_format_t in_format;
+  gavl_video_format_t out_formats[MAX_OUTPUTS];
+  gavl_video_frame_t * in_frame;
+  gavl_video_frame_t * out_frames[MAX_OUTPUTS];
+  gavl_video_frame_t * ref_frame;
+  gavl_video_ladder_scaler_t * ladder;
+  gavl_video_options_t * opt;
+  const char * name = gavl_pixelformat_to_string(pixelformat);
+
+  init_format(&in_format, SRC_WIDTH, SRC_HEIGHT, pixelformat);
+  in_frame = gavl_video_frame_create(&in_format);
+  fill_frame(in_frame, &in_format);
+
+  for(k = 0; k < num_outputs; k++)
+    {
+    init_format(&out_formats[k], sizes[k].width, sizes[k].height,
+                pixelformat);
+    out_frames[k] = gavl_video_frame_create(&out_formats[k]);
+    }
+
+  ladder = gavl_video_ladder_scaler_create();
+
+  if(cascade)
+    {
+    opt = gavl_video_ladder_scaler_get_options(ladder);
+    gavl_video_options_set_conversion_flags(opt,
+                                            gavl_video_options_get_conversion_flags(opt) |
+                                            GAVL_SCALE_CASCADE);
+    }
+
+  if(!gavl_video_ladder_scaler_init(ladder, &in_format,
+                                    out_formats, num_outputs))
+    {
+    fprintf(stderr, "%s: Initializing ladder scaler failed\n", name);
+    ret = 1;
+    goto end;
+    }
+
+  gavl_video_ladder_scaler_scale(ladder, in_frame, out_frames);
+
+  for(k = 0; k < num_outputs; k++)
+    {
+    ref_frame = gavl_video_frame_create(&out_formats[k]);
+
+    /* The largest output is always scaled from the input */
+    if(!cascade || !k)
+      scale(&in_format, &out_formats[k], in_frame, ref_frame);
+    else
+      scale(&out_formats[k-1], &out_formats[k], out_frames[k-1], ref_frame);
+
+    if(!gavl_video_frames_equal(&out_formats[k], ref_frame, out_frames[k]))
+      {
+      fprintf(stderr, "%s %dx%d: Output differs from standalone scaler\n",
+              name, sizes[k].width, sizes[k].height);
+      ret = 1;
+      }
+
+    /* Make sure, we don't scale from the input as well */
+    if(cascade && k)
+      {
+      scale(&in_format, &out_formats[k], in_frame, ref_frame);
+      if(gavl_video_frames_equal(&out_formats[k], ref_frame, out_frames[k]))
+        {
+        fprintf(stderr, "%s %dx%d: Output was not cascaded\n",
+                name, sizes[k].width, sizes[k].height);
+        ret = 1;
+        }
+      }
+    gavl_video_frame_destroy(ref_frame);
+    }
+
+  if(!ret)
+    fprintf(stderr, "%s%s: OK\n", name, cascade ? " (cascaded)" : "");
+
+  end:
+
+  gavl_video_ladder_scaler_destroy(ladder);
+  gavl_video_frame_destroy(in_frame);
+  for(k = 0; k < num_outputs; k++)
+    gavl_video_frame_destroy(out_frames[k]);
+  return ret;
+  }
+
+int main(int argc, char ** argv)
+  {
+  int i;
+  int ret = 0;
+
+  for(i = 0; i < sizeof(pixelformats) / sizeof(pixelformats[0]); i++)
+    {
+    if(test_ladder(pixelformats[i], shared_sizes,
+                   sizeof(shared_sizes) / sizeof(shared_sizes[0]), 0))
+      ret = 1;
+    if(test_ladder(pixelformats[i], cascade_sizes,
+                   sizeof(cascade_sizes) / sizeof(cascade_sizes[0]), 1))
+      ret = 1;
+    }
+  return ret;
+  }